@@ -0,0 +1,202 @@
+/**
+ * @file bench_detection.cpp
+ * @brief Detector IPC benchmarks (frame hand-off into shm and result
+ *        parsing) and detection log queries
+ *
+ * Runs the real DetectionClientImpl against MockDetector, on a private
+ * socket and shm name so a running vision-detector is never disturbed.
+ */
+
+#include "mock_detector.h"
+#include "core/detection_client.h"
+#include "detection/detection_log.h"
+
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+namespace bench {
+
+namespace {
+
+MockDetectorConfig privateDetectorConfig() {
+    MockDetectorConfig config;
+    std::string suffix = std::to_string(::getpid());
+    config.socket_path = "/tmp/rv_bench_detector_" + suffix + ".sock";
+    config.shm_name = "/rv_bench_frames_" + suffix;
+    config.auto_reply = false;      // Benchmarks decide when results arrive
+    return config;
+}
+
+DetectionClientConfig clientConfigFor(const MockDetectorConfig& mock) {
+    DetectionClientConfig config;
+    config.socket_path = mock.socket_path;
+    config.shm_name = mock.shm_name;
+    config.auto_reconnect = false;
+    return config;
+}
+
+} // namespace
+
+/**
+ * DetectionClientImpl::sendFrame(): header + memcpy into shm + FRAME_READY
+ *
+ * The mock drains notifications on its own thread, so the socket never
+ * backs up. Sizes stop at 1080p, the protocol's MAX_FRAME_SIZE.
+ */
+static void BM_SendFrame(benchmark::State& state) {
+    MockDetectorConfig mock_config = privateDetectorConfig();
+    MockDetector mock(mock_config);
+    auto client = createDetectionClient(clientConfigFor(mock_config));
+    if (!mock.start() || !client->connect()) {
+        state.SkipWithError("Could not connect to mock detector");
+        return;
+    }
+
+    const uint32_t width = static_cast<uint32_t>(state.range(0));
+    const uint32_t height = static_cast<uint32_t>(state.range(1));
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 3, 0x40);
+
+    uint64_t frame_id = 0;
+    for (auto _ : state) {
+        if (!client->sendFrame(pixels.data(), width, height, frame_id++)) {
+            state.SkipWithError("sendFrame failed");
+            break;
+        }
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(pixels.size()));
+    client->disconnect();
+    mock.stop();
+}
+BENCHMARK(BM_SendFrame)
+    ->ArgNames({"width", "height"})
+    ->Args({640, 480})
+    ->Args({1280, 720})
+    ->Args({1920, 1080})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/**
+ * DetectionClientImpl::receiveDetections(): select, recv of one
+ * DetectionResultMessage and copy into the caller's vector
+ *
+ * The result is written into the socket before timing each iteration's
+ * receive, so the measured path never waits.
+ */
+static void BM_ReceiveDetections(benchmark::State& state) {
+    MockDetectorConfig mock_config = privateDetectorConfig();
+    MockDetector mock(mock_config);
+    auto client = createDetectionClient(clientConfigFor(mock_config));
+    if (!mock.start() || !client->connect()) {
+        state.SkipWithError("Could not connect to mock detector");
+        return;
+    }
+
+    const uint32_t num_detections = static_cast<uint32_t>(state.range(0));
+    std::vector<detector_protocol::Detection> detections;
+    detections.reserve(detector_protocol::MAX_DETECTIONS);
+    uint64_t frame_id = 0;
+    float inference_ms = 0.0f;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        bool sent = mock.sendResult(frame_id + 1, num_detections);
+        state.ResumeTiming();
+
+        if (!sent || !client->receiveDetections(detections, frame_id, inference_ms)) {
+            state.SkipWithError("No detection result received");
+            break;
+        }
+        benchmark::DoNotOptimize(detections.data());
+    }
+
+    state.counters["boxes"] = static_cast<double>(num_detections);
+    client->disconnect();
+    mock.stop();
+}
+BENCHMARK(BM_ReceiveDetections)
+    ->ArgName("boxes")
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(100)
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * DetectionLogReader::query() over a session of mostly empty result sets
+ *
+ * Each of the 101 result sets (every 100th has one box) lands in its own
+ * 10 ms index block, so almost every block has an empty label mask. An
+ * unfiltered query must still visit all of them - the same records a
+ * plain scan sees - and a "person" query only the boxed ones.
+ */
+static void BM_DetectionLogQuery(benchmark::State& state) {
+    constexpr int SETS = 101;
+    DetectionLogConfig config;
+    config.enabled = true;
+    config.directory = "/tmp/rv_bench_detlog_" + std::to_string(::getpid());
+    config.flush_interval_ms = 10;
+    config.index_interval_ms = 10;
+
+    std::string data_path;
+    {
+        DetectionLogWriter writer(config);
+        if (!writer.start()) {
+            state.SkipWithError("Could not create detection log");
+            return;
+        }
+        for (int i = 0; i < SETS; ++i) {
+            auto results = std::make_shared<DetectionSet>();
+            results->frame_id = static_cast<uint64_t>(i);
+            results->received_ns = 1000000000ull + static_cast<uint64_t>(i) * 20000000ull;
+            if (i % 100 == 99) {
+                detector_protocol::Detection det{};
+                det.width = det.height = 0.1f;
+                det.confidence = 0.9f;
+                std::strncpy(det.label, "person", sizeof(det.label) - 1);
+                results->detections.push_back(det);
+            }
+            writer.consumeDetections(results);
+        }
+        writer.stop();
+        data_path = writer.path();
+    }
+
+    DetectionLogReader reader;
+    if (!reader.open(data_path)) {
+        state.SkipWithError("Could not open detection log");
+    } else {
+        DetectionLogQuery all;
+        DetectionLogQuery person;
+        person.label = "person";
+        auto count = [](const DetectionLogRecord&) { return true; };
+        if (reader.query(all, count) != SETS) {
+            state.SkipWithError("Unfiltered query missed records in empty index blocks");
+        } else if (reader.query(person, count) != 1) {
+            state.SkipWithError("Label query returned the wrong records");
+        } else {
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(reader.query(all, count));
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * SETS);
+            state.counters["index_blocks"] = static_cast<double>(reader.indexEntries());
+        }
+        reader.close();
+    }
+
+    std::remove(data_path.c_str());
+    std::remove((data_path.substr(0, data_path.size() - 5) + ".rvdx").c_str());
+    ::rmdir(config.directory.c_str());
+}
+BENCHMARK(BM_DetectionLogQuery)->Unit(benchmark::kMicrosecond);
+
+} // namespace bench
+} // namespace robot_vision
@@ -0,0 +1,77 @@
+/**
+ * @file bench_main.cpp
+ * @brief Entry point for the per-frame hot path microbenchmarks
+ *
+ * Build and run:
+ *   cmake -B build -DBUILD_BENCHMARKS=ON && cmake --build build
+ *   ./build/rv_bench                                   # console table
+ *   ./build/rv_bench --benchmark_out=bench.json \
+ *                    --benchmark_out_format=json       # machine-readable
+ *   ./build/rv_bench --benchmark_filter=UpdateTexture  # one group
+ *
+ * TEACHING: Benchmark What You Ship
+ * ---------------------------------
+ * Every benchmark here calls the same classes the application uses
+ * (GStreamerPipeline, TextureRenderer, OSDRenderer, DetectionClientImpl).
+ * A copy-pasted "equivalent" loop would drift from the real code and stop
+ * catching the regressions we care about.
+ */
+
+#include "bench_support.h"
+
+#include <benchmark/benchmark.h>
+#include <gst/gst.h>
+
+namespace robot_vision {
+namespace bench {
+
+namespace {
+std::unique_ptr<IWindow> g_window;
+bool g_window_failed = false;
+}
+
+IWindow* offscreenWindow() {
+    if (g_window || g_window_failed) {
+        return g_window.get();
+    }
+
+    WindowConfig config;
+    config.width = 1280;
+    config.height = 720;
+    config.title = "rv_bench";
+    config.resizable = false;
+    config.vsync = false;       // Never wait for a display refresh
+    config.visible = false;
+
+    g_window = createWindow();
+    if (!g_window->initialize(config)) {
+        g_window.reset();
+        g_window_failed = true;
+    }
+    return g_window.get();
+}
+
+void shutdownOffscreenWindow() {
+    if (g_window) {
+        g_window->shutdown();
+        g_window.reset();
+    }
+}
+
+} // namespace bench
+} // namespace robot_vision
+
+int main(int argc, char** argv) {
+    gst_init(&argc, &argv);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    robot_vision::bench::shutdownOffscreenWindow();
+    gst_deinit();
+    return 0;
+}
@@ -0,0 +1,520 @@
+/**
+ * @file bench_pixel.cpp
+ * @brief Pixel kernel benchmarks, one run per instruction set this CPU has
+ *
+ * Before a variant is timed it is checked byte-for-byte against the scalar
+ * reference: every length/width from 0 to 70 (all vector tails), odd
+ * strides, guard bytes past the end, for YUV, luma, lerp and blend every
+ * possible combination of input values, and for remap every weight pair.
+ * A mismatch fails the benchmark with SkipWithError, so a broken variant
+ * can't report a time.
+ */
+
+#include "pixel/pixel_kernels.h"
+#include "processing/lens_undistort.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace robot_vision {
+namespace bench {
+
+namespace {
+
+constexpr int FRAME_WIDTH = 1920;
+constexpr int FRAME_HEIGHT = 1080;
+constexpr size_t FRAME_PIXELS = static_cast<size_t>(FRAME_WIDTH) * FRAME_HEIGHT;
+constexpr size_t GUARD = 64;        // Bytes past the end that must stay untouched
+constexpr uint8_t SENTINEL = 0xA5;
+constexpr int MAX_TAIL = 70;        // Covers every tail of a 32- or 64-pixel step
+
+const PixelIsa ALL_ISAS[] = {PixelIsa::Scalar, PixelIsa::SSE41, PixelIsa::AVX2, PixelIsa::NEON};
+
+void isaArgs(benchmark::internal::Benchmark* b) {
+    b->ArgName("isa");
+    for (PixelIsa isa : ALL_ISAS) {
+        if (pixelKernelsFor(isa)) {
+            b->Arg(static_cast<int>(isa));
+        }
+    }
+}
+
+std::vector<uint8_t> randomBytes(size_t count, uint32_t seed) {
+    std::vector<uint8_t> bytes(count);
+    uint32_t state = seed * 2654435761u + 1;
+    for (auto& b : bytes) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        b = static_cast<uint8_t>(state >> 24);
+    }
+    return bytes;
+}
+
+// ============================================================================
+// Verification Against the Scalar Reference
+// ============================================================================
+
+/**
+ * Run call(table, out) on the scalar table and on `kernels`, each with the
+ * output buffer starting as `initial` plus a sentinel guard, and compare
+ */
+template <typename Call>
+bool sameOutput(const PixelKernels& kernels, const std::vector<uint8_t>& initial, Call call) {
+    std::vector<uint8_t> expected(initial);
+    expected.resize(initial.size() + GUARD, SENTINEL);
+    std::vector<uint8_t> actual(expected);
+    call(*pixelKernelsFor(PixelIsa::Scalar), expected.data());
+    call(kernels, actual.data());
+    return expected == actual;
+}
+
+bool checkSwizzles(const PixelKernels& k) {
+    for (size_t n = 0; n <= MAX_TAIL + 1; ++n) {
+        if (n == MAX_TAIL + 1) {
+            n = 1970;       // Plus one long run
+        }
+        const auto src = randomBytes(n * 4, static_cast<uint32_t>(n));
+        const std::vector<uint8_t> out3(n * 3, SENTINEL);
+        const std::vector<uint8_t> out4(n * 4, SENTINEL);
+        if (!sameOutput(k, out4, [&](const PixelKernels& t, uint8_t* out) { t.rgb_to_rgba(src.data(), out, n); }) ||
+            !sameOutput(k, out3, [&](const PixelKernels& t, uint8_t* out) { t.rgba_to_rgb(src.data(), out, n); }) ||
+            !sameOutput(k, out3, [&](const PixelKernels& t, uint8_t* out) { t.swap_rb(src.data(), out, n); })) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool checkLuma(const PixelKernels& k) {
+    for (size_t n = 0; n <= MAX_TAIL; ++n) {
+        const auto src = randomBytes(n * 3, static_cast<uint32_t>(n));
+        if (!sameOutput(k, std::vector<uint8_t>(n, SENTINEL),
+                        [&](const PixelKernels& t, uint8_t* out) { t.rgb_to_luma(src.data(), out, n); })) {
+            return false;
+        }
+    }
+    // Every (R, G, B): one call per R value
+    std::vector<uint8_t> src(65536 * 3);
+    for (int r = 0; r < 256; ++r) {
+        for (size_t i = 0; i < 65536; ++i) {
+            src[i * 3] = static_cast<uint8_t>(r);
+            src[i * 3 + 1] = static_cast<uint8_t>(i >> 8);
+            src[i * 3 + 2] = static_cast<uint8_t>(i);
+        }
+        if (!sameOutput(k, std::vector<uint8_t>(65536, SENTINEL),
+                        [&](const PixelKernels& t, uint8_t* out) { t.rgb_to_luma(src.data(), out, 65536); })) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool checkBlend(const PixelKernels& k) {
+    for (size_t n = 0; n <= MAX_TAIL; ++n) {
+        const auto rgba = randomBytes(n * 4, static_cast<uint32_t>(n));
+        if (!sameOutput(k, randomBytes(n * 3, static_cast<uint32_t>(n + 1000)),
+                        [&](const PixelKernels& t, uint8_t* out) { t.blend_rgba(rgba.data(), out, n); })) {
+            return false;
+        }
+    }
+    // Every (src, alpha, dst): one call per alpha value
+    std::vector<uint8_t> rgba(65536 * 4);
+    std::vector<uint8_t> rgb(65536 * 3);
+    for (size_t i = 0; i < 65536; ++i) {
+        rgba[i * 4] = rgba[i * 4 + 1] = rgba[i * 4 + 2] = static_cast<uint8_t>(i >> 8);
+        rgb[i * 3] = rgb[i * 3 + 1] = rgb[i * 3 + 2] = static_cast<uint8_t>(i);
+    }
+    for (int a = 0; a < 256; ++a) {
+        for (size_t i = 0; i < 65536; ++i) {
+            rgba[i * 4 + 3] = static_cast<uint8_t>(a);
+        }
+        if (!sameOutput(k, rgb, [&](const PixelKernels& t, uint8_t* out) { t.blend_rgba(rgba.data(), out, 65536); })) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * YUV planes whose 2x2 blocks enumerate all 256 Y values for each of the
+ * 256 V values, with U fixed per plane set
+ */
+struct YuvPlanes {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> y, u, v, uv;
+};
+
+YuvPlanes allYuvValues(int u_value) {
+    YuvPlanes p;
+    p.width = 512;          // 256 chroma columns: V = column
+    p.height = 128;         // 64 chroma rows: Y = 4 * chroma row + position in the block
+    p.y.resize(static_cast<size_t>(p.width) * p.height);
+    p.u.assign(256 * 64, static_cast<uint8_t>(u_value));
+    p.v.resize(256 * 64);
+    p.uv.resize(512 * 64);
+    for (int row = 0; row < p.height; ++row) {
+        for (int x = 0; x < p.width; ++x) {
+            p.y[static_cast<size_t>(row) * p.width + x] = static_cast<uint8_t>(4 * (row / 2) + 2 * (row % 2) + x % 2);
+        }
+    }
+    for (int row = 0; row < 64; ++row) {
+        for (int c = 0; c < 256; ++c) {
+            p.v[row * 256 + c] = static_cast<uint8_t>(c);
+            p.uv[row * 512 + 2 * c] = static_cast<uint8_t>(u_value);
+            p.uv[row * 512 + 2 * c + 1] = static_cast<uint8_t>(c);
+        }
+    }
+    return p;
+}
+
+bool checkYuv(const PixelKernels& k) {
+    // Tails and odd sizes, strides wider than the rows
+    for (int w = 1; w <= MAX_TAIL; ++w) {
+        for (int h = 1; h <= 3; ++h) {
+            const int cw = (w + 1) / 2;
+            const int ch = (h + 1) / 2;
+            const int ys = w + 5, cs = cw + 3, uvs = 2 * cw + 1, rs = w * 3 + 7;
+            const auto y = randomBytes(static_cast<size_t>(ys) * h, w * 10 + h);
+            const auto u = randomBytes(static_cast<size_t>(cs) * ch, w * 10 + h + 1);
+            const auto v = randomBytes(static_cast<size_t>(cs) * ch, w * 10 + h + 2);
+            const auto uv = randomBytes(static_cast<size_t>(uvs) * ch, w * 10 + h + 3);
+            const std::vector<uint8_t> out(static_cast<size_t>(rs) * h, SENTINEL);
+            if (!sameOutput(k, out, [&](const PixelKernels& t, uint8_t* o) {
+                    t.nv12_to_rgb(y.data(), ys, uv.data(), uvs, o, rs, w, h); }) ||
+                !sameOutput(k, out, [&](const PixelKernels& t, uint8_t* o) {
+                    t.i420_to_rgb(y.data(), ys, u.data(), cs, v.data(), cs, o, rs, w, h); })) {
+                return false;
+            }
+        }
+    }
+    // Every (Y, U, V)
+    for (int u_value = 0; u_value < 256; ++u_value) {
+        const YuvPlanes p = allYuvValues(u_value);
+        const std::vector<uint8_t> out(static_cast<size_t>(p.width) * p.height * 3, SENTINEL);
+        if (!sameOutput(k, out, [&](const PixelKernels& t, uint8_t* o) {
+                t.nv12_to_rgb(p.y.data(), p.width, p.uv.data(), p.width, o, p.width * 3, p.width, p.height); }) ||
+            !sameOutput(k, out, [&](const PixelKernels& t, uint8_t* o) {
+                t.i420_to_rgb(p.y.data(), p.width, p.u.data(), 256, p.v.data(), 256, o, p.width * 3,
+                              p.width, p.height); })) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool checkPlanes(const PixelKernels& k) {
+    for (int w = 1; w <= MAX_TAIL; ++w) {
+        for (int h = 1; h <= 3; ++h) {
+            const int stride = 2 * w + 9;
+            const auto a = randomBytes(static_cast<size_t>(stride) * 2 * h, w * 7 + h);
+            const auto b = randomBytes(static_cast<size_t>(stride) * 2 * h, w * 7 + h + 1);
+            if (!sameOutput(k, std::vector<uint8_t>(static_cast<size_t>(w + 3) * h, SENTINEL),
+                            [&](const PixelKernels& t, uint8_t* o) {
+                                t.downscale_2x(a.data(), stride, o, w + 3, w, h); })) {
+                return false;
+            }
+            const uint64_t expected = pixelKernelsFor(PixelIsa::Scalar)->sad(a.data(), stride, b.data(), stride, w, h);
+            if (k.sad(a.data(), stride, b.data(), stride, w, h) != expected) {
+                return false;
+            }
+        }
+    }
+    // Long rows of maximal differences (accumulator widths)
+    const std::vector<uint8_t> zeros(4099 * 3, 0);
+    const std::vector<uint8_t> full(4099 * 3, 255);
+    if (k.sad(zeros.data(), 4099, full.data(), 4099, 4099, 3) != 4099ull * 3 * 255) {
+        return false;
+    }
+
+    // lerp_rows: every (row0, row1, weight)
+    std::vector<uint8_t> row0(65536);
+    std::vector<uint8_t> row1(65536);
+    for (size_t i = 0; i < 65536; ++i) {
+        row0[i] = static_cast<uint8_t>(i >> 8);
+        row1[i] = static_cast<uint8_t>(i);
+    }
+    for (int weight = 0; weight <= 256; ++weight) {
+        for (int width : {weight % (MAX_TAIL + 1), 65536}) {
+            if (!sameOutput(k, std::vector<uint8_t>(static_cast<size_t>(width) * 2, SENTINEL),
+                            [&](const PixelKernels& t, uint8_t* o) {
+                                t.lerp_rows(row0.data(), row1.data(), weight, reinterpret_cast<uint16_t*>(o), width);
+                            })) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool checkRemap(const PixelKernels& k) {
+    // A 19x7 source; random positions with every neighbour inside, some
+    // outside (-1), and the last valid position (reads end at the last byte)
+    constexpr int SRC_WIDTH = 19;
+    constexpr int SRC_HEIGHT = 7;
+    const auto src = randomBytes(SRC_WIDTH * SRC_HEIGHT * 3, 21);
+    for (int n = 0; n <= MAX_TAIL; ++n) {
+        const auto noise = randomBytes(static_cast<size_t>(n) * 4, static_cast<uint32_t>(n) + 22);
+        std::vector<int32_t> offsets(static_cast<size_t>(n));
+        std::vector<uint16_t> fracs(static_cast<size_t>(n));
+        for (int i = 0; i < n; ++i) {
+            const int x = noise[i * 4] % (SRC_WIDTH - 1);
+            const int y = noise[i * 4 + 1] % (SRC_HEIGHT - 1);
+            offsets[i] = noise[i * 4 + 2] < 32 ? -1 : (y * SRC_WIDTH + x) * 3;
+            fracs[i] = static_cast<uint16_t>(noise[i * 4 + 3] | noise[i * 4 + 2] << 8);
+        }
+        if (n > 0) {
+            offsets[n - 1] = ((SRC_HEIGHT - 2) * SRC_WIDTH + SRC_WIDTH - 2) * 3;
+            fracs[n - 1] = 0xFFFF;
+        }
+        if (!sameOutput(k, std::vector<uint8_t>(static_cast<size_t>(n) * 3, SENTINEL),
+                        [&](const PixelKernels& t, uint8_t* o) {
+                            t.remap_rgb(src.data(), SRC_WIDTH * 3, offsets.data(), fracs.data(), o, n); })) {
+            return false;
+        }
+    }
+    // Extreme values: every weight pair on all-255 and 0/255 neighbours
+    std::vector<uint8_t> corners(2 * 2 * 3);
+    for (int pattern = 0; pattern < 16; ++pattern) {
+        for (int i = 0; i < 4; ++i) {
+            corners[i * 3] = corners[i * 3 + 1] = corners[i * 3 + 2] = (pattern >> i) & 1 ? 255 : 0;
+        }
+        std::vector<int32_t> offsets(65536, 0);
+        std::vector<uint16_t> fracs(65536);
+        for (size_t i = 0; i < fracs.size(); ++i) {
+            fracs[i] = static_cast<uint16_t>(i);
+        }
+        if (!sameOutput(k, std::vector<uint8_t>(65536 * 3, SENTINEL),
+                        [&](const PixelKernels& t, uint8_t* o) {
+                            t.remap_rgb(corners.data(), 6, offsets.data(), fracs.data(), o, 65536); })) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Verify a variant once per run (the checks take tens of milliseconds)
+ */
+bool verified(const PixelKernels& kernels) {
+    static int state[4] = {0, 0, 0, 0};     // 0 unknown, 1 good, -1 bad
+    int& s = state[static_cast<int>(kernels.isa)];
+    if (s == 0) {
+        s = checkSwizzles(kernels) && checkLuma(kernels) && checkBlend(kernels) &&
+            checkYuv(kernels) && checkPlanes(kernels) && checkRemap(kernels) ? 1 : -1;
+    }
+    return s > 0;
+}
+
+/**
+ * Kernel table for the benchmark's isa argument, verified (nullptr after SkipWithError)
+ */
+const PixelKernels* kernelsFor(benchmark::State& state) {
+    const PixelKernels* kernels = pixelKernelsFor(static_cast<PixelIsa>(state.range(0)));
+    if (!kernels) {
+        state.SkipWithError("instruction set not available");
+        return nullptr;
+    }
+    if (!verified(*kernels)) {
+        state.SkipWithError("output differs from the scalar reference");
+        return nullptr;
+    }
+    state.SetLabel(kernels->name);
+    return kernels;
+}
+
+} // namespace
+
+// ============================================================================
+// Benchmarks (one 1080p frame per iteration)
+// ============================================================================
+
+static void BM_PixelRgbToRgba(benchmark::State& state) {
+    const PixelKernels* k = kernelsFor(state);
+    if (!k) {
+        return;
+    }
+    const auto src = randomBytes(FRAME_PIXELS * 3, 1);
+    std::vector<uint8_t> dst(FRAME_PIXELS * 4);
+    for (auto _ : state) {
+        k->rgb_to_rgba(src.data(), dst.data(), FRAME_PIXELS);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * FRAME_PIXELS * 3));
+}
+BENCHMARK(BM_PixelRgbToRgba)->Apply(isaArgs)->Unit(benchmark::kMicrosecond);
+
+static void BM_PixelRgbaToRgb(benchmark::State& state) {
+    const PixelKernels* k = kernelsFor(state);
+    if (!k) {
+        return;
+    }
+    const auto src = randomBytes(FRAME_PIXELS * 4, 2);
+    std::vector<uint8_t> dst(FRAME_PIXELS * 3);
+    for (auto _ : state) {
+        k->rgba_to_rgb(src.data(), dst.data(), FRAME_PIXELS);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * FRAME_PIXELS * 4));
+}
+BENCHMARK(BM_PixelRgbaToRgb)->Apply(isaArgs)->Unit(benchmark::kMicrosecond);
+
+static void BM_PixelSwapRb(benchmark::State& state) {
+    const PixelKernels* k = kernelsFor(state);
+    if (!k) {
+        return;
+    }
+    const auto src = randomBytes(FRAME_PIXELS * 3, 3);
+    std::vector<uint8_t> dst(FRAME_PIXELS * 3);
+    for (auto _ : state) {
+        k->swap_rb(src.data(), dst.data(), FRAME_PIXELS);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * FRAME_PIXELS * 3));
+}
+BENCHMARK(BM_PixelSwapRb)->Apply(isaArgs)->Unit(benchmark::kMicrosecond);
+
+static void BM_PixelNv12ToRgb(benchmark::State& state) {
+    const PixelKernels* k = kernelsFor(state);
+    if (!k) {
+        return;
+    }
+    const auto y = randomBytes(FRAME_PIXELS, 4);
+    const auto uv = randomBytes(FRAME_PIXELS / 2, 5);
+    std::vector<uint8_t> rgb(FRAME_PIXELS * 3);
+    for (auto _ : state) {
+        k->nv12_to_rgb(y.data(), FRAME_WIDTH, uv.data(), FRAME_WIDTH, rgb.data(), FRAME_WIDTH * 3,
+                       FRAME_WIDTH, FRAME_HEIGHT);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * FRAME_PIXELS));
+}
+BENCHMARK(BM_PixelNv12ToRgb)->Apply(isaArgs)->Unit(benchmark::kMicrosecond);
+
+static void BM_PixelI420ToRgb(benchmark::State& state) {
+    const PixelKernels* k = kernelsFor(state);
+    if (!k) {
+        return;
+    }
+    const auto y = randomBytes(FRAME_PIXELS, 6);
+    const auto u = randomBytes(FRAME_PIXELS / 4, 7);
+    const auto v = randomBytes(FRAME_PIXELS / 4, 8);
+    std::vector<uint8_t> rgb(FRAME_PIXELS * 3);
+    for (auto _ : state) {
+        k->i420_to_rgb(y.data(), FRAME_WIDTH, u.data(), FRAME_WIDTH / 2, v.data(), FRAME_WIDTH / 2,
+                       rgb.data(), FRAME_WIDTH * 3, FRAME_WIDTH, FRAME_HEIGHT);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * FRAME_PIXELS));
+}
+BENCHMARK(BM_PixelI420ToRgb)->Apply(isaArgs)->Unit(benchmark::kMicrosecond);
+
+static void BM_PixelRgbToLuma(benchmark::State& state) {
+    const PixelKernels* k = kernelsFor(state);
+    if (!k) {
+        return;
+    }
+    const auto src = randomBytes(FRAME_PIXELS * 3, 9);
+    std::vector<uint8_t> luma(FRAME_PIXELS);
+    for (auto _ : state) {
+        k->rgb_to_luma(src.data(), luma.data(), FRAME_PIXELS);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * FRAME_PIXELS));
+}
+BENCHMARK(BM_PixelRgbToLuma)->Apply(isaArgs)->Unit(benchmark::kMicrosecond);
+
+static void BM_PixelDownscale2x(benchmark::State& state) {
+    const PixelKernels* k = kernelsFor(state);
+    if (!k) {
+        return;
+    }
+    const auto src = randomBytes(FRAME_PIXELS, 10);
+    std::vector<uint8_t> dst(FRAME_PIXELS / 4);
+    for (auto _ : state) {
+        k->downscale_2x(src.data(), FRAME_WIDTH, dst.data(), FRAME_WIDTH / 2, FRAME_WIDTH / 2, FRAME_HEIGHT / 2);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * FRAME_PIXELS));
+}
+BENCHMARK(BM_PixelDownscale2x)->Apply(isaArgs)->Unit(benchmark::kMicrosecond);
+
+/**
+ * resizeBilinear() 1920x1080 -> 640x360 luma: lerp_rows plus the shared
+ * horizontal pass
+ */
+static void BM_PixelResizeBilinear(benchmark::State& state) {
+    const PixelKernels* k = kernelsFor(state);
+    if (!k) {
+        return;
+    }
+    const auto src = randomBytes(FRAME_PIXELS, 11);
+    std::vector<uint8_t> dst(640 * 360);
+    for (auto _ : state) {
+        resizeBilinear(*k, src.data(), FRAME_WIDTH, FRAME_HEIGHT, FRAME_WIDTH, dst.data(), 640, 360, 640);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 640 * 360);
+}
+BENCHMARK(BM_PixelResizeBilinear)->Apply(isaArgs)->Unit(benchmark::kMicrosecond);
+
+static void BM_PixelSad(benchmark::State& state) {
+    const PixelKernels* k = kernelsFor(state);
+    if (!k) {
+        return;
+    }
+    const auto a = randomBytes(FRAME_PIXELS, 12);
+    const auto b = randomBytes(FRAME_PIXELS, 13);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(k->sad(a.data(), FRAME_WIDTH, b.data(), FRAME_WIDTH, FRAME_WIDTH, FRAME_HEIGHT));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * FRAME_PIXELS * 2));
+}
+BENCHMARK(BM_PixelSad)->Apply(isaArgs)->Unit(benchmark::kMicrosecond);
+
+static void BM_PixelBlendRgba(benchmark::State& state) {
+    const PixelKernels* k = kernelsFor(state);
+    if (!k) {
+        return;
+    }
+    const auto rgba = randomBytes(FRAME_PIXELS * 4, 14);
+    auto rgb = randomBytes(FRAME_PIXELS * 3, 15);
+    for (auto _ : state) {
+        k->blend_rgba(rgba.data(), rgb.data(), FRAME_PIXELS);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * FRAME_PIXELS));
+}
+BENCHMARK(BM_PixelBlendRgba)->Apply(isaArgs)->Unit(benchmark::kMicrosecond);
+
+/**
+ * remap_rgb() over a 1080p wide-angle undistortion table, row by row on
+ * one thread (BM_Undistort adds bands and threads)
+ */
+static void BM_PixelRemapRgb(benchmark::State& state) {
+    const PixelKernels* k = kernelsFor(state);
+    if (!k) {
+        return;
+    }
+    UndistortConfig config;
+    config.fx = config.fy = 0.45f * FRAME_WIDTH;
+    config.k1 = -0.32f;
+    config.k2 = 0.11f;
+    const UndistortMap map = buildUndistortMap(config, FRAME_WIDTH, FRAME_HEIGHT);
+    const auto src = randomBytes(FRAME_PIXELS * 3, 16);
+    std::vector<uint8_t> dst(FRAME_PIXELS * 3);
+    for (auto _ : state) {
+        for (int y = 0; y < FRAME_HEIGHT; ++y) {
+            const size_t i = static_cast<size_t>(y) * FRAME_WIDTH;
+            k->remap_rgb(src.data(), FRAME_WIDTH * 3, &map.offsets[i], &map.fracs[i], dst.data() + i * 3, FRAME_WIDTH);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * FRAME_PIXELS));
+}
+BENCHMARK(BM_PixelRemapRgb)->Apply(isaArgs)->Unit(benchmark::kMicrosecond);
+
+} // namespace bench
+} // namespace robot_vision
@@ -0,0 +1,181 @@
+/**
+ * @file bench_rendering.cpp
+ * @brief GPU-side benchmarks: texture upload and OSD overlay
+ *
+ * Both run on the hidden window's GL context and end every iteration with
+ * glFinish(), so the time includes the driver and GPU work rather than
+ * just queuing commands.
+ */
+
+#include "bench_support.h"
+#include "mock_detector.h"
+#include "core/opengl.h"
+#include "core/osd.h"
+#include "osd/detection_overlay.h"
+#include "osd/flight_hud.h"
+#include "metrics/metrics.h"
+#include "rendering/texture_renderer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+namespace bench {
+
+/**
+ * TextureRenderer::updateTexture() for one full frame
+ */
+static void BM_UpdateTexture(benchmark::State& state) {
+    IWindow* window = offscreenWindow();
+    if (!window) {
+        state.SkipWithError("No offscreen GL context (no display?)");
+        return;
+    }
+
+    const int width = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 3);
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        pixels[i] = static_cast<uint8_t>(i * 31);
+    }
+
+    TextureRenderer renderer;
+    if (!renderer.initialize(width, height)) {
+        state.SkipWithError("TextureRenderer failed to initialize");
+        return;
+    }
+
+    for (auto _ : state) {
+        renderer.updateTexture(pixels, width, height);
+        glFinish();
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(pixels.size()));
+    renderer.shutdown();
+}
+BENCHMARK(BM_UpdateTexture)
+    ->ArgNames({"width", "height"})
+    ->Args({1280, 720})
+    ->Args({1920, 1080})
+    ->Args({3840, 2160})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/**
+ * OSD with the bundled fonts (nullptr if they can't be loaded)
+ */
+static std::unique_ptr<IOSD> createBenchOSD() {
+    OSDConfig config;
+#ifdef ASSETS_PATH
+    config.font_path = std::string(ASSETS_PATH) + "/fonts/RobotoMono-Regular.ttf";
+    config.font_bold_path = std::string(ASSETS_PATH) + "/fonts/RobotoMono-Bold.ttf";
+#endif
+    auto osd = createOSD();
+    if (!osd->initialize(config)) {
+        return nullptr;
+    }
+    return osd;
+}
+
+/**
+ * One OSD frame (beginFrame .. endFrame) with N detection boxes and labels
+ */
+static void BM_OSDDetections(benchmark::State& state) {
+    IWindow* window = offscreenWindow();
+    if (!window) {
+        state.SkipWithError("No offscreen GL context (no display?)");
+        return;
+    }
+
+    auto osd = createBenchOSD();
+    if (!osd) {
+        state.SkipWithError("OSD failed to initialize (fonts missing?)");
+        return;
+    }
+
+    detector_protocol::DetectionResultMessage result;
+    MockDetector::fillResult(result, 0, static_cast<uint32_t>(state.range(0)), 0.0f);
+    std::vector<detector_protocol::Detection> detections(
+        result.detections, result.detections + result.num_detections);
+
+    const int fb_width = window->getFramebufferWidth();
+    const int fb_height = window->getFramebufferHeight();
+    DetectionOverlayStyle style;
+    style.label_font_size = static_cast<float>(fb_height) * 0.025f;
+    style.label_padding = static_cast<float>(fb_height) * 0.005f;
+    style.box_line_width = static_cast<float>(fb_height) * 0.003f;
+
+    for (auto _ : state) {
+        osd->beginFrame(fb_width, fb_height, 1.0f);
+        drawDetections(*osd, detections, fb_width, fb_height, style);
+        osd->endFrame();
+        glFinish();
+    }
+
+    state.counters["boxes"] = static_cast<double>(detections.size());
+    osd->shutdown();
+}
+BENCHMARK(BM_OSDDetections)
+    ->ArgName("boxes")
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(100)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/**
+ * One OSD frame with the full flight HUD, attitude and values changing every frame
+ *
+ * Compare with BM_OSDDetections/boxes:10: the HUD is meant to cost about
+ * as much as the regular overlay, not a multiple of it.
+ */
+static void BM_OSDFlightHud(benchmark::State& state) {
+    IWindow* window = offscreenWindow();
+    if (!window) {
+        state.SkipWithError("No offscreen GL context (no display?)");
+        return;
+    }
+    auto osd = createBenchOSD();
+    if (!osd) {
+        state.SkipWithError("OSD failed to initialize (fonts missing?)");
+        return;
+    }
+
+    const int fb_width = window->getFramebufferWidth();
+    const int fb_height = window->getFramebufferHeight();
+    FlightHudConfig config;
+    FlightHud hud;
+    TelemetrySnapshot flight{};
+    uint32_t frame = 0;
+
+    for (auto _ : state) {
+        // A gentle banked climbing turn: every widget scrolls every frame
+        const float t = static_cast<float>(frame++) / 60.0f;
+        flight.updated_ns = flight.attitude_ns = flight.hud_ns = flight.position_ns = metricsNowNs();
+        flight.roll = 0.5f * std::sin(t * 0.7f);
+        flight.pitch = 0.2f * std::sin(t * 0.4f);
+        flight.yaw = t * 0.3f;
+        flight.groundspeed = 12.0f + 4.0f * std::sin(t);
+        flight.altitude_rel_m = 40.0f + 3.0f * t;
+
+        osd->beginFrame(fb_width, fb_height, 1.0f);
+        hud.draw(*osd, flight, flight.attitude_ns, 1000, fb_width, fb_height, config);
+        osd->endFrame();
+        glFinish();
+    }
+
+    hud.release(*osd);
+    osd->shutdown();
+}
+BENCHMARK(BM_OSDFlightHud)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+} // namespace bench
+} // namespace robot_vision
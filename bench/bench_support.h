@@ -0,0 +1,74 @@
+#pragma once
+
+/**
+ * @file bench_support.h
+ * @brief Shared fixtures for the microbenchmarks
+ *
+ * - TestPatternPlatform: the host platform, but capturing from videotestsrc
+ *   as fast as GStreamer can produce frames (no camera, no clock)
+ * - offscreenWindow(): one hidden GLFW window whose GL context every
+ *   rendering benchmark shares
+ */
+
+#include "core/platform.h"
+#include "core/window.h"
+
+#include <memory>
+#include <string>
+
+namespace robot_vision {
+namespace bench {
+
+/**
+ * Host platform with the camera replaced by an unthrottled test pattern
+ */
+class TestPatternPlatform : public IPlatform {
+public:
+    TestPatternPlatform() : host_(createPlatform()) {}
+
+    PlatformInfo getInfo() const override { return host_->getInfo(); }
+    std::string getName() const override { return host_->getName() + " (test pattern)"; }
+
+    std::string getCameraPipeline(int width, int height, int fps, const std::string&) const override {
+        // is-live=false (and the appsink's sync=false): frames are produced
+        // as fast as they are pulled, so the benchmark measures pull + copy
+        // rather than the frame clock
+        return
+            "videotestsrc is-live=false pattern=smpte ! "
+            "video/x-raw,format=RGB,width=" + std::to_string(width) +
+            ",height=" + std::to_string(height) +
+            ",framerate=" + std::to_string(fps) + "/1 ! "
+            "appsink name=sink";
+    }
+
+    std::string getDisplayPipeline() const override { return host_->getDisplayPipeline(); }
+    std::string getH264EncoderPipeline(int bitrate_kbps, int keyframe_interval) const override {
+        return host_->getH264EncoderPipeline(bitrate_kbps, keyframe_interval);
+    }
+    bool hasCamera() const override { return true; }
+    bool supportsResolution(int width, int height) const override { return true; }
+    GraphicsAPI getGraphicsAPI() const override { return host_->getGraphicsAPI(); }
+    void* createGraphicsContext() const override { return host_->createGraphicsContext(); }
+    void destroyGraphicsContext(void* context) const override { host_->destroyGraphicsContext(context); }
+
+private:
+    std::unique_ptr<IPlatform> host_;
+};
+
+/**
+ * Hidden window providing the GL context for rendering benchmarks
+ *
+ * Created on first use and kept for the whole run (GL context creation is
+ * far too slow to repeat per benchmark).
+ *
+ * @return nullptr if no display is available
+ */
+IWindow* offscreenWindow();
+
+/**
+ * Destroy the offscreen window (call once, after all benchmarks ran)
+ */
+void shutdownOffscreenWindow();
+
+} // namespace bench
+} // namespace robot_vision
@@ -0,0 +1,238 @@
+/**
+ * @file bench_video.cpp
+ * @brief Frame capture benchmarks: appsink pull, allocation and copy; frame processors; undistortion;
+ *        MJPEG decode
+ */
+
+#include "bench_support.h"
+#include "core/video_pipeline.h"
+#include "processing/basic_processors.h"
+#include "processing/lens_undistort.h"
+#include "processing/processor_graph.h"
+#include "snapshot/image_encoder.h"
+#include "video/mjpeg_decoder.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace robot_vision {
+namespace bench {
+
+namespace {
+
+void resolutionThreadArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"width", "height", "threads"});
+    for (int threads : {1, 2, 4}) {
+        b->Args({1280, 720, threads});
+        b->Args({1920, 1080, threads});
+    }
+}
+
+void resolutionArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"width", "height"});
+    b->Args({1280, 720});
+    b->Args({1920, 1080});
+    b->Args({3840, 2160});
+}
+
+} // namespace
+
+/**
+ * GStreamerPipeline::getLatestFrame() -> pullFrame(): appsink pull, buffer
+ * map, FrameData allocation and pixel copy, per new frame
+ *
+ * Includes videotestsrc producing the frame, which runs on its own
+ * streaming thread; compare with BM_FrameAllocCopy for the copy alone.
+ */
+static void BM_PullFrame(benchmark::State& state) {
+    TestPatternPlatform platform;
+    PipelineConfig config;
+    config.width = static_cast<int>(state.range(0));
+    config.height = static_cast<int>(state.range(1));
+    config.fps = 30;
+
+    auto pipeline = createVideoPipeline(platform);
+    if (!pipeline->initialize(config) || !pipeline->start()) {
+        state.SkipWithError("Test pattern pipeline failed to start");
+        return;
+    }
+
+    std::shared_ptr<FrameData> last;
+    for (auto _ : state) {
+        // getLatestFrame() returns the previous frame again if nothing new arrived
+        std::shared_ptr<FrameData> frame;
+        do {
+            frame = pipeline->getLatestFrame();
+        } while (!frame || frame == last);
+        last = frame;
+        benchmark::DoNotOptimize(frame->pixels.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            config.width * config.height * 3);
+    pipeline->stop();
+}
+BENCHMARK(BM_PullFrame)->Apply(resolutionArgs)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+/**
+ * The allocation + copy pullFrame() does for every frame, without GStreamer
+ */
+static void BM_FrameAllocCopy(benchmark::State& state) {
+    const int width = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+    const size_t size = static_cast<size_t>(width) * height * 3;
+    std::vector<uint8_t> mapped(size, 0x80);     // Stands in for the mapped GstBuffer
+
+    for (auto _ : state) {
+        auto frame = std::make_shared<FrameData>();
+        frame->width = width;
+        frame->height = height;
+        frame->pixels.resize(size);
+        std::memcpy(frame->pixels.data(), mapped.data(), size);
+        benchmark::DoNotOptimize(frame->pixels.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_FrameAllocCopy)->Apply(resolutionArgs)->Unit(benchmark::kMicrosecond);
+
+/**
+ * One 1080p frame through the built-in processors (luma thumbnail,
+ * sharpness, exposure, motion) on a pool of N threads
+ */
+static void BM_ProcessorGraph(benchmark::State& state) {
+    ProcessingConfig config;
+    config.threads = static_cast<int>(state.range(0));
+    ProcessorGraph graph(config);
+    for (const auto& name : parseProcessorList(config.processors)) {
+        graph.add(createFrameProcessor(name));
+    }
+    if (!graph.start()) {
+        state.SkipWithError(graph.getLastError().c_str());
+        return;
+    }
+
+    auto frame = std::make_shared<FrameData>();
+    frame->width = 1920;
+    frame->height = 1080;
+    frame->pixels.resize(frame->getPixelBufferSize());
+    for (size_t i = 0; i < frame->pixels.size(); ++i) {
+        frame->pixels[i] = static_cast<uint8_t>((i * 7) % 251);
+    }
+
+    for (auto _ : state) {
+        ++frame->frame_number;
+        graph.processFrame(frame);
+    }
+    graph.stop();
+}
+BENCHMARK(BM_ProcessorGraph)->ArgName("threads")->Arg(1)->Arg(2)->Arg(4)
+    ->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+/**
+ * LensUndistorter::apply() on a frame from a wide-angle lens (strong
+ * barrel distortion), bands spread over N threads; the remap table is
+ * built before timing starts
+ */
+static void BM_Undistort(benchmark::State& state) {
+    const int width = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+    UndistortConfig config;
+    config.enabled = true;
+    config.fx = 0.45f * static_cast<float>(width);
+    config.fy = config.fx;
+    config.k1 = -0.32f;
+    config.k2 = 0.11f;
+    config.k3 = -0.015f;
+    config.threads = static_cast<int>(state.range(2));
+    LensUndistorter undistorter(config, "background");
+    undistorter.start();
+
+    auto frame = std::make_shared<FrameData>();
+    frame->width = width;
+    frame->height = height;
+    frame->pixels.resize(frame->getPixelBufferSize());
+    for (size_t i = 0; i < frame->pixels.size(); ++i) {
+        frame->pixels[i] = static_cast<uint8_t>((i * 7) % 251);
+    }
+    undistorter.apply(frame);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(undistorter.apply(frame));
+    }
+    undistorter.stop();
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * width * height);
+    state.counters["fps"] = benchmark::Counter(static_cast<double>(state.iterations()),
+                                               benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Undistort)->Apply(resolutionThreadArgs)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+/**
+ * MjpegDecoder on N threads kept saturated (threads + 1 frames in flight),
+ * one in-order decoded frame per iteration; latency_ms is JPEG submitted to
+ * frame delivered, queueing included
+ *
+ * The JPEG is a quality-80 encode of a textured gradient, about the size
+ * a UVC camera sends for an indoor scene.
+ */
+static void BM_MjpegDecode(benchmark::State& state) {
+    if (!MjpegDecoder::isAvailable()) {
+        state.SkipWithError("built without libjpeg");
+        return;
+    }
+    const int width = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+
+    FrameData image;
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(image.getPixelBufferSize());
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            uint8_t* px = &image.pixels[(static_cast<size_t>(y) * width + x) * 3];
+            const int texture = ((x * 13) ^ (y * 7)) & 15;
+            px[0] = static_cast<uint8_t>((x * 255 / width + texture) & 255);
+            px[1] = static_cast<uint8_t>((y * 255 / height + texture) & 255);
+            px[2] = static_cast<uint8_t>(((x + y) & 127) + texture);
+        }
+    }
+    std::vector<uint8_t> jpeg;
+    std::string error;
+    if (!encodeImage(image, ImageFormat::JPEG, 80, jpeg, error)) {
+        state.SkipWithError(error.c_str());
+        return;
+    }
+
+    MjpegDecoder decoder(static_cast<int>(state.range(2)));
+    decoder.start();
+
+    uint64_t latency_ns = 0;
+    for (auto _ : state) {
+        while (decoder.inFlight() <= decoder.threads()) {
+            decoder.submit(jpeg.data(), jpeg.size(), 0, metricsNowNs());
+        }
+        auto frame = decoder.takeNext(std::chrono::seconds(1));
+        if (!frame) {
+            state.SkipWithError("decode timed out");
+            break;
+        }
+        latency_ns += metricsNowNs() - frame->capture_time_ns;
+    }
+    decoder.stop();
+
+    const double frames = static_cast<double>(state.iterations());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * width * height);
+    state.counters["fps"] = benchmark::Counter(frames, benchmark::Counter::kIsRate);
+    state.counters["latency_ms"] = frames > 0 ? static_cast<double>(latency_ns) / frames / 1e6 : 0.0;
+    state.counters["jpeg_kb"] = static_cast<double>(jpeg.size()) / 1024.0;
+}
+BENCHMARK(BM_MjpegDecode)->Apply(resolutionThreadArgs)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+} // namespace bench
+} // namespace robot_vision
@@ -0,0 +1,308 @@
+/**
+ * @file mock_detector.cpp
+ * @brief Detector protocol server used by the benchmarks
+ */
+
+#include "mock_detector.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace robot_vision {
+namespace bench {
+
+using namespace detector_protocol;
+
+namespace {
+
+// Longest the thread blocks before re-checking running_
+constexpr int POLL_SLICE_MS = 100;
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+const char* const LABELS[] = {"person", "car", "bicycle", "dog", "chair", "bottle"};
+
+bool recvAll(int fd, void* data, size_t size) {
+    auto* p = static_cast<uint8_t*>(data);
+    while (size > 0) {
+        ssize_t n = ::recv(fd, p, size, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+MockDetector::MockDetector(const MockDetectorConfig& config)
+    : config_(config)
+{
+}
+
+MockDetector::~MockDetector() {
+    stop();
+}
+
+bool MockDetector::start() {
+    if (running_) {
+        return true;
+    }
+
+    // Shared memory: the detector owns the segment, the client maps it
+    shm_fd_ = ::shm_open(config_.shm_name.c_str(), O_CREAT | O_RDWR, 0600);
+    if (shm_fd_ < 0 || ::ftruncate(shm_fd_, static_cast<off_t>(SHM_SIZE)) != 0) {
+        std::cerr << "  ERROR: Mock detector cannot create shm " << config_.shm_name
+                  << ": " << std::strerror(errno) << "\n";
+        stop();
+        return false;
+    }
+    shm_ptr_ = ::mmap(nullptr, SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_, 0);
+    if (shm_ptr_ == MAP_FAILED) {
+        shm_ptr_ = nullptr;
+        std::cerr << "  ERROR: Mock detector cannot map shm: " << std::strerror(errno) << "\n";
+        stop();
+        return false;
+    }
+
+    sockaddr_un addr{};
+    if (config_.socket_path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "  ERROR: Mock detector socket path too long\n";
+        stop();
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, config_.socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    ::unlink(config_.socket_path.c_str());
+
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0 ||
+        ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listen_fd_, 1) < 0) {
+        std::cerr << "  ERROR: Mock detector cannot listen on " << config_.socket_path
+                  << ": " << std::strerror(errno) << "\n";
+        stop();
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&MockDetector::serveLoop, this);
+    return true;
+}
+
+void MockDetector::stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    int client = client_fd_.exchange(-1);
+    if (client >= 0) {
+        ::close(client);
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        ::unlink(config_.socket_path.c_str());
+    }
+    if (shm_ptr_) {
+        ::munmap(shm_ptr_, SHM_SIZE);
+        shm_ptr_ = nullptr;
+    }
+    if (shm_fd_ >= 0) {
+        ::close(shm_fd_);
+        shm_fd_ = -1;
+        ::shm_unlink(config_.shm_name.c_str());
+    }
+}
+
+// ============================================================================
+// Results
+// ============================================================================
+
+void MockDetector::fillResult(DetectionResultMessage& msg, uint64_t frame_id,
+                              uint32_t num_detections, float inference_time_ms) {
+    if (num_detections > MAX_DETECTIONS) {
+        num_detections = MAX_DETECTIONS;
+    }
+
+    msg.type = MessageType::DETECTION_RESULT;
+    msg.frame_id = frame_id;
+    msg.inference_time_ms = inference_time_ms;
+    msg.num_detections = num_detections;
+
+    // Deterministic grid of boxes so every run draws the same thing
+    const uint32_t cols = 10;
+    for (uint32_t i = 0; i < num_detections; ++i) {
+        Detection& det = msg.detections[i];
+        std::memset(&det, 0, sizeof(det));
+        det.x = 0.02f + 0.095f * static_cast<float>(i % cols);
+        det.y = 0.05f + 0.09f * static_cast<float>((i / cols) % cols);
+        det.width = 0.08f;
+        det.height = 0.07f;
+        det.confidence = 0.3f + 0.07f * static_cast<float>(i % 10);
+        std::snprintf(det.label, sizeof(det.label), "%s",
+                      LABELS[i % (sizeof(LABELS) / sizeof(LABELS[0]))]);
+    }
+}
+
+bool MockDetector::sendResult(uint64_t frame_id, uint32_t num_detections) {
+    int fd = client_fd_.load();
+    if (fd < 0) {
+        return false;
+    }
+    DetectionResultMessage msg;
+    fillResult(msg, frame_id, num_detections, static_cast<float>(config_.inference_ms));
+    return sendAll(fd, &msg, sizeof(msg));
+}
+
+bool MockDetector::sendAll(int fd, const void* data, size_t size) {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    const auto* p = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t n = ::send(fd, p, size, SEND_FLAGS);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// ============================================================================
+// Thread
+// ============================================================================
+
+void MockDetector::serveLoop() {
+#ifdef PLATFORM_MACOS
+    pthread_setname_np("rv-mock-det");
+#else
+    pthread_setname_np(pthread_self(), "rv-mock-det");
+#endif
+
+    while (running_.load(std::memory_order_relaxed)) {
+        int client = client_fd_.load();
+        int fd = client >= 0 ? client : listen_fd_;
+
+        pollfd pfd{fd, POLLIN, 0};
+        if (::poll(&pfd, 1, POLL_SLICE_MS) <= 0) {
+            continue;
+        }
+
+        if (client < 0) {
+            // One client at a time, like the real service
+            int accepted = ::accept(listen_fd_, nullptr, nullptr);
+            if (accepted >= 0) {
+                client_fd_.store(accepted);
+            }
+            continue;
+        }
+
+        if (!handleMessage(client)) {
+            // Client went away (or said SHUTDOWN) - wait for the next one
+            client_fd_.store(-1);
+            ::close(client);
+        }
+    }
+}
+
+bool MockDetector::handleMessage(int fd) {
+    uint8_t type_byte = 0;
+    if (::recv(fd, &type_byte, 1, MSG_PEEK) <= 0) {
+        return false;
+    }
+
+    switch (static_cast<MessageType>(type_byte)) {
+        case MessageType::HANDSHAKE_REQUEST: {
+            HandshakeRequest request;
+            if (!recvAll(fd, &request, sizeof(request))) {
+                return false;
+            }
+            HandshakeResponse response;
+            std::memset(&response, 0, sizeof(response));
+            response.type = MessageType::HANDSHAKE_RESPONSE;
+            response.protocol_version = PROTOCOL_VERSION;
+            response.accepted = request.protocol_version == PROTOCOL_VERSION;
+            std::snprintf(response.model_info.name, sizeof(response.model_info.name), "mock");
+            std::snprintf(response.model_info.description, sizeof(response.model_info.description),
+                          "Benchmark stand-in (no inference)");
+            std::snprintf(response.model_info.device, sizeof(response.model_info.device), "none");
+            response.model_info.input_width = MAX_FRAME_WIDTH;
+            response.model_info.input_height = MAX_FRAME_HEIGHT;
+            response.model_info.num_classes = sizeof(LABELS) / sizeof(LABELS[0]);
+            return sendAll(fd, &response, sizeof(response));
+        }
+
+        case MessageType::FRAME_READY: {
+            FrameReadyMessage msg;
+            if (!recvAll(fd, &msg, sizeof(msg))) {
+                return false;
+            }
+            frames_received_.fetch_add(1);
+
+            if (config_.auto_reply) {
+                // Touch the frame like a real detector would before inferring
+                volatile uint8_t sink = static_cast<const uint8_t*>(shm_ptr_)[sizeof(FrameHeader)];
+                (void)sink;
+                if (config_.inference_ms > 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(config_.inference_ms));
+                }
+                DetectionResultMessage result;
+                fillResult(result, msg.frame_id, config_.num_detections,
+                           static_cast<float>(config_.inference_ms));
+                return sendAll(fd, &result, sizeof(result));
+            }
+            return true;
+        }
+
+        case MessageType::HEARTBEAT: {
+            HeartbeatMessage msg;
+            if (!recvAll(fd, &msg, sizeof(msg))) {
+                return false;
+            }
+            return sendAll(fd, &msg, sizeof(msg));
+        }
+
+        case MessageType::SHUTDOWN: {
+            HeartbeatMessage msg;
+            recvAll(fd, &msg, sizeof(msg));
+            return false;
+        }
+
+        default: {
+            char discard[256];
+            return ::recv(fd, discard, sizeof(discard), 0) > 0;
+        }
+    }
+}
+
+} // namespace bench
+} // namespace robot_vision
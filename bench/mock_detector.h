@@ -0,0 +1,105 @@
+#pragma once
+
+/**
+ * @file mock_detector.h
+ * @brief In-process stand-in for the vision-detector service
+ *
+ * Speaks the detector protocol (handshake, FRAME_READY, DETECTION_RESULT,
+ * heartbeat) over its own socket and shared memory segment, so benchmarks
+ * can drive the real DetectionClientImpl without a model or a GPU.
+ *
+ * TEACHING: Mock the Peer, Not the Client
+ * ---------------------------------------
+ * Replacing IDetectionClient with a fake would skip exactly the code we
+ * want to measure: the shm memcpy, the socket syscalls, the result copy.
+ * Faking the OTHER end of the socket keeps all of that real.
+ */
+
+#include <detector_protocol/protocol.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace robot_vision {
+namespace bench {
+
+/**
+ * Mock detector configuration
+ */
+struct MockDetectorConfig {
+    std::string socket_path = "/tmp/rv_mock_detector.sock";
+    std::string shm_name = "/rv_mock_frames";
+    bool auto_reply = true;             // Answer every FRAME_READY with a result
+    uint32_t num_detections = 5;        // Boxes per auto reply
+    int inference_ms = 0;               // Simulated inference time per frame
+};
+
+/**
+ * Single-client detector server running on its own thread
+ */
+class MockDetector {
+public:
+    explicit MockDetector(const MockDetectorConfig& config);
+    ~MockDetector();
+
+    // Non-copyable (owns a socket, a shm segment and a thread)
+    MockDetector(const MockDetector&) = delete;
+    MockDetector& operator=(const MockDetector&) = delete;
+
+    /**
+     * Create the shm segment, bind the socket and start serving
+     *
+     * @return false if the socket or shm could not be created
+     */
+    bool start();
+
+    /**
+     * Stop serving and remove the socket and shm segment (idempotent)
+     */
+    void stop();
+
+    /**
+     * Send a result for frame_id to the connected client
+     *
+     * Used with auto_reply = false to control exactly when results arrive.
+     *
+     * @return false if no client is connected
+     */
+    bool sendResult(uint64_t frame_id, uint32_t num_detections);
+
+    /**
+     * FRAME_READY messages received so far
+     */
+    uint64_t framesReceived() const { return frames_received_.load(); }
+
+    /**
+     * Fill a result message with num_detections plausible boxes
+     */
+    static void fillResult(detector_protocol::DetectionResultMessage& msg,
+                           uint64_t frame_id, uint32_t num_detections,
+                           float inference_time_ms);
+
+private:
+    void serveLoop();
+    bool handleMessage(int fd);
+    bool sendAll(int fd, const void* data, size_t size);
+
+    MockDetectorConfig config_;
+
+    int listen_fd_ = -1;
+    int shm_fd_ = -1;
+    void* shm_ptr_ = nullptr;
+
+    std::atomic<int> client_fd_{-1};
+    std::mutex send_mutex_;             // Auto replies vs sendResult()
+    std::atomic<uint64_t> frames_received_{0};
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+} // namespace bench
+} // namespace robot_vision
@@ -0,0 +1,200 @@
+/**
+ * @file replay_main.cpp
+ * @brief End-to-end replay harness: real app, recorded clip, mock detector
+ *
+ * Runs the actual robot_vision binary (all stages, real render loop) on a
+ * hidden window, fed from a video file instead of a camera and talking to
+ * an in-process MockDetector instead of the vision-detector service. The
+ * app stops after a fixed number of frames and writes its run report.
+ *
+ *   ./build/rv_replay --clip=clips/drive.mp4 --frames=900 \
+ *                     --inference-ms=30 --boxes=10 --report=replay.json
+ *   ./build/rv_replay --clip=test --max-speed     # no clip: test pattern
+ *
+ * Anything after "--" is passed to robot_vision unchanged, e.g.
+ *   ./build/rv_replay --clip=a.mp4 -- --stages.detection_rate_hz=5
+ *
+ * TEACHING: Same Inputs, Comparable Outputs
+ * -----------------------------------------
+ * A live camera gives different frames, lighting and timing every run, and
+ * a real detector's speed depends on the model and GPU. Replaying the same
+ * clip against a detector with a FIXED inference time removes both, so a
+ * change in the report between two commits is a change in our code.
+ */
+
+#include "mock_detector.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace robot_vision::bench;
+
+namespace {
+
+struct ReplayOptions {
+    std::string app = RV_APP_PATH;      // robot_vision binary
+    std::string clip = "test";          // Video file ("test" = built-in pattern)
+    uint64_t frames = 600;
+    int width = 1280;
+    int height = 720;
+    int fps = 30;
+    bool max_speed = false;             // Decode as fast as possible instead of at fps
+    int inference_ms = 30;              // Mock detector latency
+    uint32_t boxes = 10;                // Detections per result
+    std::string report = "replay_report.json";
+    std::string label = "";
+    std::vector<std::string> app_args;  // After "--"
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options] [-- robot_vision options]\n"
+              << "  --clip=PATH          Video file to replay, or \"test\" (default)\n"
+              << "  --frames=N           Frames to show before stopping (default 600)\n"
+              << "  --width=W --height=H --fps=F   Frame format fed to the app (1280x720@30)\n"
+              << "  --max-speed          Decode the clip as fast as possible\n"
+              << "  --inference-ms=MS    Mock detector inference time (default 30)\n"
+              << "  --boxes=N            Detections per mock result (default 10)\n"
+              << "  --report=PATH        Run report JSON (default replay_report.json)\n"
+              << "  --label=TEXT         Tag stored in the report (e.g. git commit)\n"
+              << "  --app=PATH           robot_vision binary to run\n";
+}
+
+bool parseArgs(int argc, char* argv[], ReplayOptions& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* prefix) -> const char* {
+            size_t n = std::char_traits<char>::length(prefix);
+            return arg.compare(0, n, prefix) == 0 ? argv[i] + n : nullptr;
+        };
+
+        if (arg == "--") {
+            for (++i; i < argc; ++i) {
+                opts.app_args.push_back(argv[i]);
+            }
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return false;
+        } else if (arg == "--max-speed") {
+            opts.max_speed = true;
+        } else if (const char* v = value("--clip=")) {
+            opts.clip = v;
+        } else if (const char* v = value("--frames=")) {
+            opts.frames = std::strtoull(v, nullptr, 10);
+        } else if (const char* v = value("--width=")) {
+            opts.width = std::atoi(v);
+        } else if (const char* v = value("--height=")) {
+            opts.height = std::atoi(v);
+        } else if (const char* v = value("--fps=")) {
+            opts.fps = std::atoi(v);
+        } else if (const char* v = value("--inference-ms=")) {
+            opts.inference_ms = std::atoi(v);
+        } else if (const char* v = value("--boxes=")) {
+            opts.boxes = static_cast<uint32_t>(std::atoi(v));
+        } else if (const char* v = value("--report=")) {
+            opts.report = v;
+        } else if (const char* v = value("--label=")) {
+            opts.label = v;
+        } else if (const char* v = value("--app=")) {
+            opts.app = v;
+        } else {
+            std::cerr << "ERROR: Unknown option " << arg << "\n";
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+
+    if (opts.frames == 0 || opts.inference_ms < 0) {
+        std::cerr << "ERROR: --frames must be positive and --inference-ms non-negative\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ReplayOptions opts;
+    if (!parseArgs(argc, argv, opts)) {
+        return 1;
+    }
+
+    // Private socket/shm so a real detector on this machine is untouched
+    MockDetectorConfig mock_config;
+    std::string suffix = std::to_string(::getpid());
+    mock_config.socket_path = "/tmp/rv_replay_detector_" + suffix + ".sock";
+    mock_config.shm_name = "/rv_replay_frames_" + suffix;
+    mock_config.auto_reply = true;
+    mock_config.num_detections = opts.boxes;
+    mock_config.inference_ms = opts.inference_ms;
+
+    MockDetector mock(mock_config);
+    if (!mock.start()) {
+        return 1;
+    }
+
+    std::vector<std::string> args = {
+        opts.app,
+        "--pipeline.source=" + opts.clip,
+        "--pipeline.loop=true",
+        std::string("--pipeline.realtime=") + (opts.max_speed ? "false" : "true"),
+        "--pipeline.width=" + std::to_string(opts.width),
+        "--pipeline.height=" + std::to_string(opts.height),
+        "--pipeline.fps=" + std::to_string(opts.fps),
+        "--window.visible=false",
+        "--window.vsync=false",
+        "--detection.socket_path=" + mock_config.socket_path,
+        "--detection.shm_name=" + mock_config.shm_name,
+        "--run.max_frames=" + std::to_string(opts.frames),
+        "--run.report_path=" + opts.report,
+        "--run.label=" + opts.label,
+    };
+    args.insert(args.end(), opts.app_args.begin(), opts.app_args.end());
+
+    std::cout << "  Replay: " << opts.clip << ", " << opts.frames << " frames, mock detector "
+              << opts.inference_ms << " ms / " << opts.boxes << " boxes\n";
+
+    std::remove(opts.report.c_str());   // Never mistake an old report for this run's
+
+    pid_t child = ::fork();
+    if (child < 0) {
+        std::cerr << "ERROR: fork failed\n";
+        return 1;
+    }
+    if (child == 0) {
+        std::vector<char*> argv_child;
+        for (auto& a : args) {
+            argv_child.push_back(&a[0]);
+        }
+        argv_child.push_back(nullptr);
+        ::execv(opts.app.c_str(), argv_child.data());
+        std::cerr << "ERROR: Cannot run " << opts.app << "\n";
+        ::_exit(127);
+    }
+
+    int status = 0;
+    while (::waitpid(child, &status, 0) < 0 && errno == EINTR) {
+    }
+    mock.stop();
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << "ERROR: robot_vision did not exit cleanly (status " << status << ")\n";
+        return 1;
+    }
+
+    std::cout << "\n  Detector saw " << mock.framesReceived() << " frames\n";
+    std::ifstream report(opts.report);
+    if (!report) {
+        std::cerr << "ERROR: No run report at " << opts.report << "\n";
+        return 1;
+    }
+    std::cout << "  Report: " << opts.report << "\n";
+    return 0;
+}
@@ -0,0 +1,924 @@
+/**
+ * @file app_config.cpp
+ * @brief Configuration table, sources and validation
+ */
+
+#include "app_config.h"
+#include "processing/basic_processors.h"
+#include "util/logger.h"
+
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef HAS_JSON
+#include <nlohmann/json.hpp>
+#endif
+
+namespace robot_vision {
+
+namespace {
+
+// ============================================================================
+// Setting Table
+// ============================================================================
+
+enum class FieldType {
+    Int,
+    UInt64,
+    Size,
+    Float,
+    Bool,
+    String,
+    Policy
+};
+
+/**
+ * Description of one setting
+ *
+ * locate() returns the address of the member inside an AppConfig, so the
+ * same entry can read, write and compare the field generically.
+ */
+struct Field {
+    const char* key;
+    FieldType type;
+    bool live;                          // Can change on reload without restart
+    void* (*locate)(AppConfig&);
+    const char* help;
+};
+
+#define RV_FIELD(key, type, live, member, help) \
+    { key, FieldType::type, live, [](AppConfig& c) -> void* { return &c.member; }, help }
+
+const Field FIELDS[] = {
+    RV_FIELD("pipeline.width", Int, false, pipeline.width, "Capture width"),
+    RV_FIELD("pipeline.height", Int, false, pipeline.height, "Capture height"),
+    RV_FIELD("pipeline.fps", Int, false, pipeline.fps, "Capture frame rate"),
+    RV_FIELD("pipeline.device", String, false, pipeline.device,
+             "Camera device (empty = auto; Linux: /dev/videoN or part of its name)"),
+    RV_FIELD("pipeline.source", String, false, pipeline.source,
+             "Frame source: empty = camera, test, or a video file"),
+    RV_FIELD("pipeline.loop", Bool, false, pipeline.loop, "Restart a video file at the end"),
+    RV_FIELD("pipeline.realtime", Bool, false, pipeline.realtime,
+             "Play a video file at fps (false = as fast as decoded)"),
+    RV_FIELD("pipeline.decode_threads", Int, false, pipeline.decode_threads,
+             "Threads decoding camera MJPEG (0 = auto)"),
+
+    RV_FIELD("window.width", Int, false, window.width, "Initial window width"),
+    RV_FIELD("window.height", Int, false, window.height, "Initial window height"),
+    RV_FIELD("window.title", String, false, window.title, "Window title"),
+    RV_FIELD("window.resizable", Bool, false, window.resizable, "Allow window resizing"),
+    RV_FIELD("window.vsync", Bool, false, window.vsync, "Vertical sync"),
+    RV_FIELD("window.visible", Bool, false, window.visible, "Show the window (false = offscreen)"),
+
+    RV_FIELD("osd.font_path", String, false, osd.font_path, "Regular TTF font"),
+    RV_FIELD("osd.font_bold_path", String, false, osd.font_bold_path, "Bold TTF font"),
+    RV_FIELD("osd.default_font_size", Float, false, osd.default_font_size, "Default font size (px)"),
+
+    RV_FIELD("osd_layout.label_font_scale", Float, true, osd_layout.label_font_scale,
+             "Detection label size (fraction of height)"),
+    RV_FIELD("osd_layout.status_font_scale", Float, true, osd_layout.status_font_scale,
+             "Status text size (fraction of height)"),
+    RV_FIELD("osd_layout.padding_scale", Float, true, osd_layout.padding_scale,
+             "Text background padding (fraction of height)"),
+    RV_FIELD("osd_layout.box_line_scale", Float, true, osd_layout.box_line_scale,
+             "Bounding box stroke (fraction of height)"),
+    RV_FIELD("osd_layout.status_margin_scale", Float, true, osd_layout.status_margin_scale,
+             "Screen edge margin (fraction of height)"),
+
+    RV_FIELD("detection.socket_path", String, false, detection.socket_path, "Detector Unix socket"),
+    RV_FIELD("detection.shm_name", String, false, detection.shm_name, "Detector shared memory name"),
+    RV_FIELD("detection.connect_timeout_ms", Int, false, detection.connect_timeout_ms,
+             "Connect timeout"),
+    RV_FIELD("detection.auto_reconnect", Bool, false, detection.auto_reconnect, "Reconnect on loss"),
+
+    RV_FIELD("stages.render_queue.depth", Size, false, stages.render_queue.depth, "Render queue depth"),
+    RV_FIELD("stages.render_queue.policy", Policy, false, stages.render_queue.policy,
+             "drop_oldest | drop_newest | block"),
+    RV_FIELD("stages.detect_queue.depth", Size, false, stages.detect_queue.depth, "Detect queue depth"),
+    RV_FIELD("stages.detect_queue.policy", Policy, false, stages.detect_queue.policy,
+             "drop_oldest | drop_newest | block"),
+    RV_FIELD("stages.result_queue.depth", Size, false, stages.result_queue.depth, "Result queue depth"),
+    RV_FIELD("stages.result_queue.policy", Policy, false, stages.result_queue.policy,
+             "drop_oldest | drop_newest | block"),
+    RV_FIELD("stages.record_queue.depth", Size, false, stages.record_queue.depth, "Record queue depth"),
+    RV_FIELD("stages.record_queue.policy", Policy, false, stages.record_queue.policy,
+             "drop_oldest | drop_newest | block"),
+    RV_FIELD("stages.enable_detection", Bool, false, stages.enable_detection, "Run detection stages"),
+    RV_FIELD("stages.detection_rate_hz", Int, true, stages.detection_rate_hz,
+             "Max frames/s sent to detector"),
+    RV_FIELD("stages.heartbeat_interval_ms", Int, false, stages.heartbeat_interval_ms,
+             "Detector heartbeat period"),
+    RV_FIELD("stages.reconnect_interval_ms", Int, false, stages.reconnect_interval_ms,
+             "Detector reconnect period"),
+
+    RV_FIELD("metrics.listen", String, false, metrics.listen,
+             "Prometheus endpoint: [host:]port or unix:/path"),
+    RV_FIELD("metrics.snapshot_path", String, false, metrics.snapshot_path,
+             "Periodic JSON snapshot file"),
+    RV_FIELD("metrics.snapshot_interval_s", Int, false, metrics.snapshot_interval_s,
+             "JSON snapshot period"),
+
+    RV_FIELD("trace.enabled", Bool, false, trace.enabled, "Record frame timeline spans"),
+    RV_FIELD("trace.ring_events", Size, false, trace.ring_events, "Spans kept per thread"),
+    RV_FIELD("trace.output_path", String, false, trace.output_path,
+             "Chrome trace JSON (dump: SIGUSR1 or T key)"),
+    RV_FIELD("trace.dump_on_exit", Bool, false, trace.dump_on_exit, "Write a trace at shutdown"),
+
+    RV_FIELD("log.level", String, true, log.level, "trace | debug | info | warn | error | off"),
+    RV_FIELD("log.format", String, false, log.format, "text | json | plain"),
+    RV_FIELD("log.file", String, false, log.file, "Log file (empty = stdout/stderr)"),
+    RV_FIELD("log.rate_limit_per_s", Int, false, log.rate_limit_per_s,
+             "Lines per call site per second (0 = unlimited)"),
+    RV_FIELD("log.ring_slots", Size, false, log.ring_slots, "Per-thread log staging slots"),
+
+    RV_FIELD("snapshot.enabled", Bool, false, snapshot.enabled, "Snapshot writer (S key, rules)"),
+    RV_FIELD("snapshot.directory", String, false, snapshot.directory, "Snapshot output directory"),
+    RV_FIELD("snapshot.format", String, false, snapshot.format, "jpeg | png | ppm"),
+    RV_FIELD("snapshot.jpeg_quality", Int, false, snapshot.jpeg_quality, "JPEG quality 1..100"),
+    RV_FIELD("snapshot.workers", Int, false, snapshot.workers, "Encoder threads"),
+    RV_FIELD("snapshot.queue_depth", Size, false, snapshot.queue_depth,
+             "Pending snapshots (oldest dropped)"),
+    RV_FIELD("snapshot.composited", Bool, false, snapshot.composited,
+             "Key snapshots include the OSD"),
+    RV_FIELD("snapshot.interval_s", Int, false, snapshot.interval_s,
+             "Periodic snapshot (0 = off)"),
+    RV_FIELD("snapshot.trigger_label", String, false, snapshot.trigger_label,
+             "Snapshot on this detection label (* = any)"),
+    RV_FIELD("snapshot.trigger_confidence", Float, false, snapshot.trigger_confidence,
+             "Minimum confidence for the trigger"),
+    RV_FIELD("snapshot.trigger_cooldown_ms", Int, false, snapshot.trigger_cooldown_ms,
+             "Minimum gap between detection snapshots"),
+
+    RV_FIELD("recording.enabled", Bool, false, recording.enabled,
+             "Pre-roll event recording (encodes continuously)"),
+    RV_FIELD("recording.directory", String, false, recording.directory, "Event clip directory"),
+    RV_FIELD("recording.preroll_s", Int, false, recording.preroll_s, "Seconds kept before a trigger"),
+    RV_FIELD("recording.postroll_s", Int, false, recording.postroll_s,
+             "Seconds recorded after the last trigger"),
+    RV_FIELD("recording.max_buffer_bytes", Size, false, recording.max_buffer_bytes,
+             "Pre-roll ring size cap"),
+    RV_FIELD("recording.bitrate_kbps", Int, false, recording.bitrate_kbps, "H.264 bitrate"),
+    RV_FIELD("recording.keyframe_interval", Int, false, recording.keyframe_interval,
+             "Frames per GOP (pre-roll granularity)"),
+    RV_FIELD("recording.trigger_label", String, false, recording.trigger_label,
+             "Detection label that triggers (* = any)"),
+    RV_FIELD("recording.trigger_confidence", Float, false, recording.trigger_confidence,
+             "Minimum confidence to count"),
+    RV_FIELD("recording.trigger_count", Int, false, recording.trigger_count,
+             "Matching detections needed in one result"),
+
+    RV_FIELD("detection_log.enabled", Bool, false, detection_log.enabled,
+             "Binary detection log (query with rv_detlog)"),
+    RV_FIELD("detection_log.directory", String, false, detection_log.directory,
+             "Detection log directory"),
+    RV_FIELD("detection_log.queue_depth", Size, false, detection_log.queue_depth,
+             "Result sets buffered between flushes"),
+    RV_FIELD("detection_log.flush_interval_ms", Int, false, detection_log.flush_interval_ms,
+             "Batch append period"),
+    RV_FIELD("detection_log.index_interval_ms", Int, false, detection_log.index_interval_ms,
+             "Time covered by one index entry"),
+
+    RV_FIELD("governor.enabled", Bool, false, governor.enabled,
+             "Step down quality under heat or load"),
+    RV_FIELD("governor.sysfs_root", String, false, governor.sysfs_root,
+             "Thermal zones under ROOT/class/thermal"),
+    RV_FIELD("governor.procfs_root", String, false, governor.procfs_root, "CPU load from ROOT/stat"),
+    RV_FIELD("governor.thermal_zones", String, false, governor.thermal_zones,
+             "Only zones whose type contains this"),
+    RV_FIELD("governor.interval_ms", Int, false, governor.interval_ms, "Sampling period"),
+    RV_FIELD("governor.temp_high_c", Float, false, governor.temp_high_c, "Step down at or above"),
+    RV_FIELD("governor.temp_low_c", Float, false, governor.temp_low_c, "Step up at or below"),
+    RV_FIELD("governor.temp_critical_c", Float, false, governor.temp_critical_c,
+             "Jump to the cheapest point"),
+    RV_FIELD("governor.cpu_high_percent", Float, false, governor.cpu_high_percent,
+             "System CPU step-down threshold"),
+    RV_FIELD("governor.cpu_low_percent", Float, false, governor.cpu_low_percent,
+             "System CPU step-up threshold"),
+    RV_FIELD("governor.stage_busy_high", Float, false, governor.stage_busy_high,
+             "Busiest stage step-down fraction"),
+    RV_FIELD("governor.stage_busy_low", Float, false, governor.stage_busy_low,
+             "Busiest stage step-up fraction"),
+    RV_FIELD("governor.step_down_samples", Int, false, governor.step_down_samples,
+             "Hot samples before stepping down"),
+    RV_FIELD("governor.step_up_samples", Int, false, governor.step_up_samples,
+             "Calm samples before stepping up"),
+    RV_FIELD("governor.ladder", String, false, governor.ladder,
+             "det_hz/det_width/display_hz/capture_width;... (0 = configured)"),
+
+    RV_FIELD("stream.enabled", Bool, false, stream.enabled, "RTP/UDP H.264 stream to a ground station"),
+    RV_FIELD("stream.host", String, false, stream.host, "Receiver address"),
+    RV_FIELD("stream.port", Int, false, stream.port, "Receiver UDP port"),
+    RV_FIELD("stream.source", String, false, stream.source,
+             "raw (camera) | composited (video + OSD, window only)"),
+    RV_FIELD("stream.width", Int, false, stream.width, "Stream width (0 = capture width)"),
+    RV_FIELD("stream.height", Int, false, stream.height, "Stream height (0 = capture height)"),
+    RV_FIELD("stream.fps", Int, false, stream.fps, "Stream frame rate"),
+    RV_FIELD("stream.bitrate_kbps", Int, false, stream.bitrate_kbps, "H.264 bitrate"),
+    RV_FIELD("stream.keyframe_interval", Int, false, stream.keyframe_interval,
+             "Frames per GOP (recovery after packet loss)"),
+    RV_FIELD("stream.mtu", Int, false, stream.mtu, "RTP packet payload size"),
+
+    RV_FIELD("mjpeg.enabled", Bool, false, mjpeg.enabled, "MJPEG-over-HTTP preview for browsers"),
+    RV_FIELD("mjpeg.listen", String, false, mjpeg.listen, "[host:]port (0.0.0.0:PORT for other machines)"),
+    RV_FIELD("mjpeg.fps", Int, false, mjpeg.fps, "Encoded frames per second while clients watch"),
+    RV_FIELD("mjpeg.width", Int, false, mjpeg.width, "Encoded width, aspect kept (0 = capture width)"),
+    RV_FIELD("mjpeg.jpeg_quality", Int, false, mjpeg.jpeg_quality, "JPEG quality 1-100"),
+    RV_FIELD("mjpeg.max_clients", Int, false, mjpeg.max_clients, "Concurrent viewers"),
+    RV_FIELD("mjpeg.client_timeout_ms", Int, false, mjpeg.client_timeout_ms,
+             "Drop a viewer whose socket made no progress this long"),
+
+    RV_FIELD("framebus.enabled", Bool, false, framebus.enabled, "Publish frames to local processes via shared memory"),
+    RV_FIELD("framebus.shm_name", String, false, framebus.shm_name, "POSIX shared memory name (/name)"),
+    RV_FIELD("framebus.socket_path", String, false, framebus.socket_path, "Control socket readers connect to"),
+    RV_FIELD("framebus.slots", Int, false, framebus.slots, "Ring slots (frames readers may hold + 1)"),
+    RV_FIELD("framebus.max_width", Int, false, framebus.max_width, "Largest frame width a slot holds"),
+    RV_FIELD("framebus.max_height", Int, false, framebus.max_height, "Largest frame height a slot holds"),
+    RV_FIELD("framebus.max_readers", Int, false, framebus.max_readers, "Concurrent reader processes (max 63)"),
+
+    RV_FIELD("telemetry.enabled", Bool, false, telemetry.enabled, "Receive MAVLink telemetry for the OSD"),
+    RV_FIELD("telemetry.listen", String, false, telemetry.listen, "[host:]port for MAVLink UDP"),
+    RV_FIELD("telemetry.sysid", Int, false, telemetry.sysid, "Vehicle system id (0 = first heard)"),
+    RV_FIELD("telemetry.stale_ms", Int, true, telemetry.stale_ms, "Show the link as lost after this long"),
+
+    RV_FIELD("hud.enabled", Bool, true, hud.enabled, "Draw the flight HUD (needs telemetry)"),
+    RV_FIELD("hud.size_scale", Float, true, hud.size_scale, "HUD height (fraction of framebuffer height)"),
+    RV_FIELD("hud.opacity", Float, true, hud.opacity, "HUD opacity 0..1"),
+
+    RV_FIELD("processing.enabled", Bool, false, processing.enabled, "Run frame analysis processors"),
+    RV_FIELD("processing.processors", String, false, processing.processors,
+             "Comma-separated: sharpness, exposure, motion"),
+    RV_FIELD("processing.threads", Int, false, processing.threads, "Processor pool threads"),
+    RV_FIELD("processing.rate_hz", Int, false, processing.rate_hz, "Frames analysed per second (0 = all)"),
+    RV_FIELD("processing.thumb_width", Int, false, processing.thumb_width, "Shared luma thumbnail width"),
+
+    RV_FIELD("undistort.enabled", Bool, false, undistort.enabled, "Correct lens distortion"),
+    RV_FIELD("undistort.apply_to", String, false, undistort.apply_to,
+             "CPU: all (display, recording, detector), detection (detector input only) or none"),
+    RV_FIELD("undistort.gpu_display", Bool, false, undistort.gpu_display,
+             "Undistort the displayed video in the shader (no CPU cost)"),
+    RV_FIELD("undistort.calib_width", Int, false, undistort.calib_width,
+             "Resolution the intrinsics were calibrated at (0 = capture size)"),
+    RV_FIELD("undistort.calib_height", Int, false, undistort.calib_height, "Calibration height"),
+    RV_FIELD("undistort.fx", Float, false, undistort.fx, "Focal length x (pixels)"),
+    RV_FIELD("undistort.fy", Float, false, undistort.fy, "Focal length y (pixels)"),
+    RV_FIELD("undistort.cx", Float, false, undistort.cx, "Principal point x (pixels, 0 = centre)"),
+    RV_FIELD("undistort.cy", Float, false, undistort.cy, "Principal point y (pixels, 0 = centre)"),
+    RV_FIELD("undistort.k1", Float, false, undistort.k1, "Radial distortion k1"),
+    RV_FIELD("undistort.k2", Float, false, undistort.k2, "Radial distortion k2"),
+    RV_FIELD("undistort.k3", Float, false, undistort.k3, "Radial distortion k3"),
+    RV_FIELD("undistort.p1", Float, false, undistort.p1, "Tangential distortion p1"),
+    RV_FIELD("undistort.p2", Float, false, undistort.p2, "Tangential distortion p2"),
+    RV_FIELD("undistort.zoom", Float, false, undistort.zoom, "Output focal length / fx (< 1 keeps more of the field of view)"),
+    RV_FIELD("undistort.threads", Int, false, undistort.threads, "Threads per frame (including the stage thread)"),
+
+    RV_FIELD("stabilize.enabled", Bool, false, stabilize.enabled, "Stabilise the displayed video from telemetry attitude"),
+    RV_FIELD("stabilize.smoothing_ms", Float, false, stabilize.smoothing_ms, "Time constant of the smoothed camera path"),
+    RV_FIELD("stabilize.max_angle_deg", Float, false, stabilize.max_angle_deg,
+             "Largest correction per axis (bigger moves are followed)"),
+    RV_FIELD("stabilize.crop", Float, false, stabilize.crop, "Fraction of the frame shown (room for the correction)"),
+    RV_FIELD("stabilize.hfov_deg", Float, false, stabilize.hfov_deg,
+             "Horizontal field of view (when the display is not undistorted)"),
+    RV_FIELD("stabilize.camera_tilt_deg", Float, false, stabilize.camera_tilt_deg,
+             "Camera uptilt relative to the airframe"),
+
+    RV_FIELD("threads.render", String, false, threads.render,
+             "Main thread: cpus=LIST sched=other|fifo|rr priority=1..99 nice=N"),
+    RV_FIELD("threads.capture", String, false, threads.capture, "Capture stage thread policy"),
+    RV_FIELD("threads.detect", String, false, threads.detect, "Detector submit/ingest thread policy"),
+    RV_FIELD("threads.record", String, false, threads.record, "Record stage thread policy"),
+    RV_FIELD("threads.gst", String, false, threads.gst, "GStreamer streaming thread policy"),
+    RV_FIELD("threads.background", String, false, threads.background,
+             "Logger, writers, metrics and governor thread policy"),
+
+    RV_FIELD("headless.enabled", Bool, false, headless, "Run without a window"),
+    RV_FIELD("headless.loop_rate_hz", Int, false, headless_config.loop_rate_hz, "Headless loop rate"),
+    RV_FIELD("headless.cpu_budget_percent", Float, true, headless_config.cpu_budget_percent,
+             "CPU cap, % of one core (0 = off)"),
+    RV_FIELD("headless.status_interval_s", Int, true, headless_config.status_interval_s,
+             "Status line period (0 = off)"),
+    RV_FIELD("headless.max_frames", UInt64, false, headless_config.max_frames,
+             "Exit after N frames (0 = never)"),
+
+    RV_FIELD("run.max_frames", UInt64, false, run.max_frames,
+             "Stop the window loop after N frames (0 = never)"),
+    RV_FIELD("run.report_path", String, false, run.report_path, "Run report JSON written at exit"),
+    RV_FIELD("run.label", String, false, run.label, "Tag copied into the run report"),
+};
+
+#undef RV_FIELD
+
+const Field* findField(const std::string& key) {
+    for (const auto& field : FIELDS) {
+        if (key == field.key) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+const void* locateConst(const Field& field, const AppConfig& config) {
+    return field.locate(const_cast<AppConfig&>(config));
+}
+
+// ============================================================================
+// Value Conversion
+// ============================================================================
+
+const char* policyName(DropPolicy policy) {
+    switch (policy) {
+        case DropPolicy::DropOldest: return "drop_oldest";
+        case DropPolicy::DropNewest: return "drop_newest";
+        case DropPolicy::Block:      return "block";
+    }
+    return "drop_oldest";
+}
+
+/**
+ * Parse text into a field
+ *
+ * @return Empty string on success, otherwise the reason it failed
+ */
+std::string setField(const Field& field, AppConfig& config, const std::string& text) {
+    void* target = field.locate(config);
+    const char* s = text.c_str();
+    char* end = nullptr;
+    errno = 0;
+
+    switch (field.type) {
+        case FieldType::Int: {
+            long v = std::strtol(s, &end, 10);
+            if (text.empty() || *end != '\0' || errno == ERANGE || v < INT_MIN || v > INT_MAX) {
+                return "expected an integer";
+            }
+            *static_cast<int*>(target) = static_cast<int>(v);
+            return {};
+        }
+        case FieldType::UInt64:
+        case FieldType::Size: {
+            if (text.empty() || text[0] == '-') {
+                return "expected a non-negative integer";
+            }
+            unsigned long long v = std::strtoull(s, &end, 10);
+            if (*end != '\0' || errno == ERANGE) {
+                return "expected a non-negative integer";
+            }
+            if (field.type == FieldType::Size) {
+                *static_cast<size_t*>(target) = static_cast<size_t>(v);
+            } else {
+                *static_cast<uint64_t*>(target) = static_cast<uint64_t>(v);
+            }
+            return {};
+        }
+        case FieldType::Float: {
+            float v = std::strtof(s, &end);
+            if (text.empty() || *end != '\0' || errno == ERANGE) {
+                return "expected a number";
+            }
+            *static_cast<float*>(target) = v;
+            return {};
+        }
+        case FieldType::Bool: {
+            std::string lower;
+            for (char c : text) {
+                lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            bool* b = static_cast<bool*>(target);
+            if (lower == "true" || lower == "1" || lower == "yes" || lower == "on") {
+                *b = true;
+            } else if (lower == "false" || lower == "0" || lower == "no" || lower == "off") {
+                *b = false;
+            } else {
+                return "expected true or false";
+            }
+            return {};
+        }
+        case FieldType::String:
+            *static_cast<std::string*>(target) = text;
+            return {};
+        case FieldType::Policy: {
+            DropPolicy* p = static_cast<DropPolicy*>(target);
+            if (text == "drop_oldest") {
+                *p = DropPolicy::DropOldest;
+            } else if (text == "drop_newest") {
+                *p = DropPolicy::DropNewest;
+            } else if (text == "block") {
+                *p = DropPolicy::Block;
+            } else {
+                return "expected drop_oldest, drop_newest or block";
+            }
+            return {};
+        }
+    }
+    return "unsupported type";
+}
+
+std::string formatField(const Field& field, const AppConfig& config) {
+    const void* source = locateConst(field, config);
+    std::ostringstream out;
+
+    switch (field.type) {
+        case FieldType::Int:    out << *static_cast<const int*>(source); break;
+        case FieldType::UInt64: out << *static_cast<const uint64_t*>(source); break;
+        case FieldType::Size:   out << *static_cast<const size_t*>(source); break;
+        case FieldType::Float:  out << *static_cast<const float*>(source); break;
+        case FieldType::Bool:   out << (*static_cast<const bool*>(source) ? "true" : "false"); break;
+        case FieldType::String: out << '"' << *static_cast<const std::string*>(source) << '"'; break;
+        case FieldType::Policy: out << policyName(*static_cast<const DropPolicy*>(source)); break;
+    }
+    return out.str();
+}
+
+bool fieldEquals(const Field& field, const AppConfig& a, const AppConfig& b) {
+    const void* x = locateConst(field, a);
+    const void* y = locateConst(field, b);
+
+    switch (field.type) {
+        case FieldType::Int:    return *static_cast<const int*>(x) == *static_cast<const int*>(y);
+        case FieldType::UInt64: return *static_cast<const uint64_t*>(x) == *static_cast<const uint64_t*>(y);
+        case FieldType::Size:   return *static_cast<const size_t*>(x) == *static_cast<const size_t*>(y);
+        case FieldType::Float:  return *static_cast<const float*>(x) == *static_cast<const float*>(y);
+        case FieldType::Bool:   return *static_cast<const bool*>(x) == *static_cast<const bool*>(y);
+        case FieldType::String:
+            return *static_cast<const std::string*>(x) == *static_cast<const std::string*>(y);
+        case FieldType::Policy:
+            return *static_cast<const DropPolicy*>(x) == *static_cast<const DropPolicy*>(y);
+    }
+    return true;
+}
+
+void copyField(const Field& field, AppConfig& to, const AppConfig& from) {
+    void* dst = field.locate(to);
+    const void* src = locateConst(field, from);
+
+    switch (field.type) {
+        case FieldType::Int:    *static_cast<int*>(dst) = *static_cast<const int*>(src); break;
+        case FieldType::UInt64: *static_cast<uint64_t*>(dst) = *static_cast<const uint64_t*>(src); break;
+        case FieldType::Size:   *static_cast<size_t*>(dst) = *static_cast<const size_t*>(src); break;
+        case FieldType::Float:  *static_cast<float*>(dst) = *static_cast<const float*>(src); break;
+        case FieldType::Bool:   *static_cast<bool*>(dst) = *static_cast<const bool*>(src); break;
+        case FieldType::String:
+            *static_cast<std::string*>(dst) = *static_cast<const std::string*>(src);
+            break;
+        case FieldType::Policy:
+            *static_cast<DropPolicy*>(dst) = *static_cast<const DropPolicy*>(src);
+            break;
+    }
+}
+
+/**
+ * Apply one "key = value" from any source
+ */
+void applySetting(AppConfig& config, const std::string& key, const std::string& value,
+                  const std::string& source, std::vector<std::string>& errors) {
+    const Field* field = findField(key);
+    if (!field) {
+        errors.push_back(source + ": unknown setting '" + key + "'");
+        return;
+    }
+    std::string reason = setField(*field, config, value);
+    if (!reason.empty()) {
+        errors.push_back(source + ": " + key + "='" + value + "': " + reason);
+    }
+}
+
+// ============================================================================
+// Sources
+// ============================================================================
+
+#ifdef HAS_JSON
+/**
+ * Walk a JSON object, turning nested objects into dotted keys
+ *
+ * TEACHING: Every JSON leaf is converted back to text and goes through
+ * the same setter as env vars and CLI flags, so type checking and error
+ * messages are identical no matter where a value came from.
+ */
+void applyJson(AppConfig& config, const nlohmann::json& node, const std::string& prefix,
+               const std::string& source, std::vector<std::string>& errors) {
+    for (auto it = node.begin(); it != node.end(); ++it) {
+        std::string key = prefix.empty() ? it.key() : prefix + "." + it.key();
+        const auto& value = it.value();
+
+        if (value.is_object()) {
+            applyJson(config, value, key, source, errors);
+        } else if (value.is_string()) {
+            applySetting(config, key, value.get<std::string>(), source, errors);
+        } else if (value.is_boolean()) {
+            applySetting(config, key, value.get<bool>() ? "true" : "false", source, errors);
+        } else if (value.is_number()) {
+            applySetting(config, key, value.dump(), source, errors);
+        } else {
+            errors.push_back(source + ": " + key + ": expected a string, number or boolean");
+        }
+    }
+}
+#endif
+
+void loadFile(const std::string& path, AppConfig& config, std::vector<std::string>& errors) {
+#ifdef HAS_JSON
+    std::ifstream file(path);
+    if (!file) {
+        errors.push_back("Cannot open config file: " + path);
+        return;
+    }
+
+    nlohmann::json root = nlohmann::json::parse(file, nullptr, false);
+    if (root.is_discarded()) {
+        errors.push_back(path + ": invalid JSON");
+        return;
+    }
+    if (!root.is_object()) {
+        errors.push_back(path + ": top level must be an object");
+        return;
+    }
+    applyJson(config, root, "", path, errors);
+#else
+    (void)config;
+    errors.push_back("Cannot load " + path + ": built without JSON support (install nlohmann-json)");
+#endif
+}
+
+/**
+ * Environment variable name for a key: pipeline.width -> RV_PIPELINE_WIDTH
+ */
+std::string envName(const char* key) {
+    std::string name = "RV_";
+    for (const char* p = key; *p; ++p) {
+        name += (*p == '.') ? '_' : static_cast<char>(std::toupper(static_cast<unsigned char>(*p)));
+    }
+    return name;
+}
+
+void applyEnvironment(AppConfig& config, std::vector<std::string>& errors) {
+    for (const auto& field : FIELDS) {
+        std::string name = envName(field.key);
+        if (const char* value = std::getenv(name.c_str())) {
+            applySetting(config, field.key, value, name, errors);
+        }
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Defaults and Validation
+// ============================================================================
+
+AppConfig makeDefaultConfig() {
+    AppConfig config;
+
+    config.pipeline.width = 1280;
+    config.pipeline.height = 720;
+    config.pipeline.fps = 30;
+
+    config.window.width = 1280;
+    config.window.height = 720;
+    config.window.title = "Robot Vision Demo - Phase 4";
+    config.window.vsync = true;
+
+#ifdef ASSETS_PATH
+    const std::string assets = ASSETS_PATH;
+#else
+    const std::string assets = "assets";
+#endif
+    config.osd.font_path = assets + "/fonts/RobotoMono-Regular.ttf";
+    config.osd.font_bold_path = assets + "/fonts/RobotoMono-Bold.ttf";
+    config.osd.default_font_size = 18.0f;
+
+    config.stages.detection_rate_hz = 10;          // Don't overwhelm detector (~10 FPS)
+    config.stages.heartbeat_interval_ms = 5000;    // Health check every 5 seconds
+    config.stages.reconnect_interval_ms = 3000;    // Retry every 3 seconds when disconnected
+
+    return config;
+}
+
+std::vector<std::string> validateConfig(const AppConfig& config) {
+    std::vector<std::string> errors;
+
+    if (!config.pipeline.isValid()) {
+        errors.push_back("pipeline: width/height must be 1..4096, fps 1..120 and decode_threads 0..16");
+    }
+    if (!config.window.isValid()) {
+        errors.push_back("window: width and height must be positive");
+    }
+    if (config.osd.font_path.empty()) {
+        errors.push_back("osd.font_path: must be set");
+    }
+    if (config.osd.default_font_size <= 0.0f || config.osd.default_font_size > 200.0f) {
+        errors.push_back("osd.default_font_size: must be 0..200");
+    }
+    if (!config.osd_layout.isValid()) {
+        errors.push_back("osd_layout: every scale must be in (0, 0.5]");
+    }
+    if (config.detection.socket_path.empty() || config.detection.shm_name.empty()) {
+        errors.push_back("detection: socket_path and shm_name must be set");
+    }
+    if (config.detection.connect_timeout_ms <= 0) {
+        errors.push_back("detection.connect_timeout_ms: must be positive");
+    }
+
+    const struct {
+        const char* name;
+        const StageQueueConfig& queue;
+    } queues[] = {
+        {"stages.render_queue", config.stages.render_queue},
+        {"stages.detect_queue", config.stages.detect_queue},
+        {"stages.result_queue", config.stages.result_queue},
+        {"stages.record_queue", config.stages.record_queue},
+    };
+    for (const auto& q : queues) {
+        if (!q.queue.isValid()) {
+            errors.push_back(std::string(q.name) + ".depth: must be 1..1024");
+        }
+    }
+    if (config.stages.detection_rate_hz <= 0 || config.stages.detection_rate_hz > 120) {
+        errors.push_back("stages.detection_rate_hz: must be 1..120");
+    }
+    if (config.stages.heartbeat_interval_ms <= 0 || config.stages.reconnect_interval_ms <= 0) {
+        errors.push_back("stages: heartbeat and reconnect intervals must be positive");
+    }
+
+    if (!config.metrics.isValid()) {
+        errors.push_back("metrics.snapshot_interval_s: must be positive");
+    }
+
+    if (!config.trace.isValid()) {
+        errors.push_back("trace.ring_events: must be 64..4194304");
+    }
+    if (config.trace.output_path.empty()) {
+        errors.push_back("trace.output_path: must be set");
+    }
+
+    if (!config.log.isValid()) {
+        errors.push_back("log: level trace|debug|info|warn|error|off, format text|json|plain, "
+                         "rate_limit_per_s >= 0, ring_slots 16..65536");
+    }
+
+    if (!config.snapshot.isValid()) {
+        errors.push_back("snapshot: format jpeg|png|ppm, jpeg_quality 1..100, workers 1..16, "
+                         "queue_depth 1..256, trigger_confidence 0..1");
+    }
+
+    if (!config.recording.isValid()) {
+        errors.push_back("recording: preroll_s 0..300, postroll_s 0..3600, max_buffer_bytes >= 1 MiB, "
+                         "trigger_count >= 1, trigger_confidence 0..1");
+    }
+
+    if (!config.detection_log.isValid()) {
+        errors.push_back("detection_log: queue_depth 16..65536, flush_interval_ms 10..60000, "
+                         "index_interval_ms >= 10");
+    }
+
+    std::vector<OperatingPoint> ladder;
+    std::string ladder_error;
+    if (!parseOperatingLadder(config.governor.ladder, ladder, ladder_error)) {
+        errors.push_back("governor.ladder: " + ladder_error);
+    } else if (!config.governor.isValid()) {
+        errors.push_back("governor: interval_ms >= 50, each *_low below its *_high, "
+                         "temp_high_c <= temp_critical_c, step samples >= 1");
+    }
+    if (config.governor.enabled && config.headless && config.headless_config.cpu_budget_percent > 0.0f) {
+        errors.push_back("governor.enabled: cannot be combined with headless.cpu_budget_percent "
+                         "(both steer the detection rate)");
+    }
+
+    if (!config.stream.isValid()) {
+        errors.push_back("stream: port 1..65535, source raw|composited, width and height both 0 "
+                         "or both set, fps 1..120, mtu 256..9000");
+    }
+    if (config.stream.enabled && config.headless && config.stream.source == "composited") {
+        errors.push_back("stream.source: composited needs the window (use raw with --headless)");
+    }
+    if (!config.mjpeg.isValid()) {
+        errors.push_back("mjpeg: listen set, fps 1..60, width 0..4096, jpeg_quality 1..100, "
+                         "max_clients 1..256, client_timeout_ms >= 100");
+    }
+    if (!config.framebus.isValid()) {
+        errors.push_back("framebus: shm_name starts with '/', socket_path set, slots 2..64, "
+                         "max_width/max_height 1..8192, max_readers 1..63");
+    }
+    if (!config.telemetry.isValid()) {
+        errors.push_back("telemetry: listen set, sysid 0..255, stale_ms >= 100");
+    }
+    if (!config.hud.isValid()) {
+        errors.push_back("hud: size_scale in (0.1, 1], opacity in (0, 1]");
+    }
+    if (!config.processing.isValid()) {
+        errors.push_back("processing: processors set, threads 1..16, rate_hz 0..120, thumb_width 16..1920");
+    }
+    bool has_exposure = false;
+    bool has_motion = false;
+    for (const auto& name : parseProcessorList(config.processing.processors)) {
+        if (!isBuiltinProcessor(name)) {
+            errors.push_back("processing.processors: unknown processor '" + name + "'");
+        }
+        has_exposure = has_exposure || name == "exposure";
+        has_motion = has_motion || name == "motion";
+    }
+    if (has_motion && !has_exposure) {
+        errors.push_back("processing.processors: motion needs exposure (it corrects for brightness changes)");
+    }
+    if (!config.undistort.isValid()) {
+        errors.push_back("undistort: apply_to all|detection|none, calib_width/calib_height both set or both 0, "
+                         "fx/fy > 0 when enabled, cx/cy >= 0, zoom 0.25..4, threads 1..16");
+    }
+    if (config.undistort.enabled && config.undistort.apply_to == "detection" && !config.stages.enable_detection) {
+        errors.push_back("undistort.apply_to: detection needs the detector stages enabled");
+    }
+    if (config.undistort.gpu_display && config.undistort.apply_to == "all") {
+        errors.push_back("undistort.gpu_display: frames are already undistorted on the CPU (apply_to=all)");
+    }
+    if (!config.stabilize.isValid()) {
+        errors.push_back("stabilize: smoothing_ms 10..10000, max_angle_deg 0..45, crop 0.5..1, "
+                         "hfov_deg 20..170, camera_tilt_deg -90..90");
+    }
+    if (config.stabilize.enabled && !config.telemetry.enabled) {
+        errors.push_back("stabilize.enabled: needs telemetry.enabled (attitude source)");
+    }
+
+    for (const char* role : {"render", "capture", "detect", "record", "gst", "background"}) {
+        ThreadPolicy policy;
+        std::string policy_error;
+        if (!parseThreadPolicy(*config.threads.find(role), policy, policy_error)) {
+            errors.push_back(std::string("threads.") + role + ": " + policy_error);
+        }
+    }
+
+    if (!config.headless_config.isValid()) {
+        errors.push_back("headless: loop_rate_hz must be 1..1000, "
+                         "cpu_budget_percent and status_interval_s non-negative");
+    }
+
+    return errors;
+}
+
+// ============================================================================
+// ConfigManager
+// ============================================================================
+
+bool ConfigManager::initialize(int argc, char* argv[]) {
+    bool print_config = false;
+    bool valid = true;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            exit_requested_ = true;
+            return false;
+        } else if (arg == "--print-config") {
+            print_config = true;
+        } else if (arg.compare(0, 9, "--config=") == 0) {
+            config_path_ = arg.substr(9);
+        } else if (arg == "--headless") {
+            cli_overrides_.emplace_back("headless.enabled", "true");
+        } else if (arg.compare(0, 13, "--cpu-budget=") == 0) {
+            cli_overrides_.emplace_back("headless.cpu_budget_percent", arg.substr(13));
+        } else if (arg.compare(0, 9, "--frames=") == 0) {
+            cli_overrides_.emplace_back("headless.max_frames", arg.substr(9));
+        } else if (arg.compare(0, 2, "--") == 0 && arg.find('=') != std::string::npos &&
+                   findField(arg.substr(2, arg.find('=') - 2))) {
+            size_t eq = arg.find('=');
+            cli_overrides_.emplace_back(arg.substr(2, eq - 2), arg.substr(eq + 1));
+        } else {
+            RV_LOG_ERROR("config", "Unknown argument: {}", arg);
+            valid = false;
+        }
+    }
+
+    if (!valid) {
+        printUsage(argv[0]);
+        return false;
+    }
+
+    if (config_path_.empty()) {
+        if (const char* env_path = std::getenv("RV_CONFIG")) {
+            config_path_ = env_path;
+        }
+    }
+
+    AppConfig config;
+    if (!build(config)) {
+        return false;
+    }
+
+    auto errors = validateConfig(config);
+    if (!errors.empty()) {
+        for (const auto& e : errors) {
+            RV_LOG_ERROR("config", "Invalid configuration: {}", e);
+        }
+        return false;
+    }
+
+    config_ = config;
+
+    if (print_config) {
+        print();
+        exit_requested_ = true;
+        return false;
+    }
+    return true;
+}
+
+bool ConfigManager::build(AppConfig& out) const {
+    std::vector<std::string> errors;
+
+    out = makeDefaultConfig();
+    if (!config_path_.empty()) {
+        loadFile(config_path_, out, errors);
+    }
+    applyEnvironment(out, errors);
+    for (const auto& kv : cli_overrides_) {
+        applySetting(out, kv.first, kv.second, "--" + kv.first, errors);
+    }
+
+    for (const auto& e : errors) {
+        RV_LOG_ERROR("config", "{}", e);
+    }
+    return errors.empty();
+}
+
+bool ConfigManager::reload(std::vector<std::string>& changed_keys) {
+    changed_keys.clear();
+    if (config_path_.empty()) {
+        RV_LOG_INFO("config", "Reloading configuration");
+    } else {
+        RV_LOG_INFO("config", "Reloading configuration from {}", config_path_);
+    }
+
+    AppConfig fresh;
+    if (!build(fresh)) {
+        RV_LOG_WARN("config", "Reload failed, keeping current configuration");
+        return false;
+    }
+
+    auto errors = validateConfig(fresh);
+    if (!errors.empty()) {
+        for (const auto& e : errors) {
+            RV_LOG_ERROR("config", "{}", e);
+        }
+        RV_LOG_WARN("config", "Reload rejected, keeping current configuration");
+        return false;
+    }
+
+    // Only live settings are applied; the rest are in use by objects that
+    // were built at startup (window, textures, queues, sockets).
+    for (const auto& field : FIELDS) {
+        if (fieldEquals(field, config_, fresh)) {
+            continue;
+        }
+        if (field.live) {
+            RV_LOG_INFO("config", "{}: {} -> {}", field.key, formatField(field, config_),
+                        formatField(field, fresh));
+            copyField(field, config_, fresh);
+            changed_keys.push_back(field.key);
+        } else {
+            RV_LOG_WARN("config", "{}: changed to {} (restart required)", field.key,
+                        formatField(field, fresh));
+        }
+    }
+
+    if (changed_keys.empty()) {
+        RV_LOG_INFO("config", "No live settings changed");
+    }
+    return !changed_keys.empty();
+}
+
+// --print-config and --help write plain stdout: they are the program's output, not log lines
+void ConfigManager::print() const {
+    for (const auto& field : FIELDS) {
+        std::cout << "  " << field.key << " = " << formatField(field, config_) << "\n";
+    }
+}
+
+void ConfigManager::printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --config=PATH       Load settings from a JSON file (or set RV_CONFIG)\n"
+              << "  --KEY=VALUE         Override any setting below (e.g. --pipeline.fps=60)\n"
+              << "  --headless          Same as --headless.enabled=true\n"
+              << "  --cpu-budget=PCT    Same as --headless.cpu_budget_percent=PCT\n"
+              << "  --frames=N          Same as --headless.max_frames=N\n"
+              << "  --print-config      Print the effective configuration and exit\n"
+              << "  -h, --help          Show this help\n"
+              << "\n"
+              << "Settings (env: RV_<KEY> with dots as underscores, e.g. RV_PIPELINE_FPS;\n"
+              << "* = applied live on SIGHUP):\n";
+
+    for (const auto& field : FIELDS) {
+        std::string key = field.key;
+        std::cout << "  " << (field.live ? "* " : "  ") << key;
+        for (size_t pad = key.size(); pad < 34; ++pad) {
+            std::cout << ' ';
+        }
+        std::cout << field.help << "\n";
+    }
+}
+
+} // namespace robot_vision
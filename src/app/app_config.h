@@ -0,0 +1,197 @@
+#pragma once
+
+/**
+ * @file app_config.h
+ * @brief Typed runtime configuration for the whole application
+ *
+ * Every tunable that used to be a literal in main.cpp lives here, grouped
+ * by the module config struct that consumes it. Values are layered:
+ *
+ *   built-in defaults  <  JSON file (--config=PATH)  <  environment  <  command line
+ *
+ * Each setting has a dotted key used by all three sources:
+ *   JSON:  { "pipeline": { "width": 1920 } }
+ *   env:   RV_PIPELINE_WIDTH=1920
+ *   CLI:   --pipeline.width=1920
+ *
+ * Sending SIGHUP re-reads all sources. Settings marked "live" (detection
+ * rate, OSD layout, headless CPU budget, log level) take effect
+ * immediately; changes to anything else are reported and need a restart.
+ *
+ * TEACHING: One Table, Many Sources
+ * ---------------------------------
+ * Rather than writing a JSON parser, an env parser and a CLI parser that
+ * each know every field, we describe each field ONCE (key, how to parse
+ * it, whether it can change live) and feed all sources through the same
+ * string-based setter. Adding a setting means adding one table entry.
+ *
+ * Module settings come from each module's small *_config.h, never the
+ * module header itself, so configuration does not drag in GStreamer,
+ * sockets or thread pools.
+ */
+
+#include "core/video_pipeline.h"
+#include "core/window.h"
+#include "core/osd.h"
+#include "core/detection_client.h"
+#include "core/staged_pipeline.h"
+#include "app/headless_runner.h"
+#include "app/run_report.h"
+#include "metrics/metrics_config.h"
+#include "trace/trace.h"
+#include "util/logger.h"
+#include "util/thread_policy.h"
+#include "snapshot/snapshot_config.h"
+#include "recording/event_recording_config.h"
+#include "detection/detection_log_config.h"
+#include "governor/governor_config.h"
+#include "streaming/stream_config.h"
+#include "streaming/mjpeg_config.h"
+#include "framebus/frame_bus_config.h"
+#include "telemetry/telemetry_config.h"
+#include "osd/flight_hud_config.h"
+#include "processing/processing_config.h"
+#include "processing/undistort_config.h"
+#include "rendering/stabilize_config.h"
+
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * OSD layout, as fractions of framebuffer height
+ */
+struct OSDLayoutConfig {
+    float label_font_scale = 0.025f;     // Detection label font size
+    float status_font_scale = 0.022f;    // Status text font size
+    float padding_scale = 0.005f;        // Text background padding
+    float box_line_scale = 0.003f;       // Bounding box stroke width
+    float status_margin_scale = 0.03f;   // Margin from screen edge
+
+    bool isValid() const {
+        auto ok = [](float v) { return v > 0.0f && v <= 0.5f; };
+        return ok(label_font_scale) && ok(status_font_scale) && ok(padding_scale) &&
+               ok(box_line_scale) && ok(status_margin_scale);
+    }
+};
+
+/**
+ * Complete application configuration
+ */
+struct AppConfig {
+    PipelineConfig pipeline;
+    WindowConfig window;
+    OSDConfig osd;
+    OSDLayoutConfig osd_layout;
+    DetectionClientConfig detection;
+    StagedPipelineConfig stages;
+    MetricsConfig metrics;
+    TraceConfig trace;
+    LogConfig log;
+    RunConfig run;                      // Fixed-length runs and run report
+    SnapshotConfig snapshot;
+    EventRecordingConfig recording;     // Pre-roll event clips
+    DetectionLogConfig detection_log;   // Binary detection log
+    GovernorConfig governor;            // Thermal/load operating point ladder
+    StreamConfig stream;                // RTP/UDP H.264 network stream
+    MjpegConfig mjpeg;                  // MJPEG-over-HTTP browser preview
+    FrameBusConfig framebus;            // Shared-memory frames for local processes
+    TelemetryConfig telemetry;          // MAVLink flight telemetry for the OSD
+    FlightHudConfig hud;                // Horizon, heading tape, speed/altitude ladders
+    ProcessingConfig processing;        // Per-frame analysis processors
+    UndistortConfig undistort;          // Lens undistortion (capture or detector branch)
+    StabilizeConfig stabilize;          // Attitude stabilisation of the displayed video
+    ThreadPolicyConfig threads;         // Affinity / scheduling per thread role
+
+    bool headless = false;              // Run without a window
+    HeadlessConfig headless_config;     // Used when headless
+};
+
+/**
+ * Build the default configuration (the values main.cpp used to hardcode)
+ */
+AppConfig makeDefaultConfig();
+
+/**
+ * Check a configuration
+ *
+ * @return One human-readable message per problem (empty = valid)
+ */
+std::vector<std::string> validateConfig(const AppConfig& config);
+
+/**
+ * Loads, layers, validates and reloads the application configuration
+ *
+ * Usage:
+ *   ConfigManager manager;
+ *   if (!manager.initialize(argc, argv)) return 1;
+ *   const AppConfig& config = manager.config();
+ *   ...
+ *   // On SIGHUP:
+ *   std::vector<std::string> changed;
+ *   if (manager.reload(changed)) { apply live settings }
+ */
+class ConfigManager {
+public:
+    /**
+     * Build the configuration from file, environment and command line
+     *
+     * @return false on error (messages already printed) or if --help /
+     *         --print-config was handled; check exitRequested() to tell
+     *         them apart
+     */
+    bool initialize(int argc, char* argv[]);
+
+    /**
+     * Current effective configuration
+     */
+    const AppConfig& config() const { return config_; }
+
+    /**
+     * True if --help or --print-config was handled and the program should exit
+     */
+    bool exitRequested() const { return exit_requested_; }
+
+    /**
+     * Config file in use (empty = built-in defaults)
+     */
+    const std::string& configPath() const { return config_path_; }
+
+    /**
+     * Re-read the config file and environment, re-apply CLI overrides
+     *
+     * Only settings marked live are applied; others are reported as
+     * requiring a restart and left unchanged. An invalid file leaves the
+     * current configuration untouched.
+     *
+     * @param changed_keys Output: live keys whose value changed
+     * @return true if any live setting changed
+     */
+    bool reload(std::vector<std::string>& changed_keys);
+
+    /**
+     * Print the effective configuration, one "key = value" per line
+     */
+    void print() const;
+
+    /**
+     * Print command line help, including every setting key
+     */
+    static void printUsage(const char* program);
+
+private:
+    /**
+     * Build a configuration from all sources
+     *
+     * @return false if any source had errors (printed)
+     */
+    bool build(AppConfig& out) const;
+
+    AppConfig config_;
+    std::string config_path_;                                   // --config=PATH
+    std::vector<std::pair<std::string, std::string>> cli_overrides_;  // key, value
+    bool exit_requested_ = false;
+};
+
+} // namespace robot_vision
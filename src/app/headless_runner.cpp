@@ -0,0 +1,187 @@
+/**
+ * @file headless_runner.cpp
+ * @brief Windowless run mode implementation
+ */
+
+#include "headless_runner.h"
+#include "util/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <utility>
+
+namespace robot_vision {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * CPU time consumed by the whole process (all threads), in seconds
+ */
+double processCpuSeconds() {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0) {
+        return 0.0;
+    }
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+} // namespace
+
+HeadlessRunner::HeadlessRunner(IStagedPipeline& staged, const HeadlessConfig& config)
+    : staged_(staged)
+    , config_(config)
+    , configured_detection_rate_(staged.getDetectionRate())
+{
+}
+
+int HeadlessRunner::run(const std::atomic<bool>& stop_requested) {
+    if (!config_.isValid()) {
+        RV_LOG_ERROR("app", "Invalid headless configuration");
+        return 1;
+    }
+
+    const auto tick = std::chrono::microseconds(1000000 / config_.loop_rate_hz);
+    const auto start = Clock::now();
+    auto next_tick = start + tick;
+
+    // Budget window state
+    auto window_start = start;
+    double window_cpu = processCpuSeconds();
+    float cpu_percent = 0.0f;
+
+    // Status counters
+    auto last_status = start;
+    uint64_t total_frames = 0;
+    uint64_t status_frames = 0;
+    uint64_t total_result_sets = 0;
+    uint64_t total_detections = 0;
+
+    if (config_.cpu_budget_percent > 0.0f && !rate_control_) {
+        RV_LOG_WARN("app", "Headless loop: {} Hz; CPU budget {}% not enforced, the performance "
+                    "governor controls the detection rate", config_.loop_rate_hz,
+                    config_.cpu_budget_percent);
+    } else if (config_.cpu_budget_percent > 0.0f) {
+        RV_LOG_INFO("app", "Headless loop: {} Hz, CPU budget {}%",
+                    config_.loop_rate_hz, config_.cpu_budget_percent);
+    } else {
+        RV_LOG_INFO("app", "Headless loop: {} Hz", config_.loop_rate_hz);
+    }
+
+    while (!stop_requested.load(std::memory_order_relaxed)) {
+        // Drain the render-stage queues exactly like the GUI loop does.
+        // Recording and detection logging happen in the pipeline's sinks.
+        if (staged_.acquireFrame()) {
+            if (total_frames == 0 && first_frame_callback_) {
+                first_frame_callback_();
+            }
+            total_frames++;
+            status_frames++;
+        }
+
+        if (auto results = staged_.acquireDetections()) {
+            total_result_sets++;
+            total_detections += results->detections.size();
+        }
+
+        if (config_.max_frames > 0 && total_frames >= config_.max_frames) {
+            RV_LOG_INFO("app", "Reached frame limit ({})", config_.max_frames);
+            break;
+        }
+
+        auto now = Clock::now();
+
+        // CPU budget window (1 second)
+        if (now - window_start >= std::chrono::seconds(1)) {
+            double cpu = processCpuSeconds();
+            double wall = std::chrono::duration<double>(now - window_start).count();
+            cpu_percent = static_cast<float>((cpu - window_cpu) / wall * 100.0);
+            window_cpu = cpu;
+            window_start = now;
+
+            if (config_.cpu_budget_percent > 0.0f && rate_control_) {
+                enforceCpuBudget(cpu_percent);
+            }
+        }
+
+        // Periodic status line
+        if (config_.status_interval_s > 0 &&
+            now - last_status >= std::chrono::seconds(config_.status_interval_s)) {
+            double secs = std::chrono::duration<double>(now - last_status).count();
+            RV_LOG_INFO("app", "[headless] {} frames, {:.1f} FPS, {} result sets ({} detections), "
+                        "det {} {} Hz, CPU {:.1f}%",
+                        total_frames, status_frames / secs, total_result_sets, total_detections,
+                        staged_.isDetectorConnected() ? "ON" : "OFF",
+                        staged_.getDetectionRate(), cpu_percent);
+            status_frames = 0;
+            last_status = now;
+        }
+
+        if (tick_callback_) {
+            tick_callback_();
+        }
+
+        // Fixed-rate tick. If we fell behind, don't try to catch up in a burst.
+        std::this_thread::sleep_until(next_tick);
+        next_tick += tick;
+        now = Clock::now();
+        if (next_tick < now) {
+            next_tick = now + tick;
+        }
+    }
+
+    double runtime = std::chrono::duration<double>(Clock::now() - start).count();
+    RV_LOG_INFO("app", "Headless run: {} frames in {:.1f}s, {} result sets",
+                total_frames, runtime, total_result_sets);
+    return 0;
+}
+
+void HeadlessRunner::setTickCallback(std::function<void()> callback) {
+    tick_callback_ = std::move(callback);
+}
+
+void HeadlessRunner::setFirstFrameCallback(std::function<void()> callback) {
+    first_frame_callback_ = std::move(callback);
+}
+
+void HeadlessRunner::updateConfig(const HeadlessConfig& config, int detection_rate_hz) {
+    config_.cpu_budget_percent = config.cpu_budget_percent;
+    config_.status_interval_s = config.status_interval_s;
+    if (!rate_control_) {
+        return;
+    }
+
+    // The new rate is both the current rate and the ceiling the budget
+    // loop recovers to
+    configured_detection_rate_ = detection_rate_hz;
+    staged_.setDetectionRate(detection_rate_hz);
+}
+
+void HeadlessRunner::disableRateControl() {
+    rate_control_ = false;
+}
+
+void HeadlessRunner::enforceCpuBudget(float cpu_percent) {
+    int rate = staged_.getDetectionRate();
+    int new_rate = rate;
+
+    if (cpu_percent > config_.cpu_budget_percent) {
+        // Over budget: back off quickly (multiplicative decrease)
+        new_rate = std::max(1, rate * 3 / 4);
+    } else if (cpu_percent < config_.cpu_budget_percent * 0.7f &&
+               rate < configured_detection_rate_) {
+        // Comfortably under: recover slowly (additive increase)
+        new_rate = std::min(configured_detection_rate_, rate + 1);
+    }
+
+    if (new_rate != rate) {
+        staged_.setDetectionRate(new_rate);
+        RV_LOG_INFO("app", "[headless] CPU {:.1f}% (budget {:.1f}%): detection rate {} -> {} Hz",
+                    cpu_percent, config_.cpu_budget_percent, rate, new_rate);
+    }
+}
+
+} // namespace robot_vision
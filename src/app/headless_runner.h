@@ -0,0 +1,102 @@
+#pragma once
+
+/**
+ * @file headless_runner.h
+ * @brief Windowless run mode: capture -> detection -> sinks
+ *
+ * For unattended airframes and server-side processing. No GLFW window,
+ * no OpenGL texture, no NanoVG - the headless loop takes the place of the
+ * render stage and drains the same staged-pipeline queues, so flow
+ * control (queue depths, drop policies, detection rate) is identical to
+ * the GUI mode.
+ */
+
+#include "core/staged_pipeline.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+namespace robot_vision {
+
+/**
+ * Headless mode configuration
+ */
+struct HeadlessConfig {
+    int loop_rate_hz = 100;             // Scheduling loop tick rate
+    float cpu_budget_percent = 0.0f;    // Process CPU cap, % of one core (0 = unlimited)
+    int status_interval_s = 10;         // Periodic status line (0 = off)
+    uint64_t max_frames = 0;            // Exit after N frames (0 = run until signalled)
+
+    bool isValid() const {
+        return loop_rate_hz > 0 && loop_rate_hz <= 1000 &&
+               cpu_budget_percent >= 0.0f && status_interval_s >= 0;
+    }
+};
+
+/**
+ * Headless scheduling loop
+ *
+ * TEACHING: CPU Budget by Feedback
+ * --------------------------------
+ * We can't tell the OS "use at most 40% CPU", but we can measure how much
+ * we used (CLOCK_PROCESS_CPUTIME_ID) and turn down the biggest knob we
+ * control - the detection submit rate - when over budget, then slowly
+ * turn it back up when comfortably under. This is a simple feedback loop.
+ */
+class HeadlessRunner {
+public:
+    HeadlessRunner(IStagedPipeline& staged, const HeadlessConfig& config);
+
+    /**
+     * Run until stop_requested becomes true or max_frames is reached
+     *
+     * @return Process exit code
+     */
+    int run(const std::atomic<bool>& stop_requested);
+
+    /**
+     * Called once per loop tick on the run() thread (e.g. to handle a
+     * pending config reload). Set before run().
+     */
+    void setTickCallback(std::function<void()> callback);
+
+    /**
+     * Called once on the run() thread when the first frame is taken
+     * (time-to-first-frame). Set before run().
+     */
+    void setFirstFrameCallback(std::function<void()> callback);
+
+    /**
+     * Apply live settings (call from the tick callback)
+     *
+     * @param config New CPU budget and status interval (other fields ignored)
+     * @param detection_rate_hz New detection rate ceiling for the budget loop
+     *        (ignored after disableRateControl())
+     */
+    void updateConfig(const HeadlessConfig& config, int detection_rate_hz);
+
+    /**
+     * Leave the detection rate to another controller (the performance
+     * governor) so two loops never fight over it. The CPU budget is then
+     * measured and reported but not enforced. Call before run().
+     */
+    void disableRateControl();
+
+private:
+    /**
+     * Adjust detection rate to stay within the CPU budget
+     *
+     * @param cpu_percent Process CPU usage over the last window
+     */
+    void enforceCpuBudget(float cpu_percent);
+
+    IStagedPipeline& staged_;
+    HeadlessConfig config_;
+    int configured_detection_rate_;
+    bool rate_control_ = true;          // Budget loop may change the detection rate
+    std::function<void()> tick_callback_;
+    std::function<void()> first_frame_callback_;
+};
+
+} // namespace robot_vision
@@ -0,0 +1,276 @@
+/**
+ * @file run_report.cpp
+ * @brief End-of-run performance report
+ */
+
+#include "run_report.h"
+#include "util/logger.h"
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace robot_vision {
+
+namespace {
+
+double toMs(uint64_t ns) {
+    return static_cast<double>(ns) / 1e6;
+}
+
+std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+/**
+ * Distribution summary; scale converts recorded units to reported units
+ */
+void writeDistribution(std::ostream& out, const char* key, const Histogram& hist, double scale) {
+    auto snap = hist.snapshot();
+    auto q = [&](double quantile) {
+        // Bucket upper edges can overshoot the largest value actually seen
+        return static_cast<double>(std::min(snap.quantile(quantile), snap.max_ns)) * scale;
+    };
+    double mean = snap.count ? static_cast<double>(snap.sum_ns) / static_cast<double>(snap.count) * scale : 0.0;
+
+    out << "\"" << key << "\":{\"count\":" << snap.count
+        << ",\"mean\":" << mean
+        << ",\"p50\":" << q(0.5)
+        << ",\"p90\":" << q(0.9)
+        << ",\"p99\":" << q(0.99)
+        << ",\"max\":" << static_cast<double>(snap.max_ns) * scale << "}";
+}
+
+/**
+ * Left-align a table column
+ */
+std::string padRight(const std::string& s, size_t width) {
+    return s.size() >= width ? s : s + std::string(width - s.size(), ' ');
+}
+
+void printDistribution(const char* name, const Histogram& hist, double scale, const char* unit) {
+    auto snap = hist.snapshot();
+    if (snap.count == 0) {
+        RV_LOG_INFO("report", "  {}n/a", padRight(name, 18));
+        return;
+    }
+    auto q = [&](double quantile) {
+        return static_cast<double>(std::min(snap.quantile(quantile), snap.max_ns)) * scale;
+    };
+    RV_LOG_INFO("report", "  {}p50 {:8.2f}  p90 {:8.2f}  p99 {:8.2f}  max {:8.2f} {}",
+                padRight(name, 18), q(0.5), q(0.9), q(0.99),
+                static_cast<double>(snap.max_ns) * scale, unit);
+}
+
+} // namespace
+
+// ============================================================================
+// Thread CPU
+// ============================================================================
+
+std::vector<ThreadCpu> readThreadCpu() {
+    std::vector<ThreadCpu> threads;
+
+    DIR* dir = ::opendir("/proc/self/task");
+    if (!dir) {
+        return threads;     // Not Linux
+    }
+
+    const double ticks_per_s = static_cast<double>(::sysconf(_SC_CLK_TCK));
+    while (dirent* entry = ::readdir(dir)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        std::string base = std::string("/proc/self/task/") + entry->d_name;
+
+        std::ifstream stat_file(base + "/stat");
+        std::string stat;
+        if (!std::getline(stat_file, stat)) {
+            continue;       // Thread exited while we looked
+        }
+
+        // Fields after "(comm)": state ppid ... utime(14) stime(15)
+        size_t paren = stat.rfind(')');
+        if (paren == std::string::npos) {
+            continue;
+        }
+        std::istringstream fields(stat.substr(paren + 2));
+        std::string field;
+        unsigned long long utime = 0, stime = 0;
+        for (int i = 3; i <= 15 && (fields >> field); ++i) {
+            if (i == 14) {
+                utime = std::strtoull(field.c_str(), nullptr, 10);
+            } else if (i == 15) {
+                stime = std::strtoull(field.c_str(), nullptr, 10);
+            }
+        }
+
+        ThreadCpu t;
+        t.tid = std::atoi(entry->d_name);
+        std::ifstream comm_file(base + "/comm");
+        std::getline(comm_file, t.name);
+        t.cpu_s = static_cast<double>(utime + stime) / ticks_per_s;
+        threads.push_back(t);
+    }
+    ::closedir(dir);
+
+    std::sort(threads.begin(), threads.end(),
+              [](const ThreadCpu& a, const ThreadCpu& b) { return a.tid < b.tid; });
+    return threads;
+}
+
+// ============================================================================
+// RunReport
+// ============================================================================
+
+RunReport::RunReport(const RunConfig& config)
+    : config_(config)
+{
+}
+
+void RunReport::start() {
+    start_ns_ = metricsNowNs();
+    cpu_start_ = readThreadCpu();
+}
+
+void RunReport::recordFrame(uint64_t present_ns, const FrameData& frame,
+                            const DetectionSet* detections) {
+    if (frames_ == 0) {
+        first_frame_number_ = frame.frame_number;
+    } else {
+        frame_time_.record(present_ns - last_present_ns_);
+    }
+    last_present_ns_ = present_ns;
+    last_frame_number_ = frame.frame_number;
+    frames_++;
+
+    if (frame.capture_time_ns > 0 && present_ns > frame.capture_time_ns) {
+        latency_.record(present_ns - frame.capture_time_ns);
+    }
+
+    if (detections) {
+        if (present_ns > detections->received_ns) {
+            staleness_.record(present_ns - detections->received_ns);
+        }
+        if (frame.frame_number >= detections->frame_id) {
+            staleness_frames_.record(frame.frame_number - detections->frame_id);
+        }
+    }
+}
+
+void RunReport::finish() {
+    end_ns_ = metricsNowNs();
+
+    std::map<int, double> baseline;
+    for (const auto& t : cpu_start_) {
+        baseline[t.tid] = t.cpu_s;
+    }
+    cpu_delta_.clear();
+    for (auto t : readThreadCpu()) {
+        auto it = baseline.find(t.tid);
+        if (it != baseline.end()) {
+            t.cpu_s -= it->second;
+        }
+        cpu_delta_.push_back(t);
+    }
+}
+
+std::string RunReport::toJson() const {
+    const double wall_s = static_cast<double>(end_ns_ - start_ns_) / 1e9;
+    const uint64_t captured = frames_ ? last_frame_number_ - first_frame_number_ + 1 : 0;
+
+    std::ostringstream out;
+    out << std::setprecision(6);
+    out << "{\"label\":\"" << jsonEscape(config_.label) << "\""
+        << ",\"frames\":" << frames_
+        << ",\"frames_skipped\":" << (captured > frames_ ? captured - frames_ : 0)
+        << ",\"wall_s\":" << wall_s
+        << ",\"throughput_fps\":" << (wall_s > 0 ? static_cast<double>(frames_) / wall_s : 0.0)
+        << ",\n";
+    writeDistribution(out, "frame_time_ms", frame_time_, 1e-6);
+    out << ",\n";
+    writeDistribution(out, "latency_ms", latency_, 1e-6);
+    out << ",\n";
+    writeDistribution(out, "staleness_ms", staleness_, 1e-6);
+    out << ",\n";
+    writeDistribution(out, "staleness_frames", staleness_frames_, 1.0);
+    out << ",\n\"threads\":[";
+
+    double total_cpu = 0.0;
+    for (size_t i = 0; i < cpu_delta_.size(); ++i) {
+        const ThreadCpu& t = cpu_delta_[i];
+        total_cpu += t.cpu_s;
+        out << (i ? "," : "") << "\n{\"tid\":" << t.tid << ",\"name\":\"" << jsonEscape(t.name)
+            << "\",\"cpu_s\":" << t.cpu_s
+            << ",\"cpu_percent\":" << (wall_s > 0 ? t.cpu_s / wall_s * 100.0 : 0.0) << "}";
+    }
+    out << "\n],\"process_cpu_percent\":" << (wall_s > 0 ? total_cpu / wall_s * 100.0 : 0.0)
+        << "}\n";
+    return out.str();
+}
+
+void RunReport::print() const {
+    const double wall_s = static_cast<double>(end_ns_ - start_ns_) / 1e9;
+
+    if (config_.label.empty()) {
+        RV_LOG_INFO("report", "--- Run Report ---");
+    } else {
+        RV_LOG_INFO("report", "--- Run Report ({}) ---", config_.label);
+    }
+    RV_LOG_INFO("report", "  Frames: {} in {:.2f}s = {:.2f} FPS", frames_, wall_s,
+                wall_s > 0 ? static_cast<double>(frames_) / wall_s : 0.0);
+
+    printDistribution("Frame time", frame_time_, 1e-6, "ms");
+    printDistribution("Capture->present", latency_, 1e-6, "ms");
+    printDistribution("Detection age", staleness_, 1e-6, "ms");
+    printDistribution("Detection lag", staleness_frames_, 1.0, "frames");
+
+    if (!cpu_delta_.empty()) {
+        RV_LOG_INFO("report", "  Thread            CPU(s)  %core");
+        for (const auto& t : cpu_delta_) {
+            RV_LOG_INFO("report", "  {}{:8.2f}{:7.1f}", padRight(t.name, 16), t.cpu_s,
+                        wall_s > 0 ? t.cpu_s / wall_s * 100.0 : 0.0);
+        }
+    }
+}
+
+bool RunReport::write() const {
+    if (config_.report_path.empty()) {
+        return true;
+    }
+
+    std::string tmp = config_.report_path + ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::trunc);
+        if (!file || !(file << toJson())) {
+            RV_LOG_ERROR("report", "Cannot write run report {}", tmp);
+            return false;
+        }
+    }
+    if (std::rename(tmp.c_str(), config_.report_path.c_str()) != 0) {
+        RV_LOG_ERROR("report", "Cannot rename {}", tmp);
+        return false;
+    }
+    RV_LOG_INFO("report", "Run report written to {}", config_.report_path);
+    return true;
+}
+
+} // namespace robot_vision
@@ -0,0 +1,128 @@
+#pragma once
+
+/**
+ * @file run_report.h
+ * @brief Fixed-length runs and the end-of-run performance report
+ *
+ * With run.max_frames set, the render loop stops after that many frames
+ * and (if run.report_path is set) writes one JSON object summarising the
+ * run:
+ *
+ *   throughput          frames shown per second of wall time
+ *   frame_time_ms       interval between consecutive new frames on screen
+ *   latency_ms          capture -> buffer swap, per shown frame
+ *   staleness_ms        age of the detections drawn on each shown frame
+ *   staleness_frames    how many frames behind the shown frame they are
+ *   threads             CPU time and % of one core per thread
+ *
+ * bench/replay_main.cpp drives this against a recorded clip and a mock
+ * detector to get one comparable set of numbers per commit.
+ *
+ * TEACHING: Measure Where the User Looks
+ * --------------------------------------
+ * Per-stage timings tell you which stage is slow; they don't tell you what
+ * the operator sees. Everything here is sampled at the moment a frame is
+ * presented, so a queue that quietly adds 50 ms of latency shows up even
+ * if every stage is individually fast.
+ */
+
+#include "core/staged_pipeline.h"
+#include "metrics/metrics.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * Run length and report settings
+ */
+struct RunConfig {
+    uint64_t max_frames = 0;            // Stop after N frames shown (0 = until closed)
+    std::string report_path = "";       // Run report JSON written at exit (empty = off)
+    std::string label = "";             // Free-form tag copied into the report (e.g. commit)
+};
+
+/**
+ * CPU time of one thread of this process
+ */
+struct ThreadCpu {
+    int tid = 0;
+    std::string name;
+    double cpu_s = 0.0;                 // User + system
+};
+
+/**
+ * Read CPU time for every thread of this process
+ *
+ * Linux only (/proc/self/task); returns an empty list elsewhere.
+ */
+std::vector<ThreadCpu> readThreadCpu();
+
+/**
+ * Collects per-frame samples on the render thread and writes the report
+ *
+ * Not thread-safe: call everything from the render thread.
+ */
+class RunReport {
+public:
+    explicit RunReport(const RunConfig& config);
+
+    /**
+     * Mark the start of the measured run (takes the CPU baseline)
+     */
+    void start();
+
+    /**
+     * Record a newly captured frame that was just presented
+     *
+     * @param present_ns Steady-clock time just after the buffer swap
+     * @param frame The frame shown
+     * @param detections Detections drawn on it (nullptr = none yet)
+     */
+    void recordFrame(uint64_t present_ns, const FrameData& frame,
+                     const DetectionSet* detections);
+
+    /**
+     * End the measured run and sample CPU (call BEFORE stage threads join)
+     */
+    void finish();
+
+    /**
+     * Render the report as a JSON object
+     */
+    std::string toJson() const;
+
+    /**
+     * Print a human-readable summary
+     */
+    void print() const;
+
+    /**
+     * Write toJson() to run.report_path (no-op if empty)
+     *
+     * @return false if the file could not be written
+     */
+    bool write() const;
+
+private:
+    RunConfig config_;
+
+    uint64_t start_ns_ = 0;
+    uint64_t end_ns_ = 0;
+    uint64_t last_present_ns_ = 0;
+    uint64_t frames_ = 0;
+    uint32_t first_frame_number_ = 0;
+    uint32_t last_frame_number_ = 0;
+
+    Histogram frame_time_;
+    Histogram latency_;
+    Histogram staleness_;
+    Histogram staleness_frames_;        // Frame counts, not nanoseconds
+
+    std::vector<ThreadCpu> cpu_start_;
+    std::vector<ThreadCpu> cpu_delta_;  // Filled by finish()
+};
+
+} // namespace robot_vision
@@ -0,0 +1,212 @@
+/**
+ * @file startup_graph.cpp
+ * @brief Concurrent startup step scheduler
+ */
+
+#include "startup_graph.h"
+#include "metrics/metrics.h"
+#include "util/logger.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace robot_vision {
+
+namespace {
+
+enum class StepState {
+    Waiting,
+    Running,
+    Done,
+    Failed,
+    Skipped
+};
+
+} // namespace
+
+void StartupGraph::add(const std::string& name, std::vector<std::string> depends_on,
+                       StartupThread thread, std::function<bool()> step) {
+    steps_.push_back(Step{name, std::move(depends_on), {}, thread, std::move(step)});
+}
+
+bool StartupGraph::resolve() {
+    for (auto& step : steps_) {
+        step.deps.clear();
+        for (const auto& dep : step.depends_on) {
+            size_t i = 0;
+            while (i < steps_.size() && steps_[i].name != dep) {
+                ++i;
+            }
+            if (i == steps_.size()) {
+                RV_LOG_ERROR("startup", "Step '{}' depends on unknown step '{}'", step.name, dep);
+                return false;
+            }
+            step.deps.push_back(i);
+        }
+    }
+
+    // Cycle check (Kahn): every step must become ready eventually. The
+    // visiting order is a topological order, kept for run()
+    std::vector<size_t> pending(steps_.size());
+    std::vector<size_t> ready;
+    order_.clear();
+    for (size_t i = 0; i < steps_.size(); ++i) {
+        pending[i] = steps_[i].deps.size();
+        if (pending[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+    while (!ready.empty()) {
+        size_t done = ready.back();
+        ready.pop_back();
+        order_.push_back(done);
+        for (size_t i = 0; i < steps_.size(); ++i) {
+            for (size_t dep : steps_[i].deps) {
+                if (dep == done && --pending[i] == 0) {
+                    ready.push_back(i);
+                }
+            }
+        }
+    }
+    if (order_.size() != steps_.size()) {
+        RV_LOG_ERROR("startup", "Startup steps have a dependency cycle");
+        return false;
+    }
+    return true;
+}
+
+bool StartupGraph::run() {
+    results_.clear();
+    failed_step_.clear();
+    if (!resolve()) {
+        return false;
+    }
+
+    const uint64_t t0 = metricsNowNs();
+    std::vector<StepState> state(steps_.size(), StepState::Waiting);
+    results_.resize(steps_.size());
+    for (size_t i = 0; i < steps_.size(); ++i) {
+        results_[i].name = steps_[i].name;
+        results_[i].thread = steps_[i].thread;
+    }
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<std::thread> workers;
+    size_t finished = 0;
+    std::function<void(size_t, std::unique_lock<std::mutex>&)> execute;
+
+    // Caller holds the lock. Skips steps behind a failure and starts ready
+    // workers - called by whoever finishes a step, so a worker's dependents
+    // start at once even while the main thread is busy. Walked in dependency
+    // order, so a skip reaches every step behind it in one pass.
+    auto promote = [&]() {
+        for (size_t i : order_) {
+            if (state[i] != StepState::Waiting) {
+                continue;
+            }
+            bool ready = true;
+            bool blocked = false;
+            for (size_t dep : steps_[i].deps) {
+                ready = ready && state[dep] == StepState::Done;
+                blocked = blocked || state[dep] == StepState::Failed || state[dep] == StepState::Skipped;
+            }
+            if (blocked) {
+                state[i] = StepState::Skipped;
+                results_[i].skipped = true;
+                ++finished;
+            } else if (ready && steps_[i].thread == StartupThread::Worker) {
+                state[i] = StepState::Running;
+                workers.emplace_back([&, i] {
+                    std::unique_lock<std::mutex> worker_lock(mutex);
+                    execute(i, worker_lock);
+                });
+            }
+        }
+        changed.notify_all();
+    };
+
+    // Caller holds the lock; runs the step without it
+    execute = [&](size_t i, std::unique_lock<std::mutex>& lock) {
+        state[i] = StepState::Running;
+        lock.unlock();
+        uint64_t start = metricsNowNs();
+        bool ok = steps_[i].fn();
+        uint64_t end = metricsNowNs();
+        lock.lock();
+        results_[i].ok = ok;
+        results_[i].start_ns = start - t0;
+        results_[i].duration_ns = end - start;
+        state[i] = ok ? StepState::Done : StepState::Failed;
+        if (!ok && failed_step_.empty()) {
+            failed_step_ = steps_[i].name;
+        }
+        ++finished;
+        promote();
+    };
+
+    std::unique_lock<std::mutex> lock(mutex);
+    promote();
+    while (finished < steps_.size()) {
+        size_t main_ready = steps_.size();
+        for (size_t i = 0; i < steps_.size() && main_ready == steps_.size(); ++i) {
+            if (state[i] != StepState::Waiting || steps_[i].thread != StartupThread::Main) {
+                continue;
+            }
+            bool ready = true;
+            for (size_t dep : steps_[i].deps) {
+                ready = ready && state[dep] == StepState::Done;
+            }
+            if (ready) {
+                main_ready = i;
+            }
+        }
+
+        if (main_ready < steps_.size()) {
+            execute(main_ready, lock);
+        } else {
+            changed.wait(lock);
+        }
+    }
+    lock.unlock();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    total_ns_ = metricsNowNs() - t0;
+
+    auto& registry = MetricsRegistry::global();
+    for (const auto& result : results_) {
+        registry.gauge("rv_startup_step_seconds", "Duration of each startup step",
+                       "step=\"" + result.name + "\"")
+            .set(static_cast<double>(result.duration_ns) / 1e9);
+    }
+    logSummary();
+    return failed_step_.empty();
+}
+
+void StartupGraph::logSummary() const {
+    RV_LOG_INFO("startup", "Startup took {:.0f} ms ({} steps)",
+                static_cast<double>(total_ns_) / 1e6, results_.size());
+    for (const auto& r : results_) {
+        if (r.skipped) {
+            RV_LOG_INFO("startup", "  {} skipped", r.name);
+            continue;
+        }
+        RV_LOG_INFO("startup", "  {} [{}] at {:.0f} ms, took {:.0f} ms{}", r.name,
+                    r.thread == StartupThread::Main ? "main" : "worker",
+                    static_cast<double>(r.start_ns) / 1e6, static_cast<double>(r.duration_ns) / 1e6,
+                    r.ok ? "" : " - FAILED");
+    }
+}
+
+void reportTimeToFirstFrame(uint64_t process_start_ns) {
+    double seconds = static_cast<double>(metricsNowNs() - process_start_ns) / 1e9;
+    MetricsRegistry::global()
+        .gauge("rv_time_to_first_frame_seconds", "Process start until the first frame was shown")
+        .set(seconds);
+    RV_LOG_INFO("startup", "Time to first frame: {:.0f} ms", seconds * 1000.0);
+}
+
+} // namespace robot_vision
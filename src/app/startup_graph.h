@@ -0,0 +1,115 @@
+#pragma once
+
+/**
+ * @file startup_graph.h
+ * @brief Run independent startup steps concurrently
+ *
+ *   StartupGraph graph;
+ *   graph.add("gstreamer", {}, StartupThread::Worker, [] { return initGStreamer(); });
+ *   graph.add("pipeline", {"gstreamer"}, StartupThread::Worker, [&] { ... });
+ *   graph.add("window", {}, StartupThread::Main, [&] { return window->initialize(...); });
+ *   graph.add("osd", {"window"}, StartupThread::Main, [&] { ... });
+ *   if (!graph.run()) { ... graph.failedStep() ... }
+ *
+ * Worker steps each get a thread as soon as their dependencies are done.
+ * Main steps run on the thread that called run() - the one that will own
+ * the OpenGL context (GLFW requires window creation on the main thread).
+ *
+ * TEACHING: Critical Path
+ * -----------------------
+ * Serial startup costs the SUM of all steps. A dependency graph costs the
+ * longest chain through it: here, typically gst_init + the camera reaching
+ * PLAYING, while the window, GL context and fonts come up alongside. The
+ * summary line shows each step's start and duration so the chain that
+ * actually gates the first frame is easy to spot.
+ */
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * Where a startup step runs
+ */
+enum class StartupThread {
+    Main,       // The thread calling run() (GL context, window system)
+    Worker      // A thread of its own
+};
+
+/**
+ * Outcome of one step (after run())
+ */
+struct StartupStepResult {
+    std::string name;
+    StartupThread thread = StartupThread::Worker;
+    bool ok = false;
+    bool skipped = false;           // A dependency failed, step never ran
+    uint64_t start_ns = 0;          // Relative to run() start
+    uint64_t duration_ns = 0;
+};
+
+/**
+ * Startup dependency graph (single use)
+ */
+class StartupGraph {
+public:
+    /**
+     * Add a step; dependencies must be added before run()
+     *
+     * @param step Returns false on failure (dependents are skipped)
+     */
+    void add(const std::string& name, std::vector<std::string> depends_on, StartupThread thread,
+             std::function<bool()> step);
+
+    /**
+     * Run every step, respecting dependencies
+     *
+     * Returns once all steps have finished or been skipped (worker threads
+     * are joined). Step durations are exported as rv_startup_step_seconds.
+     *
+     * @return true if every step succeeded
+     */
+    bool run();
+
+    /**
+     * First step that failed (empty if none, or the graph was malformed)
+     */
+    const std::string& failedStep() const { return failed_step_; }
+
+    const std::vector<StartupStepResult>& results() const { return results_; }
+
+    /**
+     * Wall time of the last run()
+     */
+    uint64_t totalNs() const { return total_ns_; }
+
+private:
+    struct Step {
+        std::string name;
+        std::vector<std::string> depends_on;
+        std::vector<size_t> deps;       // Resolved indices
+        StartupThread thread;
+        std::function<bool()> fn;
+    };
+
+    bool resolve();
+    void logSummary() const;
+
+    std::vector<Step> steps_;
+    std::vector<size_t> order_;         // Step indices, dependencies first (from resolve())
+    std::vector<StartupStepResult> results_;
+    std::string failed_step_;
+    uint64_t total_ns_ = 0;
+};
+
+/**
+ * Publish time-to-first-frame (call once, when the first frame is shown)
+ *
+ * @param process_start_ns metricsNowNs() taken at the top of main()
+ */
+void reportTimeToFirstFrame(uint64_t process_start_ns);
+
+} // namespace robot_vision
@@ -81,6 +81,9 @@ struct ServerInfo {
  * Detection client interface
  *
  * Connects to vision-detector service and exchanges detection data.
+ *
+ * Thread safety: all methods may be called from different threads
+ * (e.g. one thread sending frames while another receives results).
  */
 class IDetectionClient {
 public:
@@ -155,6 +158,15 @@ public:
      */
     virtual bool receiveDetections(std::vector<detector_protocol::Detection>& detections,
                                    uint64_t& frame_id, float& inference_time_ms) = 0;
+
+    /**
+     * Wait until a message from the server is ready to be read
+     * @param timeout_ms Maximum time to wait
+     * @return true if receiveDetections() has data to consume
+     *
+     * Lets a dedicated result thread sleep in the kernel instead of polling.
+     */
+    virtual bool waitForResults(int timeout_ms) = 0;
 };
 
 // ============================================================================
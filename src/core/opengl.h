@@ -33,6 +33,10 @@
     // Jetson Nano uses OpenGL ES 2.0
     #include <GLES2/gl2.h>
 #else
-    // Standard Linux OpenGL
+    // Standard Linux OpenGL; GL 2.0 entry points (shaders) come from glext.h,
+    // which only declares prototypes when asked to
+    #ifndef GL_GLEXT_PROTOTYPES
+        #define GL_GLEXT_PROTOTYPES
+    #endif
     #include <GL/gl.h>
 #endif
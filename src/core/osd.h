@@ -19,6 +19,7 @@
  * NanoVG provides hardware-accelerated vector graphics for this.
  */
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -197,6 +198,61 @@ public:
     virtual void drawCircle(float cx, float cy, float radius,
                             Color color, bool filled = true) = 0;
 
+    // ========================================================================
+    // Images and Transforms
+    // ========================================================================
+
+    /**
+     * Create an image from RGBA pixels (premultiplied alpha, top row first)
+     *
+     * @return Image handle, 0 on failure
+     *
+     * TEACHING: Pre-built Geometry
+     * ----------------------------
+     * Every vector stroke is tessellated on the CPU and drawn as its own
+     * GPU call (three with stencil strokes). A tape of forty tick marks
+     * drawn as strokes costs forty of those per frame; drawn once into an
+     * image at startup it costs a single textured quad, moved by the
+     * transform below. Images live until deleteImage() or shutdown().
+     */
+    virtual int createImage(int width, int height, const uint8_t* rgba) = 0;
+
+    /**
+     * Release an image from createImage()
+     */
+    virtual void deleteImage(int image) = 0;
+
+    /**
+     * Fill a rectangle with an image
+     *
+     * The image is placed at (image_x, image_y), scaled to image_width x
+     * image_height; only the part inside (x, y, width, height) is drawn.
+     * Moving image_x/image_y scrolls the image under a fixed rectangle.
+     */
+    virtual void drawImage(int image, float x, float y, float width, float height,
+                           float image_x, float image_y, float image_width, float image_height,
+                           float alpha = 1.0f) = 0;
+
+    /**
+     * Save / restore the transform and clip (calls must pair up)
+     */
+    virtual void pushTransform() = 0;
+    virtual void popTransform() = 0;
+
+    /**
+     * Move / rotate (radians, clockwise on screen) everything drawn afterwards
+     */
+    virtual void translate(float x, float y) = 0;
+    virtual void rotate(float radians) = 0;
+
+    /**
+     * Clip later drawing to a rectangle (in the current transform)
+     *
+     * The clip keeps the transform it was set with: rotating afterwards
+     * turns the content but not the clip window.
+     */
+    virtual void clipRect(float x, float y, float width, float height) = 0;
+
     // ========================================================================
     // Convenience Methods
     // ========================================================================
@@ -117,13 +117,16 @@ public:
      * @param width   Desired frame width (e.g., 1280)
      * @param height  Desired frame height (e.g., 720)
      * @param fps     Desired frames per second (e.g., 30)
+     * @param device  Camera to use ("" = pick automatically; platform-specific
+     *                name, e.g. "/dev/video2" on Linux)
      * @return GStreamer pipeline string ready for gst_parse_launch()
      *
      * Example return values:
      * - macOS:  "autovideosrc ! videoconvert ! video/x-raw,format=RGB,width=1280,height=720 ! appsink"
      * - Jetson: "nvarguscamerasrc ! nvvidconv ! video/x-raw,format=RGB,width=1280,height=720 ! appsink"
      */
-    virtual std::string getCameraPipeline(int width, int height, int fps) const = 0;
+    virtual std::string getCameraPipeline(int width, int height, int fps,
+                                          const std::string& device) const = 0;
 
     /**
      * Get GStreamer pipeline string for video display
@@ -136,6 +139,21 @@ public:
      */
     virtual std::string getDisplayPipeline() const = 0;
 
+    /**
+     * Get GStreamer H.264 encoder chain
+     *
+     * @param bitrate_kbps       Target bitrate in kbit/s
+     * @param keyframe_interval  Frames between keyframes (GOP length)
+     * @return Pipeline fragment taking video/x-raw,format=RGB and producing
+     *         H.264 without B-frames (so decode order == display order)
+     *
+     * Example return values:
+     * - macOS:  "videoconvert ! vtenc_h264 realtime=true ..."
+     * - Jetson: "... ! nvvidconv ! nvv4l2h264enc ..." (hardware encoder)
+     * - Linux:  "videoconvert ! x264enc tune=zerolatency ..."
+     */
+    virtual std::string getH264EncoderPipeline(int bitrate_kbps, int keyframe_interval) const = 0;
+
     // ========================================================================
     // Capability Queries
     // ========================================================================
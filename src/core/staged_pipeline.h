@@ -0,0 +1,290 @@
+#pragma once
+
+/**
+ * @file staged_pipeline.h
+ * @brief Multi-threaded frame pipeline interface
+ *
+ * Splits the per-frame work into stages, each running on its own thread
+ * and connected by bounded lock-free queues:
+ *
+ *   capture ──┬──> [render queue]  ──> render (caller's thread, owns GL)
+ *             ├──> [detect queue]  ──> detect-submit ──> detector (IPC)
+ *             └──> [record queue]  ──> record/stream sinks (optional)
+ *
+ *   detector ──> result ingest ──> [result queue] ──> render
+ *
+ * TEACHING: Throughput of a Pipeline
+ * ----------------------------------
+ * When stages run in sequence, frame time = sum of all stage times.
+ * When stages run concurrently, frame time = time of the SLOWEST stage.
+ * Bounded queues between stages keep memory constant: when a consumer
+ * falls behind, the queue's drop policy decides what to throw away
+ * instead of letting latency grow without limit.
+ */
+
+#include "core/detection_client.h"
+#include "core/video_pipeline.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * What a stage queue does when it is full
+ */
+enum class DropPolicy {
+    DropOldest,     // Discard the oldest queued item (keeps latency low)
+    DropNewest,     // Discard the incoming item (keeps ordering)
+    Block           // Producer waits for space (lossless, propagates backpressure)
+};
+
+/**
+ * Configuration of a single stage queue
+ */
+struct StageQueueConfig {
+    size_t depth = 2;                               // Maximum queued items
+    DropPolicy policy = DropPolicy::DropOldest;     // Behaviour when full
+
+    bool isValid() const {
+        return depth > 0 && depth <= 1024;
+    }
+};
+
+/**
+ * Staged pipeline configuration
+ */
+struct StagedPipelineConfig {
+    StageQueueConfig render_queue{2, DropPolicy::DropOldest};   // capture -> render
+    StageQueueConfig detect_queue{1, DropPolicy::DropOldest};   // capture -> detect-submit
+    StageQueueConfig result_queue{4, DropPolicy::DropOldest};   // ingest -> render
+    StageQueueConfig record_queue{8, DropPolicy::DropOldest};   // capture -> record/stream
+
+    bool enable_detection = true;       // Run detect-submit and result ingest stages
+    int detection_rate_hz = 10;         // Max frames per second sent to detector
+    int heartbeat_interval_ms = 5000;   // Detector health check period
+    int reconnect_interval_ms = 3000;   // Retry period while disconnected
+
+    bool isValid() const {
+        return render_queue.isValid() && detect_queue.isValid() &&
+               result_queue.isValid() && record_queue.isValid() &&
+               detection_rate_hz > 0 && detection_rate_hz <= 120 &&
+               heartbeat_interval_ms > 0 && reconnect_interval_ms > 0;
+    }
+};
+
+/**
+ * One set of detection results, as received from the detector
+ */
+struct DetectionSet {
+    std::vector<detector_protocol::Detection> detections;
+    uint64_t frame_id = 0;              // Frame the results belong to
+    float inference_time_ms = 0.0f;     // Detector-side inference time
+    uint64_t received_ns = 0;           // Steady-clock time results arrived
+};
+
+/**
+ * Per-stage counters (snapshot)
+ *
+ * "Wait" is time the stage spent idle waiting for input (or, for a
+ * Block-policy producer, waiting for space). "Busy" is time spent doing
+ * work on items. occupancy is the input queue fill level at snapshot time.
+ */
+struct StageStats {
+    std::string name;
+    size_t queue_depth = 0;         // Configured input queue depth (0 = no queue)
+    size_t occupancy = 0;           // Items currently queued
+    size_t max_occupancy = 0;       // High-water mark
+    uint64_t pushed = 0;            // Items accepted into the input queue
+    uint64_t dropped = 0;           // Items discarded by the drop policy
+    uint64_t processed = 0;         // Items handled by the stage
+    uint64_t wait_ns = 0;           // Total time waiting
+    uint64_t max_wait_ns = 0;       // Longest single wait
+    uint64_t busy_ns = 0;           // Total time working
+};
+
+/**
+ * Consumer of captured frames on the record/stream stage
+ *
+ * Implementations (recorders, streamers, snapshot writers) run on the
+ * record thread and may take their time - the capture and render stages
+ * never wait for them.
+ */
+class IFrameSink {
+public:
+    virtual ~IFrameSink() = default;
+
+    /**
+     * Consume a captured frame
+     */
+    virtual void consumeFrame(const std::shared_ptr<FrameData>& frame) = 0;
+};
+
+/**
+ * Consumer of detection results
+ *
+ * Called on the result-ingest thread as each result set arrives.
+ * Implementations must not block (hand slow work to their own thread),
+ * otherwise they delay delivery of results to the render stage.
+ */
+class IDetectionSink {
+public:
+    virtual ~IDetectionSink() = default;
+
+    /**
+     * Consume a detection result set
+     */
+    virtual void consumeDetections(const std::shared_ptr<const DetectionSet>& results) = 0;
+};
+
+/**
+ * Frame transform run inside a stage (e.g. lens undistortion)
+ *
+ * The capture filter runs on the capture thread before frames fan out to
+ * every consumer; the detection filter runs on the detect-submit thread
+ * and only changes what the detector sees. Either way it is on the frame's
+ * critical path, so it must finish well within a frame interval.
+ */
+class IFrameFilter {
+public:
+    virtual ~IFrameFilter() = default;
+
+    /**
+     * Transform a frame
+     *
+     * @return Transformed frame (a new FrameData; the input may be shared
+     *         with other consumers and must not be modified)
+     */
+    virtual std::shared_ptr<FrameData> apply(const std::shared_ptr<FrameData>& frame) = 0;
+};
+
+/**
+ * Staged pipeline interface
+ */
+class IStagedPipeline {
+public:
+    virtual ~IStagedPipeline() = default;
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    /**
+     * Register a record/stream sink (before start())
+     */
+    virtual void addFrameSink(std::shared_ptr<IFrameSink> sink) = 0;
+
+    /**
+     * Register a detection sink (before start())
+     */
+    virtual void addDetectionSink(std::shared_ptr<IDetectionSink> sink) = 0;
+
+    /**
+     * Transform every captured frame before fan-out (before start())
+     */
+    virtual void setCaptureFilter(std::shared_ptr<IFrameFilter> filter) = 0;
+
+    /**
+     * Transform only frames sent to the detector, before the input
+     * downscale (before start())
+     */
+    virtual void setDetectionFilter(std::shared_ptr<IFrameFilter> filter) = 0;
+
+    /**
+     * Start all stage threads
+     *
+     * The video pipeline must already be running.
+     */
+    virtual bool start() = 0;
+
+    /**
+     * Stop and join all stage threads (idempotent)
+     */
+    virtual void stop() = 0;
+
+    // ========================================================================
+    // Render Stage Access (called from the render thread)
+    // ========================================================================
+
+    /**
+     * Take the newest captured frame, if a new one arrived
+     *
+     * @return Frame or nullptr if nothing new since the last call
+     */
+    virtual std::shared_ptr<FrameData> acquireFrame() = 0;
+
+    /**
+     * Take the newest detection results, if new ones arrived
+     *
+     * @return Results or nullptr if nothing new since the last call
+     */
+    virtual std::shared_ptr<const DetectionSet> acquireDetections() = 0;
+
+    // ========================================================================
+    // Detector State
+    // ========================================================================
+
+    /**
+     * Check if the detector connection is up
+     */
+    virtual bool isDetectorConnected() const = 0;
+
+    /**
+     * Get a copy of the detector's server info (valid while connected)
+     */
+    virtual ServerInfo getDetectorInfo() const = 0;
+
+    /**
+     * Change the maximum rate frames are sent to the detector (live)
+     *
+     * @param hz New rate, clamped to 1..120
+     */
+    virtual void setDetectionRate(int hz) = 0;
+
+    /**
+     * Get the current detection submit rate
+     */
+    virtual int getDetectionRate() const = 0;
+
+    /**
+     * Downscale frames sent to the detector to at most this width (live)
+     *
+     * Detections are normalized, so results need no rescaling.
+     *
+     * @param width Maximum width in pixels (0 = send frames as captured)
+     */
+    virtual void setDetectionInputWidth(int width) = 0;
+
+    /**
+     * Get the detector input width cap (0 = none)
+     */
+    virtual int getDetectionInputWidth() const = 0;
+
+    // ========================================================================
+    // Diagnostics
+    // ========================================================================
+
+    /**
+     * Snapshot per-stage counters
+     */
+    virtual std::vector<StageStats> getStats() const = 0;
+};
+
+// ============================================================================
+// Factory Function
+// ============================================================================
+
+/**
+ * Create a staged pipeline
+ *
+ * @param video Running video pipeline (capture stage input)
+ * @param detector Detection client (may be disconnected; stage reconnects)
+ * @param config Queue depths, drop policies and rates
+ */
+std::unique_ptr<IStagedPipeline> createStagedPipeline(IVideoPipeline& video,
+                                                      IDetectionClient& detector,
+                                                      const StagedPipelineConfig& config = {});
+
+} // namespace robot_vision
@@ -44,6 +44,7 @@ struct FrameData {
     int width = 0;                   // Frame width in pixels
     int height = 0;                  // Frame height in pixels
     uint64_t timestamp_ns = 0;       // Capture timestamp in nanoseconds
+    uint64_t capture_time_ns = 0;    // Steady-clock time the frame was pulled (for latency)
     uint32_t frame_number = 0;       // Sequential frame counter
 
     /**
@@ -69,6 +70,10 @@ struct PipelineConfig {
     int height = 720;               // Desired frame height
     int fps = 30;                   // Desired frames per second
     std::string device = "";        // Camera device (empty = auto-detect)
+    std::string source = "";        // "" = camera, "test" = test pattern, else a video file
+    bool loop = false;              // Restart a file source at end of stream
+    bool realtime = true;           // Pace a file source at fps (false = as fast as it decodes)
+    int decode_threads = 0;         // Camera MJPEG decoder threads (0 = auto)
 
     /**
      * Validate configuration
@@ -78,7 +83,8 @@ struct PipelineConfig {
     bool isValid() const {
         return width > 0 && width <= 4096 &&
                height > 0 && height <= 4096 &&
-               fps > 0 && fps <= 120;
+               fps > 0 && fps <= 120 &&
+               decode_threads >= 0 && decode_threads <= 16;
     }
 };
 
@@ -218,6 +224,22 @@ public:
      * @param[out] height Actual frame height
      */
     virtual void getFrameDimensions(int& width, int& height) const = 0;
+
+    // ========================================================================
+    // Live Adjustment
+    // ========================================================================
+
+    /**
+     * Scale delivered frames to a new size while running
+     *
+     * @param width Output width (0 with height 0 = configured size)
+     * @param height Output height
+     * @return true if the pipeline accepted the new size
+     *
+     * Takes effect within a few frames; consumers must cope with the
+     * frame size changing (FrameData carries its own dimensions).
+     */
+    virtual bool setOutputResolution(int width, int height) = 0;
 };
 
 // ============================================================================
@@ -16,6 +16,7 @@
  */
 
 #include <memory>
+#include <functional>
 #include <string>
 
 namespace robot_vision {
@@ -29,6 +30,7 @@ struct WindowConfig {
     std::string title = "Robot Vision Demo";   // Window title
     bool resizable = true;                      // Allow window resizing
     bool vsync = true;                          // Enable vertical sync
+    bool visible = true;                        // false = hidden window (offscreen GL context)
 
     bool isValid() const {
         return width > 0 && height > 0;
@@ -191,6 +193,22 @@ public:
      * Sets the close flag so shouldClose() returns true.
      */
     virtual void requestClose() = 0;
+
+    // ========================================================================
+    // Input
+    // ========================================================================
+
+    /**
+     * Key press handler
+     *
+     * @param key Key code; letters and digits are their uppercase ASCII value
+     */
+    using KeyCallback = std::function<void(int key)>;
+
+    /**
+     * Set the key press handler (called from pollEvents(), on the window thread)
+     */
+    virtual void setKeyCallback(KeyCallback callback) = 0;
 };
 
 // ============================================================================
@@ -0,0 +1,25 @@
+/**
+ * @file console_detection_sink.cpp
+ * @brief Detection sink that prints results to the console
+ */
+
+#include "console_detection_sink.h"
+#include "util/logger.h"
+
+
+namespace robot_vision {
+
+void ConsoleDetectionSink::consumeDetections(const std::shared_ptr<const DetectionSet>& results) {
+    if (results->detections.empty()) {
+        return;
+    }
+
+    RV_LOG_INFO("detect", "Received {} detections (frame {}, {}ms)",
+                results->detections.size(), results->frame_id, results->inference_time_ms);
+    for (const auto& det : results->detections) {
+        RV_LOG_INFO("detect", "  - {} {}% at [{},{} {}x{}]", det.label, det.confidence * 100,
+                    det.x, det.y, det.width, det.height);
+    }
+}
+
+} // namespace robot_vision
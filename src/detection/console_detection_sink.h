@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ * @file console_detection_sink.h
+ * @brief Detection sink that prints results to the console
+ */
+
+#include "core/staged_pipeline.h"
+
+namespace robot_vision {
+
+/**
+ * Prints every non-empty detection set, one line per detection
+ *
+ * Runs on the result-ingest thread, so console I/O never stalls rendering.
+ */
+class ConsoleDetectionSink : public IDetectionSink {
+public:
+    void consumeDetections(const std::shared_ptr<const DetectionSet>& results) override;
+};
+
+} // namespace robot_vision
@@ -1,6 +1,8 @@
 #include "detection_client.h"
+#include "util/logger.h"
+#include "trace/trace.h"
 
-#include <iostream>
+#include <cerrno>
 #include <chrono>
 #include <cstring>
 #include <sys/select.h>
@@ -31,6 +33,7 @@ DetectionClientImpl::~DetectionClientImpl() {
 }
 
 bool DetectionClientImpl::connect() {
+    std::lock_guard<std::mutex> lock(io_mutex_);
     if (state_ == ConnectionState::Connected) {
         return true;
     }
@@ -64,16 +67,17 @@ bool DetectionClientImpl::connect() {
     }
 
     state_ = ConnectionState::Connected;
-    std::cout << "  Connected to detector (Protocol v" << server_info_.protocol_version << ")\n";
-    std::cout << "  Model: " << server_info_.model_name << " (" << server_info_.getModelTypeString() << ")\n";
-    std::cout << "  Input: " << server_info_.model_input_width << "x"
-              << server_info_.model_input_height << ", Classes: " << server_info_.num_classes << "\n";
-    std::cout << "  Size: " << server_info_.getModelSizeString() << ", Device: " << server_info_.device << "\n";
+    RV_LOG_INFO("detect", "Connected to detector (Protocol v{})", server_info_.protocol_version);
+    RV_LOG_INFO("detect", "Model: {} ({})", server_info_.model_name, server_info_.getModelTypeString());
+    RV_LOG_INFO("detect", "Input: {}x{}, Classes: {}", server_info_.model_input_width,
+                server_info_.model_input_height, server_info_.num_classes);
+    RV_LOG_INFO("detect", "Size: {}, Device: {}", server_info_.getModelSizeString(), server_info_.device);
 
     return true;
 }
 
 void DetectionClientImpl::disconnect() {
+    std::lock_guard<std::mutex> lock(io_mutex_);
     if (state_ == ConnectionState::Connected && socket_fd_ >= 0) {
         // Send shutdown message
         HeartbeatMessage msg;
@@ -103,42 +107,60 @@ const std::string& DetectionClientImpl::getLastError() const {
 }
 
 bool DetectionClientImpl::sendHeartbeat() {
-    if (state_ != ConnectionState::Connected) {
-        setError("Not connected");
-        return false;
-    }
+    int fd;
+    {
+        std::lock_guard<std::mutex> lock(io_mutex_);
+        if (state_ != ConnectionState::Connected) {
+            setError("Not connected");
+            return false;
+        }
 
-    // Send heartbeat
-    HeartbeatMessage msg;
-    msg.type = MessageType::HEARTBEAT;
-    auto now = std::chrono::steady_clock::now();
-    msg.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        now.time_since_epoch()).count();
+        // Send heartbeat
+        HeartbeatMessage msg;
+        msg.type = MessageType::HEARTBEAT;
+        auto now = std::chrono::steady_clock::now();
+        msg.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            now.time_since_epoch()).count();
 
-    if (send(socket_fd_, &msg, sizeof(msg), 0) != sizeof(msg)) {
-        setError("Failed to send heartbeat");
-        return false;
+        if (send(socket_fd_, &msg, sizeof(msg), 0) != sizeof(msg)) {
+            setError("Failed to send heartbeat");
+            return false;
+        }
+        fd = socket_fd_;
     }
 
-    // Wait for response with timeout, handling any interleaved messages
+    /**
+     * Wait for the response without holding io_mutex_, so sendFrame() keeps
+     * feeding the detector meanwhile. Detection results that arrive first
+     * are kept for receiveDetections() rather than dropped.
+     */
     for (int attempts = 0; attempts < 5; ++attempts) {
         fd_set read_fds;
         FD_ZERO(&read_fds);
-        FD_SET(socket_fd_, &read_fds);
+        FD_SET(fd, &read_fds);
 
         struct timeval timeout;
         timeout.tv_sec = 1;
         timeout.tv_usec = 0;
 
-        int ready = select(socket_fd_ + 1, &read_fds, nullptr, nullptr, &timeout);
+        int ready = select(fd + 1, &read_fds, nullptr, nullptr, &timeout);
+
+        std::lock_guard<std::mutex> lock(io_mutex_);
+        if (state_ != ConnectionState::Connected || socket_fd_ != fd) {
+            setError("Disconnected during heartbeat");
+            return false;
+        }
         if (ready <= 0) {
             setError("Heartbeat timeout");
             return false;
         }
 
-        // Peek at message type first
+        // Peek at message type first (another reader may have taken the data)
         uint8_t msg_type;
-        ssize_t n = recv(socket_fd_, &msg_type, 1, MSG_PEEK);
+        ssize_t n = recv(fd, &msg_type, 1, MSG_PEEK | MSG_DONTWAIT);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            continue;
+        }
         if (n <= 0) {
             setError("Connection closed during heartbeat");
             return false;
@@ -147,21 +169,22 @@ bool DetectionClientImpl::sendHeartbeat() {
         if (static_cast<MessageType>(msg_type) == MessageType::HEARTBEAT) {
             // This is our heartbeat response
             HeartbeatMessage response;
-            n = recv(socket_fd_, &response, sizeof(response), 0);
+            n = recv(fd, &response, sizeof(response), 0);
             if (n == sizeof(response)) {
                 return true;  // Success!
             }
             setError("Incomplete heartbeat response");
             return false;
         } else if (static_cast<MessageType>(msg_type) == MessageType::DETECTION_RESULT) {
-            // Got a detection result instead - consume it and continue waiting
+            // A result overtook the response: keep it for the ingest path
             DetectionResultMessage result;
-            recv(socket_fd_, &result, sizeof(result), 0);
-            // Continue loop to wait for heartbeat response
+            if (recv(fd, &result, sizeof(result), 0) > 0) {
+                held_results_.push_back(result);
+            }
         } else {
             // Unknown message type - try to skip it
             char discard[256];
-            recv(socket_fd_, discard, sizeof(discard), 0);
+            recv(fd, discard, sizeof(discard), 0);
         }
     }
 
@@ -171,6 +194,8 @@ bool DetectionClientImpl::sendHeartbeat() {
 
 bool DetectionClientImpl::sendFrame(const uint8_t* pixels, uint32_t width, uint32_t height,
                                      uint64_t frame_id) {
+    ScopedSpan span("sendFrame", frame_id);
+    std::lock_guard<std::mutex> lock(io_mutex_);
     if (state_ != ConnectionState::Connected) {
         setError("Not connected");
         return false;
@@ -225,34 +250,42 @@ bool DetectionClientImpl::sendFrame(const uint8_t* pixels, uint32_t width, uint3
 
 bool DetectionClientImpl::receiveDetections(std::vector<detector_protocol::Detection>& detections,
                                              uint64_t& frame_id, float& inference_time_ms) {
+    TRACE_SCOPE_FRAME("receiveDetections", span);
+    std::lock_guard<std::mutex> lock(io_mutex_);
     if (state_ != ConnectionState::Connected) {
         return false;
     }
 
-    // Check if data available (non-blocking)
-    fd_set read_fds;
-    FD_ZERO(&read_fds);
-    FD_SET(socket_fd_, &read_fds);
+    DetectionResultMessage result;
+    if (!held_results_.empty()) {
+        // Read while a heartbeat waited for its reply
+        result = held_results_.front();
+        held_results_.pop_front();
+    } else {
+        // Check if data available (non-blocking)
+        fd_set read_fds;
+        FD_ZERO(&read_fds);
+        FD_SET(socket_fd_, &read_fds);
 
-    struct timeval timeout;
-    timeout.tv_sec = 0;
-    timeout.tv_usec = 0;  // Non-blocking
+        struct timeval timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_usec = 0;  // Non-blocking
 
-    int ready = select(socket_fd_ + 1, &read_fds, nullptr, nullptr, &timeout);
-    if (ready <= 0) {
-        return false;  // No data available
-    }
+        int ready = select(socket_fd_ + 1, &read_fds, nullptr, nullptr, &timeout);
+        if (ready <= 0) {
+            return false;  // No data available
+        }
 
-    // Receive result message
-    DetectionResultMessage result;
-    ssize_t n = recv(socket_fd_, &result, sizeof(result), 0);
+        // Receive result message
+        ssize_t n = recv(socket_fd_, &result, sizeof(result), 0);
 
-    if (n <= 0) {
-        if (n == 0) {
-            setError("Server disconnected");
-            state_ = ConnectionState::Disconnected;
+        if (n <= 0) {
+            if (n == 0) {
+                setError("Server disconnected");
+                state_ = ConnectionState::Disconnected;
+            }
+            return false;
         }
-        return false;
     }
 
     if (result.type != MessageType::DETECTION_RESULT) {
@@ -261,6 +294,7 @@ bool DetectionClientImpl::receiveDetections(std::vector<detector_protocol::Detec
 
     frame_id = result.frame_id;
     inference_time_ms = result.inference_time_ms;
+    span.setFrame(frame_id);
 
     detections.clear();
     for (uint32_t i = 0; i < result.num_detections; ++i) {
@@ -270,6 +304,32 @@ bool DetectionClientImpl::receiveDetections(std::vector<detector_protocol::Detec
     return true;
 }
 
+bool DetectionClientImpl::waitForResults(int timeout_ms) {
+    int fd;
+    {
+        std::lock_guard<std::mutex> lock(io_mutex_);
+        if (state_ != ConnectionState::Connected) {
+            return false;
+        }
+        if (!held_results_.empty()) {
+            return true;
+        }
+        fd = socket_fd_;
+    }
+
+    // Block in select() without holding io_mutex_ so sendFrame() can proceed
+    TRACE_SCOPE("waitForResults");
+    fd_set read_fds;
+    FD_ZERO(&read_fds);
+    FD_SET(fd, &read_fds);
+
+    struct timeval timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_usec = (timeout_ms % 1000) * 1000;
+
+    return select(fd + 1, &read_fds, nullptr, nullptr, &timeout) > 0;
+}
+
 bool DetectionClientImpl::performHandshake() {
     // Send handshake request
     HandshakeRequest request;
@@ -336,10 +396,12 @@ bool DetectionClientImpl::performHandshake() {
 
 void DetectionClientImpl::setError(const std::string& error) {
     last_error_ = error;
-    std::cerr << "DetectionClient: " << error << std::endl;
+    RV_LOG_ERROR("detect", "DetectionClient: {}", error);
 }
 
 void DetectionClientImpl::cleanup() {
+    held_results_.clear();
+
     if (socket_fd_ >= 0) {
         UnixSocket::close(socket_fd_);
         socket_fd_ = -1;
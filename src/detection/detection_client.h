@@ -10,6 +10,10 @@
 #include "core/detection_client.h"
 #include <detector_protocol/ipc_common.h>
 
+#include <atomic>
+#include <deque>
+#include <mutex>
+
 namespace robot_vision {
 
 class DetectionClientImpl : public IDetectionClient {
@@ -35,10 +39,15 @@ public:
                    uint64_t frame_id) override;
     bool receiveDetections(std::vector<detector_protocol::Detection>& detections,
                            uint64_t& frame_id, float& inference_time_ms) override;
+    bool waitForResults(int timeout_ms) override;
 
 private:
     DetectionClientConfig config_;
-    ConnectionState state_ = ConnectionState::Disconnected;
+    std::atomic<ConnectionState> state_{ConnectionState::Disconnected};
+
+    // Serialises socket/shm access between the send and receive threads.
+    // waitForResults() deliberately does NOT hold it while blocked.
+    mutable std::mutex io_mutex_;
     ServerInfo server_info_{};
     std::string last_error_;
 
@@ -46,6 +55,10 @@ private:
     int shm_fd_ = -1;
     void* shm_ptr_ = nullptr;
 
+    // Results read while sendHeartbeat() waited for its reply, handed out
+    // by receiveDetections() before the socket is read again
+    std::deque<detector_protocol::DetectionResultMessage> held_results_;
+
     bool performHandshake();
     void setError(const std::string& error);
     void cleanup();
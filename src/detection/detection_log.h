@@ -0,0 +1,246 @@
+#pragma once
+
+/**
+ * @file detection_log.h
+ * @brief Append-only binary detection log with a sparse time index
+ *
+ * One session = two files, written by DetectionLogWriter and queried by
+ * DetectionLogReader (and the rv_detlog tool):
+ *
+ *   <name>.rvdl  data   LogFileHeader, then records:
+ *                       [u32 payload bytes][LogRecordHeader][LogBox x count]
+ *   <name>.rvdx  index  LogIndexHeader, then one LogIndexEntry per block
+ *                       (a block = the records of ~index_interval_ms)
+ *
+ * Each index entry stores its block's time span, byte range and a 64-bit
+ * label mask (one bit per label hash). A query binary-searches the index
+ * for the start time and skips every block whose mask cannot contain the
+ * label, so hours of flight are answered by touching a handful of pages.
+ * Records after the last indexed block (a crash, or the open block) are
+ * scanned directly. All integers are little-endian host order.
+ *
+ * TEACHING: Keep Logging Off the Hot Path
+ * ---------------------------------------
+ * The result thread only pushes a shared_ptr into a lock-free queue. A
+ * background thread serializes everything queued since the last flush
+ * and writes it with one sequential write() per file, so the disk sees a
+ * few large appends per second instead of one small write per result.
+ */
+
+#include "core/staged_pipeline.h"
+#include "detection/detection_log_config.h"
+#include "metrics/metrics.h"
+#include "util/bounded_queue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace robot_vision {
+
+// ============================================================================
+// File Format
+// ============================================================================
+
+constexpr char DETECTION_LOG_MAGIC[4] = {'R', 'V', 'D', 'L'};
+constexpr char DETECTION_INDEX_MAGIC[4] = {'R', 'V', 'D', 'X'};
+constexpr uint32_t DETECTION_LOG_VERSION = 1;
+
+struct LogFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t created_ns;            // Wall clock (Unix ns) when the session started
+    uint64_t reserved;
+};
+
+struct LogRecordHeader {
+    uint64_t frame_id;
+    uint64_t timestamp_ns;          // Wall clock (Unix ns) the results arrived
+    float inference_ms;
+    uint32_t count;                 // LogBox entries that follow
+};
+
+struct LogBox {
+    float x, y, width, height;      // Normalized 0..1
+    float confidence;
+    uint32_t class_id;
+    char label[32];
+};
+
+struct LogIndexHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t reserved;
+};
+
+struct LogIndexEntry {
+    uint64_t first_ns;              // Timestamp of the block's first record
+    uint64_t last_ns;               // Timestamp of the block's last record
+    uint64_t first_frame;
+    uint64_t offset;                // Data file byte range [offset, end_offset)
+    uint64_t end_offset;
+    uint64_t label_mask;            // Bit (hash(label) % 64) set for every label present
+};
+
+static_assert(sizeof(LogFileHeader) == 24, "LogFileHeader layout");
+static_assert(sizeof(LogRecordHeader) == 24, "LogRecordHeader layout");
+static_assert(sizeof(LogBox) == 56, "LogBox layout");
+static_assert(sizeof(LogIndexHeader) == 16, "LogIndexHeader layout");
+static_assert(sizeof(LogIndexEntry) == 48, "LogIndexEntry layout");
+
+/**
+ * Label mask bit for a label (FNV-1a hash)
+ */
+uint64_t detectionLabelBit(const char* label);
+
+// ============================================================================
+// Writer
+// ============================================================================
+
+/**
+ * Detection sink appending every result set to a session log
+ */
+class DetectionLogWriter : public IDetectionSink {
+public:
+    explicit DetectionLogWriter(const DetectionLogConfig& config);
+    ~DetectionLogWriter() override;
+
+    // Non-copyable (owns files and a thread)
+    DetectionLogWriter(const DetectionLogWriter&) = delete;
+    DetectionLogWriter& operator=(const DetectionLogWriter&) = delete;
+
+    /**
+     * Create the session files and start the writer thread
+     */
+    bool start();
+
+    /**
+     * Flush everything queued, close the files (idempotent)
+     */
+    void stop();
+
+    // IDetectionSink (result thread): one lock-free push
+    void consumeDetections(const std::shared_ptr<const DetectionSet>& results) override;
+
+    const std::string& path() const { return data_path_; }
+
+private:
+    void writerLoop();
+    void flush();
+    void closeBlock();
+    void writeIndex();
+    bool writeAll(int fd, const std::vector<uint8_t>& bytes);
+
+    DetectionLogConfig config_;
+    BoundedQueue<std::shared_ptr<const DetectionSet>> queue_;
+
+    std::string data_path_;
+    std::string index_path_;
+    int data_fd_ = -1;
+    int index_fd_ = -1;
+    int64_t wall_offset_ns_ = 0;        // Wall clock minus steady clock at start
+
+    // Writer thread only
+    std::vector<uint8_t> data_batch_;
+    std::vector<uint8_t> index_batch_;
+    uint64_t data_offset_ = 0;          // File offset of data_batch_[0]
+    uint64_t index_offset_ = 0;         // File offset of index_batch_[0]
+    LogIndexEntry block_{};
+    bool block_open_ = false;
+    bool failed_ = false;               // A data write failed: nothing more is logged
+    bool index_failed_ = false;         // An index write failed: data is logged unindexed
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    bool running_ = false;              // Guarded by wake_mutex_
+    std::thread thread_;
+
+    Counter& records_;
+    Counter& dropped_;
+    Counter& bytes_;
+};
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+/**
+ * One logged result set
+ */
+struct DetectionLogRecord {
+    uint64_t frame_id = 0;
+    uint64_t timestamp_ns = 0;          // Wall clock (Unix ns)
+    float inference_ms = 0.0f;
+    std::vector<LogBox> boxes;          // Only the boxes matching the query
+};
+
+/**
+ * Query parameters (all optional)
+ */
+struct DetectionLogQuery {
+    uint64_t start_ns = 0;              // Inclusive
+    uint64_t end_ns = UINT64_MAX;       // Inclusive
+    std::string label;                  // "" = any label
+    float min_confidence = 0.0f;
+};
+
+/**
+ * Memory-mapped, read-only view of one session log
+ *
+ * Safe to use on a log that is still being written: it sees whatever
+ * was flushed when open() was called.
+ */
+class DetectionLogReader {
+public:
+    DetectionLogReader() = default;
+    ~DetectionLogReader();
+
+    // Non-copyable (owns mappings)
+    DetectionLogReader(const DetectionLogReader&) = delete;
+    DetectionLogReader& operator=(const DetectionLogReader&) = delete;
+
+    /**
+     * Map a .rvdl file and its .rvdx index (the index is optional)
+     */
+    bool open(const std::string& data_path);
+    void close();
+
+    /**
+     * Visit matching records in time order
+     *
+     * @param visit Return false to stop early
+     * @return Number of records visited
+     */
+    size_t query(const DetectionLogQuery& query,
+                 const std::function<bool(const DetectionLogRecord&)>& visit) const;
+
+    uint64_t createdNs() const { return created_ns_; }
+    size_t indexEntries() const { return index_count_; }
+    size_t dataBytes() const { return data_size_; }
+    std::string getLastError() const { return last_error_; }
+
+private:
+    /**
+     * Scan records in [begin, end), stopping after end_ns
+     *
+     * @return false if the visitor asked to stop (or end_ns was passed)
+     */
+    bool scan(uint64_t begin, uint64_t end, const DetectionLogQuery& query,
+              const std::function<bool(const DetectionLogRecord&)>& visit, size_t& visited) const;
+
+    const uint8_t* data_ = nullptr;
+    size_t data_size_ = 0;
+    const LogIndexEntry* index_ = nullptr;
+    size_t index_count_ = 0;
+    void* index_map_ = nullptr;
+    size_t index_map_size_ = 0;
+    uint64_t created_ns_ = 0;
+    std::string last_error_;
+};
+
+} // namespace robot_vision
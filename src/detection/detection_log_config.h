@@ -0,0 +1,31 @@
+#pragma once
+
+/**
+ * @file detection_log_config.h
+ * @brief Detection log settings
+ */
+
+#include <cstddef>
+#include <string>
+
+namespace robot_vision {
+
+/**
+ * Detection log configuration
+ */
+struct DetectionLogConfig {
+    bool enabled = false;               // Log every detection result set
+    std::string directory = "detections";
+    size_t queue_depth = 256;           // Result sets buffered between flushes (drops when full)
+    int flush_interval_ms = 500;        // How often the writer appends to disk
+    int index_interval_ms = 1000;       // Time covered by one index entry
+
+    bool isValid() const {
+        return !directory.empty() &&
+               queue_depth >= 16 && queue_depth <= 65536 &&
+               flush_interval_ms >= 10 && flush_interval_ms <= 60000 &&
+               index_interval_ms >= 10;
+    }
+};
+
+} // namespace robot_vision
@@ -0,0 +1,215 @@
+/**
+ * @file detection_log_reader.cpp
+ * @brief mmap-based queries over the binary detection log
+ */
+
+#include "detection_log.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace robot_vision {
+
+namespace {
+
+/**
+ * Map a whole file read-only
+ *
+ * @return Mapping or nullptr (size 0 files are not mapped)
+ */
+void* mapFile(const std::string& path, size_t& size, std::string& error) {
+    size = 0;
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = path + ": " + std::strerror(errno);
+        return nullptr;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        error = path + ": empty or unreadable";
+        ::close(fd);
+        return nullptr;
+    }
+    void* map = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);    // The mapping keeps the file referenced
+    if (map == MAP_FAILED) {
+        error = path + ": mmap failed: " + std::strerror(errno);
+        return nullptr;
+    }
+    size = static_cast<size_t>(st.st_size);
+    return map;
+}
+
+} // namespace
+
+// ============================================================================
+// Open / Close
+// ============================================================================
+
+DetectionLogReader::~DetectionLogReader() {
+    close();
+}
+
+bool DetectionLogReader::open(const std::string& data_path) {
+    close();
+
+    void* data = mapFile(data_path, data_size_, last_error_);
+    if (!data) {
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(data);
+
+    LogFileHeader header{};
+    if (data_size_ < sizeof(header)) {
+        last_error_ = data_path + ": truncated header";
+        close();
+        return false;
+    }
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, DETECTION_LOG_MAGIC, 4) != 0 ||
+        header.version != DETECTION_LOG_VERSION) {
+        last_error_ = data_path + ": not a detection log (or unsupported version)";
+        close();
+        return false;
+    }
+    created_ns_ = header.created_ns;
+
+    // Index is optional: without it every query is a full scan
+    std::string index_path = data_path;
+    if (index_path.size() > 5 && index_path.compare(index_path.size() - 5, 5, ".rvdl") == 0) {
+        index_path.replace(index_path.size() - 5, 5, ".rvdx");
+        std::string ignored;
+        index_map_ = mapFile(index_path, index_map_size_, ignored);
+    }
+    if (index_map_) {
+        const auto* index_header = static_cast<const LogIndexHeader*>(index_map_);
+        if (index_map_size_ >= sizeof(LogIndexHeader) &&
+            std::memcmp(index_header->magic, DETECTION_INDEX_MAGIC, 4) == 0) {
+            index_ = reinterpret_cast<const LogIndexEntry*>(
+                static_cast<const uint8_t*>(index_map_) + sizeof(LogIndexHeader));
+            index_count_ = (index_map_size_ - sizeof(LogIndexHeader)) / sizeof(LogIndexEntry);
+
+            // Ignore entries describing data we cannot see (e.g. mapped mid-flush)
+            while (index_count_ > 0 && index_[index_count_ - 1].end_offset > data_size_) {
+                --index_count_;
+            }
+        }
+    }
+    return true;
+}
+
+void DetectionLogReader::close() {
+    if (data_) {
+        ::munmap(const_cast<uint8_t*>(data_), data_size_);
+        data_ = nullptr;
+    }
+    if (index_map_) {
+        ::munmap(index_map_, index_map_size_);
+        index_map_ = nullptr;
+    }
+    data_size_ = 0;
+    index_map_size_ = 0;
+    index_ = nullptr;
+    index_count_ = 0;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+size_t DetectionLogReader::query(const DetectionLogQuery& query,
+                                 const std::function<bool(const DetectionLogRecord&)>& visit) const {
+    size_t visited = 0;
+    if (!data_) {
+        return 0;
+    }
+
+    const bool by_label = !query.label.empty();
+    const uint64_t label_bit = by_label ? detectionLabelBit(query.label.c_str()) : 0;
+    uint64_t tail = sizeof(LogFileHeader);
+
+    if (index_count_ > 0) {
+        // First block that can still contain start_ns (blocks are in time order)
+        const LogIndexEntry* end = index_ + index_count_;
+        const LogIndexEntry* it = std::lower_bound(index_, end, query.start_ns,
+            [](const LogIndexEntry& e, uint64_t t) { return e.last_ns < t; });
+
+        for (; it != end; ++it) {
+            if (it->first_ns > query.end_ns) {
+                return visited;
+            }
+            if (by_label && (it->label_mask & label_bit) == 0) {
+                continue;   // Label cannot be in this block (blocks of empty sets have no bits)
+            }
+            if (!scan(it->offset, it->end_offset, query, visit, visited)) {
+                return visited;
+            }
+        }
+        tail = index_[index_count_ - 1].end_offset;
+    }
+
+    // Records not covered by the index (open block, or the writer crashed)
+    scan(tail, data_size_, query, visit, visited);
+    return visited;
+}
+
+bool DetectionLogReader::scan(uint64_t begin, uint64_t end, const DetectionLogQuery& query,
+                              const std::function<bool(const DetectionLogRecord&)>& visit,
+                              size_t& visited) const {
+    DetectionLogRecord out;
+    const bool filtered = !query.label.empty() || query.min_confidence > 0.0f;
+    uint64_t pos = begin;
+    end = std::min<uint64_t>(end, data_size_);
+
+    while (pos + sizeof(uint32_t) + sizeof(LogRecordHeader) <= end) {
+        uint32_t payload = 0;
+        std::memcpy(&payload, data_ + pos, sizeof(payload));
+        LogRecordHeader record{};
+        std::memcpy(&record, data_ + pos + sizeof(payload), sizeof(record));
+        uint64_t next = pos + sizeof(payload) + payload;
+        if (payload < sizeof(LogRecordHeader) ||
+            payload != sizeof(LogRecordHeader) + static_cast<uint64_t>(record.count) * sizeof(LogBox) ||
+            next > end) {
+            break;      // Torn tail record
+        }
+
+        if (record.timestamp_ns > query.end_ns) {
+            return false;
+        }
+        if (record.timestamp_ns >= query.start_ns) {
+            out.frame_id = record.frame_id;
+            out.timestamp_ns = record.timestamp_ns;
+            out.inference_ms = record.inference_ms;
+            out.boxes.clear();
+
+            const uint8_t* boxes = data_ + pos + sizeof(payload) + sizeof(LogRecordHeader);
+            for (uint32_t i = 0; i < record.count; ++i) {
+                LogBox box;
+                std::memcpy(&box, boxes + i * sizeof(LogBox), sizeof(LogBox));
+                box.label[sizeof(box.label) - 1] = '\0';
+                if (box.confidence >= query.min_confidence &&
+                    (query.label.empty() || query.label == box.label)) {
+                    out.boxes.push_back(box);
+                }
+            }
+
+            // A filter asks "when was X seen": skip records with no matching box
+            if (!filtered || !out.boxes.empty()) {
+                ++visited;
+                if (!visit(out)) {
+                    return false;
+                }
+            }
+        }
+        pos = next;
+    }
+    return true;
+}
+
+} // namespace robot_vision
@@ -0,0 +1,326 @@
+/**
+ * @file detection_log_writer.cpp
+ * @brief Background batching writer for the binary detection log
+ */
+
+#include "detection_log.h"
+#include "util/logger.h"
+#include "trace/trace.h"
+#include "util/file_util.h"
+#include "util/thread_policy.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace robot_vision {
+
+namespace {
+
+int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t wallNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+template <typename T>
+void appendPod(std::vector<uint8_t>& out, const T& value) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+} // namespace
+
+uint64_t detectionLabelBit(const char* label) {
+    uint64_t hash = 1469598103934665603ull;
+    for (const char* p = label; *p; ++p) {
+        hash = (hash ^ static_cast<uint8_t>(*p)) * 1099511628211ull;
+    }
+    return 1ull << (hash % 64);
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+DetectionLogWriter::DetectionLogWriter(const DetectionLogConfig& config)
+    : config_(config)
+    , queue_(config.queue_depth)
+    , records_(MetricsRegistry::global().counter("rv_detection_log_records_total",
+                                                 "Result sets written to the detection log"))
+    , dropped_(MetricsRegistry::global().counter("rv_detection_log_dropped_total",
+                                                 "Result sets lost (log queue full, or logging stopped by a write error)"))
+    , bytes_(MetricsRegistry::global().counter("rv_detection_log_bytes_total",
+                                               "Bytes appended to the detection log"))
+{
+}
+
+DetectionLogWriter::~DetectionLogWriter() {
+    stop();
+}
+
+bool DetectionLogWriter::start() {
+    if (data_fd_ >= 0) {
+        return true;
+    }
+    if (!makeDirectories(config_.directory)) {
+        RV_LOG_ERROR("detlog", "Cannot create detection log directory {}: {}",
+                     config_.directory, std::strerror(errno));
+        return false;
+    }
+
+    std::string base = config_.directory + "/det_" + wallTimestamp();
+    data_path_ = base + ".rvdl";
+    index_path_ = base + ".rvdx";
+    data_fd_ = ::open(data_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    index_fd_ = ::open(index_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (data_fd_ < 0 || index_fd_ < 0) {
+        RV_LOG_ERROR("detlog", "Cannot create detection log {}: {}", base, std::strerror(errno));
+        stop();
+        return false;
+    }
+
+    /**
+     * TEACHING: One Monotonic Wall Clock
+     * ----------------------------------
+     * Records carry wall-clock times (so a query can say "14:02 to 14:05"),
+     * but the system clock can step backwards under NTP. We sample the
+     * wall/steady offset once and stamp records with steady + offset: the
+     * timestamps stay monotonic and the index stays binary-searchable.
+     */
+    wall_offset_ns_ = wallNowNs() - steadyNowNs();
+
+    LogFileHeader header{};
+    std::memcpy(header.magic, DETECTION_LOG_MAGIC, 4);
+    header.version = DETECTION_LOG_VERSION;
+    header.created_ns = static_cast<uint64_t>(wallNowNs());
+    LogIndexHeader index_header{};
+    std::memcpy(index_header.magic, DETECTION_INDEX_MAGIC, 4);
+    index_header.version = DETECTION_LOG_VERSION;
+
+    data_batch_.clear();
+    appendPod(data_batch_, header);
+    index_batch_.clear();
+    appendPod(index_batch_, index_header);
+    data_offset_ = 0;
+    index_offset_ = 0;
+    block_open_ = false;
+    failed_ = false;
+    index_failed_ = false;
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        running_ = true;
+    }
+    thread_ = std::thread(&DetectionLogWriter::writerLoop, this);
+
+    RV_LOG_INFO("detlog", "Detection log: {}", data_path_);
+    return true;
+}
+
+void DetectionLogWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        running_ = false;
+    }
+    wake_cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();     // Final flush happens on the writer thread
+    }
+    if (data_fd_ >= 0) {
+        ::close(data_fd_);
+        data_fd_ = -1;
+    }
+    if (index_fd_ >= 0) {
+        ::close(index_fd_);
+        index_fd_ = -1;
+    }
+}
+
+// ============================================================================
+// Hot Path (result thread)
+// ============================================================================
+
+void DetectionLogWriter::consumeDetections(const std::shared_ptr<const DetectionSet>& results) {
+    auto copy = results;
+    if (!queue_.tryPush(std::move(copy))) {
+        dropped_.inc();
+    }
+}
+
+// ============================================================================
+// Writer Thread
+// ============================================================================
+
+void DetectionLogWriter::writerLoop() {
+#ifdef PLATFORM_MACOS
+    pthread_setname_np("rv-detlog");
+#else
+    pthread_setname_np(pthread_self(), "rv-detlog");
+#endif
+    ScopedThreadRole thread_role("background");
+
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    while (running_) {
+        wake_cv_.wait_for(lock, std::chrono::milliseconds(config_.flush_interval_ms),
+                          [this] { return !running_; });
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+    lock.unlock();
+
+    // Final flush: drain the queue and index the open block
+    flush();
+    if (block_open_) {
+        closeBlock();
+    }
+    writeIndex();
+}
+
+void DetectionLogWriter::flush() {
+    TRACE_SCOPE("detectionLogFlush");
+    const uint64_t index_interval_ns = static_cast<uint64_t>(config_.index_interval_ms) * 1000000ull;
+
+    std::shared_ptr<const DetectionSet> results;
+    if (failed_) {
+        while (queue_.tryPop(results)) {
+            dropped_.inc();
+        }
+        return;
+    }
+
+    // Index state matching the data already on disk, to fall back to if this batch fails
+    const size_t index_mark = index_batch_.size();
+    const LogIndexEntry block_mark = block_;
+    const bool block_open_mark = block_open_;
+    uint64_t batch_records = 0;
+
+    while (queue_.tryPop(results)) {
+        LogRecordHeader record{};
+        record.frame_id = results->frame_id;
+        record.timestamp_ns = static_cast<uint64_t>(
+            static_cast<int64_t>(results->received_ns) + wall_offset_ns_);
+        record.inference_ms = results->inference_time_ms;
+        record.count = static_cast<uint32_t>(results->detections.size());
+
+        uint64_t offset = data_offset_ + data_batch_.size();
+        if (block_open_ && record.timestamp_ns - block_.first_ns >= index_interval_ns) {
+            closeBlock();
+        }
+        if (!block_open_) {
+            block_ = LogIndexEntry{};
+            block_.first_ns = record.timestamp_ns;
+            block_.first_frame = record.frame_id;
+            block_.offset = offset;
+            block_open_ = true;
+        }
+
+        uint32_t payload = static_cast<uint32_t>(sizeof(LogRecordHeader) + record.count * sizeof(LogBox));
+        appendPod(data_batch_, payload);
+        appendPod(data_batch_, record);
+        for (const auto& det : results->detections) {
+            LogBox box{};
+            box.x = det.x;
+            box.y = det.y;
+            box.width = det.width;
+            box.height = det.height;
+            box.confidence = det.confidence;
+            box.class_id = det.class_id;
+            std::strncpy(box.label, det.label, sizeof(box.label) - 1);
+            appendPod(data_batch_, box);
+            block_.label_mask |= detectionLabelBit(box.label);
+        }
+
+        block_.last_ns = record.timestamp_ns;
+        block_.end_offset = data_offset_ + data_batch_.size();
+        ++batch_records;
+    }
+
+    // Data before index, so an index entry never points past the data
+    if (!data_batch_.empty()) {
+        if (!writeAll(data_fd_, data_batch_)) {
+            /**
+             * A failed or partial write leaves the file at an unknown size,
+             * so every later offset would be wrong. Cut it back to the last
+             * whole batch, index up to there, and stop logging.
+             */
+            if (::ftruncate(data_fd_, static_cast<off_t>(data_offset_)) != 0) {
+                RV_LOG_WARN("detlog", "Cannot truncate {}: {}", data_path_, std::strerror(errno));
+            }
+            index_batch_.resize(index_mark);
+            block_ = block_mark;
+            block_open_ = block_open_mark;
+            if (block_open_) {
+                closeBlock();
+            }
+            writeIndex();
+            data_batch_.clear();
+            dropped_.inc(batch_records);
+            failed_ = true;
+            RV_LOG_ERROR("detlog", "Detection logging stopped; {} is complete up to byte {}",
+                         data_path_, data_offset_);
+            return;
+        }
+        bytes_.inc(data_batch_.size());
+        records_.inc(batch_records);
+        data_offset_ += data_batch_.size();
+        data_batch_.clear();
+    }
+    writeIndex();
+}
+
+void DetectionLogWriter::closeBlock() {
+    appendPod(index_batch_, block_);
+    block_open_ = false;
+}
+
+void DetectionLogWriter::writeIndex() {
+    if (index_batch_.empty() || index_failed_) {
+        index_batch_.clear();
+        return;
+    }
+    if (!writeAll(index_fd_, index_batch_)) {
+        /**
+         * A partial entry would shift every later one. Cut the index back
+         * to the last whole batch and stop indexing: readers scan the
+         * records after the last entry, so the data stays queryable.
+         */
+        if (::ftruncate(index_fd_, static_cast<off_t>(index_offset_)) != 0) {
+            RV_LOG_WARN("detlog", "Cannot truncate {}: {}", index_path_, std::strerror(errno));
+        }
+        index_failed_ = true;
+        RV_LOG_ERROR("detlog", "Detection log index stopped; {} is complete up to byte {}",
+                     index_path_, index_offset_);
+    } else {
+        index_offset_ += index_batch_.size();
+    }
+    index_batch_.clear();
+}
+
+bool DetectionLogWriter::writeAll(int fd, const std::vector<uint8_t>& bytes) {
+    size_t done = 0;
+    while (done < bytes.size()) {
+        ssize_t n = ::write(fd, bytes.data() + done, bytes.size() - done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            RV_LOG_WARN("detlog", "Detection log write failed: {}", std::strerror(errno));
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace robot_vision
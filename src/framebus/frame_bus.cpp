@@ -0,0 +1,685 @@
+/**
+ * @file frame_bus.cpp
+ * @brief Shared-memory frame ring, control socket and reader client
+ */
+
+#include "frame_bus.h"
+#include "trace/trace.h"
+#include "util/logger.h"
+#include "util/thread_policy.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+namespace robot_vision {
+
+namespace {
+
+// Longest the control thread sleeps in poll() before re-checking running_
+constexpr int POLL_SLICE_MS = 200;
+
+// How long connect() waits for the publisher's OK line
+constexpr int HELLO_TIMEOUT_MS = 2000;
+
+// Longest HELLO line accepted
+constexpr size_t MAX_HELLO_BYTES = 256;
+
+constexpr size_t PAGE_BYTES = 4096;
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;       // SIGPIPE is ignored process-wide (main.cpp)
+#endif
+
+size_t roundUp(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+void setNonBlocking(int fd) {
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+bool fillUnixAddress(const std::string& path, sockaddr_un& addr) {
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    addr = sockaddr_un{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    return true;
+}
+
+/**
+ * Reader names end up in metric labels: keep [A-Za-z0-9_.-]
+ */
+std::string sanitizeName(const std::string& name) {
+    std::string out;
+    for (char c : name) {
+        if (out.size() >= 31) {
+            break;
+        }
+        if (std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || c == '-') {
+            out += c;
+        }
+    }
+    return out.empty() ? "reader" : out;
+}
+
+} // namespace
+
+// ============================================================================
+// Publisher Lifecycle
+// ============================================================================
+
+FrameBusPublisher::FrameBusPublisher(const FrameBusConfig& config)
+    : config_(config)
+    , published_(MetricsRegistry::global().counter("rv_framebus_frames_published_total",
+                                                   "Frames published on the shared-memory bus"))
+    , dropped_(MetricsRegistry::global().counter("rv_framebus_frames_dropped_total",
+                                                 "Frames not published (every slot held, or too large)"))
+    , readers_gauge_(MetricsRegistry::global().gauge("rv_framebus_readers", "Processes reading the frame bus"))
+{
+}
+
+FrameBusPublisher::~FrameBusPublisher() {
+    stop();
+}
+
+bool FrameBusPublisher::start() {
+    if (running_) {
+        return true;
+    }
+    if (!config_.isValid()) {
+        setError("Invalid frame bus configuration");
+        return false;
+    }
+    if (!createSharedMemory()) {
+        return false;
+    }
+    if (!openControlSocket()) {
+        ::munmap(base_, map_bytes_);
+        ::shm_unlink(config_.shm_name.c_str());
+        base_ = nullptr;
+        return false;
+    }
+
+    collector_id_ = MetricsRegistry::global().addCollector([this]() { collect(); });
+    running_ = true;
+    thread_ = std::thread(&FrameBusPublisher::controlLoop, this);
+    RV_LOG_INFO("framebus", "Frame bus: {} ({} slots of {}x{}), readers connect to {}",
+                config_.shm_name, config_.slots, config_.max_width, config_.max_height,
+                config_.socket_path);
+    return true;
+}
+
+void FrameBusPublisher::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    MetricsRegistry::global().removeCollector(collector_id_);
+    collector_id_ = -1;
+
+    {
+        std::lock_guard<std::mutex> lock(readers_mutex_);
+        for (auto& reader : readers_) {
+            ::close(reader.fd);     // Readers see EOF: publisher gone
+        }
+        readers_.clear();
+    }
+    active_readers_ = 0;
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        ::unlink(config_.socket_path.c_str());
+    }
+
+    // Readers keep their mapping until they unmap; unlinking only removes the name
+    if (base_) {
+        ::munmap(base_, map_bytes_);
+        base_ = nullptr;
+        ::shm_unlink(config_.shm_name.c_str());
+    }
+}
+
+bool FrameBusPublisher::createSharedMemory() {
+    const size_t slot_bytes = static_cast<size_t>(config_.max_width) * config_.max_height * 3;
+    const size_t slot_stride = roundUp(slot_bytes, PAGE_BYTES);
+    const size_t entries_offset = sizeof(FrameBusHeader);
+    const size_t slots_offset = entries_offset + sizeof(FrameBusReaderEntry) * config_.max_readers;
+    const size_t pixels_offset = roundUp(slots_offset + sizeof(FrameBusSlot) * config_.slots, PAGE_BYTES);
+    map_bytes_ = pixels_offset + slot_stride * config_.slots;
+
+    ::shm_unlink(config_.shm_name.c_str());     // Stale bus from a previous run
+    int fd = ::shm_open(config_.shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+        setError("shm_open(" + config_.shm_name + ") failed: " + std::strerror(errno));
+        return false;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(map_bytes_)) != 0) {
+        setError(std::string("ftruncate() failed: ") + std::strerror(errno));
+        ::close(fd);
+        ::shm_unlink(config_.shm_name.c_str());
+        return false;
+    }
+    void* map = ::mmap(nullptr, map_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);    // The mapping keeps the object alive
+    if (map == MAP_FAILED) {
+        setError(std::string("mmap() failed: ") + std::strerror(errno));
+        ::shm_unlink(config_.shm_name.c_str());
+        return false;
+    }
+    base_ = static_cast<uint8_t*>(map);
+
+    // Fresh pages are zero; construct the atomics in place anyway
+    header_ = new (base_) FrameBusHeader();
+    std::memcpy(header_->magic, FRAME_BUS_MAGIC, sizeof(FRAME_BUS_MAGIC));
+    header_->version = FRAME_BUS_VERSION;
+    header_->slot_count = static_cast<uint32_t>(config_.slots);
+    header_->max_readers = static_cast<uint32_t>(config_.max_readers);
+    header_->slot_bytes = slot_bytes;
+    header_->slot_stride = slot_stride;
+    header_->pixels_offset = pixels_offset;
+    header_->total_bytes = map_bytes_;
+    header_->publisher_pid = static_cast<int32_t>(::getpid());
+    header_->write_seq.store(0, std::memory_order_relaxed);
+
+    entries_ = reinterpret_cast<FrameBusReaderEntry*>(base_ + entries_offset);
+    for (int i = 0; i < config_.max_readers; ++i) {
+        new (&entries_[i]) FrameBusReaderEntry();
+        entries_[i].active.store(0, std::memory_order_relaxed);
+    }
+    slots_ = reinterpret_cast<FrameBusSlot*>(base_ + slots_offset);
+    for (int i = 0; i < config_.slots; ++i) {
+        new (&slots_[i]) FrameBusSlot();
+        slots_[i].owners.store(0, std::memory_order_relaxed);
+        slots_[i].seq.store(0, std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    return true;
+}
+
+bool FrameBusPublisher::openControlSocket() {
+    sockaddr_un addr;
+    if (!fillUnixAddress(config_.socket_path, addr)) {
+        setError("Invalid frame bus socket path: " + config_.socket_path);
+        return false;
+    }
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        setError(std::string("socket() failed: ") + std::strerror(errno));
+        return false;
+    }
+    ::unlink(config_.socket_path.c_str());     // Stale socket from a previous run
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listen_fd_, 8) < 0) {
+        setError("Cannot listen on " + config_.socket_path + ": " + std::strerror(errno));
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    setNonBlocking(listen_fd_);
+    return true;
+}
+
+// ============================================================================
+// Record Thread
+// ============================================================================
+
+void FrameBusPublisher::consumeFrame(const std::shared_ptr<FrameData>& frame) {
+    if (!frame || !base_ || active_readers_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    const size_t bytes = frame->getPixelBufferSize();
+    if (bytes > header_->slot_bytes || frame->pixels.size() < bytes) {
+        if (!warned_size_) {
+            RV_LOG_WARN("framebus", "Frame {}x{} exceeds bus slots ({}x{}); not published",
+                        frame->width, frame->height, config_.max_width, config_.max_height);
+            warned_size_ = true;
+        }
+        dropped_.inc();
+        return;
+    }
+
+    TRACE_SCOPE("framebusPublish");
+
+    // Claim the next slot nobody holds (oldest first, so readers keep recent frames)
+    const uint32_t count = header_->slot_count;
+    FrameBusSlot* slot = nullptr;
+    uint32_t index = 0;
+    for (uint32_t k = 0; k < count && !slot; ++k) {
+        index = (next_slot_ + k) % count;
+        uint64_t expected = 0;
+        if (slots_[index].owners.compare_exchange_strong(expected, FRAME_BUS_WRITER_BIT,
+                                                         std::memory_order_acquire,
+                                                         std::memory_order_relaxed)) {
+            slot = &slots_[index];
+        }
+    }
+    if (!slot) {
+        dropped_.inc();     // Every slot pinned by readers: never wait for them
+        return;
+    }
+    next_slot_ = (index + 1) % count;
+
+    const uint64_t seq = header_->write_seq.load(std::memory_order_relaxed) + 1;
+    slot->seq.store(0, std::memory_order_relaxed);
+    slot->frame_id = frame->frame_number;
+    slot->timestamp_ns = frame->timestamp_ns;
+    slot->capture_time_ns = frame->capture_time_ns;
+    slot->width = static_cast<uint32_t>(frame->width);
+    slot->height = static_cast<uint32_t>(frame->height);
+    slot->stride = static_cast<uint32_t>(frame->width) * 3;
+    slot->format = 0;
+    std::memcpy(base_ + header_->pixels_offset + header_->slot_stride * index, frame->pixels.data(), bytes);
+    slot->seq.store(seq, std::memory_order_relaxed);
+
+    // Clear only the writer bit: a reader that tried meanwhile clears its own
+    slot->owners.fetch_and(~FRAME_BUS_WRITER_BIT, std::memory_order_release);
+    header_->write_seq.store(seq, std::memory_order_release);
+    published_.inc();
+
+    // Doorbells: a reader that hasn't drained earlier ones is behind anyway
+    std::lock_guard<std::mutex> lock(readers_mutex_);
+    for (const auto& reader : readers_) {
+        if (reader.index >= 0) {
+            ::send(reader.fd, "F", 1, MSG_DONTWAIT | SEND_FLAGS);
+        }
+    }
+}
+
+// ============================================================================
+// Control Thread
+// ============================================================================
+
+void FrameBusPublisher::controlLoop() {
+#ifdef PLATFORM_MACOS
+    pthread_setname_np("rv-framebus");
+#else
+    pthread_setname_np(pthread_self(), "rv-framebus");
+#endif
+    ScopedThreadRole thread_role("background");
+
+    std::vector<pollfd> fds;
+    while (running_.load(std::memory_order_relaxed)) {
+        // readers_ only changes on this thread: reading it unlocked is safe here
+        fds.clear();
+        fds.push_back(pollfd{listen_fd_, POLLIN, 0});
+        for (const auto& reader : readers_) {
+            fds.push_back(pollfd{reader.fd, POLLIN, 0});
+        }
+        if (::poll(fds.data(), fds.size(), POLL_SLICE_MS) <= 0) {
+            continue;
+        }
+
+        for (size_t i = 0; i < readers_.size(); ++i) {
+            Reader& reader = readers_[i];
+            short revents = fds[i + 1].revents;
+            if (!(revents & (POLLIN | POLLERR | POLLHUP))) {
+                continue;
+            }
+            char buf[256];
+            ssize_t n = ::recv(reader.fd, buf, sizeof(buf), MSG_DONTWAIT);
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                dropReader(reader);
+                continue;
+            }
+            if (n < 0 || reader.index >= 0) {
+                continue;   // Registered readers have nothing more to say
+            }
+            reader.request.append(buf, static_cast<size_t>(n));
+            if (reader.request.find('\n') != std::string::npos) {
+                if (!handleHello(reader)) {
+                    dropReader(reader);
+                }
+            } else if (reader.request.size() > MAX_HELLO_BYTES) {
+                dropReader(reader);
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int fd;
+            while ((fd = ::accept(listen_fd_, nullptr, nullptr)) >= 0) {
+                setNonBlocking(fd);
+                Reader reader;
+                reader.fd = fd;
+                std::lock_guard<std::mutex> lock(readers_mutex_);
+                readers_.push_back(std::move(reader));
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(readers_mutex_);
+        readers_.erase(std::remove_if(readers_.begin(), readers_.end(),
+                                      [](const Reader& r) { return r.fd < 0; }),
+                       readers_.end());
+    }
+}
+
+bool FrameBusPublisher::handleHello(Reader& reader) {
+    std::string line = reader.request.substr(0, reader.request.find('\n'));
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+    if (line.compare(0, 6, "HELLO ") != 0) {
+        ::send(reader.fd, "ERR expected HELLO <name>\n", 26, SEND_FLAGS);
+        return false;
+    }
+    std::string name = sanitizeName(line.substr(6));
+
+    int index = -1;
+    for (int i = 0; i < config_.max_readers; ++i) {
+        if (entries_[i].active.load(std::memory_order_acquire) == 0) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) {
+        RV_LOG_WARN("framebus", "Frame bus full ({} readers), refused {}", config_.max_readers, name);
+        ::send(reader.fd, "ERR full\n", 9, SEND_FLAGS);
+        return false;
+    }
+
+    FrameBusReaderEntry& entry = entries_[index];
+    int32_t pid = 0;
+#ifdef SO_PEERCRED
+    ucred cred{};
+    socklen_t cred_len = sizeof(cred);
+    if (::getsockopt(reader.fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) == 0) {
+        pid = cred.pid;
+    }
+#endif
+    entry.pid = pid;
+    std::memset(entry.name, 0, sizeof(entry.name));
+    std::memcpy(entry.name, name.data(), name.size());
+    entry.read_seq.store(header_->write_seq.load(std::memory_order_acquire), std::memory_order_relaxed);
+    entry.skipped.store(0, std::memory_order_relaxed);
+    entry.active.store(1, std::memory_order_release);
+
+    // OK before the first doorbell: the index is published only after it is sent
+    std::string ok = "OK shm=" + config_.shm_name + " reader=" + std::to_string(index) +
+                     " version=" + std::to_string(FRAME_BUS_VERSION) + "\n";
+    if (::send(reader.fd, ok.data(), ok.size(), SEND_FLAGS) != static_cast<ssize_t>(ok.size())) {
+        entry.active.store(0, std::memory_order_release);
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(readers_mutex_);
+        reader.index = index;
+        reader.request.clear();
+    }
+    active_readers_.fetch_add(1, std::memory_order_relaxed);
+    RV_LOG_INFO("framebus", "Reader {} connected (pid {}, slot {})", name, pid, index);
+    return true;
+}
+
+void FrameBusPublisher::dropReader(Reader& reader) {
+    std::lock_guard<std::mutex> lock(readers_mutex_);
+    if (reader.index >= 0) {
+        // Release whatever it still held - exact, whether it exited or crashed
+        const uint64_t bit = 1ull << reader.index;
+        for (uint32_t i = 0; i < header_->slot_count; ++i) {
+            slots_[i].owners.fetch_and(~bit, std::memory_order_release);
+        }
+        FrameBusReaderEntry& entry = entries_[reader.index];
+        RV_LOG_INFO("framebus", "Reader {} disconnected ({} frames skipped)", entry.name,
+                    entry.skipped.load(std::memory_order_relaxed));
+        entry.active.store(0, std::memory_order_release);
+        active_readers_.fetch_sub(1, std::memory_order_relaxed);
+        reader.index = -1;
+    }
+    ::close(reader.fd);
+    reader.fd = -1;
+}
+
+void FrameBusPublisher::collect() {
+    if (!base_) {
+        return;
+    }
+    const uint64_t write_seq = header_->write_seq.load(std::memory_order_acquire);
+    int active = 0;
+    for (int i = 0; i < config_.max_readers; ++i) {
+        const FrameBusReaderEntry& entry = entries_[i];
+        if (entry.active.load(std::memory_order_acquire) == 0) {
+            continue;
+        }
+        ++active;
+        std::string labels = std::string("reader=\"") + entry.name + "\"";
+        const uint64_t read_seq = entry.read_seq.load(std::memory_order_relaxed);
+        MetricsRegistry::global()
+            .gauge("rv_framebus_reader_lag_frames", "Frames published since the reader last took one", labels)
+            .set(write_seq > read_seq ? static_cast<double>(write_seq - read_seq) : 0.0);
+        MetricsRegistry::global()
+            .counter("rv_framebus_reader_skipped_total", "Frames a reader never took (too slow)", labels)
+            .set(entry.skipped.load(std::memory_order_relaxed));
+    }
+    readers_gauge_.set(static_cast<double>(active));
+}
+
+void FrameBusPublisher::setError(const std::string& error) {
+    last_error_ = error;
+    RV_LOG_ERROR("framebus", "{}", error);
+}
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+FrameBusReader::~FrameBusReader() {
+    disconnect();
+}
+
+bool FrameBusReader::connect(const std::string& socket_path, const std::string& name) {
+    disconnect();
+
+    sockaddr_un addr;
+    if (!fillUnixAddress(socket_path, addr)) {
+        setError("Invalid frame bus socket path: " + socket_path);
+        return false;
+    }
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0 || ::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        setError("Cannot connect to " + socket_path + ": " + std::strerror(errno));
+        disconnect();
+        return false;
+    }
+
+    std::string hello = "HELLO " + name + "\n";
+    if (::send(fd_, hello.data(), hello.size(), SEND_FLAGS) != static_cast<ssize_t>(hello.size())) {
+        setError(std::string("send() failed: ") + std::strerror(errno));
+        disconnect();
+        return false;
+    }
+
+    // One line back; doorbells may follow it in the same read
+    std::string reply;
+    while (reply.find('\n') == std::string::npos) {
+        pollfd pfd{fd_, POLLIN, 0};
+        char c;
+        if (::poll(&pfd, 1, HELLO_TIMEOUT_MS) <= 0 || ::recv(fd_, &c, 1, 0) != 1) {
+            setError("No reply from the frame bus publisher");
+            disconnect();
+            return false;
+        }
+        reply += c;
+    }
+
+    char shm_name[128] = {0};
+    unsigned version = 0;
+    if (std::sscanf(reply.c_str(), "OK shm=%127s reader=%d version=%u", shm_name, &index_, &version) != 3) {
+        setError("Frame bus refused: " + reply.substr(0, reply.size() - 1));
+        disconnect();
+        return false;
+    }
+    if (version != FRAME_BUS_VERSION) {
+        setError("Frame bus version " + std::to_string(version) + ", expected " +
+                 std::to_string(FRAME_BUS_VERSION));
+        disconnect();
+        return false;
+    }
+
+    int shm_fd = ::shm_open(shm_name, O_RDWR, 0);
+    struct stat st{};
+    if (shm_fd < 0 || ::fstat(shm_fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FrameBusHeader)) {
+        setError(std::string("Cannot open ") + shm_name + ": " + std::strerror(errno));
+        if (shm_fd >= 0) {
+            ::close(shm_fd);
+        }
+        disconnect();
+        return false;
+    }
+    map_bytes_ = static_cast<size_t>(st.st_size);
+    void* map = ::mmap(nullptr, map_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    ::close(shm_fd);
+    if (map == MAP_FAILED) {
+        setError(std::string("mmap() failed: ") + std::strerror(errno));
+        disconnect();
+        return false;
+    }
+    base_ = static_cast<uint8_t*>(map);
+    header_ = reinterpret_cast<const FrameBusHeader*>(base_);
+    if (std::memcmp(header_->magic, FRAME_BUS_MAGIC, sizeof(FRAME_BUS_MAGIC)) != 0 ||
+        header_->total_bytes != map_bytes_ || index_ < 0 ||
+        static_cast<uint32_t>(index_) >= header_->max_readers) {
+        setError(std::string("Not a frame bus: ") + shm_name);
+        disconnect();
+        return false;
+    }
+    auto* entries = reinterpret_cast<FrameBusReaderEntry*>(base_ + sizeof(FrameBusHeader));
+    entry_ = &entries[index_];
+    slots_ = reinterpret_cast<FrameBusSlot*>(entries + header_->max_readers);
+    last_seq_ = entry_->read_seq.load(std::memory_order_relaxed);
+
+    setNonBlocking(fd_);
+    return true;
+}
+
+void FrameBusReader::disconnect() {
+    if (base_) {
+        if (slots_) {
+            const uint64_t bit = 1ull << index_;
+            for (uint32_t i = 0; i < header_->slot_count; ++i) {
+                slots_[i].owners.fetch_and(~bit, std::memory_order_release);
+            }
+        }
+        ::munmap(base_, map_bytes_);
+    }
+    base_ = nullptr;
+    header_ = nullptr;
+    entry_ = nullptr;
+    slots_ = nullptr;
+    index_ = -1;
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool FrameBusReader::next(FrameBusView& view, int timeout_ms, bool latest) {
+    if (!base_) {
+        setError("Not connected");
+        return false;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        // Drain doorbells first: a frame published after this rings again
+        char buf[256];
+        ssize_t n;
+        while ((n = ::recv(fd_, buf, sizeof(buf), MSG_DONTWAIT)) > 0) {
+        }
+        if (n == 0) {
+            setError("Frame bus publisher went away");
+            return false;
+        }
+
+        if (tryTake(view, latest)) {
+            return true;
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+            return false;
+        }
+        pollfd pfd{fd_, POLLIN, 0};
+        ::poll(&pfd, 1, static_cast<int>(remaining));
+    }
+}
+
+bool FrameBusReader::tryTake(FrameBusView& view, bool latest) {
+    if (header_->write_seq.load(std::memory_order_acquire) <= last_seq_) {
+        return false;
+    }
+    const uint64_t bit = 1ull << index_;
+
+    // A slot can be rewritten between choosing and claiming it: retry a few times
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        int best = -1;
+        uint64_t best_seq = 0;
+        for (uint32_t i = 0; i < header_->slot_count; ++i) {
+            uint64_t seq = slots_[i].seq.load(std::memory_order_acquire);
+            if (seq > last_seq_ && (best < 0 || (latest ? seq > best_seq : seq < best_seq))) {
+                best = static_cast<int>(i);
+                best_seq = seq;
+            }
+        }
+        if (best < 0) {
+            return false;
+        }
+
+        FrameBusSlot& slot = slots_[best];
+        uint64_t prev = slot.owners.fetch_or(bit, std::memory_order_acquire);
+        if ((prev & FRAME_BUS_WRITER_BIT) || slot.seq.load(std::memory_order_acquire) != best_seq) {
+            slot.owners.fetch_and(~bit, std::memory_order_release);
+            continue;
+        }
+
+        view.pixels = base_ + header_->pixels_offset + header_->slot_stride * best;
+        view.width = slot.width;
+        view.height = slot.height;
+        view.stride = slot.stride;
+        view.frame_id = slot.frame_id;
+        view.timestamp_ns = slot.timestamp_ns;
+        view.capture_time_ns = slot.capture_time_ns;
+        view.seq = best_seq;
+        view.slot = best;
+
+        if (best_seq > last_seq_ + 1) {
+            entry_->skipped.fetch_add(best_seq - last_seq_ - 1, std::memory_order_relaxed);
+        }
+        last_seq_ = best_seq;
+        entry_->read_seq.store(best_seq, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void FrameBusReader::release(FrameBusView& view) {
+    if (base_ && view.slot >= 0 && static_cast<uint32_t>(view.slot) < header_->slot_count) {
+        slots_[view.slot].owners.fetch_and(~(1ull << index_), std::memory_order_release);
+    }
+    view.slot = -1;
+    view.pixels = nullptr;
+}
+
+uint64_t FrameBusReader::skipped() const {
+    return entry_ ? entry_->skipped.load(std::memory_order_relaxed) : 0;
+}
+
+} // namespace robot_vision
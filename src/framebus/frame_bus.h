@@ -0,0 +1,263 @@
+#pragma once
+
+/**
+ * @file frame_bus.h
+ * @brief Shared-memory publish/subscribe frame bus for local processes
+ *
+ * The application publishes every captured frame once into a ring of
+ * slots in POSIX shared memory; any number of local processes (logger,
+ * segmentation, mapping, rv_framebus) map the same memory and read frames
+ * in place, without opening the camera or decoding a stream themselves.
+ *
+ *   /dev/shm/<shm_name>
+ *     FrameBusHeader                       magic, geometry, write_seq
+ *     FrameBusReaderEntry x max_readers    per-reader read_seq / skipped
+ *     FrameBusSlot x slots                 seq, owners mask, frame metadata
+ *     (page aligned) pixels x slots        RGB, slot_stride bytes apart
+ *
+ *   <socket_path>  control socket (Unix stream)
+ *     reader -> "HELLO <name>\n"
+ *     bus    -> "OK shm=<name> reader=<index> version=<v>\n" | "ERR <why>\n"
+ *     bus    -> one byte per published frame (doorbell, dropped if unread)
+ *
+ * The control connection is the reader's lease: when it closes (exit or
+ * crash) the publisher frees the reader entry and every slot it held.
+ *
+ * TEACHING: Ownership Bits Instead of Reference Counts
+ * ----------------------------------------------------
+ * Each slot's reference count is kept as a bitmask of owners (bit r =
+ * reader r holds it, the top bit = the publisher is writing it), so
+ * "how many readers hold this frame" is a popcount and a crashed reader's
+ * references can be dropped exactly - clear its bit in every slot -
+ * instead of guessing how much to subtract. The publisher claims a slot
+ * with compare-exchange(0 -> writer); a reader sets its bit with
+ * fetch_or and backs off if the writer bit was already set. The
+ * publisher never waits: if every slot is held it drops the frame.
+ */
+
+#include "core/staged_pipeline.h"
+#include "framebus/frame_bus_config.h"
+#include "metrics/metrics.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace robot_vision {
+
+// ============================================================================
+// Shared Memory Layout
+// ============================================================================
+
+constexpr char FRAME_BUS_MAGIC[4] = {'R', 'V', 'F', 'B'};
+constexpr uint32_t FRAME_BUS_VERSION = 1;
+constexpr uint64_t FRAME_BUS_WRITER_BIT = 1ull << 63;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Bus atomics must be address-free");
+
+struct alignas(64) FrameBusHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t max_readers;
+    uint64_t slot_bytes;            // Largest frame a slot holds
+    uint64_t slot_stride;           // Distance between slot pixel buffers (page multiple)
+    uint64_t pixels_offset;         // From the start of the mapping
+    uint64_t total_bytes;           // Mapping size
+    int32_t publisher_pid;
+    uint32_t reserved;
+    alignas(64) std::atomic<uint64_t> write_seq;    // Last published sequence (0 = none yet)
+};
+
+struct alignas(64) FrameBusReaderEntry {
+    std::atomic<uint32_t> active;   // Set by the publisher on HELLO, cleared on disconnect
+    int32_t pid;
+    char name[32];
+    std::atomic<uint64_t> read_seq;     // Last sequence the reader took
+    std::atomic<uint64_t> skipped;      // Frames published but never taken
+};
+
+struct alignas(64) FrameBusSlot {
+    std::atomic<uint64_t> owners;   // Reader bits + FRAME_BUS_WRITER_BIT
+    std::atomic<uint64_t> seq;      // Sequence of the frame inside (0 = being written)
+    uint64_t frame_id;
+    uint64_t timestamp_ns;
+    uint64_t capture_time_ns;       // Publisher steady clock (CLOCK_MONOTONIC)
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;                // Bytes per row (RGB, width * 3)
+    uint32_t format;                // 0 = RGB24
+};
+
+static_assert(sizeof(FrameBusHeader) == 128, "FrameBusHeader layout");
+static_assert(sizeof(FrameBusReaderEntry) == 64, "FrameBusReaderEntry layout");
+static_assert(sizeof(FrameBusSlot) == 64, "FrameBusSlot layout");
+
+// ============================================================================
+// Publisher
+// ============================================================================
+
+/**
+ * Frame sink publishing captured frames on the bus
+ *
+ * The record thread copies each frame into a free slot (the only copy;
+ * readers use it in place) and rings every reader's doorbell. A control
+ * thread accepts readers and cleans up after the ones that leave.
+ */
+class FrameBusPublisher : public IFrameSink {
+public:
+    explicit FrameBusPublisher(const FrameBusConfig& config);
+    ~FrameBusPublisher() override;
+
+    // Non-copyable (owns shared memory, sockets and a thread)
+    FrameBusPublisher(const FrameBusPublisher&) = delete;
+    FrameBusPublisher& operator=(const FrameBusPublisher&) = delete;
+
+    /**
+     * Create the shared memory and control socket, start the control thread
+     */
+    bool start();
+
+    /**
+     * Disconnect readers, unlink the shared memory and socket (idempotent)
+     */
+    void stop();
+
+    // IFrameSink (record thread): one copy into a free slot, never blocks
+    void consumeFrame(const std::shared_ptr<FrameData>& frame) override;
+
+    const std::string& getLastError() const { return last_error_; }
+
+private:
+    struct Reader {
+        int fd = -1;
+        int index = -1;                 // Entry in the shared reader table (-1 = no HELLO yet)
+        std::string request;
+    };
+
+    bool createSharedMemory();
+    bool openControlSocket();
+    void controlLoop();
+    bool handleHello(Reader& reader);
+    void dropReader(Reader& reader);
+    void collect();
+    void setError(const std::string& error);
+
+    FrameBusConfig config_;
+    std::atomic<bool> running_{false};
+    std::string last_error_;
+
+    uint8_t* base_ = nullptr;
+    size_t map_bytes_ = 0;
+    FrameBusHeader* header_ = nullptr;
+    FrameBusReaderEntry* entries_ = nullptr;
+    FrameBusSlot* slots_ = nullptr;
+    uint32_t next_slot_ = 0;            // Record thread only
+
+    int listen_fd_ = -1;
+    std::mutex readers_mutex_;          // Control thread edits, record thread rings doorbells
+    std::vector<Reader> readers_;
+    std::atomic<int> active_readers_{0};    // Nothing is copied while 0
+    std::thread thread_;
+    int collector_id_ = -1;
+    bool warned_size_ = false;          // Record thread only
+
+    Counter& published_;
+    Counter& dropped_;
+    Gauge& readers_gauge_;
+};
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+/**
+ * A frame held by a reader (valid until released)
+ */
+struct FrameBusView {
+    const uint8_t* pixels = nullptr;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t stride = 0;
+    uint64_t frame_id = 0;
+    uint64_t timestamp_ns = 0;
+    uint64_t capture_time_ns = 0;       // Comparable with this process's steady clock
+    uint64_t seq = 0;                   // Bus sequence (gaps = frames this reader skipped)
+    int slot = -1;
+};
+
+/**
+ * Client side of the bus, for consumer processes
+ *
+ *   FrameBusReader bus;
+ *   if (!bus.connect("/tmp/rv_framebus.sock", "mapper")) { ... bus.getLastError() ... }
+ *   FrameBusView frame;
+ *   while (bus.next(frame, 1000)) {
+ *       process(frame.pixels, frame.width, frame.height, frame.stride);
+ *       bus.release(frame);
+ *   }
+ *
+ * Holding a frame pins its slot; hold at most slots - 1 frames at once
+ * or the publisher runs out of slots and drops frames for everyone.
+ */
+class FrameBusReader {
+public:
+    FrameBusReader() = default;
+    ~FrameBusReader();
+
+    // Non-copyable (owns a mapping and a socket)
+    FrameBusReader(const FrameBusReader&) = delete;
+    FrameBusReader& operator=(const FrameBusReader&) = delete;
+
+    /**
+     * Register with the publisher and map the bus
+     *
+     * @param name Shows up in the publisher's per-reader metrics
+     */
+    bool connect(const std::string& socket_path, const std::string& name);
+
+    /**
+     * Release held frames, unmap and close (idempotent)
+     */
+    void disconnect();
+
+    /**
+     * Take the next frame, waiting up to timeout_ms for one to be published
+     *
+     * @param latest true: newest frame (skip any backlog); false: oldest
+     *               frame not yet taken that is still in the ring
+     * @return false on timeout or if the publisher went away
+     */
+    bool next(FrameBusView& view, int timeout_ms, bool latest = true);
+
+    /**
+     * Give a frame's slot back to the publisher
+     */
+    void release(FrameBusView& view);
+
+    const FrameBusHeader* header() const { return header_; }
+    int readerIndex() const { return index_; }
+    uint64_t skipped() const;
+    const std::string& getLastError() const { return last_error_; }
+
+private:
+    bool tryTake(FrameBusView& view, bool latest);
+    void setError(const std::string& error) { last_error_ = error; }
+
+    int fd_ = -1;
+    int index_ = -1;
+    uint8_t* base_ = nullptr;
+    size_t map_bytes_ = 0;
+    const FrameBusHeader* header_ = nullptr;
+    FrameBusReaderEntry* entry_ = nullptr;
+    FrameBusSlot* slots_ = nullptr;
+    uint64_t last_seq_ = 0;
+    std::string last_error_;
+};
+
+} // namespace robot_vision
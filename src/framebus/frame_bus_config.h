@@ -0,0 +1,36 @@
+#pragma once
+
+/**
+ * @file frame_bus_config.h
+ * @brief Frame bus settings and ring limits
+ */
+
+#include <cstdint>
+#include <string>
+
+namespace robot_vision {
+
+constexpr uint32_t FRAME_BUS_MAX_READERS = 63;                     // Bit 63 = writer
+constexpr uint32_t FRAME_BUS_MAX_SLOTS = 64;
+
+/**
+ * Frame bus configuration
+ */
+struct FrameBusConfig {
+    bool enabled = false;
+    std::string shm_name = "/rv_framebus";
+    std::string socket_path = "/tmp/rv_framebus.sock";
+    int slots = 4;                      // Ring size: frames readers can hold + 1 being written
+    int max_width = 1920;               // Slot capacity; larger frames are dropped
+    int max_height = 1080;
+    int max_readers = 8;
+
+    bool isValid() const {
+        return !shm_name.empty() && shm_name[0] == '/' && !socket_path.empty() &&
+               slots >= 2 && slots <= static_cast<int>(FRAME_BUS_MAX_SLOTS) &&
+               max_width > 0 && max_height > 0 && max_width <= 8192 && max_height <= 8192 &&
+               max_readers >= 1 && max_readers <= static_cast<int>(FRAME_BUS_MAX_READERS);
+    }
+};
+
+} // namespace robot_vision
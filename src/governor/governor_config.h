@@ -0,0 +1,66 @@
+#pragma once
+
+/**
+ * @file governor_config.h
+ * @brief Performance governor settings and the operating point ladder
+ */
+
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * One rung of the ladder; 0 = use the configured value / no limit
+ */
+struct OperatingPoint {
+    int detection_rate_hz = 0;
+    int detection_width = 0;        // Detector input width cap
+    int display_rate_hz = 0;        // Window + OSD redraws per second
+    int capture_width = 0;          // Capture output width (height keeps aspect)
+};
+
+/**
+ * Parse "det_hz/det_width/display_hz/capture_width;..." (whitespace ignored)
+ *
+ * @return false (and error) if a point is malformed or the ladder is empty
+ */
+bool parseOperatingLadder(const std::string& text, std::vector<OperatingPoint>& ladder,
+                          std::string& error);
+
+/**
+ * Governor configuration
+ */
+struct GovernorConfig {
+    bool enabled = false;
+    std::string sysfs_root = "/sys";
+    std::string procfs_root = "/proc";
+    std::string thermal_zones = "";     // Substring of zone "type" to watch (empty = all)
+    int interval_ms = 1000;             // Sampling period
+
+    float temp_high_c = 80.0f;          // Step down at or above
+    float temp_low_c = 70.0f;           // Step up only at or below
+    float temp_critical_c = 90.0f;      // Jump straight to the last point
+    float cpu_high_percent = 90.0f;     // System CPU, % of all cores
+    float cpu_low_percent = 60.0f;
+    float stage_busy_high = 0.9f;       // Busiest stage, fraction of wall time
+    float stage_busy_low = 0.6f;
+
+    int step_down_samples = 2;          // Consecutive hot samples before stepping down
+    int step_up_samples = 10;           // Consecutive calm samples before stepping up
+
+    std::string ladder = "0/0/0/0; 5/0/0/0; 5/640/15/0; 3/416/10/0; 2/320/5/640";
+
+    bool isValid() const {
+        std::vector<OperatingPoint> points;
+        std::string error;
+        return interval_ms >= 50 &&
+               temp_low_c < temp_high_c && temp_high_c <= temp_critical_c &&
+               cpu_low_percent < cpu_high_percent &&
+               stage_busy_low < stage_busy_high &&
+               step_down_samples >= 1 && step_up_samples >= 1 &&
+               parseOperatingLadder(ladder, points, error);
+    }
+};
+
+} // namespace robot_vision
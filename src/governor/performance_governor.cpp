@@ -0,0 +1,369 @@
+/**
+ * @file performance_governor.cpp
+ * @brief Thermal/load sampling and the operating point ladder
+ */
+
+#include "performance_governor.h"
+#include "util/logger.h"
+#include "util/thread_policy.h"
+
+#include <dirent.h>
+#include <pthread.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace robot_vision {
+
+namespace {
+
+/**
+ * First line of a small sysfs/procfs file
+ */
+bool readLine(const std::string& path, std::string& line) {
+    std::ifstream file(path);
+    return static_cast<bool>(std::getline(file, line));
+}
+
+} // namespace
+
+// ============================================================================
+// Ladder
+// ============================================================================
+
+bool parseOperatingLadder(const std::string& text, std::vector<OperatingPoint>& ladder,
+                          std::string& error) {
+    ladder.clear();
+    std::stringstream points(text);
+    std::string point;
+    while (std::getline(points, point, ';')) {
+        point.erase(std::remove_if(point.begin(), point.end(), ::isspace), point.end());
+        if (point.empty()) {
+            continue;
+        }
+        OperatingPoint op;
+        char extra = 0;
+        if (std::sscanf(point.c_str(), "%d/%d/%d/%d%c", &op.detection_rate_hz, &op.detection_width,
+                        &op.display_rate_hz, &op.capture_width, &extra) != 4 ||
+            op.detection_rate_hz < 0 || op.detection_rate_hz > 120 ||
+            op.detection_width < 0 || op.display_rate_hz < 0 || op.capture_width < 0 ||
+            (op.capture_width > 0 && op.capture_width < 64)) {
+            error = "bad operating point '" + point + "' (det_hz/det_width/display_hz/capture_width)";
+            return false;
+        }
+        ladder.push_back(op);
+    }
+    if (ladder.empty()) {
+        error = "empty ladder";
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// SystemSampler
+// ============================================================================
+
+SystemSampler::SystemSampler(const GovernorConfig& config, const IStagedPipeline& staged)
+    : staged_(staged)
+    , procfs_root_(config.procfs_root)
+{
+    std::string thermal_dir = config.sysfs_root + "/class/thermal";
+    if (DIR* dir = ::opendir(thermal_dir.c_str())) {
+        while (dirent* entry = ::readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.compare(0, 12, "thermal_zone") != 0) {
+                continue;
+            }
+            std::string zone = thermal_dir + "/" + name;
+            std::string type;
+            readLine(zone + "/type", type);
+            if (config.thermal_zones.empty() || type.find(config.thermal_zones) != std::string::npos) {
+                zone_paths_.push_back(zone + "/temp");
+            }
+        }
+        ::closedir(dir);
+        std::sort(zone_paths_.begin(), zone_paths_.end());
+    }
+}
+
+GovernorSample SystemSampler::sample() {
+    GovernorSample out;
+    out.temperature_c = readTemperature();
+    out.cpu_percent = readCpuPercent();
+    readStageBusy(out);
+    return out;
+}
+
+float SystemSampler::readTemperature() const {
+    float hottest = -1.0f;
+    std::string line;
+    for (const auto& path : zone_paths_) {
+        if (readLine(path, line)) {
+            // Millidegrees Celsius; a zone may read back an error while suspended
+            char* end = nullptr;
+            long milli = std::strtol(line.c_str(), &end, 10);
+            if (end != line.c_str()) {
+                hottest = std::max(hottest, static_cast<float>(milli) / 1000.0f);
+            }
+        }
+    }
+    return hottest;
+}
+
+float SystemSampler::readCpuPercent() {
+    // "cpu  user nice system idle iowait irq softirq steal ..."
+    std::string line;
+    if (!readLine(procfs_root_ + "/stat", line) || line.compare(0, 4, "cpu ") != 0) {
+        return -1.0f;
+    }
+    std::istringstream fields(line.substr(4));
+    uint64_t total = 0;
+    uint64_t idle = 0;
+    uint64_t value = 0;
+    for (int i = 0; i < 8 && fields >> value; ++i) {
+        total += value;
+        if (i == 3 || i == 4) {
+            idle += value;      // idle + iowait
+        }
+    }
+
+    float percent = -1.0f;
+    if (last_cpu_total_ != 0 && total > last_cpu_total_) {
+        uint64_t d_total = total - last_cpu_total_;
+        uint64_t d_idle = idle >= last_cpu_idle_ ? idle - last_cpu_idle_ : 0;
+        percent = 100.0f * static_cast<float>(d_total - std::min(d_idle, d_total)) /
+                  static_cast<float>(d_total);
+    }
+    last_cpu_total_ = total;
+    last_cpu_idle_ = idle;
+    return percent;
+}
+
+void SystemSampler::readStageBusy(GovernorSample& out) {
+    uint64_t now = metricsNowNs();
+    uint64_t wall = now - last_sample_ns_;
+    bool have_window = last_sample_ns_ != 0 && wall > 0;
+    last_sample_ns_ = now;
+
+    std::vector<std::pair<std::string, uint64_t>> busy;
+    for (const auto& st : staged_.getStats()) {
+        busy.emplace_back(st.name, st.busy_ns);
+        if (!have_window) {
+            continue;
+        }
+        for (const auto& prev : last_busy_ns_) {
+            if (prev.first == st.name && st.busy_ns >= prev.second) {
+                float fraction = static_cast<float>(st.busy_ns - prev.second) / static_cast<float>(wall);
+                if (fraction > out.stage_busy) {
+                    out.stage_busy = fraction;
+                    out.busiest_stage = st.name;
+                }
+            }
+        }
+    }
+    last_busy_ns_.swap(busy);
+}
+
+// ============================================================================
+// PerformanceGovernor
+// ============================================================================
+
+PerformanceGovernor::PerformanceGovernor(const GovernorConfig& config, IStagedPipeline& staged,
+                                         IVideoPipeline& video, const OperatingPoint& base,
+                                         int capture_height)
+    : config_(config)
+    , staged_(staged)
+    , video_(video)
+    , base_(base)
+    , capture_height_(capture_height)
+    , base_detection_rate_(base.detection_rate_hz)
+    , applied_(base)
+    , applied_base_rate_(base.detection_rate_hz)
+    , level_gauge_(MetricsRegistry::global().gauge(
+          "rv_governor_level", "Operating point ladder position (0 = full quality)"))
+    , temperature_gauge_(MetricsRegistry::global().gauge(
+          "rv_soc_temperature_celsius", "Hottest watched thermal zone"))
+    , cpu_gauge_(MetricsRegistry::global().gauge(
+          "rv_system_cpu_percent", "System CPU use, percent of all cores"))
+    , stage_busy_gauge_(MetricsRegistry::global().gauge(
+          "rv_governor_stage_busy_ratio", "Busy fraction of the busiest pipeline stage"))
+    , steps_down_(MetricsRegistry::global().counter(
+          "rv_governor_steps_down_total", "Moves to a cheaper operating point"))
+    , steps_up_(MetricsRegistry::global().counter(
+          "rv_governor_steps_up_total", "Moves back toward full quality"))
+{
+    std::string error;
+    parseOperatingLadder(config_.ladder, ladder_, error);
+}
+
+PerformanceGovernor::~PerformanceGovernor() {
+    stop();
+}
+
+bool PerformanceGovernor::start() {
+    if (running_) {
+        return true;
+    }
+    if (!config_.isValid() || ladder_.empty()) {
+        last_error_ = "Invalid governor configuration";
+        RV_LOG_ERROR("governor", "{}", last_error_);
+        return false;
+    }
+
+    sampler_ = std::make_unique<SystemSampler>(config_, staged_);
+    if (sampler_->thermalZones().empty()) {
+        RV_LOG_WARN("governor", "No thermal zones under {}/class/thermal; using load only",
+                    config_.sysfs_root);
+    }
+
+    running_ = true;
+    thread_ = std::thread(&PerformanceGovernor::run, this);
+    RV_LOG_INFO("governor", "Governor: {} operating points, {} thermal zones, every {} ms",
+                ladder_.size(), sampler_->thermalZones().size(), config_.interval_ms);
+    return true;
+}
+
+void PerformanceGovernor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (level_.load() != 0) {
+        apply(0, GovernorSample{});
+    }
+}
+
+void PerformanceGovernor::run() {
+#ifdef PLATFORM_MACOS
+    pthread_setname_np("rv-governor");
+#else
+    pthread_setname_np(pthread_self(), "rv-governor");
+#endif
+    ScopedThreadRole thread_role("background");
+
+    const auto interval = std::chrono::milliseconds(config_.interval_ms);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        wake_.wait_for(lock, interval, [this] { return !running_; });
+        if (!running_) {
+            break;
+        }
+        lock.unlock();
+        update(sampler_->sample());
+        lock.lock();
+    }
+}
+
+void PerformanceGovernor::update(const GovernorSample& sample) {
+    temperature_gauge_.set(sample.temperature_c);
+    cpu_gauge_.set(sample.cpu_percent);
+    stage_busy_gauge_.set(sample.stage_busy);
+
+    const int last = static_cast<int>(ladder_.size()) - 1;
+    const int current = level_.load(std::memory_order_relaxed);
+
+    // Detection rate changed by a config reload: re-derive the current point
+    if (base_detection_rate_.load(std::memory_order_relaxed) != applied_base_rate_) {
+        applied_base_rate_ = base_detection_rate_.load(std::memory_order_relaxed);
+        apply(current, sample);
+    }
+    const bool have_temp = sample.temperature_c >= 0.0f;
+    const bool have_cpu = sample.cpu_percent >= 0.0f;
+
+    if (have_temp && sample.temperature_c >= config_.temp_critical_c) {
+        hot_samples_ = 0;
+        calm_samples_ = 0;
+        if (current != last) {
+            steps_down_.inc();
+            apply(last, sample);
+        }
+        return;
+    }
+
+    bool hot = (have_temp && sample.temperature_c >= config_.temp_high_c) ||
+               (have_cpu && sample.cpu_percent >= config_.cpu_high_percent) ||
+               sample.stage_busy >= config_.stage_busy_high;
+    bool calm = (!have_temp || sample.temperature_c <= config_.temp_low_c) &&
+                (!have_cpu || sample.cpu_percent <= config_.cpu_low_percent) &&
+                sample.stage_busy <= config_.stage_busy_low;
+
+    // Between the thresholds: hold, and restart both dwell counts
+    hot_samples_ = hot ? hot_samples_ + 1 : 0;
+    calm_samples_ = calm ? calm_samples_ + 1 : 0;
+
+    if (hot_samples_ >= config_.step_down_samples && current < last) {
+        hot_samples_ = 0;
+        steps_down_.inc();
+        apply(current + 1, sample);
+    } else if (calm_samples_ >= config_.step_up_samples && current > 0) {
+        calm_samples_ = 0;
+        steps_up_.inc();
+        apply(current - 1, sample);
+    }
+}
+
+void PerformanceGovernor::apply(int level, const GovernorSample& sample) {
+    const OperatingPoint& point = ladder_[static_cast<size_t>(level)];
+    const int base_rate = base_detection_rate_.load(std::memory_order_relaxed);
+
+    // Never go above what was configured; 0 = configured value
+    OperatingPoint target;
+    target.detection_rate_hz = point.detection_rate_hz > 0
+        ? std::min(point.detection_rate_hz, base_rate) : base_rate;
+    target.detection_width = point.detection_width;
+    target.display_rate_hz = point.display_rate_hz;
+    target.capture_width = point.capture_width > 0 && point.capture_width < base_.capture_width
+        ? point.capture_width : 0;
+
+    if (target.detection_rate_hz != applied_.detection_rate_hz) {
+        staged_.setDetectionRate(target.detection_rate_hz);
+    }
+    if (target.detection_width != applied_.detection_width) {
+        staged_.setDetectionInputWidth(target.detection_width);
+    }
+    display_rate_hz_.store(target.display_rate_hz, std::memory_order_relaxed);
+    if (target.capture_width != applied_.capture_width) {
+        // Keep the aspect ratio; even sizes suit every converter downstream
+        int width = target.capture_width & ~1;
+        int height = width > 0 && base_.capture_width > 0
+            ? (capture_height_ * width / base_.capture_width) & ~1 : 0;
+        if (!video_.setOutputResolution(width, height)) {
+            RV_LOG_WARN("governor", "Capture resize failed: {}", video_.getLastError());
+            target.capture_width = applied_.capture_width;
+        }
+    }
+
+    int previous = level_.exchange(level, std::memory_order_relaxed);
+    applied_ = target;
+    level_gauge_.set(level);
+    if (level == previous) {
+        return;     // Re-applied after a configuration change
+    }
+
+    if (level > previous) {
+        RV_LOG_WARN("governor", "Step down {} -> {}: detect {} Hz, det width {}, display {} Hz, "
+                    "capture width {} (temp {:.1f} C, cpu {:.0f}%, stage busy {:.2f})",
+                    previous, level, target.detection_rate_hz, target.detection_width,
+                    target.display_rate_hz, target.capture_width, sample.temperature_c,
+                    sample.cpu_percent, sample.stage_busy);
+    } else {
+        RV_LOG_INFO("governor", "Step up {} -> {}: detect {} Hz, det width {}, display {} Hz, "
+                    "capture width {}",
+                    previous, level, target.detection_rate_hz, target.detection_width,
+                    target.display_rate_hz, target.capture_width);
+    }
+}
+
+} // namespace robot_vision
@@ -0,0 +1,180 @@
+#pragma once
+
+/**
+ * @file performance_governor.h
+ * @brief Thermal- and load-aware operating point ladder
+ *
+ * One background thread ("rv-governor") samples, once per interval:
+ *   - SoC temperature: hottest <sysfs_root>/class/thermal/thermal_zoneN/temp
+ *   - system CPU load: <procfs_root>/stat
+ *   - stage utilisation: busy time / wall time of the busiest stage
+ * and moves along a ladder of operating points, each cheaper than the
+ * last:
+ *
+ *   level  detection Hz  detector width  display Hz  capture width
+ *   0      configured    native          every frame configured
+ *   1      5             native          every frame configured
+ *   2      5             640             15          configured
+ *   ...
+ *
+ * Both roots are configurable so the governor can be exercised against
+ * a fake sysfs tree (echo 95000 > fake/class/thermal/thermal_zone0/temp).
+ *
+ * TEACHING: Hysteresis
+ * --------------------
+ * A single threshold makes a controller oscillate: throttling cools the
+ * SoC, which un-throttles, which heats it again - every second. Two
+ * thresholds (step down above `high`, step up only below `low`) plus a
+ * dwell time (N consecutive samples) leave a band where nothing changes.
+ * Stepping down is quick (heat is dangerous, dropped frames are visible);
+ * stepping up is slow (one calm sample proves little).
+ */
+
+#include "core/staged_pipeline.h"
+#include "core/video_pipeline.h"
+#include "governor/governor_config.h"
+#include "metrics/metrics.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * One sample of the signals the governor reacts to
+ */
+struct GovernorSample {
+    float temperature_c = -1.0f;        // Hottest watched zone (-1 = no zones)
+    float cpu_percent = -1.0f;          // System CPU (-1 = not yet known)
+    float stage_busy = 0.0f;            // Busiest stage utilisation
+    std::string busiest_stage;
+};
+
+/**
+ * Reads thermal zones, /proc/stat and stage counters (governor thread)
+ */
+class SystemSampler {
+public:
+    SystemSampler(const GovernorConfig& config, const IStagedPipeline& staged);
+
+    /**
+     * Take a sample; CPU and stage values are deltas since the last call
+     */
+    GovernorSample sample();
+
+    /**
+     * Thermal zone temperature files found at construction
+     */
+    const std::vector<std::string>& thermalZones() const { return zone_paths_; }
+
+private:
+    float readTemperature() const;
+    float readCpuPercent();
+    void readStageBusy(GovernorSample& out);
+
+    const IStagedPipeline& staged_;
+    std::string procfs_root_;
+    std::vector<std::string> zone_paths_;
+
+    uint64_t last_cpu_total_ = 0;
+    uint64_t last_cpu_idle_ = 0;
+    uint64_t last_sample_ns_ = 0;
+    std::vector<std::pair<std::string, uint64_t>> last_busy_ns_;
+};
+
+/**
+ * Ladder controller
+ */
+class PerformanceGovernor {
+public:
+    /**
+     * @param base Configured operating point (level 0 and the 0 = "configured" values)
+     * @param capture_height Configured capture height (for the aspect ratio)
+     */
+    PerformanceGovernor(const GovernorConfig& config, IStagedPipeline& staged,
+                        IVideoPipeline& video, const OperatingPoint& base, int capture_height);
+    ~PerformanceGovernor();
+
+    // Non-copyable (owns a thread)
+    PerformanceGovernor(const PerformanceGovernor&) = delete;
+    PerformanceGovernor& operator=(const PerformanceGovernor&) = delete;
+
+    /**
+     * Start sampling (the staged pipeline must be running)
+     */
+    bool start();
+
+    /**
+     * Stop the thread and restore level 0 (idempotent)
+     */
+    void stop();
+
+    /**
+     * Current ladder position
+     */
+    int level() const { return level_.load(std::memory_order_relaxed); }
+
+    /**
+     * Display redraw cap for the render loop (0 = every frame)
+     */
+    int displayRateHz() const { return display_rate_hz_.load(std::memory_order_relaxed); }
+
+    /**
+     * New configured detection rate (config reload); the governor applies
+     * it, capped by the current point, on its next sample
+     */
+    void setConfiguredDetectionRate(int hz) {
+        base_detection_rate_.store(hz, std::memory_order_relaxed);
+    }
+
+    /**
+     * Feed one sample through the hysteresis and apply any step
+     *
+     * Called by the governor thread; public so a fake sample stream can
+     * drive it directly.
+     */
+    void update(const GovernorSample& sample);
+
+    const std::string& getLastError() const { return last_error_; }
+
+private:
+    void run();
+    void apply(int level, const GovernorSample& sample);
+
+    GovernorConfig config_;
+    IStagedPipeline& staged_;
+    IVideoPipeline& video_;
+    OperatingPoint base_;
+    int capture_height_;
+    std::vector<OperatingPoint> ladder_;
+    std::unique_ptr<SystemSampler> sampler_;
+
+    std::atomic<int> level_{0};
+    std::atomic<int> display_rate_hz_{0};
+    std::atomic<int> base_detection_rate_;
+    int hot_samples_ = 0;
+    int calm_samples_ = 0;
+    OperatingPoint applied_;            // What the knobs are currently set to
+    int applied_base_rate_;             // base_detection_rate_ that applied_ was derived from
+
+    Gauge& level_gauge_;
+    Gauge& temperature_gauge_;
+    Gauge& cpu_gauge_;
+    Gauge& stage_busy_gauge_;
+    Counter& steps_down_;
+    Counter& steps_up_;
+
+    std::atomic<bool> running_{false};
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::thread thread_;
+    std::string last_error_;
+};
+
+} // namespace robot_vision
@@ -15,13 +15,45 @@
 #include "core/window.h"
 #include "core/osd.h"
 #include "core/detection_client.h"
+#include "core/staged_pipeline.h"
 #include "rendering/texture_renderer.h"
+#include "rendering/video_stabilizer.h"
+#include "rendering/framebuffer_capture.h"
+#include "osd/detection_overlay.h"
+#include "osd/telemetry_overlay.h"
+#include "osd/flight_hud.h"
+#include "detection/console_detection_sink.h"
+#include "detection/detection_log.h"
+#include "app/headless_runner.h"
+#include "app/app_config.h"
+#include "app/run_report.h"
+#include "app/startup_graph.h"
+#include "snapshot/snapshot_writer.h"
+#include "recording/event_recorder.h"
+#include "governor/performance_governor.h"
+#include "streaming/rtp_streamer.h"
+#include "streaming/mjpeg_server.h"
+#include "framebus/frame_bus.h"
+#include "telemetry/telemetry_receiver.h"
+#include "processing/processor_graph.h"
+#include "processing/basic_processors.h"
+#include "processing/lens_undistort.h"
+#include "metrics/metrics.h"
+#include "metrics/metrics_server.h"
+#include "trace/trace.h"
+#include "util/logger.h"
+#include "util/thread_policy.h"
 
 #include <gst/gst.h>
-#include <iostream>
+#include <atomic>
+#include <iomanip>
+#include <sstream>
 #include <chrono>
 #include <string>
 #include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <thread>
 #include <vector>
 
 using namespace robot_vision;
@@ -36,7 +68,7 @@ bool initGStreamer() {
     guint major, minor, micro, nano;
     gst_version(&major, &minor, &micro, &nano);
 
-    std::cout << "  GStreamer: " << major << "." << minor << "." << micro << "\n";
+    RV_LOG_INFO("app", "GStreamer: {}.{}.{}", major, minor, micro);
     return true;
 }
 
@@ -45,159 +77,627 @@ void cleanupGStreamer() {
 }
 
 // ============================================================================
-// Main Application
+// Diagnostics
 // ============================================================================
 
-int main() {
-    // Ignore SIGPIPE to prevent crash when writing to closed sockets
-    std::signal(SIGPIPE, SIG_IGN);
+void printStageStats(const std::vector<StageStats>& stats) {
+    RV_LOG_INFO("app", "  Stage            queue  max  pushed   dropped  processed  wait(ms)  max-wait(ms)  busy(ms)");
+    for (const auto& st : stats) {
+        std::ostringstream line;
+        line << "  " << std::left << std::setw(16) << st.name << std::right
+                  << std::setw(6) << st.queue_depth
+                  << std::setw(5) << st.max_occupancy
+                  << std::setw(8) << st.pushed
+                  << std::setw(10) << st.dropped
+                  << std::setw(11) << st.processed
+                  << std::setw(10) << st.wait_ns / 1000000
+                  << std::setw(14) << st.max_wait_ns / 1000000
+                  << std::setw(10) << st.busy_ns / 1000000;
+        RV_LOG_INFO("app", "{}", line.str());
+    }
+}
 
-    std::cout << "\n";
-    std::cout << "========================================\n";
-    std::cout << "   Robot Vision Demo v1.0.0            \n";
-    std::cout << "   Phase 4: Object Detection           \n";
-    std::cout << "========================================\n";
-    std::cout << "\n";
+// ============================================================================
+// Signals
+// ============================================================================
 
-    // ========================================================================
-    // Step 1: Initialize GStreamer
-    // ========================================================================
-    std::cout << "--- Initializing ---\n";
-    if (!initGStreamer()) {
-        std::cerr << "ERROR: Failed to initialize GStreamer!\n";
-        return 1;
+// Set by SIGINT/SIGTERM - the headless loop has no window to close
+std::atomic<bool> g_stop_requested{false};
+
+// Set by SIGHUP - the main thread reloads the configuration
+std::atomic<bool> g_reload_requested{false};
+
+// Set by SIGUSR1 (or the T key) - the main thread dumps the trace rings
+std::atomic<bool> g_trace_dump_requested{false};
+
+// Set by the S key - the render loop takes a snapshot
+std::atomic<bool> g_snapshot_requested{false};
+
+void handleStopSignal(int) {
+    g_stop_requested.store(true);
+}
+
+void handleReloadSignal(int) {
+    g_reload_requested.store(true);
+}
+
+void handleTraceSignal(int) {
+    g_trace_dump_requested.store(true);
+}
+
+/**
+ * Dump the trace if SIGUSR1 or the T key asked for it
+ */
+void checkTraceDump() {
+    if (g_trace_dump_requested.exchange(false)) {
+        if (Tracer::global().enabled()) {
+            Tracer::global().dump();
+        } else {
+            RV_LOG_WARN("trace", "Tracing is off (start with --trace.enabled=true)");
+        }
     }
+}
 
-    // ========================================================================
-    // Step 2: Create Platform
-    // ========================================================================
-    auto platform = createPlatform();
-    auto platform_info = platform->getInfo();
-    std::cout << "  Platform: " << platform_info.name << "\n";
-    std::cout << "  Graphics: " << platform_info.graphics_api_name << "\n";
+/**
+ * Reload the configuration if SIGHUP arrived
+ *
+ * @return true if live settings changed (caller re-applies them)
+ */
+bool checkConfigReload(ConfigManager& config_manager) {
+    if (!g_reload_requested.exchange(false)) {
+        return false;
+    }
+    std::vector<std::string> changed;
+    if (!config_manager.reload(changed)) {
+        return false;
+    }
+    LogLevel level;
+    if (parseLogLevel(config_manager.config().log.level, level)) {
+        Logger::setLevel(level);
+    }
+    return true;
+}
 
-    // ========================================================================
-    // Step 3: Create Window
-    // ========================================================================
-    std::cout << "\n--- Creating Window ---\n";
-    auto window = createWindow();
+// ============================================================================
+// Snapshots
+// ============================================================================
 
-    WindowConfig window_config;
-    window_config.width = 1280;
-    window_config.height = 720;
-    window_config.title = "Robot Vision Demo - Phase 4";
-    window_config.vsync = true;
+/**
+ * Start the snapshot writer and attach it to the record and result stages
+ *
+ * @return Writer, or nullptr if disabled or it failed to start
+ */
+std::shared_ptr<SnapshotWriter> attachSnapshotWriter(IStagedPipeline& staged,
+                                                     const SnapshotConfig& config) {
+    if (!config.enabled) {
+        return nullptr;
+    }
+    auto writer = std::make_shared<SnapshotWriter>(config);
+    if (!writer->start()) {
+        return nullptr;
+    }
+    staged.addFrameSink(writer);
+    staged.addDetectionSink(writer);
+    return writer;
+}
 
-    if (!window->initialize(window_config)) {
-        std::cerr << "ERROR: Failed to create window!\n";
-        cleanupGStreamer();
+// ============================================================================
+// Event Recording
+// ============================================================================
+
+/**
+ * Start the pre-roll recorder and attach it to the record and result stages
+ *
+ * @return Recorder, or nullptr if disabled or it failed to start
+ */
+std::shared_ptr<EventRecorder> attachEventRecorder(IStagedPipeline& staged,
+                                                   const AppConfig& config,
+                                                   IPlatform& platform) {
+    if (!config.recording.enabled) {
+        return nullptr;
+    }
+    auto recorder = std::make_shared<EventRecorder>(config.recording, platform, config.pipeline.fps);
+    if (!recorder->start()) {
+        return nullptr;
+    }
+    staged.addFrameSink(recorder);
+    staged.addDetectionSink(recorder);
+    return recorder;
+}
+
+// ============================================================================
+// Detection Log
+// ============================================================================
+
+/**
+ * Start the binary detection log and attach it to the result stage
+ *
+ * @return Writer, or nullptr if disabled or it failed to start
+ */
+std::shared_ptr<DetectionLogWriter> attachDetectionLog(IStagedPipeline& staged,
+                                                       const DetectionLogConfig& config) {
+    if (!config.enabled) {
+        return nullptr;
+    }
+    auto writer = std::make_shared<DetectionLogWriter>(config);
+    if (!writer->start()) {
+        return nullptr;
+    }
+    staged.addDetectionSink(writer);
+    return writer;
+}
+
+// ============================================================================
+// Network Stream
+// ============================================================================
+
+/**
+ * Start the RTP stream; raw mode attaches it to the record stage
+ *
+ * @return Streamer, or nullptr if disabled or it failed to start
+ */
+std::shared_ptr<RtpStreamer> attachStreamer(IStagedPipeline& staged, const AppConfig& config,
+                                            IPlatform& platform) {
+    if (!config.stream.enabled) {
+        return nullptr;
+    }
+    auto streamer = std::make_shared<RtpStreamer>(config.stream, platform, config.pipeline.width,
+                                                  config.pipeline.height);
+    if (!streamer->start()) {
+        return nullptr;
+    }
+    if (!streamer->isComposited()) {
+        staged.addFrameSink(streamer);
+    }
+    return streamer;
+}
+
+/**
+ * Start the MJPEG preview server and attach it to the record stage
+ *
+ * @return Server, or nullptr if disabled or it failed to start
+ */
+std::shared_ptr<MjpegServer> attachMjpegServer(IStagedPipeline& staged, const MjpegConfig& config) {
+    if (!config.enabled) {
+        return nullptr;
+    }
+    auto server = std::make_shared<MjpegServer>(config);
+    if (!server->start()) {
+        return nullptr;
+    }
+    staged.addFrameSink(server);
+    return server;
+}
+
+// ============================================================================
+// Frame Bus
+// ============================================================================
+
+/**
+ * Start the shared-memory frame bus and attach it to the record stage
+ *
+ * @return Publisher, or nullptr if disabled or it failed to start
+ */
+std::shared_ptr<FrameBusPublisher> attachFrameBus(IStagedPipeline& staged, const FrameBusConfig& config) {
+    if (!config.enabled) {
+        return nullptr;
+    }
+    auto bus = std::make_shared<FrameBusPublisher>(config);
+    if (!bus->start()) {
+        return nullptr;
+    }
+    staged.addFrameSink(bus);
+    return bus;
+}
+
+// ============================================================================
+// Frame Processors
+// ============================================================================
+
+/**
+ * Build the configured processor graph and attach it to the record stage
+ * and detection results
+ *
+ * @return Graph, or nullptr if disabled or it failed to start
+ */
+std::shared_ptr<ProcessorGraph> attachProcessorGraph(IStagedPipeline& staged, const ProcessingConfig& config) {
+    if (!config.enabled) {
+        return nullptr;
+    }
+    auto graph = std::make_shared<ProcessorGraph>(config);
+    for (const auto& name : parseProcessorList(config.processors)) {
+        graph->add(createFrameProcessor(name));
+    }
+    if (!graph->start()) {
+        return nullptr;
+    }
+    staged.addFrameSink(graph);
+    staged.addDetectionSink(graph);
+    return graph;
+}
+
+// ============================================================================
+// Lens Undistortion
+// ============================================================================
+
+/**
+ * Start lens undistortion on the capture stage (every consumer) or the
+ * detect-submit stage (detector input only)
+ *
+ * @return Undistorter, or nullptr if disabled or apply_to = none
+ */
+std::shared_ptr<LensUndistorter> attachUndistortion(IStagedPipeline& staged, const UndistortConfig& config) {
+    if (!config.enabled || config.apply_to == "none") {
+        return nullptr;
+    }
+    const bool detection_only = config.apply_to == "detection";
+    auto undistorter = std::make_shared<LensUndistorter>(config, detection_only ? "detect" : "capture");
+    undistorter->start();
+    if (detection_only) {
+        staged.setDetectionFilter(undistorter);
+    } else {
+        staged.setCaptureFilter(undistorter);
+    }
+    return undistorter;
+}
+
+/**
+ * Set up shader lens correction and stabilisation of the displayed video
+ *
+ * @return Stabiliser, or nullptr if stabilisation is off
+ */
+std::unique_ptr<VideoStabilizer> attachDisplayCorrection(TextureRenderer& renderer, const AppConfig& config) {
+    const UndistortConfig& lens = config.undistort;
+    if (lens.enabled && lens.gpu_display) {
+        renderer.setLensCorrection(lens);
+    }
+    if (!config.stabilize.enabled) {
+        return nullptr;
+    }
+    // The homography acts on the undistorted image whenever the display shows one
+    const bool undistorted = lens.enabled && (lens.gpu_display || lens.apply_to == "all");
+    RV_LOG_INFO("app", "Stabilising the display from telemetry attitude (smoothing {} ms, crop {:.2f})",
+                config.stabilize.smoothing_ms, config.stabilize.crop);
+    return std::make_unique<VideoStabilizer>(config.stabilize, undistorted ? &lens : nullptr);
+}
+
+// ============================================================================
+// Performance Governor
+// ============================================================================
+
+/**
+ * Start the thermal/load governor on a running staged pipeline
+ *
+ * @return Governor, or nullptr if disabled or it failed to start
+ */
+std::unique_ptr<PerformanceGovernor> startGovernor(IStagedPipeline& staged, IVideoPipeline& video,
+                                                   const AppConfig& config) {
+    if (!config.governor.enabled) {
+        return nullptr;
+    }
+    OperatingPoint base;
+    base.detection_rate_hz = config.stages.detection_rate_hz;
+    base.capture_width = config.pipeline.width;
+    auto governor = std::make_unique<PerformanceGovernor>(config.governor, staged, video, base,
+                                                          config.pipeline.height);
+    if (!governor->start()) {
+        return nullptr;
+    }
+    return governor;
+}
+
+// ============================================================================
+// Headless Mode
+// ============================================================================
+
+/**
+ * Run capture -> detection -> sinks with no window, texture or NanoVG
+ *
+ * The video pipeline is already playing (started by the startup graph).
+ */
+int runHeadless(IPlatform& platform, IVideoPipeline& pipeline, IDetectionClient& detector,
+                ConfigManager& config_manager, uint64_t process_start_ns) {
+    const AppConfig& config = config_manager.config();
+
+    RV_LOG_INFO("app", "--- Starting Pipeline Stages ---");
+    auto staged = createStagedPipeline(pipeline, detector, config.stages);
+    staged->addDetectionSink(std::make_shared<ConsoleDetectionSink>());
+    auto snapshots = attachSnapshotWriter(*staged, config.snapshot);
+    auto recorder = attachEventRecorder(*staged, config, platform);
+    auto detection_log = attachDetectionLog(*staged, config.detection_log);
+    auto streamer = attachStreamer(*staged, config, platform);
+    auto mjpeg = attachMjpegServer(*staged, config.mjpeg);
+    auto framebus = attachFrameBus(*staged, config.framebus);
+    auto processors = attachProcessorGraph(*staged, config.processing);
+    auto undistorter = attachUndistortion(*staged, config.undistort);
+    if (!staged->start()) {
+        RV_LOG_ERROR("app", "Failed to start pipeline stages");
+        pipeline.stop();
         return 1;
     }
+    auto governor = startGovernor(*staged, pipeline, config);
 
-    // ========================================================================
-    // Step 4: Create Video Pipeline
-    // ========================================================================
-    std::cout << "\n--- Creating Video Pipeline ---\n";
-    auto pipeline = createVideoPipeline(*platform);
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
 
-    PipelineConfig pipeline_config;
-    pipeline_config.width = 1280;
-    pipeline_config.height = 720;
-    pipeline_config.fps = 30;
+    RV_LOG_INFO("app", "Headless mode running. Ctrl+C to exit.");
 
-    if (!pipeline->initialize(pipeline_config)) {
-        std::cerr << "ERROR: Failed to initialize video pipeline!\n";
-        std::cerr << "  " << pipeline->getLastError() << "\n";
-        cleanupGStreamer();
+    // Tagged last: threads created above must not inherit the loop's pinning
+    ScopedThreadRole thread_role("render");
+
+    HeadlessRunner runner(*staged, config.headless_config);
+    if (governor) {
+        runner.disableRateControl();    // One owner for the detection rate
+    }
+    runner.setTickCallback([&]() {
+        checkTraceDump();
+        if (checkConfigReload(config_manager)) {
+            runner.updateConfig(config.headless_config, config.stages.detection_rate_hz);
+            if (governor) {
+                governor->setConfiguredDetectionRate(config.stages.detection_rate_hz);
+            }
+        }
+    });
+    runner.setFirstFrameCallback([&]() { reportTimeToFirstFrame(process_start_ns); });
+    int rc = runner.run(g_stop_requested);
+
+    RV_LOG_INFO("app", "--- Shutting Down ---");
+    if (governor) {
+        governor->stop();   // Restores full quality before the stages go away
+    }
+    ThreadRegistry::global().logSummary();   // While the stage threads still exist
+    staged->stop();
+    printStageStats(staged->getStats());
+    if (snapshots) {
+        snapshots->stop();  // Finishes queued snapshots
+    }
+    if (recorder) {
+        recorder->stop();   // Closes an open clip (post-roll cut short)
+    }
+    if (detection_log) {
+        detection_log->stop();  // Final flush and index entry
+    }
+    if (streamer) {
+        streamer->stop();
+    }
+    if (mjpeg) {
+        mjpeg->stop();      // Disconnects viewers
+    }
+    if (framebus) {
+        framebus->stop();   // Readers see the control socket close
+    }
+    if (processors) {
+        processors->stop(); // Logs per-processor timings
+    }
+    if (undistorter) {
+        undistorter->stop();
+    }
+    if (config.trace.dump_on_exit && Tracer::global().enabled()) {
+        Tracer::global().dump();
+    }
+    if (detector.isConnected()) {
+        detector.disconnect();
+    }
+    pipeline.stop();
+    return rc;
+}
+
+// ============================================================================
+// Main Application
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    // Time-to-first-frame is measured from here
+    const uint64_t process_start_ns = metricsNowNs();
+
+    // Ignore SIGPIPE to prevent crash when writing to closed sockets
+    std::signal(SIGPIPE, SIG_IGN);
+
+    ConfigManager config_manager;
+    if (!config_manager.initialize(argc, argv)) {
+        return config_manager.exitRequested() ? 0 : 1;
+    }
+    const AppConfig& config = config_manager.config();
+
+    // SIGHUP reloads the configuration (live settings only)
+    std::signal(SIGHUP, handleReloadSignal);
+
+    // Leveled async logging (configured first so startup lines use it)
+    if (!Logger::global().configure(config.log)) {
+        RV_LOG_ERROR("app", "Cannot open log file '{}': {}", config.log.file, std::strerror(errno));
         return 1;
     }
 
+    // Affinity / scheduling class per thread role (threads tag themselves)
+    ThreadRegistry::global().configure(config.threads);
+
+    // Frame timeline tracing (SIGUSR1 dumps the rings)
+    Tracer::global().configure(config.trace);
+    std::signal(SIGUSR1, handleTraceSignal);
+
+    RV_LOG_INFO("app", "Robot Vision Demo v1.0.0 (Phase 4: Object Detection)");
+
     // ========================================================================
-    // Step 5: Create Texture Renderer
+    // Step 1: Create Platform and Components
     // ========================================================================
-    std::cout << "\n--- Creating Texture Renderer ---\n";
+    RV_LOG_INFO("app", "--- Initializing ---");
+    RV_LOG_INFO("app", "Config: {}", config_manager.configPath().empty() ? "built-in defaults"
+                                                                         : config_manager.configPath());
+    auto platform = createPlatform();
+    auto platform_info = platform->getInfo();
+    RV_LOG_INFO("app", "Platform: {}", platform_info.name);
+    RV_LOG_INFO("app", "Graphics: {}", platform_info.graphics_api_name);
+
+    auto pipeline = createVideoPipeline(*platform);
+    auto detector = createDetectionClient(config.detection);
+    std::unique_ptr<IWindow> window;
+    std::unique_ptr<IOSD> osd;
     TextureRenderer renderer;
-    if (!renderer.initialize(pipeline_config.width, pipeline_config.height)) {
-        std::cerr << "ERROR: Failed to initialize texture renderer!\n";
-        cleanupGStreamer();
-        return 1;
-    }
+    std::unique_ptr<MetricsServer> metrics_server;
+    std::unique_ptr<TelemetryReceiver> telemetry;
 
     // ========================================================================
-    // Step 6: Create OSD Renderer (Phase 3)
+    // Step 2: Startup Graph
     // ========================================================================
-    std::cout << "\n--- Creating OSD Renderer ---\n";
-    auto osd = createOSD();
 
-    OSDConfig osd_config;
-    osd_config.font_path = std::string(ASSETS_PATH) + "/fonts/RobotoMono-Regular.ttf";
-    osd_config.font_bold_path = std::string(ASSETS_PATH) + "/fonts/RobotoMono-Bold.ttf";
-    osd_config.default_font_size = 18.0f;
+    /**
+     * TEACHING: Parallel Startup
+     * --------------------------
+     * The camera reaching PLAYING (often 1-2 s) used to wait behind the
+     * window, GL context and font loads, and all of it behind the detector
+     * handshake. Now the camera comes up on a worker thread while the main
+     * thread (which must own the GL context) builds the window, texture
+     * and OSD. The detector is connected lazily by the staged pipeline's
+     * ingest thread, so a missing server never delays the first frame.
+     *
+     *   worker: gstreamer -> pipeline (parse, PLAYING)
+     *   worker: metrics
+     *   worker: telemetry                       (not in headless mode)
+     *   main:   window -> texture, osd          (not in headless mode)
+     */
+    StartupGraph startup;
+    startup.add("gstreamer", {}, StartupThread::Worker, [] { return initGStreamer(); });
+    startup.add("pipeline", {"gstreamer"}, StartupThread::Worker, [&] {
+        if (!pipeline->initialize(config.pipeline)) {
+            RV_LOG_ERROR("app", "Failed to initialize video pipeline: {}", pipeline->getLastError());
+            return false;
+        }
+        if (!pipeline->start()) {
+            RV_LOG_ERROR("app", "Failed to start video pipeline: {}", pipeline->getLastError());
+            return false;
+        }
+        return true;
+    });
+
+    // Metrics export (optional): Prometheus endpoint and/or JSON snapshots
+    startup.add("metrics", {}, StartupThread::Worker, [&] {
+        if (config.metrics.isEnabled()) {
+            metrics_server = std::make_unique<MetricsServer>(MetricsRegistry::global(), config.metrics);
+            if (!metrics_server->start()) {
+                RV_LOG_WARN("app", "Metrics export disabled");
+                metrics_server.reset();
+            }
+        }
+        return true;    // Optional: never fails startup
+    });
 
-    if (!osd->initialize(osd_config)) {
-        std::cerr << "ERROR: Failed to initialize OSD renderer!\n";
+    if (!config.headless && config.telemetry.enabled) {
+        startup.add("telemetry", {}, StartupThread::Worker, [&] {
+            telemetry = std::make_unique<TelemetryReceiver>(config.telemetry);
+            if (!telemetry->start()) {
+                RV_LOG_WARN("app", "Telemetry disabled");
+                telemetry.reset();
+            }
+            return true;    // Optional: never fails startup
+        });
+    }
+
+    if (!config.headless) {
+        startup.add("window", {}, StartupThread::Main, [&] {
+            window = createWindow();
+            if (!window->initialize(config.window)) {
+                RV_LOG_ERROR("app", "Failed to create window (use --headless to run without one)");
+                return false;
+            }
+            return true;
+        });
+        startup.add("texture", {"window"}, StartupThread::Main, [&] {
+            if (!renderer.initialize(config.pipeline.width, config.pipeline.height)) {
+                RV_LOG_ERROR("app", "Failed to initialize texture renderer");
+                return false;
+            }
+            return true;
+        });
+        startup.add("osd", {"window"}, StartupThread::Main, [&] {
+            osd = createOSD();
+            if (!osd->initialize(config.osd)) {
+                RV_LOG_ERROR("app", "Failed to initialize OSD renderer");
+                return false;
+            }
+            return true;
+        });
+    }
+
+    if (!startup.run()) {
+        RV_LOG_ERROR("app", "Startup failed{}", startup.failedStep().empty()
+                                                    ? std::string()
+                                                    : " at step '" + startup.failedStep() + "'");
+        if (metrics_server) {
+            metrics_server->stop();
+        }
+        pipeline->stop();
+        if (osd) {
+            osd->shutdown();
+        }
+        renderer.shutdown();
+        if (window) {
+            window->shutdown();
+        }
         cleanupGStreamer();
+        Logger::global().shutdown();
         return 1;
     }
 
     // ========================================================================
-    // Step 7: Create Detection Client (Phase 4)
+    // Headless: no window, texture or OSD
     // ========================================================================
-    std::cout << "\n--- Creating Detection Client ---\n";
-    auto detector = createDetectionClient();
-    bool detector_connected = false;
-
-    // Try to connect to vision-detector service (non-blocking, optional)
-    std::cout << "  Attempting to connect to vision-detector...\n";
-    if (detector->connect()) {
-        detector_connected = true;
-        std::cout << "  Detection service connected!\n";
-
-        // Test heartbeat
-        if (detector->sendHeartbeat()) {
-            std::cout << "  Heartbeat OK - connection verified!\n";
+    if (config.headless) {
+        int rc = runHeadless(*platform, *pipeline, *detector, config_manager, process_start_ns);
+        if (metrics_server) {
+            metrics_server->stop();
         }
-    } else {
-        std::cout << "  Detection service not available (running standalone)\n";
-        std::cout << "  Start vision-detector service to enable detection\n";
+        cleanupGStreamer();
+        RV_LOG_INFO("app", "Goodbye!");
+        Logger::global().shutdown();
+        return rc;
     }
 
     // ========================================================================
-    // Step 8: Start Video Capture
+    // Step 3: Start Pipeline Stages
     // ========================================================================
-    std::cout << "\n--- Starting Video Capture ---\n";
-    if (!pipeline->start()) {
-        std::cerr << "ERROR: Failed to start video pipeline!\n";
-        std::cerr << "  " << pipeline->getLastError() << "\n";
+    RV_LOG_INFO("app", "--- Starting Pipeline Stages ---");
+    auto staged = createStagedPipeline(*pipeline, *detector, config.stages);
+    staged->addDetectionSink(std::make_shared<ConsoleDetectionSink>());
+    auto snapshots = attachSnapshotWriter(*staged, config.snapshot);
+    auto recorder = attachEventRecorder(*staged, config, *platform);
+    auto detection_log = attachDetectionLog(*staged, config.detection_log);
+    auto streamer = attachStreamer(*staged, config, *platform);
+    auto mjpeg = attachMjpegServer(*staged, config.mjpeg);
+    auto framebus = attachFrameBus(*staged, config.framebus);
+    auto processors = attachProcessorGraph(*staged, config.processing);
+    auto undistorter = attachUndistortion(*staged, config.undistort);
+    auto stabilizer = attachDisplayCorrection(renderer, config);
+    if (!staged->start()) {
+        RV_LOG_ERROR("app", "Failed to start pipeline stages");
+        pipeline->stop();
         cleanupGStreamer();
         return 1;
     }
+    auto governor = startGovernor(*staged, *pipeline, config);
 
-    std::cout << "\n========================================\n";
-    std::cout << "  Camera running! Close window to exit.\n";
-    if (detector_connected) {
-        std::cout << "  Detection: ENABLED\n";
-    } else {
-        std::cout << "  Detection: DISABLED (no server)\n";
-    }
-    std::cout << "========================================\n\n";
+    RV_LOG_INFO("app", "Camera running! Close window to exit. Detection: {}",
+                config.stages.enable_detection ? "connecting in background" : "DISABLED");
+    RV_LOG_INFO("app", "Keys: S = snapshot, T = dump trace");
 
     // ========================================================================
-    // Step 9: Main Loop
+    // Step 4: Render Loop
     // ========================================================================
 
     /**
-     * TEACHING: Main Loop Structure (Phase 4 Update)
+     * TEACHING: Main Loop Structure (Staged Pipeline)
      * -----------------------------------------------
-     * Every real-time graphics application has a main loop:
+     * Capture, detector I/O and recording now run on their own threads
+     * (see core/staged_pipeline.h). This thread only does what must
+     * happen on the thread that owns the OpenGL context:
      * 1. Poll events (handle input, window events)
-     * 2. Update state (get new video frame)
-     * 3. Send frame to detector (if connected)
-     * 4. Receive detection results (if available)
-     * 5. Render video (draw video texture to screen)
-     * 6. Render OSD (draw overlay graphics on top, including detections)
-     * 7. Swap buffers (show the rendered frame)
-     * 8. Repeat until exit
+     * 2. Take the newest frame from the capture stage (if any)
+     * 3. Take the newest detection results (if any)
+     * 4. Render video (draw video texture to screen)
+     * 5. Render OSD (draw overlay graphics on top, including detections)
+     * 6. Swap buffers (show the rendered frame)
+     * 7. Repeat until exit
+     *
+     * Frame rate is now bounded by the slowest stage, not their sum.
      */
 
     uint32_t total_frames = 0;
@@ -205,93 +705,153 @@ int main() {
     float current_fps = 0.0f;
     auto start_time = std::chrono::steady_clock::now();
     auto last_fps_time = start_time;
-    auto last_heartbeat_time = start_time;
-    auto last_reconnect_time = start_time;
 
-    // Detection state (Phase 4 Milestone 2)
-    // current_detections: stores latest detections for OSD rendering (Milestone 3)
+    // Detection state
+    // current_detections: stores latest detections for OSD rendering
     // last_detection_frame_id: correlates results to frames (for future latency tracking)
     std::vector<detector_protocol::Detection> current_detections;
+    std::shared_ptr<const DetectionSet> shown_detections;   // For the run report's staleness
     uint64_t last_detection_frame_id = 0;
     float last_inference_time_ms = 0.0f;
-    (void)last_detection_frame_id;  // Will be used in Milestone 3 for latency calculation
+    bool detector_connected = false;
+    bool first_frame_shown = false;
+    (void)last_detection_frame_id;  // Will be used for latency calculation
 
-    // Frame throttling: don't overwhelm detector (target ~10 FPS for detection)
-    auto last_frame_sent_time = std::chrono::steady_clock::now();
-    constexpr int DETECTION_TARGET_FPS = 10;
-    constexpr auto DETECTION_FRAME_INTERVAL = std::chrono::milliseconds(1000 / DETECTION_TARGET_FPS);
+    // Server info is copied once per (re)connection, not every frame
+    ServerInfo detector_info{};
+    bool detector_info_valid = false;
+
+    // Flight state: copied once per frame; kept as-is if a read overlaps a write
+    TelemetrySnapshot flight{};
+    uint64_t shown_capture_ns = 0;      // Capture time of the frame on screen
+    FlightHud hud;                      // Builds its tick images on first draw
+    FramebufferReadback stream_readback;    // Composited stream; PBOs created on first use
+
+    // Render-thread metrics (registered once, updated lock-free per frame)
+    auto& registry = MetricsRegistry::global();
+    Histogram& upload_hist = registry.histogram("rv_texture_upload_seconds",
+                                                "Time to upload a frame to the GPU texture");
+    Histogram& frame_hist = registry.histogram("rv_render_frame_seconds",
+                                               "Render loop iteration time (includes vsync wait)");
+    Histogram& display_latency_hist = registry.histogram("rv_display_latency_seconds",
+                                                         "Frame capture until buffer swap");
+    Gauge& fps_gauge = registry.gauge("rv_render_fps", "Frames shown per second");
+    Histogram& readback_hist = registry.histogram("rv_stream_readback_seconds",
+                                                  "Framebuffer readback for the composited stream");
+    auto last_iteration = std::chrono::steady_clock::now();
+    auto last_present = last_iteration;
 
     // Calculate device pixel ratio for Retina displays
     float pixel_ratio = static_cast<float>(window->getFramebufferWidth()) /
                         static_cast<float>(window->getWidth());
 
+    // T dumps the trace rings (same as SIGUSR1), S saves a snapshot
+    window->setKeyCallback([](int key) {
+        if (key == 'T') {
+            g_trace_dump_requested.store(true);
+        } else if (key == 'S') {
+            g_snapshot_requested.store(true);
+        }
+    });
+
+    // Tagged last: threads created above must not inherit the loop's pinning
+    ScopedThreadRole thread_role("render");
+
+    // Fixed-length runs (run.max_frames) report what the operator would have seen
+    RunReport run_report(config.run);
+    run_report.start();
+
     while (!window->shouldClose()) {
-        // 1. Poll window events
-        window->pollEvents();
+        TRACE_SCOPE_FRAME("frame", frame_span);
+
+        // 1. Poll window events (and pending SIGHUP / SIGUSR1 requests)
+        {
+            TRACE_SCOPE("pollEvents");
+            window->pollEvents();
+        }
+        checkTraceDump();
+        if (checkConfigReload(config_manager)) {
+            if (governor) {
+                governor->setConfiguredDetectionRate(config.stages.detection_rate_hz);
+            } else {
+                staged->setDetectionRate(config.stages.detection_rate_hz);
+            }
+        }
 
-        // 2. Get latest video frame
-        auto frame = pipeline->getLatestFrame();
+        // Governor display cap: skip the whole redraw (texture, OSD, swap)
+        // until the next slot; the stage queues keep only the newest items
+        if (int display_hz = governor ? governor->displayRateHz() : 0) {
+            auto next_present = last_present + std::chrono::microseconds(1000000 / display_hz);
+            auto now = std::chrono::steady_clock::now();
+            if (now < next_present) {
+                std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+                    next_present - now, std::chrono::milliseconds(5)));
+                continue;
+            }
+        }
+        last_present = std::chrono::steady_clock::now();
 
-        if (frame && frame->isValid()) {
-            // 3. Upload frame to texture
+        // 2. Upload the newest captured frame (if a new one arrived)
+        auto frame = staged->acquireFrame();
+        if (frame) {
+            frame_span.setFrame(frame->frame_number);
+            shown_capture_ns = frame->capture_time_ns;
+            auto upload_start = std::chrono::steady_clock::now();
             renderer.updateTexture(frame->pixels, frame->width, frame->height);
-            frame_count++;
-            total_frames++;
+            upload_hist.record(std::chrono::steady_clock::now() - upload_start);
 
-            // 4. Send frame to detector (Phase 4 Milestone 2)
-            // Throttle to avoid overwhelming detector - only send at DETECTION_TARGET_FPS
-            if (detector_connected) {
-                auto now = std::chrono::steady_clock::now();
-                if (now - last_frame_sent_time >= DETECTION_FRAME_INTERVAL) {
-                    if (!detector->sendFrame(frame->pixels.data(), frame->width, frame->height, total_frames)) {
-                        // Frame send failed - connection may be broken
-                        if (!detector->isConnected()) {
-                            std::cout << "WARNING: Lost connection to detector during frame send\n";
-                            detector_connected = false;
-                        }
-                    }
-                    last_frame_sent_time = now;
+            // Re-project against the attitude at this frame's capture time;
+            // without a live attitude the frame is shown as captured
+            if (stabilizer) {
+                if (telemetry) {
+                    telemetry->read(flight);
                 }
+                const uint64_t stale_ns = static_cast<uint64_t>(config.telemetry.stale_ms) * 1000000ull;
+                if (telemetry && flight.attitude_ns != 0 && flight.linkAlive(metricsNowNs(), stale_ns)) {
+                    float roll = 0.0f, pitch = 0.0f, yaw = 0.0f;
+                    flight.attitudeAt(frame->capture_time_ns, roll, pitch, yaw);
+                    stabilizer->update(frame->capture_time_ns, roll, pitch, yaw);
+                } else {
+                    stabilizer->reset();
+                }
+                float homography[9];
+                renderer.setStabilization(stabilizer->homography(frame->width, frame->height, homography)
+                                              ? homography : nullptr);
             }
+            frame_count++;
+            total_frames++;
         }
 
-        // 5. Receive detection results (non-blocking poll)
-        if (detector_connected) {
-            uint64_t result_frame_id = 0;
-            float inference_time = 0.0f;
-            std::vector<detector_protocol::Detection> new_detections;
-
-            if (detector->receiveDetections(new_detections, result_frame_id, inference_time)) {
-                current_detections = std::move(new_detections);
-                last_detection_frame_id = result_frame_id;
-                last_inference_time_ms = inference_time;
-
-                // Debug: log when detections are received
-                if (!current_detections.empty()) {
-                    std::cout << "Received " << current_detections.size() << " detections (frame "
-                              << result_frame_id << ", " << inference_time << "ms):\n";
-                    for (const auto& det : current_detections) {
-                        std::cout << "  - " << det.label << " " << (det.confidence * 100) << "% at ["
-                                  << det.x << "," << det.y << " " << det.width << "x" << det.height << "]\n";
-                    }
-                }
-            }
+        // 3. Take the newest detection results (non-blocking)
+        if (auto results = staged->acquireDetections()) {
+            current_detections = results->detections;
+            last_detection_frame_id = results->frame_id;
+            last_inference_time_ms = results->inference_time_ms;
+            shown_detections = results;
         }
 
-        // 6. Render video texture to window
+        detector_connected = staged->isDetectorConnected();
+        if (detector_connected && !detector_info_valid) {
+            detector_info = staged->getDetectorInfo();
+            detector_info_valid = true;
+        } else if (!detector_connected) {
+            detector_info_valid = false;
+        }
+
+        // 4. Render video texture to window
         renderer.render(window->getFramebufferWidth(), window->getFramebufferHeight());
 
-        // 7. Render OSD overlay
+        // 5. Render OSD overlay
         int fb_width = window->getFramebufferWidth();
         int fb_height = window->getFramebufferHeight();
 
-        // Relative font sizes (percentage of screen height)
-        float label_font_size = static_cast<float>(fb_height) * 0.025f;      // 2.5% for detection labels
-        float status_font_size = static_cast<float>(fb_height) * 0.022f;     // 2.2% for status text
-        float label_padding = static_cast<float>(fb_height) * 0.005f;        // 0.5% padding
-        float box_line_width = static_cast<float>(fb_height) * 0.003f;       // 0.3% line width
-        float label_offset_y = label_font_size * 1.5f;                       // Space above box for label
-        float status_margin = static_cast<float>(fb_height) * 0.03f;         // 3% margin from edge
+        // Relative font sizes (fraction of screen height, live-reloadable)
+        const OSDLayoutConfig& layout = config.osd_layout;
+        float label_font_size = static_cast<float>(fb_height) * layout.label_font_scale;
+        float status_font_size = static_cast<float>(fb_height) * layout.status_font_scale;
+        float label_padding = static_cast<float>(fb_height) * layout.padding_scale;
+        float box_line_width = static_cast<float>(fb_height) * layout.box_line_scale;
+        float status_margin = static_cast<float>(fb_height) * layout.status_margin_scale;
 
         osd->beginFrame(fb_width, fb_height, pixel_ratio);
 
@@ -303,7 +863,7 @@ int main() {
 
         // Draw model info (top-left, below timestamp) when connected
         if (detector_connected) {
-            const auto& info = detector->getServerInfo();
+            const auto& info = detector_info;
             std::string model_text = info.model_name + " (" + info.getModelTypeString() + ") " + info.getModelSizeString();
             osd->drawTextWithBackground(
                 10.0f,
@@ -319,40 +879,22 @@ int main() {
         // Draw frame counter (bottom-left)
         osd->drawFrameCounter(total_frames, 10.0f, static_cast<float>(fb_height) - status_margin);
 
-        // Draw detection bounding boxes (Phase 4 Milestone 3)
-        for (const auto& det : current_detections) {
-            // Convert normalized coordinates to screen pixels
-            float box_x = det.x * static_cast<float>(fb_width);
-            float box_y = det.y * static_cast<float>(fb_height);
-            float box_w = det.width * static_cast<float>(fb_width);
-            float box_h = det.height * static_cast<float>(fb_height);
-
-            // Color based on confidence (green = high, yellow = medium, red = low)
-            Color box_color;
-            if (det.confidence >= 0.7f) {
-                box_color = Color::green();
-            } else if (det.confidence >= 0.4f) {
-                box_color = Color::yellow();
-            } else {
-                box_color = Color::red();
+        // Draw flight telemetry (bottom-left, above frame counter)
+        if (telemetry) {
+            telemetry->read(flight);
+            drawTelemetryLine(*osd, flight, shown_capture_ns, config.telemetry.stale_ms,
+                              10.0f, static_cast<float>(fb_height) - status_margin - status_font_size * 1.8f,
+                              label_padding, status_font_size * 0.9f);
+            if (config.hud.enabled) {
+                hud.draw(*osd, flight, shown_capture_ns, config.telemetry.stale_ms,
+                         fb_width, fb_height, config.hud);
             }
-
-            // Draw bounding box
-            osd->drawRectOutline(box_x, box_y, box_w, box_h, box_color, box_line_width);
-
-            // Draw label with confidence
-            std::string label = std::string(det.label) + " " +
-                std::to_string(static_cast<int>(det.confidence * 100)) + "%";
-            osd->drawTextWithBackground(
-                box_x, box_y - label_offset_y,  // Above the box
-                label,
-                Color::white(),
-                Color{box_color.r, box_color.g, box_color.b, 0.7f},  // Semi-transparent bg
-                label_padding,
-                label_font_size
-            );
         }
 
+        // Draw detection bounding boxes (Phase 4 Milestone 3)
+        drawDetections(*osd, current_detections, fb_width, fb_height,
+                       DetectionOverlayStyle{label_font_size, label_padding, box_line_width});
+
         // Draw detector status and detection count (bottom-right)
         std::string detector_status;
         Color status_color;
@@ -391,64 +933,126 @@ int main() {
 
         osd->endFrame();
 
-        // 8. Swap buffers
-        window->swapBuffers();
+        // Snapshot key: composited readback (what's on screen) or next raw frame
+        if (g_snapshot_requested.exchange(false) && snapshots) {
+            if (config.snapshot.composited) {
+                snapshots->submit(captureFramebuffer(fb_width, fb_height), "key");
+            } else {
+                snapshots->requestSnapshot("key");
+            }
+        }
+
+        // Composited stream: read back what the operator sees, at the stream rate.
+        // The read started on an earlier frame is collected; the GPU finished it long ago.
+        if (streamer && streamer->isComposited()) {
+            auto readback_start = std::chrono::steady_clock::now();
+            if (auto image = stream_readback.collect()) {
+                streamer->submit(image);
+            }
+            if (streamer->wantsCompositedFrame()) {
+                stream_readback.start(fb_width, fb_height);
+            }
+            readback_hist.record(std::chrono::steady_clock::now() - readback_start);
+        }
+
+        // 6. Swap buffers (blocks for vsync)
+        {
+            TRACE_SCOPE("swapBuffers");
+            window->swapBuffers();
+        }
 
-        // Update FPS calculation and periodic heartbeat every second
         auto now = std::chrono::steady_clock::now();
+        frame_hist.record(now - last_iteration);
+        last_iteration = now;
+        if (frame) {
+            if (!first_frame_shown) {
+                reportTimeToFirstFrame(process_start_ns);
+                first_frame_shown = true;
+            }
+            uint64_t present_ns = metricsNowNs();
+            if (frame->capture_time_ns > 0) {
+                display_latency_hist.record(present_ns - frame->capture_time_ns);
+            }
+            run_report.recordFrame(present_ns, *frame, shown_detections.get());
+        }
+
+        // Update FPS calculation every second
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_fps_time).count();
 
         if (elapsed >= 1000) {
             current_fps = frame_count * 1000.0f / static_cast<float>(elapsed);
+            fps_gauge.set(current_fps);
             std::string title = "Robot Vision Demo - " + std::to_string(static_cast<int>(current_fps)) + " FPS";
             window->setTitle(title);
             frame_count = 0;
             last_fps_time = now;
+        }
 
-            // Periodic heartbeat to check connection health
-            if (detector_connected) {
-                auto heartbeat_elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-                    now - last_heartbeat_time).count();
-                if (heartbeat_elapsed >= 5) {  // Every 5 seconds
-                    if (!detector->sendHeartbeat()) {
-                        std::cout << "WARNING: Lost connection to detector\n";
-                        detector->disconnect();  // Clean up old connection
-                        detector_connected = false;
-                    }
-                    last_heartbeat_time = now;
-                }
-            } else {
-                // Try to reconnect every 3 seconds
-                auto reconnect_elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-                    now - last_reconnect_time).count();
-                if (reconnect_elapsed >= 3) {
-                    if (detector->connect()) {
-                        detector_connected = true;
-                        std::cout << "Reconnected to detector!\n";
-                        if (detector->sendHeartbeat()) {
-                            std::cout << "Heartbeat OK\n";
-                        }
-                        last_heartbeat_time = now;
-                    }
-                    last_reconnect_time = now;
-                }
-            }
+        if (config.run.max_frames > 0 && total_frames >= config.run.max_frames) {
+            break;
         }
     }
+    run_report.finish();  // Sample per-thread CPU while the stage threads still exist
 
     // ========================================================================
     // Cleanup
     // ========================================================================
-    std::cout << "\n--- Shutting Down ---\n";
-    if (detector_connected) {
+    RV_LOG_INFO("app", "--- Shutting Down ---");
+    if (governor) {
+        governor->stop();
+    }
+    ThreadRegistry::global().logSummary();   // While the stage threads still exist
+    staged->stop();  // Join stage threads before tearing down what they use
+    printStageStats(staged->getStats());
+    if (snapshots) {
+        snapshots->stop();  // Finishes queued snapshots
+    }
+    if (recorder) {
+        recorder->stop();   // Closes an open clip (post-roll cut short)
+    }
+    if (detection_log) {
+        detection_log->stop();  // Final flush and index entry
+    }
+    if (streamer) {
+        streamer->stop();
+    }
+    if (mjpeg) {
+        mjpeg->stop();      // Disconnects viewers
+    }
+    if (framebus) {
+        framebus->stop();   // Readers see the control socket close
+    }
+    if (processors) {
+        processors->stop(); // Logs per-processor timings
+    }
+    if (undistorter) {
+        undistorter->stop();
+    }
+    if (config.run.max_frames > 0 || !config.run.report_path.empty()) {
+        run_report.print();
+        run_report.write();
+    }
+    if (metrics_server) {
+        metrics_server->stop();  // Writes a final snapshot while stage stats are still live
+    }
+    if (telemetry) {
+        telemetry->stop();
+    }
+    if (config.trace.dump_on_exit && Tracer::global().enabled()) {
+        Tracer::global().dump();
+    }
+    if (detector->isConnected()) {
         detector->disconnect();
     }
     pipeline->stop();
+    hud.release(*osd);    // HUD images live in the OSD's GL context
+    stream_readback.release();
     osd->shutdown();      // Shutdown OSD before window (needs OpenGL context)
     renderer.shutdown();
     window->shutdown();
     cleanupGStreamer();
 
-    std::cout << "  Goodbye!\n\n";
+    RV_LOG_INFO("app", "Goodbye!");
+    Logger::global().shutdown();
     return 0;
 }
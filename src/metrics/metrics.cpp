@@ -0,0 +1,264 @@
+/**
+ * @file metrics.cpp
+ * @brief Metrics registry and Prometheus/JSON rendering
+ */
+
+#include "metrics.h"
+#include "util/logger.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace robot_vision {
+
+namespace {
+
+constexpr double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+double toSeconds(uint64_t ns) {
+    return static_cast<double>(ns) * 1e-9;
+}
+
+std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+/**
+ * name{labels} or name{labels,extra} - handles empty label sets
+ */
+std::string series(const std::string& name, const std::string& labels,
+                   const std::string& extra = "") {
+    if (labels.empty() && extra.empty()) {
+        return name;
+    }
+    std::string all = labels;
+    if (!extra.empty()) {
+        all += (all.empty() ? "" : ",") + extra;
+    }
+    return name + "{" + all + "}";
+}
+
+} // namespace
+
+// ============================================================================
+// Histogram
+// ============================================================================
+
+uint64_t Histogram::bucketUpperBound(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    uint64_t shift = index / SUB_BUCKETS - 1;
+    uint64_t sub = index % SUB_BUCKETS + SUB_BUCKETS;
+    if (index == NUM_BUCKETS - 1) {
+        return UINT64_MAX;      // (sub + 1) << shift would overflow
+    }
+    return ((sub + 1) << shift) - 1;
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot snap;
+    snap.buckets.resize(NUM_BUCKETS);
+    for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+        snap.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        snap.count += snap.buckets[i];
+    }
+    snap.sum_ns = sum_.load(std::memory_order_relaxed);
+    snap.max_ns = max_.load(std::memory_order_relaxed);
+    return snap;
+}
+
+uint64_t Histogram::Snapshot::quantile(double q) const {
+    uint64_t total = count;
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), max_ns);
+        }
+    }
+    return max_ns;
+}
+
+// ============================================================================
+// Registry
+// ============================================================================
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Metric& MetricsRegistry::getOrCreate(Kind kind, const std::string& name,
+                                                      const std::string& help,
+                                                      const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto key = std::make_pair(name, labels);
+    auto it = metrics_.find(key);
+    if (it != metrics_.end()) {
+        if (it->second.kind == kind) {
+            return it->second;
+        }
+        // Programming error: same series registered as two kinds. Hand out a
+        // private metric so the caller still works, but don't export it.
+        RV_LOG_ERROR("metrics", "Metric {} registered with conflicting types", series(name, labels));
+        orphans_.push_back(Metric{kind, name, labels, help, nullptr, nullptr, nullptr});
+        Metric& orphan = orphans_.back();
+        orphan.counter = std::make_unique<Counter>();
+        orphan.gauge = std::make_unique<Gauge>();
+        orphan.histogram = std::make_unique<Histogram>();
+        return orphan;
+    }
+
+    Metric metric{kind, name, labels, help, nullptr, nullptr, nullptr};
+    switch (kind) {
+        case Kind::Counter:   metric.counter = std::make_unique<Counter>(); break;
+        case Kind::Gauge:     metric.gauge = std::make_unique<Gauge>(); break;
+        case Kind::Histogram: metric.histogram = std::make_unique<Histogram>(); break;
+    }
+    return metrics_.emplace(key, std::move(metric)).first->second;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help,
+                                  const std::string& labels) {
+    return *getOrCreate(Kind::Counter, name, help, labels).counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help,
+                              const std::string& labels) {
+    return *getOrCreate(Kind::Gauge, name, help, labels).gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                      const std::string& labels) {
+    return *getOrCreate(Kind::Histogram, name, help, labels).histogram;
+}
+
+int MetricsRegistry::addCollector(std::function<void()> collector) {
+    std::lock_guard<std::mutex> lock(collector_mutex_);
+    int id = next_collector_id_++;
+    collectors_.emplace(id, std::move(collector));
+    return id;
+}
+
+void MetricsRegistry::removeCollector(int id) {
+    // Taking the lock also waits for a collector that is running right now
+    std::lock_guard<std::mutex> lock(collector_mutex_);
+    collectors_.erase(id);
+}
+
+void MetricsRegistry::runCollectors() {
+    std::lock_guard<std::mutex> lock(collector_mutex_);
+    for (auto& kv : collectors_) {
+        kv.second();
+    }
+}
+
+// ============================================================================
+// Export
+// ============================================================================
+
+std::string MetricsRegistry::renderPrometheus() {
+    runCollectors();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream out;
+    out << std::setprecision(9);
+
+    const std::string* last_family = nullptr;
+    for (const auto& kv : metrics_) {
+        const Metric& m = kv.second;
+
+        // HELP/TYPE once per family (map order keeps a family's series together)
+        if (!last_family || *last_family != m.name) {
+            const char* type = m.kind == Kind::Counter ? "counter"
+                             : m.kind == Kind::Gauge   ? "gauge"
+                                                       : "summary";
+            out << "# HELP " << m.name << " " << m.help << "\n";
+            out << "# TYPE " << m.name << " " << type << "\n";
+            last_family = &m.name;
+        }
+
+        switch (m.kind) {
+            case Kind::Counter:
+                out << series(m.name, m.labels) << " " << m.counter->value() << "\n";
+                break;
+            case Kind::Gauge:
+                out << series(m.name, m.labels) << " " << m.gauge->value() << "\n";
+                break;
+            case Kind::Histogram: {
+                auto snap = m.histogram->snapshot();
+                for (double q : QUANTILES) {
+                    std::ostringstream label;
+                    label << "quantile=\"" << q << "\"";
+                    out << series(m.name, m.labels, label.str()) << " "
+                        << toSeconds(snap.quantile(q)) << "\n";
+                }
+                out << series(m.name + "_sum", m.labels) << " " << toSeconds(snap.sum_ns) << "\n";
+                out << series(m.name + "_count", m.labels) << " " << snap.count << "\n";
+                break;
+            }
+        }
+    }
+    return out.str();
+}
+
+std::string MetricsRegistry::renderJson() {
+    runCollectors();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream out;
+    out << std::setprecision(9);
+
+    auto wall_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    out << "{\"timestamp_ms\":" << wall_ms << ",\"metrics\":[";
+
+    bool first = true;
+    for (const auto& kv : metrics_) {
+        const Metric& m = kv.second;
+        out << (first ? "" : ",") << "\n{\"name\":\"" << m.name << "\"";
+        if (!m.labels.empty()) {
+            out << ",\"labels\":\"" << jsonEscape(m.labels) << "\"";
+        }
+        first = false;
+
+        switch (m.kind) {
+            case Kind::Counter:
+                out << ",\"type\":\"counter\",\"value\":" << m.counter->value() << "}";
+                break;
+            case Kind::Gauge:
+                out << ",\"type\":\"gauge\",\"value\":" << m.gauge->value() << "}";
+                break;
+            case Kind::Histogram: {
+                auto snap = m.histogram->snapshot();
+                out << ",\"type\":\"histogram\",\"count\":" << snap.count
+                    << ",\"sum_s\":" << toSeconds(snap.sum_ns)
+                    << ",\"max_s\":" << toSeconds(snap.max_ns)
+                    << ",\"p50_s\":" << toSeconds(snap.quantile(0.5))
+                    << ",\"p90_s\":" << toSeconds(snap.quantile(0.9))
+                    << ",\"p99_s\":" << toSeconds(snap.quantile(0.99))
+                    << ",\"p999_s\":" << toSeconds(snap.quantile(0.999)) << "}";
+                break;
+            }
+        }
+    }
+    out << "\n]}\n";
+    return out.str();
+}
+
+} // namespace robot_vision
@@ -0,0 +1,278 @@
+#pragma once
+
+/**
+ * @file metrics.h
+ * @brief Lock-free counters, gauges and latency histograms
+ *
+ * Metrics are registered once (slow, takes a lock) and the returned
+ * reference is kept by the code that updates it. Updating is a single
+ * relaxed atomic add - no lock, no lookup, no allocation:
+ *
+ *   // At startup
+ *   Counter& frames = MetricsRegistry::global().counter(
+ *       "rv_frames_captured_total", "Frames taken from the camera");
+ *   Histogram& pull = MetricsRegistry::global().histogram(
+ *       "rv_capture_pull_seconds", "Time to pull a frame from GStreamer");
+ *
+ *   // Hot path
+ *   frames.inc();
+ *   pull.record(elapsed_ns);
+ *
+ * TEACHING: Why Relaxed Atomics?
+ * ------------------------------
+ * A metric doesn't need to be ordered with anything else - a scrape that
+ * sees a counter a few nanoseconds late is still correct. memory_order_relaxed
+ * compiles to a plain locked add on x86 and ldadd on ARMv8.1, with no
+ * fences. Cost: a few nanoseconds when the cache line isn't contended.
+ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace robot_vision {
+
+// ============================================================================
+// Metric Types
+// ============================================================================
+
+/**
+ * Monotonic counter
+ */
+class Counter {
+public:
+    void inc(uint64_t n = 1) {
+        value_.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /**
+     * Mirror a counter kept elsewhere (for collectors, see addCollector)
+     */
+    void set(uint64_t value) {
+        value_.store(value, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+/**
+ * Value that can go up and down
+ */
+class Gauge {
+public:
+    void set(double value) {
+        bits_.store(toBits(value), std::memory_order_relaxed);
+    }
+
+    double value() const {
+        return fromBits(bits_.load(std::memory_order_relaxed));
+    }
+
+private:
+    static uint64_t toBits(double v) {
+        uint64_t b;
+        std::memcpy(&b, &v, sizeof(b));
+        return b;
+    }
+
+    static double fromBits(uint64_t b) {
+        double v;
+        std::memcpy(&v, &b, sizeof(v));
+        return v;
+    }
+
+    std::atomic<uint64_t> bits_{0};     // double stored as bits (0 == 0.0)
+};
+
+/**
+ * Latency histogram in nanoseconds (HDR-style log-linear buckets)
+ *
+ * TEACHING: Log-Linear Buckets
+ * ----------------------------
+ * Each power of two is split into SUB_BUCKETS equal slices, so every
+ * bucket is at most 1/16 (~6%) wide relative to its value whether the
+ * latency is 800 ns or 80 ms. The bucket index comes from the position
+ * of the highest set bit (one instruction) plus the next 4 bits - no
+ * loops, no floating point on the hot path.
+ */
+class Histogram {
+public:
+    static constexpr int SUB_BITS = 4;
+    static constexpr uint64_t SUB_BUCKETS = 1u << SUB_BITS;   // 16 per octave
+    static constexpr size_t NUM_BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    /**
+     * Record one value in nanoseconds
+     */
+    void record(uint64_t ns) {
+        buckets_[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t prev = max_.load(std::memory_order_relaxed);
+        while (ns > prev && !max_.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * Record a steady-clock duration
+     */
+    void record(std::chrono::steady_clock::duration d) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+    }
+
+    /**
+     * Point-in-time copy for export
+     */
+    struct Snapshot {
+        uint64_t count = 0;
+        uint64_t sum_ns = 0;
+        uint64_t max_ns = 0;
+        std::vector<uint64_t> buckets;
+
+        /**
+         * Value at quantile q (0..1), as the upper edge of its bucket
+         */
+        uint64_t quantile(double q) const;
+    };
+
+    Snapshot snapshot() const;
+
+    static size_t bucketIndex(uint64_t v) {
+        if (v < SUB_BUCKETS) {
+            return static_cast<size_t>(v);
+        }
+        int msb = 63 - __builtin_clzll(v);
+        int shift = msb - SUB_BITS;
+        return static_cast<size_t>((shift + 1) * SUB_BUCKETS + ((v >> shift) - SUB_BUCKETS));
+    }
+
+    static uint64_t bucketUpperBound(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets_{};
+    std::atomic<uint64_t> sum_{0};       // Count is the bucket total (one less atomic per record)
+    std::atomic<uint64_t> max_{0};
+};
+
+// ============================================================================
+// Registry
+// ============================================================================
+
+/**
+ * Owns all metrics and renders them for export
+ *
+ * Registration and export are thread-safe and take a lock; updating a
+ * metric through its reference never does. References stay valid for
+ * the life of the registry. Registering the same name and labels twice
+ * returns the same metric.
+ */
+class MetricsRegistry {
+public:
+    MetricsRegistry() = default;
+
+    // Non-copyable (hands out references to its metrics)
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /**
+     * Process-wide registry used by the pipeline stages
+     */
+    static MetricsRegistry& global();
+
+    /**
+     * Get or create a metric
+     *
+     * @param name Prometheus metric name (e.g. "rv_frames_captured_total")
+     * @param help One-line description
+     * @param labels Prometheus label set without braces, e.g. "stage=\"render\""
+     */
+    Counter& counter(const std::string& name, const std::string& help,
+                     const std::string& labels = "");
+    Gauge& gauge(const std::string& name, const std::string& help,
+                 const std::string& labels = "");
+
+    /**
+     * Get or create a latency histogram
+     *
+     * Values are recorded in nanoseconds and exported in seconds, so the
+     * name should end in "_seconds".
+     */
+    Histogram& histogram(const std::string& name, const std::string& help,
+                         const std::string& labels = "");
+
+    /**
+     * Register a callback run before every export
+     *
+     * Lets components publish state they already track (queue stats,
+     * connection flags) without touching metrics on their hot path.
+     *
+     * @return Id for removeCollector()
+     */
+    int addCollector(std::function<void()> collector);
+
+    /**
+     * Unregister a collector (call before the captured object dies)
+     */
+    void removeCollector(int id);
+
+    /**
+     * Render all metrics in Prometheus text exposition format
+     *
+     * Histograms are exported as summaries (quantiles + sum + count).
+     */
+    std::string renderPrometheus();
+
+    /**
+     * Render all metrics as a JSON object
+     */
+    std::string renderJson();
+
+private:
+    enum class Kind { Counter, Gauge, Histogram };
+
+    struct Metric {
+        Kind kind;
+        std::string name;
+        std::string labels;
+        std::string help;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    Metric& getOrCreate(Kind kind, const std::string& name, const std::string& help,
+                        const std::string& labels);
+    void runCollectors();
+
+    std::mutex mutex_;
+    std::map<std::pair<std::string, std::string>, Metric> metrics_;   // (name, labels), groups families
+    std::vector<Metric> orphans_;               // Returned on kind mismatch (not exported)
+
+    std::mutex collector_mutex_;
+    std::map<int, std::function<void()>> collectors_;
+    int next_collector_id_ = 1;
+};
+
+/**
+ * Steady-clock now in nanoseconds (same clock as FrameData::capture_time_ns)
+ */
+inline uint64_t metricsNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace robot_vision
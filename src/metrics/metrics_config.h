@@ -0,0 +1,29 @@
+#pragma once
+
+/**
+ * @file metrics_config.h
+ * @brief Metrics export settings
+ */
+
+#include <string>
+
+namespace robot_vision {
+
+/**
+ * Metrics export configuration
+ */
+struct MetricsConfig {
+    std::string listen = "";            // "127.0.0.1:9100", ":9100", "unix:/path" (empty = off)
+    std::string snapshot_path = "";     // JSON snapshot file (empty = off)
+    int snapshot_interval_s = 10;       // Snapshot period
+
+    bool isEnabled() const {
+        return !listen.empty() || !snapshot_path.empty();
+    }
+
+    bool isValid() const {
+        return snapshot_interval_s > 0;
+    }
+};
+
+} // namespace robot_vision
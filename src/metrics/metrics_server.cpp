@@ -0,0 +1,311 @@
+/**
+ * @file metrics_server.cpp
+ * @brief Minimal HTTP/1.0 metrics endpoint and JSON snapshot writer
+ */
+
+#include "metrics_server.h"
+#include "util/logger.h"
+#include "util/thread_policy.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace robot_vision {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Longest the thread sleeps in poll() before re-checking running_
+constexpr int POLL_SLICE_MS = 200;
+
+// Slow or idle clients are dropped after this long
+constexpr int CLIENT_TIMEOUT_MS = 500;
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;       // SIGPIPE is ignored process-wide (main.cpp)
+#endif
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::send(fd, data, size, SEND_FLAGS);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void sendResponse(int fd, const char* status, const char* content_type, const std::string& body) {
+    std::string head = std::string("HTTP/1.0 ") + status + "\r\n" +
+                       "Content-Type: " + content_type + "\r\n" +
+                       "Content-Length: " + std::to_string(body.size()) + "\r\n" +
+                       "Connection: close\r\n\r\n";
+    if (writeAll(fd, head.data(), head.size())) {
+        writeAll(fd, body.data(), body.size());
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+MetricsServer::MetricsServer(MetricsRegistry& registry, const MetricsConfig& config)
+    : registry_(registry)
+    , config_(config)
+{
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start() {
+    if (running_) {
+        return true;
+    }
+    if (!config_.isValid()) {
+        setError("Invalid metrics configuration");
+        return false;
+    }
+    if (!config_.listen.empty() && !openListener()) {
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&MetricsServer::serveLoop, this);
+
+    if (!config_.listen.empty()) {
+        RV_LOG_INFO("metrics", "Metrics: serving /metrics on {}", config_.listen);
+    }
+    if (!config_.snapshot_path.empty()) {
+        RV_LOG_INFO("metrics", "Metrics: JSON snapshot every {}s to {}",
+                    config_.snapshot_interval_s, config_.snapshot_path);
+    }
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+    if (!unix_path_.empty()) {
+        ::unlink(unix_path_.c_str());
+        unix_path_.clear();
+    }
+
+    // Final snapshot so short runs still leave a record
+    if (!config_.snapshot_path.empty()) {
+        writeSnapshot();
+    }
+}
+
+// ============================================================================
+// Listener
+// ============================================================================
+
+bool MetricsServer::openListener() {
+    const std::string& listen = config_.listen;
+
+    if (listen.compare(0, 5, "unix:") == 0) {
+        std::string path = listen.substr(5);
+        sockaddr_un addr{};
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            setError("Invalid metrics socket path: " + path);
+            return false;
+        }
+
+        listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) {
+            setError(std::string("socket() failed: ") + std::strerror(errno));
+            return false;
+        }
+
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        ::unlink(path.c_str());     // Stale socket from a previous run
+
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            setError("Cannot bind " + path + ": " + std::strerror(errno));
+            ::close(listen_fd_);
+            listen_fd_ = -1;
+            return false;
+        }
+        unix_path_ = path;
+    } else {
+        // [host:]port, host defaults to loopback - metrics are not for the world
+        std::string host = "127.0.0.1";
+        std::string port = listen;
+        size_t colon = listen.rfind(':');
+        if (colon != std::string::npos) {
+            if (colon > 0) {
+                host = listen.substr(0, colon);
+            }
+            port = listen.substr(colon + 1);
+        }
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        int port_num = std::atoi(port.c_str());
+        if (port_num <= 0 || port_num > 65535 || ::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+            setError("Invalid metrics listen address: " + listen);
+            return false;
+        }
+        addr.sin_port = htons(static_cast<uint16_t>(port_num));
+
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) {
+            setError(std::string("socket() failed: ") + std::strerror(errno));
+            return false;
+        }
+        int yes = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            setError("Cannot bind " + listen + ": " + std::strerror(errno));
+            ::close(listen_fd_);
+            listen_fd_ = -1;
+            return false;
+        }
+    }
+
+    if (::listen(listen_fd_, 8) < 0) {
+        setError(std::string("listen() failed: ") + std::strerror(errno));
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Thread
+// ============================================================================
+
+void MetricsServer::serveLoop() {
+#ifdef PLATFORM_MACOS
+    pthread_setname_np("rv-metrics");
+#else
+    pthread_setname_np(pthread_self(), "rv-metrics");
+#endif
+    ScopedThreadRole thread_role("background");
+
+    const auto snapshot_interval = std::chrono::seconds(config_.snapshot_interval_s);
+    auto next_snapshot = Clock::now() + snapshot_interval;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        if (listen_fd_ >= 0) {
+            pollfd pfd{listen_fd_, POLLIN, 0};
+            if (::poll(&pfd, 1, POLL_SLICE_MS) > 0 && (pfd.revents & POLLIN)) {
+                int client = ::accept(listen_fd_, nullptr, nullptr);
+                if (client >= 0) {
+                    handleClient(client);
+                    ::close(client);
+                }
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(POLL_SLICE_MS));
+        }
+
+        if (!config_.snapshot_path.empty() && Clock::now() >= next_snapshot) {
+            writeSnapshot();
+            next_snapshot += snapshot_interval;
+        }
+    }
+}
+
+void MetricsServer::handleClient(int client_fd) {
+    timeval tv{0, CLIENT_TIMEOUT_MS * 1000};
+    ::setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    // Read until the end of the request headers (we ignore any body)
+    char buf[2048];
+    size_t used = 0;
+    while (used < sizeof(buf) - 1) {
+        ssize_t n = ::recv(client_fd, buf + used, sizeof(buf) - 1 - used, 0);
+        if (n <= 0) {
+            break;
+        }
+        used += static_cast<size_t>(n);
+        buf[used] = '\0';
+        if (std::strstr(buf, "\r\n\r\n") || std::strstr(buf, "\n\n")) {
+            break;
+        }
+    }
+    buf[used] = '\0';
+
+    // Request line: "GET /path HTTP/1.x"
+    char method[8] = {0};
+    char path[256] = {0};
+    if (std::sscanf(buf, "%7s %255s", method, path) != 2) {
+        sendResponse(client_fd, "400 Bad Request", "text/plain", "Bad request\n");
+        return;
+    }
+    if (std::strcmp(method, "GET") != 0) {
+        sendResponse(client_fd, "405 Method Not Allowed", "text/plain", "GET only\n");
+        return;
+    }
+
+    std::string target = path;
+    if (target == "/metrics" || target == "/") {
+        sendResponse(client_fd, "200 OK", "text/plain; version=0.0.4", registry_.renderPrometheus());
+    } else if (target == "/metrics.json") {
+        sendResponse(client_fd, "200 OK", "application/json", registry_.renderJson());
+    } else {
+        sendResponse(client_fd, "404 Not Found", "text/plain", "Try /metrics or /metrics.json\n");
+    }
+}
+
+void MetricsServer::writeSnapshot() {
+    // Write-then-rename: readers never see a half-written file
+    std::string tmp = config_.snapshot_path + ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::trunc);
+        if (!file) {
+            RV_LOG_WARN("metrics", "Cannot write metrics snapshot {}", tmp);
+            return;
+        }
+        file << registry_.renderJson();
+        if (!file) {
+            RV_LOG_WARN("metrics", "Failed writing metrics snapshot {}", tmp);
+            return;
+        }
+    }
+    if (std::rename(tmp.c_str(), config_.snapshot_path.c_str()) != 0) {
+        RV_LOG_WARN("metrics", "Cannot rename {}: {}", tmp, std::strerror(errno));
+    }
+}
+
+void MetricsServer::setError(const std::string& error) {
+    last_error_ = error;
+    RV_LOG_ERROR("metrics", "{}", error);
+}
+
+} // namespace robot_vision
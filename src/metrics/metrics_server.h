@@ -0,0 +1,76 @@
+#pragma once
+
+/**
+ * @file metrics_server.h
+ * @brief Prometheus scrape endpoint and periodic JSON snapshots
+ *
+ * One background thread ("rv-metrics") serves:
+ *   GET /metrics        Prometheus text format
+ *   GET /metrics.json   Same data as JSON
+ * on a local TCP port or a Unix socket, and optionally writes the JSON
+ * form to a file every few seconds.
+ *
+ *   curl http://127.0.0.1:9100/metrics
+ *   curl --unix-socket /tmp/robot_vision_metrics.sock http://x/metrics
+ *
+ * TEACHING: Scrape, Don't Push
+ * ----------------------------
+ * Rendering metrics costs a few microseconds of string formatting. Doing
+ * it on the metrics thread only when someone asks keeps that cost off the
+ * capture and render threads entirely - they only ever do atomic adds.
+ */
+
+#include "metrics/metrics.h"
+#include "metrics/metrics_config.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace robot_vision {
+
+/**
+ * Metrics export thread
+ */
+class MetricsServer {
+public:
+    MetricsServer(MetricsRegistry& registry, const MetricsConfig& config);
+    ~MetricsServer();
+
+    // Non-copyable (owns a socket and a thread)
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    /**
+     * Bind the listener (if configured) and start the thread
+     *
+     * @return false if the listener could not be created (see getLastError)
+     */
+    bool start();
+
+    /**
+     * Stop the thread and close the listener (idempotent)
+     */
+    void stop();
+
+    const std::string& getLastError() const { return last_error_; }
+
+private:
+    bool openListener();
+    void serveLoop();
+    void handleClient(int client_fd);
+    void writeSnapshot();
+    void setError(const std::string& error);
+
+    MetricsRegistry& registry_;
+    MetricsConfig config_;
+
+    int listen_fd_ = -1;
+    std::string unix_path_;             // Unlinked on stop
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::string last_error_;
+};
+
+} // namespace robot_vision
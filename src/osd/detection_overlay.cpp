@@ -0,0 +1,50 @@
+/**
+ * @file detection_overlay.cpp
+ * @brief Detection bounding box rendering
+ */
+
+#include "detection_overlay.h"
+
+#include <string>
+
+namespace robot_vision {
+
+void drawDetections(IOSD& osd, const std::vector<detector_protocol::Detection>& detections,
+                    int fb_width, int fb_height, const DetectionOverlayStyle& style) {
+    const float label_offset_y = style.label_font_size * 1.5f;  // Space above box for label
+
+    for (const auto& det : detections) {
+        // Convert normalized coordinates to screen pixels
+        float box_x = det.x * static_cast<float>(fb_width);
+        float box_y = det.y * static_cast<float>(fb_height);
+        float box_w = det.width * static_cast<float>(fb_width);
+        float box_h = det.height * static_cast<float>(fb_height);
+
+        // Color based on confidence (green = high, yellow = medium, red = low)
+        Color box_color;
+        if (det.confidence >= 0.7f) {
+            box_color = Color::green();
+        } else if (det.confidence >= 0.4f) {
+            box_color = Color::yellow();
+        } else {
+            box_color = Color::red();
+        }
+
+        // Draw bounding box
+        osd.drawRectOutline(box_x, box_y, box_w, box_h, box_color, style.box_line_width);
+
+        // Draw label with confidence
+        std::string label = std::string(det.label) + " " +
+            std::to_string(static_cast<int>(det.confidence * 100)) + "%";
+        osd.drawTextWithBackground(
+            box_x, box_y - label_offset_y,  // Above the box
+            label,
+            Color::white(),
+            Color{box_color.r, box_color.g, box_color.b, 0.7f},  // Semi-transparent bg
+            style.label_padding,
+            style.label_font_size
+        );
+    }
+}
+
+} // namespace robot_vision
@@ -0,0 +1,36 @@
+#pragma once
+
+/**
+ * @file detection_overlay.h
+ * @brief Draws detection bounding boxes and labels through IOSD
+ *
+ * Shared by the render loop and the OSD benchmarks so both measure and
+ * draw exactly the same thing.
+ */
+
+#include "core/osd.h"
+#include <detector_protocol/protocol.h>
+
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * Sizes in framebuffer pixels (computed from OSDLayoutConfig by the caller)
+ */
+struct DetectionOverlayStyle {
+    float label_font_size = 18.0f;      // Label text size
+    float label_padding = 4.0f;         // Label background padding
+    float box_line_width = 2.0f;        // Bounding box stroke width
+};
+
+/**
+ * Draw one outlined box plus "label NN%" per detection
+ *
+ * Must be called between IOSD::beginFrame() and IOSD::endFrame().
+ * Detection coordinates are normalized (0..1) and scaled to the framebuffer.
+ */
+void drawDetections(IOSD& osd, const std::vector<detector_protocol::Detection>& detections,
+                    int fb_width, int fb_height, const DetectionOverlayStyle& style);
+
+} // namespace robot_vision
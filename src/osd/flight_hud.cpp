@@ -0,0 +1,477 @@
+/**
+ * @file flight_hud.cpp
+ * @brief HUD widget geometry, image building and per-frame drawing
+ */
+
+#include "flight_hud.h"
+#include "metrics/metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace robot_vision {
+
+namespace {
+
+constexpr float RAD_TO_DEG = 57.29578f;
+
+// Layout, in HUD units (1 unit = size_scale * framebuffer height)
+constexpr float HORIZON_WIDTH = 0.9f;
+constexpr float HORIZON_HEIGHT = 0.8f;
+constexpr float PITCH_VISIBLE_DEG = 40.0f;          // Across HORIZON_HEIGHT
+constexpr float PITCH_GAP = 0.16f;                  // Gap in the bars for the aircraft symbol
+constexpr float PITCH_BAR = 0.2f;                   // Length of a 10-degree bar (each side)
+constexpr float HEADING_HEIGHT = 0.1f;
+constexpr float HEADING_VISIBLE_DEG = 60.0f;        // Across HORIZON_WIDTH
+constexpr float LADDER_WIDTH = 0.2f;
+constexpr int LADDER_VISIBLE_MAJORS = 4;            // Labelled ticks in view
+constexpr float WIDGET_GAP = 0.03f;
+constexpr float FONT_SIZE = 0.045f;
+
+// Tick geometry in image pixels
+constexpr float LINE_WIDTH = 0.006f;                // Units
+constexpr float MIN_LINE_PX = 1.5f;
+constexpr float OUTLINE_PX = 1.0f;
+constexpr float BACKGROUND_ALPHA = 0.35f;
+
+// Larger images are built at reduced resolution and scaled up when drawn
+constexpr int MAX_IMAGE_PX = 4096;
+
+const Color SYMBOL_COLOR = Color::yellow();
+
+/**
+ * Premultiplied RGBA image built from anti-aliased axis-aligned rectangles
+ *
+ * Ticks, bars and tape backgrounds are all rectangles, so coverage is the
+ * rectangle's overlap with each pixel - exact, and no rasterizer needed.
+ */
+class Canvas {
+public:
+    Canvas(int width, int height)
+        : width_(width), height_(height), rgba_(static_cast<size_t>(width) * height * 4, 0) {}
+
+    /**
+     * Blend color over [x0, x1) x [y0, y1) (fractional edges partially covered)
+     */
+    void fill(float x0, float y0, float x1, float y1, Color color) {
+        const int px0 = std::max(0, static_cast<int>(std::floor(x0)));
+        const int py0 = std::max(0, static_cast<int>(std::floor(y0)));
+        const int px1 = std::min(width_, static_cast<int>(std::ceil(x1)));
+        const int py1 = std::min(height_, static_cast<int>(std::ceil(y1)));
+        for (int py = py0; py < py1; ++py) {
+            const float cover_y = std::min(y1, py + 1.0f) - std::max(y0, static_cast<float>(py));
+            for (int px = px0; px < px1; ++px) {
+                const float cover_x = std::min(x1, px + 1.0f) - std::max(x0, static_cast<float>(px));
+                const float alpha = color.a * cover_x * cover_y;
+                uint8_t* dst = &rgba_[(static_cast<size_t>(py) * width_ + px) * 4];
+                const float keep = 1.0f - alpha;
+                dst[0] = static_cast<uint8_t>(color.r * alpha * 255.0f + dst[0] * keep + 0.5f);
+                dst[1] = static_cast<uint8_t>(color.g * alpha * 255.0f + dst[1] * keep + 0.5f);
+                dst[2] = static_cast<uint8_t>(color.b * alpha * 255.0f + dst[2] * keep + 0.5f);
+                dst[3] = static_cast<uint8_t>(alpha * 255.0f + dst[3] * keep + 0.5f);
+            }
+        }
+    }
+
+    /**
+     * Bar with a dark outline, readable over sky and ground alike
+     */
+    void bar(float x0, float y0, float x1, float y1, Color color = Color::white()) {
+        fill(x0 - OUTLINE_PX, y0 - OUTLINE_PX, x1 + OUTLINE_PX, y1 + OUTLINE_PX, Color::transparent(0.6f));
+        fill(x0, y0, x1, y1, color);
+    }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    const uint8_t* data() const { return rgba_.data(); }
+
+private:
+    int width_;
+    int height_;
+    std::vector<uint8_t> rgba_;
+};
+
+bool upload(IOSD& osd, const Canvas& canvas, int unit, HudImage& image) {
+    image.release(osd);
+    image.handle = osd.createImage(canvas.width(), canvas.height(), canvas.data());
+    image.width = canvas.width();
+    image.height = canvas.height();
+    image.built_for = unit;
+    return image.handle != 0;
+}
+
+float lineWidth(float unit) {
+    return std::max(MIN_LINE_PX, LINE_WIDTH * unit);
+}
+
+/**
+ * Largest multiple of step not above value (also for negative values)
+ */
+int floorTo(float value, int step) {
+    return static_cast<int>(std::floor(value / static_cast<float>(step))) * step;
+}
+
+} // namespace
+
+// ============================================================================
+// LabelCache / HudImage
+// ============================================================================
+
+const std::string& LabelCache::get(int value) {
+    Slot& slot = slots_[static_cast<size_t>(((value % SLOTS) + SLOTS) % SLOTS)];
+    if (!slot.valid || slot.value != value) {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), format_, value);
+        slot.text = buf;
+        slot.value = value;
+        slot.valid = true;
+    }
+    return slot.text;
+}
+
+void HudImage::release(IOSD& osd) {
+    if (handle != 0) {
+        osd.deleteImage(handle);
+    }
+    handle = 0;
+    built_for = 0;
+}
+
+// ============================================================================
+// Artificial Horizon
+// ============================================================================
+
+ArtificialHorizon::ArtificialHorizon() {
+    for (int pitch = -90; pitch <= 90; pitch += 10) {
+        labels_.push_back(std::to_string(pitch));
+    }
+}
+
+void ArtificialHorizon::build(IOSD& osd, int unit) {
+    const float u = static_cast<float>(unit);
+
+    // The whole -90..90 ladder in one image: pitch only moves it, never changes it
+    const float pad = 8.0f;
+    const float full_ppd = HORIZON_HEIGHT * u / PITCH_VISIBLE_DEG;
+    ladder_scale_ = std::min(1.0f, (MAX_IMAGE_PX - 2.0f * pad) / (180.0f * full_ppd));
+    const float s = ladder_scale_;
+    const float ppd = full_ppd * s;
+
+    Canvas ladder(static_cast<int>(std::ceil(HORIZON_WIDTH * u * s)),
+                  static_cast<int>(std::ceil(180.0f * ppd + 2.0f * pad)));
+    const float cx = ladder.width() * 0.5f;
+    const float half_gap = PITCH_GAP * 0.5f * u * s;
+    const float bar = PITCH_BAR * u * s;
+    const float line = lineWidth(u) * s;
+    const float end_tick = 0.025f * u * s;
+
+    for (int pitch = -90; pitch <= 90; pitch += 5) {
+        const float y = pad + (90 - pitch) * ppd - line * 0.5f;
+        if (pitch == 0) {
+            ladder.bar(0.0f, y, cx - half_gap, y + line * 1.5f);
+            ladder.bar(cx + half_gap, y, static_cast<float>(ladder.width()), y + line * 1.5f);
+        } else if (pitch % 10 == 0) {
+            // Bars point their end ticks at the horizon; below it they are dashed
+            for (int side = -1; side <= 1; side += 2) {
+                const float inner = cx + side * half_gap;
+                const float outer = cx + side * (half_gap + bar);
+                const int dashes = pitch > 0 ? 1 : 3;
+                for (int d = 0; d < dashes; ++d) {
+                    float a = inner + (outer - inner) * (d * 0.375f);
+                    float b = dashes == 1 ? outer : inner + (outer - inner) * (d * 0.375f + 0.25f);
+                    ladder.bar(std::min(a, b), y, std::max(a, b), y + line);
+                }
+                const float tick_x = side < 0 ? outer : outer - line;
+                if (pitch > 0) {
+                    ladder.bar(tick_x, y, tick_x + line, y + end_tick);
+                } else {
+                    ladder.bar(tick_x, y - end_tick + line, tick_x + line, y + line);
+                }
+            }
+        } else if (std::abs(pitch) < 90) {
+            const float short_bar = bar * 0.4f;
+            ladder.bar(cx - half_gap - short_bar, y, cx - half_gap, y + line);
+            ladder.bar(cx + half_gap, y, cx + half_gap + short_bar, y + line);
+        }
+    }
+    upload(osd, ladder, unit, ladder_);
+
+    // Fixed aircraft symbol: two wings with drop ticks and a center dot
+    const float sline = lineWidth(u) * 1.5f;
+    Canvas symbol(static_cast<int>(std::ceil(PITCH_GAP * u * 1.8f)), static_cast<int>(std::ceil(0.05f * u)));
+    const float sx = symbol.width() * 0.5f;
+    const float sy = symbol.height() * 0.3f;
+    const float wing = PITCH_GAP * u * 0.5f;
+    const float drop = 0.025f * u;
+    symbol.bar(OUTLINE_PX, sy, OUTLINE_PX + wing, sy + sline, SYMBOL_COLOR);
+    symbol.bar(OUTLINE_PX + wing - sline, sy, OUTLINE_PX + wing, sy + drop, SYMBOL_COLOR);
+    symbol.bar(symbol.width() - OUTLINE_PX - wing, sy, symbol.width() - OUTLINE_PX, sy + sline, SYMBOL_COLOR);
+    symbol.bar(symbol.width() - OUTLINE_PX - wing, sy, symbol.width() - OUTLINE_PX - wing + sline, sy + drop,
+               SYMBOL_COLOR);
+    symbol.bar(sx - sline, sy - sline * 0.5f, sx + sline, sy + sline * 1.5f, SYMBOL_COLOR);
+    upload(osd, symbol, unit, symbol_);
+}
+
+void ArtificialHorizon::draw(IOSD& osd, float cx, float cy, float unit, float roll_rad, float pitch_rad,
+                             float opacity) {
+    const int key = static_cast<int>(std::lround(unit));
+    if (ladder_.built_for != key) {
+        release(osd);
+        build(osd, key);
+    }
+    unit = static_cast<float>(key);     // Same spacing the image was built with
+
+    const float pitch_deg = pitch_rad * RAD_TO_DEG;
+    const float ppd = HORIZON_HEIGHT * unit / PITCH_VISIBLE_DEG;
+    const float half_w = HORIZON_WIDTH * unit * 0.5f;
+    const float half_h = HORIZON_HEIGHT * unit * 0.5f;
+
+    osd.pushTransform();
+    osd.translate(cx, cy);
+    osd.clipRect(-half_w, -half_h, 2.0f * half_w, 2.0f * half_h);     // Fixed window...
+    osd.rotate(-roll_rad);                                             // ...ladder turns inside it
+
+    // Scroll so the current pitch's row sits on the center
+    const float pad = 8.0f / ladder_scale_;
+    const float image_w = ladder_.width / ladder_scale_;
+    const float image_h = ladder_.height / ladder_scale_;
+    const float image_y = -(pad + (90.0f - pitch_deg) * ppd);
+    osd.drawImage(ladder_.handle, -image_w * 0.5f, image_y, image_w, image_h,
+                  -image_w * 0.5f, image_y, image_w, image_h, opacity);
+
+    // Labels for the bars in view only (the clip hides the rest anyway)
+    const float font = FONT_SIZE * unit * 0.8f;
+    const float label_x = (PITCH_GAP * 0.5f + PITCH_BAR + 0.015f) * unit;
+    const float reach = std::hypot(half_w, half_h);
+    const Color text{1.0f, 1.0f, 1.0f, opacity};
+    for (int i = 0; i < static_cast<int>(labels_.size()); ++i) {
+        const int pitch = -90 + i * 10;
+        const float y = (pitch_deg - pitch) * ppd;
+        if (pitch == 0 || std::fabs(y) > reach) {
+            continue;
+        }
+        osd.drawText(-label_x, y - font * 0.5f, labels_[i], text, font, TextAlign::Right);
+        osd.drawText(label_x, y - font * 0.5f, labels_[i], text, font, TextAlign::Left);
+    }
+    osd.popTransform();
+
+    osd.drawImage(symbol_.handle, cx - symbol_.width * 0.5f, cy - symbol_.height * 0.3f,
+                  static_cast<float>(symbol_.width), static_cast<float>(symbol_.height),
+                  cx - symbol_.width * 0.5f, cy - symbol_.height * 0.3f,
+                  static_cast<float>(symbol_.width), static_cast<float>(symbol_.height), opacity);
+}
+
+void ArtificialHorizon::release(IOSD& osd) {
+    ladder_.release(osd);
+    symbol_.release(osd);
+}
+
+// ============================================================================
+// Heading Tape
+// ============================================================================
+
+HeadingTape::HeadingTape() {
+    static const char* const NAMES[] = {"N", "3", "6", "E", "12", "15", "S", "21", "24", "W", "30", "33"};
+    labels_.assign(std::begin(NAMES), std::end(NAMES));
+}
+
+void HeadingTape::build(IOSD& osd, int unit) {
+    const float u = static_cast<float>(unit);
+    const float ppd = HORIZON_WIDTH * u / HEADING_VISIBLE_DEG;
+
+    // The view plus one 30-degree label period: ticks repeat every 30
+    // degrees, so scrolling modulo 30 covers any heading with one image
+    Canvas tape(static_cast<int>(std::ceil((HEADING_VISIBLE_DEG + 30.0f) * ppd)) + 1,
+                static_cast<int>(std::ceil(HEADING_HEIGHT * u)));
+    const float h = static_cast<float>(tape.height());
+    const float line = lineWidth(u);
+    tape.fill(0.0f, 0.0f, static_cast<float>(tape.width()), h, Color::transparent(BACKGROUND_ALPHA));
+    for (int deg = 0; deg <= static_cast<int>(HEADING_VISIBLE_DEG) + 30; deg += 5) {
+        const float x = deg * ppd;
+        const float length = (deg % 10 == 0 ? 0.4f : 0.22f) * h;
+        tape.bar(x - line * 0.5f, h - length, x + line * 0.5f, h - OUTLINE_PX);
+    }
+    upload(osd, tape, unit, ticks_);
+}
+
+void HeadingTape::draw(IOSD& osd, float cx, float top, float unit, float heading_deg, float opacity) {
+    const int key = static_cast<int>(std::lround(unit));
+    if (ticks_.built_for != key) {
+        release(osd);
+        build(osd, key);
+    }
+    unit = static_cast<float>(key);     // Same spacing the image was built with
+
+    heading_deg = std::fmod(heading_deg, 360.0f);
+    if (heading_deg < 0.0f) {
+        heading_deg += 360.0f;
+    }
+    const float ppd = HORIZON_WIDTH * unit / HEADING_VISIBLE_DEG;
+    const float width = HORIZON_WIDTH * unit;
+    const float height = static_cast<float>(ticks_.height);
+    const float left = cx - width * 0.5f;
+
+    // Image column 0 is the last 30-degree mark at or before the left edge
+    const float view_start = heading_deg - HEADING_VISIBLE_DEG * 0.5f;
+    const int base = floorTo(view_start, 30);
+    const float image_x = left + (base - view_start) * ppd;
+    osd.drawImage(ticks_.handle, left, top, width, height,
+                  image_x, top, static_cast<float>(ticks_.width), height, opacity);
+
+    const float font = std::min(FONT_SIZE * unit, height * 0.45f);
+    const Color text{1.0f, 1.0f, 1.0f, opacity};
+    osd.pushTransform();
+    osd.clipRect(left, top, width, height);
+    for (int deg = base; deg <= base + static_cast<int>(HEADING_VISIBLE_DEG) + 30; deg += 30) {
+        const float x = image_x + (deg - base) * ppd;
+        if (x < left - font || x > left + width + font) {
+            continue;
+        }
+        const size_t index = static_cast<size_t>((((deg / 30) % 12) + 12) % 12);
+        osd.drawText(x, top + height * 0.08f, labels_[index], text, font, TextAlign::Center);
+    }
+    osd.popTransform();
+
+    // Center mark and readout below the tape
+    const float line = lineWidth(unit);
+    osd.drawRect(cx - line, top + height * 0.45f, 2.0f * line, height * 0.55f,
+                 Color{SYMBOL_COLOR.r, SYMBOL_COLOR.g, SYMBOL_COLOR.b, opacity});
+    const std::string& readout = readout_.get(static_cast<int>(std::lround(heading_deg)) % 360);
+    osd.drawTextWithBackground(cx - font * 0.6f * 1.5f, top + height + font * 0.4f, readout,
+                               text, Color::transparent(0.6f * opacity), font * 0.2f, font);
+}
+
+void HeadingTape::release(IOSD& osd) {
+    ticks_.release(osd);
+}
+
+// ============================================================================
+// Ladder Tape
+// ============================================================================
+
+LadderTape::LadderTape(int minor, int major, bool ticks_right)
+    : minor_(minor), major_(major), ticks_right_(ticks_right) {}
+
+void LadderTape::build(IOSD& osd, int unit) {
+    const float u = static_cast<float>(unit);
+    const float ppv = HORIZON_HEIGHT * u / static_cast<float>(LADDER_VISIBLE_MAJORS * major_);
+
+    // The view plus one labelled period, scrolled modulo that period
+    const int span = (LADDER_VISIBLE_MAJORS + 1) * major_;
+    Canvas tape(static_cast<int>(std::ceil(LADDER_WIDTH * u)), static_cast<int>(std::ceil(span * ppv)) + 1);
+    const float w = static_cast<float>(tape.width());
+    const float line = lineWidth(u);
+    tape.fill(0.0f, 0.0f, w, static_cast<float>(tape.height()), Color::transparent(BACKGROUND_ALPHA));
+    for (int v = 0; v <= span; v += minor_) {
+        const float y = v * ppv;
+        const float length = (v % major_ == 0 ? 0.3f : 0.15f) * w;
+        if (ticks_right_) {
+            tape.bar(w - length, y - line * 0.5f, w - OUTLINE_PX, y + line * 0.5f);
+        } else {
+            tape.bar(OUTLINE_PX, y - line * 0.5f, length, y + line * 0.5f);
+        }
+    }
+    upload(osd, tape, unit, ticks_);
+}
+
+void LadderTape::draw(IOSD& osd, float x, float cy, float unit, float value, float opacity) {
+    const int key = static_cast<int>(std::lround(unit));
+    if (ticks_.built_for != key) {
+        release(osd);
+        build(osd, key);
+    }
+    unit = static_cast<float>(key);     // Same spacing the image was built with
+
+    const float ppv = HORIZON_HEIGHT * unit / static_cast<float>(LADDER_VISIBLE_MAJORS * major_);
+    const float width = static_cast<float>(ticks_.width);
+    const float height = HORIZON_HEIGHT * unit;
+    const float top = cy - height * 0.5f;
+
+    // Image row 0 is the labelled value (base + span) above the view's top edge
+    const int base = floorTo(value - LADDER_VISIBLE_MAJORS * 0.5f * major_, major_);
+    const int span = (LADDER_VISIBLE_MAJORS + 1) * major_;
+    const float image_y = cy - (base + span - value) * ppv;
+    osd.drawImage(ticks_.handle, x, top, width, height,
+                  x, image_y, width, static_cast<float>(ticks_.height), opacity);
+
+    const float font = FONT_SIZE * unit * 0.8f;
+    const Color text{1.0f, 1.0f, 1.0f, opacity};
+    osd.pushTransform();
+    osd.clipRect(x, top, width, height);
+    for (int v = base; v <= base + span; v += major_) {
+        const float y = cy - (v - value) * ppv - font * 0.5f;
+        if (y < top - font || y > top + height) {
+            continue;
+        }
+        if (ticks_right_) {
+            osd.drawText(x + width * 0.62f, y, labels_.get(v), text, font, TextAlign::Right);
+        } else {
+            osd.drawText(x + width * 0.38f, y, labels_.get(v), text, font, TextAlign::Left);
+        }
+    }
+    osd.popTransform();
+
+    // Readout box over the center of the tape, on the side away from the ticks
+    const float box_font = FONT_SIZE * unit;
+    const std::string& readout = labels_.get(static_cast<int>(std::lround(value)));
+    osd.drawTextWithBackground(ticks_right_ ? x + box_font * 0.2f : x + width * 0.3f, cy - box_font * 0.5f,
+                               readout, Color{SYMBOL_COLOR.r, SYMBOL_COLOR.g, SYMBOL_COLOR.b, opacity},
+                               Color::transparent(0.75f * opacity), box_font * 0.2f, box_font);
+}
+
+void LadderTape::release(IOSD& osd) {
+    ticks_.release(osd);
+}
+
+// ============================================================================
+// Flight HUD
+// ============================================================================
+
+FlightHud::FlightHud()
+    : speed_(1, 5, true)            // m/s
+    , altitude_(2, 10, false)       // m
+{
+}
+
+void FlightHud::draw(IOSD& osd, const TelemetrySnapshot& flight, uint64_t frame_time_ns, int stale_ms,
+                     int fb_width, int fb_height, const FlightHudConfig& config) {
+    const uint64_t now_ns = metricsNowNs();
+    if (!flight.linkAlive(now_ns, static_cast<uint64_t>(stale_ms) * 1000000ull)) {
+        return;
+    }
+
+    const float unit = static_cast<float>(fb_height) * config.size_scale;
+    const float cx = static_cast<float>(fb_width) * 0.5f;
+    const float cy = static_cast<float>(fb_height) * 0.5f;
+    const float opacity = config.opacity;
+
+    float heading_deg = flight.heading_deg;
+    if (flight.attitude_ns != 0) {
+        float roll, pitch, yaw;
+        flight.attitudeAt(frame_time_ns != 0 ? frame_time_ns : now_ns, roll, pitch, yaw);
+        horizon_.draw(osd, cx, cy, unit, roll, pitch, opacity);
+        heading_deg = yaw * RAD_TO_DEG;     // Frame-aligned, finer than VFR_HUD's whole degrees
+    }
+    if (flight.attitude_ns != 0 || flight.hud_ns != 0) {
+        const float top = cy - (HORIZON_HEIGHT * 0.5f + WIDGET_GAP + HEADING_HEIGHT) * unit;
+        heading_.draw(osd, cx, top, unit, heading_deg, opacity);
+    }
+
+    const float side = (HORIZON_WIDTH * 0.5f + WIDGET_GAP) * unit;
+    if (flight.hud_ns != 0) {
+        speed_.draw(osd, cx - side - LADDER_WIDTH * unit, cy, unit, flight.groundspeed, opacity);
+    }
+    if (flight.position_ns != 0) {
+        altitude_.draw(osd, cx + side, cy, unit, flight.altitude_rel_m, opacity);
+    }
+}
+
+void FlightHud::release(IOSD& osd) {
+    horizon_.release(osd);
+    heading_.release(osd);
+    speed_.release(osd);
+    altitude_.release(osd);
+}
+
+} // namespace robot_vision
@@ -0,0 +1,165 @@
+#pragma once
+
+/**
+ * @file flight_hud.h
+ * @brief Artificial horizon, heading tape and speed/altitude ladders
+ *
+ * Each widget owns one pre-built image of its tick marks, rasterized on
+ * the CPU for the current size and uploaded once. Per frame a widget
+ * draws that image as a single quad, scrolled (tapes) or rotated
+ * (horizon) by a transform, plus the handful of numeric labels in view;
+ * label strings come from a small cache so the same "120" is not
+ * formatted again every frame. Images are rebuilt only when the widget
+ * size changes (window resize or a live hud.size_scale change).
+ *
+ *            [ 240  |  270  |  300 ]       heading tape
+ *    [ 12 ]      ---- 10 ----     [ 140 ]
+ *    [ 10 ]  ----------  ---------[ 120 ]  speed ladder | horizon | altitude ladder
+ *    [  8 ]      ---- -10 ---     [ 100 ]
+ *
+ * All widgets need telemetry; each is skipped until its message arrives.
+ */
+
+#include "core/osd.h"
+#include "osd/flight_hud_config.h"
+#include "telemetry/telemetry_receiver.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * Formatted integer labels, made once per value instead of once per frame
+ *
+ * Direct-mapped: a value always lands in the same slot, so a lookup is an
+ * index and a compare. Values that collide simply format again.
+ */
+class LabelCache {
+public:
+    explicit LabelCache(const char* format) : format_(format) {}
+
+    const std::string& get(int value);
+
+private:
+    static constexpr int SLOTS = 64;
+
+    struct Slot {
+        int value = 0;
+        bool valid = false;
+        std::string text;
+    };
+
+    const char* format_;
+    std::array<Slot, SLOTS> slots_{};
+};
+
+/**
+ * An image uploaded through IOSD, tagged with the size it was built for
+ */
+struct HudImage {
+    int handle = 0;
+    int width = 0;
+    int height = 0;
+    int built_for = 0;                  // Widget size key (pixels); 0 = not built
+
+    void release(IOSD& osd);
+};
+
+/**
+ * Pitch ladder rotated by roll, with a fixed aircraft symbol
+ */
+class ArtificialHorizon {
+public:
+    ArtificialHorizon();
+
+    void draw(IOSD& osd, float cx, float cy, float unit, float roll_rad, float pitch_rad, float opacity);
+    void release(IOSD& osd);
+
+private:
+    void build(IOSD& osd, int unit);
+
+    HudImage ladder_;
+    HudImage symbol_;
+    float ladder_scale_ = 1.0f;         // Image pixels per screen pixel (< 1 when capped)
+    std::vector<std::string> labels_;   // -90 .. 90 in steps of 10
+};
+
+/**
+ * Heading tape (60 degrees in view), ticks every 5 degrees
+ */
+class HeadingTape {
+public:
+    HeadingTape();
+
+    void draw(IOSD& osd, float cx, float top, float unit, float heading_deg, float opacity);
+    void release(IOSD& osd);
+
+private:
+    void build(IOSD& osd, int unit);
+
+    HudImage ticks_;
+    std::vector<std::string> labels_;   // Every 30 degrees: N 3 6 E 12 ...
+    LabelCache readout_{"%03d"};
+};
+
+/**
+ * Vertical value ladder (speed on the left, altitude on the right)
+ */
+class LadderTape {
+public:
+    /**
+     * @param minor Value between ticks
+     * @param major Value between labelled ticks (a multiple of minor)
+     * @param ticks_right Ticks on the right edge (facing a widget to the right)
+     */
+    LadderTape(int minor, int major, bool ticks_right);
+
+    void draw(IOSD& osd, float x, float cy, float unit, float value, float opacity);
+    void release(IOSD& osd);
+
+private:
+    void build(IOSD& osd, int unit);
+
+    const int minor_;
+    const int major_;
+    const bool ticks_right_;
+    HudImage ticks_;
+    LabelCache labels_{"%d"};
+};
+
+/**
+ * The complete HUD, laid out around the framebuffer center
+ *
+ * Not thread-safe: draw from the render thread only. Call release()
+ * before IOSD::shutdown() (images belong to the OSD's GL context).
+ */
+class FlightHud {
+public:
+    FlightHud();
+
+    // Non-copyable (owns OSD images)
+    FlightHud(const FlightHud&) = delete;
+    FlightHud& operator=(const FlightHud&) = delete;
+
+    /**
+     * Draw between IOSD::beginFrame() and IOSD::endFrame()
+     *
+     * Attitude and heading are evaluated at frame_time_ns (the displayed
+     * frame's capture time); nothing is drawn while the link is stale.
+     */
+    void draw(IOSD& osd, const TelemetrySnapshot& flight, uint64_t frame_time_ns, int stale_ms,
+              int fb_width, int fb_height, const FlightHudConfig& config);
+
+    void release(IOSD& osd);
+
+private:
+    ArtificialHorizon horizon_;
+    HeadingTape heading_;
+    LadderTape speed_;
+    LadderTape altitude_;
+};
+
+} // namespace robot_vision
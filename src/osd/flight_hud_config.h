@@ -0,0 +1,23 @@
+#pragma once
+
+/**
+ * @file flight_hud_config.h
+ * @brief Flight HUD settings
+ */
+
+namespace robot_vision {
+
+/**
+ * Flight HUD configuration (all live-reloadable)
+ */
+struct FlightHudConfig {
+    bool enabled = true;                // Draw the HUD when telemetry is enabled
+    float size_scale = 0.5f;            // HUD height as a fraction of framebuffer height
+    float opacity = 0.9f;               // 0..1
+
+    bool isValid() const {
+        return size_scale > 0.1f && size_scale <= 1.0f && opacity > 0.0f && opacity <= 1.0f;
+    }
+};
+
+} // namespace robot_vision
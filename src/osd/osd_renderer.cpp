@@ -4,6 +4,7 @@
  */
 
 #include "osd_renderer.h"
+#include "util/logger.h"
 
 /**
  * TEACHING: NanoVG Backend Selection
@@ -19,6 +20,7 @@
  */
 
 #include "core/opengl.h"
+#include "trace/trace.h"
 
 #ifdef PLATFORM_MACOS
     #define NANOVG_GL2_IMPLEMENTATION
@@ -29,7 +31,6 @@
 #include <nanovg.h>
 #include <nanovg_gl.h>
 
-#include <iostream>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
@@ -52,7 +53,7 @@ OSDRenderer::~OSDRenderer() {
 
 bool OSDRenderer::initialize(const OSDConfig& config) {
     if (initialized_) {
-        std::cerr << "  OSD already initialized\n";
+        RV_LOG_ERROR("osd", "OSD already initialized");
         return false;
     }
 
@@ -74,7 +75,7 @@ bool OSDRenderer::initialize(const OSDConfig& config) {
 #endif
 
     if (!vg_) {
-        std::cerr << "  ERROR: Failed to create NanoVG context\n";
+        RV_LOG_ERROR("osd", "Failed to create NanoVG context");
         return false;
     }
 
@@ -84,7 +85,7 @@ bool OSDRenderer::initialize(const OSDConfig& config) {
     // Load fonts
     font_regular_ = loadFont("regular", config.font_path);
     if (font_regular_ == -1) {
-        std::cerr << "  ERROR: Failed to load regular font: " << config.font_path << "\n";
+        RV_LOG_ERROR("osd", "Failed to load regular font: {}", config.font_path);
         return false;
     }
 
@@ -92,7 +93,7 @@ bool OSDRenderer::initialize(const OSDConfig& config) {
     if (!config.font_bold_path.empty()) {
         font_bold_ = loadFont("bold", config.font_bold_path);
         if (font_bold_ == -1) {
-            std::cout << "  Warning: Failed to load bold font, using regular\n";
+            RV_LOG_WARN("osd", "Failed to load bold font, using regular");
             font_bold_ = font_regular_;
         }
     } else {
@@ -100,7 +101,7 @@ bool OSDRenderer::initialize(const OSDConfig& config) {
     }
 
     initialized_ = true;
-    std::cout << "  OSD renderer initialized\n";
+    RV_LOG_INFO("osd", "OSD renderer initialized");
     return true;
 }
 
@@ -149,6 +150,7 @@ void OSDRenderer::beginFrame(int width, int height, float device_pixel_ratio) {
      * - devicePixelRatio: For Retina displays (2.0), coordinates stay same
      *   but rendering happens at higher resolution.
      */
+    TRACE_SCOPE("nvgBeginFrame");
     nvgBeginFrame(vg_, static_cast<float>(width), static_cast<float>(height), device_pixel_ratio);
     in_frame_ = true;
 }
@@ -158,6 +160,8 @@ void OSDRenderer::endFrame() {
         return;
     }
 
+    // NanoVG builds geometry during draw calls and flushes it to GL here
+    TRACE_SCOPE("nvgEndFrame");
     nvgEndFrame(vg_);
     in_frame_ = false;
 }
@@ -277,6 +281,67 @@ void OSDRenderer::drawCircle(float cx, float cy, float radius, Color color, bool
     }
 }
 
+// ============================================================================
+// Images and Transforms
+// ============================================================================
+
+int OSDRenderer::createImage(int width, int height, const uint8_t* rgba) {
+    if (!initialized_ || width <= 0 || height <= 0) {
+        return 0;
+    }
+
+    // No repeat/mipmap flags: GLES2 only allows those for power-of-two sizes
+    // Premultiplied so linear filtering at transparent edges doesn't darken them
+    int image = nvgCreateImageRGBA(vg_, width, height, NVG_IMAGE_PREMULTIPLIED, rgba);
+    if (image == 0) {
+        RV_LOG_ERROR("osd", "Failed to create {}x{} OSD image", width, height);
+    }
+    return image;
+}
+
+void OSDRenderer::deleteImage(int image) {
+    if (initialized_ && image != 0) {
+        nvgDeleteImage(vg_, image);
+    }
+}
+
+void OSDRenderer::drawImage(int image, float x, float y, float width, float height,
+                            float image_x, float image_y, float image_width, float image_height,
+                            float alpha) {
+    if (!in_frame_ || image == 0) return;
+
+    NVGpaint paint = nvgImagePattern(vg_, image_x, image_y, image_width, image_height, 0.0f, image, alpha);
+    nvgBeginPath(vg_);
+    nvgRect(vg_, x, y, width, height);
+    nvgFillPaint(vg_, paint);
+    nvgFill(vg_);
+}
+
+void OSDRenderer::pushTransform() {
+    if (!in_frame_) return;
+    nvgSave(vg_);
+}
+
+void OSDRenderer::popTransform() {
+    if (!in_frame_) return;
+    nvgRestore(vg_);
+}
+
+void OSDRenderer::translate(float x, float y) {
+    if (!in_frame_) return;
+    nvgTranslate(vg_, x, y);
+}
+
+void OSDRenderer::rotate(float radians) {
+    if (!in_frame_) return;
+    nvgRotate(vg_, radians);
+}
+
+void OSDRenderer::clipRect(float x, float y, float width, float height) {
+    if (!in_frame_) return;
+    nvgIntersectScissor(vg_, x, y, width, height);
+}
+
 // ============================================================================
 // Convenience Methods
 // ============================================================================
@@ -355,9 +420,9 @@ int OSDRenderer::loadFont(const std::string& name, const std::string& path) {
     int font_id = nvgCreateFont(vg_, name.c_str(), path.c_str());
 
     if (font_id == -1) {
-        std::cerr << "  Failed to load font: " << path << "\n";
+        RV_LOG_ERROR("osd", "Failed to load font: {}", path);
     } else {
-        std::cout << "  Loaded font '" << name << "' from: " << path << "\n";
+        RV_LOG_INFO("osd", "Loaded font '{}' from: {}", name, path);
     }
 
     return font_id;
@@ -57,6 +57,17 @@ public:
                   Color color, float width) override;
     void drawCircle(float cx, float cy, float radius, Color color, bool filled) override;
 
+    int createImage(int width, int height, const uint8_t* rgba) override;
+    void deleteImage(int image) override;
+    void drawImage(int image, float x, float y, float width, float height,
+                   float image_x, float image_y, float image_width, float image_height,
+                   float alpha) override;
+    void pushTransform() override;
+    void popTransform() override;
+    void translate(float x, float y) override;
+    void rotate(float radians) override;
+    void clipRect(float x, float y, float width, float height) override;
+
     void drawFPS(float fps, int width) override;
     void drawTimestamp(float x, float y) override;
     void drawFrameCounter(uint32_t frame_number, float x, float y) override;
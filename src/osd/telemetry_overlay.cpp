@@ -0,0 +1,65 @@
+/**
+ * @file telemetry_overlay.cpp
+ * @brief Telemetry summary line
+ */
+
+#include "telemetry_overlay.h"
+#include "metrics/metrics.h"
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace robot_vision {
+
+namespace {
+
+constexpr float RAD_TO_DEG = 57.29578f;
+
+} // namespace
+
+void drawTelemetryLine(IOSD& osd, const TelemetrySnapshot& flight, uint64_t frame_time_ns,
+                       int stale_ms, float x, float y, float padding, float font_size) {
+    const uint64_t now_ns = metricsNowNs();
+    if (!flight.linkAlive(now_ns, static_cast<uint64_t>(stale_ms) * 1000000ull)) {
+        osd.drawTextWithBackground(x, y, flight.updated_ns == 0 ? "TLM: waiting" : "TLM LOST",
+                                   flight.updated_ns == 0 ? Color{0.5f, 0.5f, 0.5f, 1.0f} : Color::red(),
+                                   Color::transparent(0.6f), padding, font_size);
+        return;
+    }
+
+    std::string text = flight.heartbeat_ns != 0 ? (flight.armed ? "ARMED" : "DISARMED") : "";
+    char buf[64];
+    if (flight.attitude_ns != 0) {
+        float roll, pitch, yaw;
+        flight.attitudeAt(frame_time_ns != 0 ? frame_time_ns : now_ns, roll, pitch, yaw);
+        std::snprintf(buf, sizeof(buf), "  R %.0f P %.0f", roll * RAD_TO_DEG, pitch * RAD_TO_DEG);
+        text += buf;
+    }
+    if (flight.position_ns != 0) {
+        std::snprintf(buf, sizeof(buf), "  ALT %.1fm", flight.altitude_rel_m);
+        text += buf;
+    }
+    if (flight.hud_ns != 0) {
+        std::snprintf(buf, sizeof(buf), "  GS %.1fm/s  HDG %03.0f", flight.groundspeed, flight.heading_deg);
+        text += buf;
+    }
+    if (flight.battery_ns != 0 && flight.battery_v > 0.0f) {
+        std::snprintf(buf, sizeof(buf), "  %.1fV", flight.battery_v);
+        text += buf;
+        if (flight.battery_pct >= 0) {
+            std::snprintf(buf, sizeof(buf), " %d%%", flight.battery_pct);
+            text += buf;
+        }
+    }
+
+    if (text.compare(0, 2, "  ") == 0) {
+        text.erase(0, 2);   // No heartbeat yet
+    }
+
+    // Low battery turns the whole line yellow: it is the one number that must not be missed
+    Color color = (flight.battery_pct >= 0 && flight.battery_pct < 20) ? Color::yellow() : Color::white();
+    osd.drawTextWithBackground(x, y, text, color, Color::transparent(0.6f), padding, font_size);
+}
+
+} // namespace robot_vision
@@ -0,0 +1,26 @@
+#pragma once
+
+/**
+ * @file telemetry_overlay.h
+ * @brief Draws a one-line flight telemetry summary through IOSD
+ */
+
+#include "core/osd.h"
+#include "telemetry/telemetry_receiver.h"
+
+#include <cstdint>
+
+namespace robot_vision {
+
+/**
+ * Draw "ARMED  R 4 P -2  ALT 12.3m  GS 5.1m/s  HDG 273  15.8V 76%"
+ * (or "TLM LOST" once nothing arrived for stale_ms)
+ *
+ * Attitude is evaluated at frame_time_ns (the displayed frame's capture
+ * time) so it matches the video, not the newest message.
+ * Must be called between IOSD::beginFrame() and IOSD::endFrame().
+ */
+void drawTelemetryLine(IOSD& osd, const TelemetrySnapshot& flight, uint64_t frame_time_ns,
+                       int stale_ms, float x, float y, float padding, float font_size);
+
+} // namespace robot_vision
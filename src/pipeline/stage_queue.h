@@ -0,0 +1,188 @@
+#pragma once
+
+/**
+ * @file stage_queue.h
+ * @brief Bounded queue with drop policy and wait/occupancy accounting
+ *
+ * Wraps BoundedQueue with the behaviour a pipeline stage needs:
+ * - a drop policy applied by the producer when the queue is full
+ * - a blocking pop with timeout for the consumer
+ * - counters for occupancy, drops and time spent waiting
+ */
+
+#include "core/staged_pipeline.h"
+#include "util/bounded_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace robot_vision {
+
+template <typename T>
+class StageQueue {
+public:
+    explicit StageQueue(const StageQueueConfig& config)
+        : queue_(config.depth), policy_(config.policy) {}
+
+    /**
+     * Push an item, applying the drop policy when full
+     *
+     * @param running Cleared to abort a Block-policy wait during shutdown
+     * @return true if the item was queued
+     */
+    bool push(T item, const std::atomic<bool>& running) {
+        if (queue_.tryPush(std::move(item))) {
+            notePush();
+            return true;
+        }
+
+        switch (policy_) {
+            case DropPolicy::DropNewest:
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+
+            case DropPolicy::DropOldest: {
+                T discarded;
+                while (!queue_.tryPush(std::move(item))) {
+                    if (queue_.tryPop(discarded)) {
+                        dropped_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                notePush();
+                return true;
+            }
+
+            case DropPolicy::Block: {
+                auto start = std::chrono::steady_clock::now();
+                int spins = 0;
+                while (!queue_.tryPush(std::move(item))) {
+                    if (!running.load(std::memory_order_relaxed)) {
+                        return false;
+                    }
+                    backoff(spins++);
+                }
+                recordWait(std::chrono::steady_clock::now() - start);
+                notePush();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Pop without waiting
+     */
+    bool tryPop(T& out) {
+        return queue_.tryPop(out);
+    }
+
+    /**
+     * Pop, waiting up to `timeout` for an item
+     *
+     * TEACHING: Spin, Yield, Sleep
+     * ----------------------------
+     * A lock-free queue has no condition variable to sleep on. We spin
+     * briefly (cheap when the item is about to arrive), then yield the
+     * core, then sleep in short slices so an idle stage costs ~no CPU.
+     */
+    bool popWait(T& out, std::chrono::microseconds timeout, const std::atomic<bool>& running) {
+        if (queue_.tryPop(out)) {
+            return true;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + timeout;
+        int spins = 0;
+        bool got = false;
+        while (running.load(std::memory_order_relaxed)) {
+            if (queue_.tryPop(out)) {
+                got = true;
+                break;
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+            backoff(spins++);
+        }
+        recordWait(std::chrono::steady_clock::now() - start);
+        return got;
+    }
+
+    /**
+     * Pop everything, keeping only the newest item
+     *
+     * @return true if at least one item was popped
+     */
+    bool popLatest(T& out) {
+        bool got = false;
+        T item;
+        while (queue_.tryPop(item)) {
+            if (got) {
+                skipped_.fetch_add(1, std::memory_order_relaxed);
+            }
+            out = std::move(item);
+            got = true;
+        }
+        return got;
+    }
+
+    /**
+     * Fill queue-related fields of a stats snapshot
+     */
+    void fillStats(StageStats& stats) const {
+        stats.queue_depth = queue_.capacity();
+        stats.occupancy = queue_.size();
+        stats.max_occupancy = max_occupancy_.load(std::memory_order_relaxed);
+        stats.pushed = pushed_.load(std::memory_order_relaxed);
+        stats.dropped = dropped_.load(std::memory_order_relaxed) +
+                        skipped_.load(std::memory_order_relaxed);
+        stats.wait_ns += wait_ns_.load(std::memory_order_relaxed);
+        uint64_t max_wait = max_wait_ns_.load(std::memory_order_relaxed);
+        if (max_wait > stats.max_wait_ns) {
+            stats.max_wait_ns = max_wait;
+        }
+    }
+
+private:
+    void notePush() {
+        pushed_.fetch_add(1, std::memory_order_relaxed);
+        size_t occupancy = queue_.size();
+        size_t prev = max_occupancy_.load(std::memory_order_relaxed);
+        while (occupancy > prev &&
+               !max_occupancy_.compare_exchange_weak(prev, occupancy, std::memory_order_relaxed)) {
+        }
+    }
+
+    void recordWait(std::chrono::steady_clock::duration waited) {
+        auto ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count());
+        wait_ns_.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t prev = max_wait_ns_.load(std::memory_order_relaxed);
+        while (ns > prev &&
+               !max_wait_ns_.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void backoff(int spins) {
+        if (spins < 64) {
+            // Busy spin - item is likely imminent
+        } else if (spins < 128) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    BoundedQueue<T> queue_;
+    DropPolicy policy_;
+
+    std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> dropped_{0};      // Dropped by policy on push
+    std::atomic<uint64_t> skipped_{0};      // Superseded by popLatest()
+    std::atomic<size_t> max_occupancy_{0};
+    std::atomic<uint64_t> wait_ns_{0};
+    std::atomic<uint64_t> max_wait_ns_{0};
+};
+
+} // namespace robot_vision
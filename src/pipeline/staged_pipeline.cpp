@@ -0,0 +1,615 @@
+/**
+ * @file staged_pipeline.cpp
+ * @brief Threaded implementation of IStagedPipeline
+ */
+
+#include "staged_pipeline.h"
+#include "util/image_scale.h"
+#include "util/logger.h"
+#include "util/thread_policy.h"
+
+#include <pthread.h>
+#include <algorithm>
+
+namespace robot_vision {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// How long an idle stage sleeps before re-checking the running flag.
+// Bounds shutdown latency without burning CPU.
+constexpr auto IDLE_SLICE = std::chrono::milliseconds(20);
+
+uint64_t toNs(Clock::duration d) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+}
+
+uint64_t nowNs() {
+    return toNs(Clock::now().time_since_epoch());
+}
+
+/**
+ * Name the calling thread (shows up in top -H, gdb and perf)
+ */
+void setThreadName(const char* name) {
+#ifdef PLATFORM_MACOS
+    pthread_setname_np(name);
+#else
+    pthread_setname_np(pthread_self(), name);
+#endif
+}
+
+} // namespace
+
+// ============================================================================
+// StageCounters
+// ============================================================================
+
+void StagedPipeline::StageCounters::addBusy(Clock::duration d) {
+    busy_ns.fetch_add(toNs(d), std::memory_order_relaxed);
+}
+
+void StagedPipeline::StageCounters::addWait(Clock::duration d) {
+    uint64_t ns = toNs(d);
+    wait_ns.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t prev = max_wait_ns.load(std::memory_order_relaxed);
+    while (ns > prev && !max_wait_ns.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+    }
+}
+
+void StagedPipeline::StageCounters::fill(StageStats& stats) const {
+    stats.processed = processed.load(std::memory_order_relaxed);
+    stats.busy_ns = busy_ns.load(std::memory_order_relaxed);
+    stats.wait_ns += wait_ns.load(std::memory_order_relaxed);
+    stats.max_wait_ns = std::max(stats.max_wait_ns, max_wait_ns.load(std::memory_order_relaxed));
+}
+
+// ============================================================================
+// PipelineMetrics
+// ============================================================================
+
+StagedPipeline::PipelineMetrics::PipelineMetrics(MetricsRegistry& registry)
+    : frames_captured(registry.counter("rv_frames_captured_total",
+                                       "New frames taken from the camera"))
+    , capture_pull(registry.histogram("rv_capture_pull_seconds",
+                                      "Time to pull and copy a new frame from the video pipeline"))
+    , detect_send(registry.histogram("rv_detect_send_seconds",
+                                     "Time to hand a frame to the detector (shm copy + notify)"))
+    , detect_roundtrip(registry.histogram("rv_detect_roundtrip_seconds",
+                                          "Frame sent to detector until its results arrive"))
+    , detect_result_age(registry.histogram("rv_detect_result_age_seconds",
+                                           "Frame capture until its detection results arrive"))
+    , detect_inference(registry.histogram("rv_detect_inference_seconds",
+                                          "Detector-reported inference time"))
+    , detections(registry.counter("rv_detections_total", "Objects detected"))
+    , detector_reconnects(registry.counter("rv_detector_reconnects_total",
+                                           "Successful detector reconnections"))
+{
+}
+
+// ============================================================================
+// Factory Function
+// ============================================================================
+
+std::unique_ptr<IStagedPipeline> createStagedPipeline(IVideoPipeline& video,
+                                                      IDetectionClient& detector,
+                                                      const StagedPipelineConfig& config) {
+    return std::make_unique<StagedPipeline>(video, detector, config);
+}
+
+// ============================================================================
+// Constructor / Destructor
+// ============================================================================
+
+StagedPipeline::StagedPipeline(IVideoPipeline& video, IDetectionClient& detector,
+                               const StagedPipelineConfig& config)
+    : video_(video)
+    , detector_(detector)
+    , config_(config)
+    , render_queue_(config.render_queue)
+    , detect_queue_(config.detect_queue)
+    , result_queue_(config.result_queue)
+    , record_queue_(config.record_queue)
+    , detection_rate_hz_(config.detection_rate_hz)
+    , metrics_(MetricsRegistry::global())
+{
+    // Queue and stage counters are already tracked; publish them at scrape time
+    collector_id_ = MetricsRegistry::global().addCollector([this]() { exportStats(); });
+}
+
+StagedPipeline::~StagedPipeline() {
+    MetricsRegistry::global().removeCollector(collector_id_);
+    stop();
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+void StagedPipeline::addFrameSink(std::shared_ptr<IFrameSink> sink) {
+    if (running_) {
+        RV_LOG_ERROR("pipeline", "Frame sinks must be added before start()");
+        return;
+    }
+    if (sink) {
+        sinks_.push_back(std::move(sink));
+    }
+}
+
+void StagedPipeline::addDetectionSink(std::shared_ptr<IDetectionSink> sink) {
+    if (running_) {
+        RV_LOG_ERROR("pipeline", "Detection sinks must be added before start()");
+        return;
+    }
+    if (sink) {
+        detection_sinks_.push_back(std::move(sink));
+    }
+}
+
+void StagedPipeline::setCaptureFilter(std::shared_ptr<IFrameFilter> filter) {
+    if (running_) {
+        RV_LOG_ERROR("pipeline", "Frame filters must be set before start()");
+        return;
+    }
+    capture_filter_ = std::move(filter);
+}
+
+void StagedPipeline::setDetectionFilter(std::shared_ptr<IFrameFilter> filter) {
+    if (running_) {
+        RV_LOG_ERROR("pipeline", "Frame filters must be set before start()");
+        return;
+    }
+    detection_filter_ = std::move(filter);
+}
+
+bool StagedPipeline::start() {
+    if (running_) {
+        return true;
+    }
+
+    if (!config_.isValid()) {
+        RV_LOG_ERROR("pipeline", "Invalid staged pipeline configuration");
+        return false;
+    }
+
+    // Adopt a connection made during startup
+    if (config_.enable_detection && detector_.isConnected()) {
+        std::lock_guard<std::mutex> lock(info_mutex_);
+        server_info_ = detector_.getServerInfo();
+        detector_connected_ = true;
+    }
+
+    running_ = true;
+    capture_thread_ = std::thread(&StagedPipeline::captureLoop, this);
+    if (config_.enable_detection) {
+        submit_thread_ = std::thread(&StagedPipeline::submitLoop, this);
+        ingest_thread_ = std::thread(&StagedPipeline::ingestLoop, this);
+    }
+    if (!sinks_.empty()) {
+        record_thread_ = std::thread(&StagedPipeline::recordLoop, this);
+    }
+
+    RV_LOG_INFO("pipeline", "Staged pipeline started ({}{} threads)",
+                config_.enable_detection ? "capture, detect-submit, result-ingest" : "capture",
+                sinks_.empty() ? "" : ", record");
+    return true;
+}
+
+void StagedPipeline::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    for (auto* t : {&capture_thread_, &submit_thread_, &ingest_thread_, &record_thread_}) {
+        if (t->joinable()) {
+            t->join();
+        }
+    }
+}
+
+// ============================================================================
+// Render Stage Access
+// ============================================================================
+
+std::shared_ptr<FrameData> StagedPipeline::acquireFrame() {
+    std::shared_ptr<FrameData> frame;
+    if (render_queue_.popLatest(frame)) {
+        render_stats_.processed.fetch_add(1, std::memory_order_relaxed);
+        return frame;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<const DetectionSet> StagedPipeline::acquireDetections() {
+    std::shared_ptr<const DetectionSet> results;
+    if (result_queue_.popLatest(results)) {
+        return results;
+    }
+    return nullptr;
+}
+
+// ============================================================================
+// Detector State
+// ============================================================================
+
+bool StagedPipeline::isDetectorConnected() const {
+    return detector_connected_.load(std::memory_order_relaxed);
+}
+
+ServerInfo StagedPipeline::getDetectorInfo() const {
+    std::lock_guard<std::mutex> lock(info_mutex_);
+    return server_info_;
+}
+
+void StagedPipeline::setDetectionRate(int hz) {
+    detection_rate_hz_.store(std::clamp(hz, 1, 120), std::memory_order_relaxed);
+}
+
+int StagedPipeline::getDetectionRate() const {
+    return detection_rate_hz_.load(std::memory_order_relaxed);
+}
+
+void StagedPipeline::setDetectionInputWidth(int width) {
+    detection_input_width_.store(std::max(0, width), std::memory_order_relaxed);
+}
+
+int StagedPipeline::getDetectionInputWidth() const {
+    return detection_input_width_.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Diagnostics
+// ============================================================================
+
+std::vector<StageStats> StagedPipeline::getStats() const {
+    std::vector<StageStats> all;
+
+    StageStats capture;
+    capture.name = "capture";
+    capture_stats_.fill(capture);
+    all.push_back(capture);
+
+    if (config_.enable_detection) {
+        StageStats submit;
+        submit.name = "detect_submit";
+        detect_queue_.fillStats(submit);
+        submit_stats_.fill(submit);
+        all.push_back(submit);
+
+        StageStats ingest;
+        ingest.name = "result_ingest";
+        ingest_stats_.fill(ingest);
+        all.push_back(ingest);
+    }
+
+    StageStats render;
+    render.name = "render";
+    render_queue_.fillStats(render);
+    render_stats_.fill(render);
+    all.push_back(render);
+
+    if (config_.enable_detection) {
+        StageStats results;
+        results.name = "render_results";
+        result_queue_.fillStats(results);
+        all.push_back(results);
+    }
+
+    if (!sinks_.empty()) {
+        StageStats record;
+        record.name = "record";
+        record_queue_.fillStats(record);
+        record_stats_.fill(record);
+        all.push_back(record);
+    }
+
+    return all;
+}
+
+// ============================================================================
+// Stage Threads
+// ============================================================================
+
+void StagedPipeline::captureLoop() {
+    setThreadName("rv-capture");
+    ScopedThreadRole thread_role("capture");
+
+    bool have_last = false;
+    uint32_t last_frame_number = 0;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        auto t0 = Clock::now();
+
+        // Blocks for up to the appsink pull timeout waiting for a new sample
+        auto frame = video_.getLatestFrame();
+        auto t_pulled = Clock::now();
+
+        if (!frame) {
+            // Pipeline not running - don't spin
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            capture_stats_.addWait(Clock::now() - t0);
+            continue;
+        }
+
+        if (!frame->isValid() || (have_last && frame->frame_number == last_frame_number)) {
+            capture_stats_.addWait(Clock::now() - t0);
+            continue;  // No new frame yet
+        }
+
+        have_last = true;
+        last_frame_number = frame->frame_number;
+        metrics_.capture_pull.record(t_pulled - t0);
+        metrics_.frames_captured.inc();
+
+        if (capture_filter_) {
+            frame = capture_filter_->apply(frame);
+        }
+
+        // Fan out to consumers. shared_ptr copies only bump a refcount.
+        render_queue_.push(frame, running_);
+        if (config_.enable_detection && detector_connected_.load(std::memory_order_relaxed)) {
+            detect_queue_.push(frame, running_);
+        }
+        if (!sinks_.empty()) {
+            record_queue_.push(frame, running_);
+        }
+
+        capture_stats_.processed.fetch_add(1, std::memory_order_relaxed);
+        capture_stats_.addBusy(Clock::now() - t0);
+    }
+}
+
+void StagedPipeline::submitLoop() {
+    setThreadName("rv-det-submit");
+    ScopedThreadRole thread_role("detect");
+
+    auto next_send = Clock::now();
+
+    while (running_.load(std::memory_order_relaxed)) {
+        if (!detector_connected_.load(std::memory_order_relaxed)) {
+            // Discard anything queued before the connection dropped
+            std::shared_ptr<FrameData> stale;
+            while (detect_queue_.tryPop(stale)) {
+            }
+            std::this_thread::sleep_for(IDLE_SLICE);
+            continue;
+        }
+
+        /**
+         * TEACHING: Throttle by Waiting, Not by Skipping
+         * ----------------------------------------------
+         * We sleep until the next send slot and THEN take a frame. The
+         * detect queue (depth 1, drop-oldest) keeps replacing its content
+         * while we sleep, so the frame we send is always the freshest one.
+         */
+        auto now = Clock::now();
+        if (now < next_send) {
+            std::this_thread::sleep_until(std::min(next_send, now + IDLE_SLICE));
+            continue;
+        }
+
+        std::shared_ptr<FrameData> frame;
+        if (!detect_queue_.popWait(frame, IDLE_SLICE, running_)) {
+            continue;
+        }
+
+        auto t0 = Clock::now();
+
+        // Publish send time before sending: a fast detector may answer
+        // before sendFrame() returns. Id last, so a reader that sees the
+        // id also sees the timestamps.
+        last_sent_ns_.store(toNs(t0.time_since_epoch()), std::memory_order_relaxed);
+        last_sent_capture_ns_.store(frame->capture_time_ns, std::memory_order_relaxed);
+        last_sent_frame_id_.store(frame->frame_number, std::memory_order_release);
+
+        if (detection_filter_) {
+            frame = detection_filter_->apply(frame);
+        }
+
+        // Optional downscale (performance governor): fewer bytes through
+        // shared memory and less resizing work in the detector
+        const uint8_t* pixels = frame->pixels.data();
+        int width = frame->width;
+        int height = frame->height;
+        int max_width = detection_input_width_.load(std::memory_order_relaxed);
+        if (max_width > 0 && max_width < width) {
+            int scaled_height = std::max(1, height * max_width / width);
+            scaleNearestRGB(pixels, width, height, scaled_pixels_, max_width, scaled_height);
+            pixels = scaled_pixels_.data();
+            width = max_width;
+            height = scaled_height;
+        }
+
+        if (!detector_.sendFrame(pixels,
+                                 static_cast<uint32_t>(width),
+                                 static_cast<uint32_t>(height),
+                                 frame->frame_number)) {
+            if (!detector_.isConnected()) {
+                RV_LOG_WARN("pipeline", "Lost connection to detector during frame send");
+                detector_connected_ = false;
+            }
+        }
+        auto t1 = Clock::now();
+        metrics_.detect_send.record(t1 - t0);
+        submit_stats_.processed.fetch_add(1, std::memory_order_relaxed);
+        submit_stats_.addBusy(t1 - t0);
+
+        // Rate may be changed live (config reload, CPU budget)
+        next_send = t0 + std::chrono::microseconds(
+            1000000 / detection_rate_hz_.load(std::memory_order_relaxed));
+    }
+}
+
+void StagedPipeline::ingestLoop() {
+    setThreadName("rv-det-ingest");
+    ScopedThreadRole thread_role("detect");
+
+    const auto heartbeat_interval = std::chrono::milliseconds(config_.heartbeat_interval_ms);
+    const auto reconnect_interval = std::chrono::milliseconds(config_.reconnect_interval_ms);
+    auto last_heartbeat = Clock::now();
+    // First attempt is immediate: startup no longer blocks on the detector
+    auto last_reconnect = Clock::now() - reconnect_interval;
+    bool ever_connected = detector_connected_.load(std::memory_order_relaxed);
+
+    while (running_.load(std::memory_order_relaxed)) {
+        auto now = Clock::now();
+
+        if (!detector_connected_.load(std::memory_order_relaxed)) {
+            if (now - last_reconnect >= reconnect_interval) {
+                if (connectDetector()) {
+                    if (ever_connected) {
+                        RV_LOG_INFO("pipeline", "Reconnected to detector");
+                        metrics_.detector_reconnects.inc();
+                    } else {
+                        RV_LOG_INFO("pipeline", "Connected to detector");
+                        ever_connected = true;
+                    }
+                    last_heartbeat = Clock::now();
+                }
+                last_reconnect = Clock::now();
+            } else {
+                std::this_thread::sleep_for(IDLE_SLICE);
+            }
+            continue;
+        }
+
+        // Sleep in the kernel until results arrive (or the slice ends)
+        auto t0 = Clock::now();
+        bool ready = detector_.waitForResults(
+            static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(IDLE_SLICE).count()));
+        auto t1 = Clock::now();
+        ingest_stats_.addWait(t1 - t0);
+
+        if (ready) {
+            auto results = std::make_shared<DetectionSet>();
+            if (detector_.receiveDetections(results->detections, results->frame_id,
+                                            results->inference_time_ms)) {
+                results->received_ns = nowNs();
+                recordResultLatency(*results);
+
+                std::shared_ptr<const DetectionSet> shared = std::move(results);
+                for (const auto& sink : detection_sinks_) {
+                    sink->consumeDetections(shared);
+                }
+                result_queue_.push(shared, running_);
+                ingest_stats_.processed.fetch_add(1, std::memory_order_relaxed);
+            } else if (!detector_.isConnected()) {
+                onDetectorLost("Lost connection to detector");
+                last_reconnect = Clock::now();
+                continue;
+            }
+            ingest_stats_.addBusy(Clock::now() - t1);
+        }
+
+        // Periodic heartbeat to check connection health
+        if (Clock::now() - last_heartbeat >= heartbeat_interval) {
+            if (!detector_.sendHeartbeat()) {
+                onDetectorLost("Lost connection to detector");
+                last_reconnect = Clock::now();
+            }
+            last_heartbeat = Clock::now();
+        }
+    }
+}
+
+void StagedPipeline::recordLoop() {
+    setThreadName("rv-record");
+    ScopedThreadRole thread_role("record");
+
+    while (running_.load(std::memory_order_relaxed)) {
+        std::shared_ptr<FrameData> frame;
+        if (!record_queue_.popWait(frame, IDLE_SLICE, running_)) {
+            continue;
+        }
+
+        auto t0 = Clock::now();
+        for (const auto& sink : sinks_) {
+            sink->consumeFrame(frame);
+        }
+        record_stats_.processed.fetch_add(1, std::memory_order_relaxed);
+        record_stats_.addBusy(Clock::now() - t0);
+    }
+}
+
+// ============================================================================
+// Private Helpers
+// ============================================================================
+
+bool StagedPipeline::connectDetector() {
+    if (!detector_.connect()) {
+        return false;
+    }
+
+    if (detector_.sendHeartbeat()) {
+        RV_LOG_DEBUG("pipeline", "Heartbeat OK");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(info_mutex_);
+        server_info_ = detector_.getServerInfo();
+    }
+    detector_connected_ = true;
+    return true;
+}
+
+void StagedPipeline::recordResultLatency(const DetectionSet& results) {
+    metrics_.detections.inc(results.detections.size());
+    metrics_.detect_inference.record(static_cast<uint64_t>(results.inference_time_ms * 1e6f));
+
+    // Only the most recent send is tracked; results for an older frame
+    // (or a send racing this read) are skipped rather than mis-attributed.
+    uint64_t id = last_sent_frame_id_.load(std::memory_order_acquire);
+    if (id != results.frame_id) {
+        return;
+    }
+    uint64_t sent_ns = last_sent_ns_.load(std::memory_order_relaxed);
+    uint64_t capture_ns = last_sent_capture_ns_.load(std::memory_order_relaxed);
+    if (last_sent_frame_id_.load(std::memory_order_acquire) != id) {
+        return;
+    }
+
+    if (results.received_ns > sent_ns) {
+        metrics_.detect_roundtrip.record(results.received_ns - sent_ns);
+    }
+    if (capture_ns > 0 && results.received_ns > capture_ns) {
+        metrics_.detect_result_age.record(results.received_ns - capture_ns);
+    }
+}
+
+void StagedPipeline::exportStats() {
+    auto& registry = MetricsRegistry::global();
+
+    registry.gauge("rv_detector_connected", "1 while the detector connection is up")
+        .set(isDetectorConnected() ? 1.0 : 0.0);
+    registry.gauge("rv_detection_rate_hz", "Current detection submit rate limit")
+        .set(getDetectionRate());
+
+    // Registration is idempotent, so looking the series up here is fine:
+    // this runs on the metrics thread, once per scrape.
+    for (const auto& st : getStats()) {
+        std::string labels = "stage=\"" + st.name + "\"";
+        registry.gauge("rv_stage_queue_occupancy", "Items waiting in the stage input queue", labels)
+            .set(static_cast<double>(st.occupancy));
+        registry.gauge("rv_stage_queue_max_occupancy", "Stage input queue high-water mark", labels)
+            .set(static_cast<double>(st.max_occupancy));
+        registry.counter("rv_stage_items_pushed_total", "Items accepted into the stage queue", labels)
+            .set(st.pushed);
+        registry.counter("rv_stage_items_dropped_total", "Items discarded by the drop policy", labels)
+            .set(st.dropped);
+        registry.counter("rv_stage_items_processed_total", "Items handled by the stage", labels)
+            .set(st.processed);
+        registry.gauge("rv_stage_wait_seconds", "Total time the stage waited for input", labels)
+            .set(static_cast<double>(st.wait_ns) * 1e-9);
+        registry.gauge("rv_stage_busy_seconds", "Total time the stage spent working", labels)
+            .set(static_cast<double>(st.busy_ns) * 1e-9);
+    }
+}
+
+void StagedPipeline::onDetectorLost(const char* reason) {
+    RV_LOG_WARN("pipeline", "{}", reason);
+    detector_connected_ = false;
+    detector_.disconnect();  // Clean up old connection
+}
+
+} // namespace robot_vision
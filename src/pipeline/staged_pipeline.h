@@ -0,0 +1,150 @@
+#pragma once
+
+/**
+ * @file staged_pipeline.h
+ * @brief Threaded implementation of IStagedPipeline
+ */
+
+#include "core/staged_pipeline.h"
+#include "pipeline/stage_queue.h"
+#include "metrics/metrics.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace robot_vision {
+
+/**
+ * Staged pipeline implementation
+ *
+ * TEACHING: Thread Ownership
+ * --------------------------
+ * Each stage thread owns exactly one job, and shared objects are touched
+ * by as few threads as possible:
+ * - capture thread: the only caller of IVideoPipeline::getLatestFrame()
+ * - submit thread: the only caller of IDetectionClient::sendFrame()
+ * - ingest thread: receives results, heartbeats and reconnects
+ * - render (caller) thread: the only thread touching OpenGL
+ * Everything else crosses thread boundaries through the stage queues.
+ */
+class StagedPipeline : public IStagedPipeline {
+public:
+    StagedPipeline(IVideoPipeline& video, IDetectionClient& detector,
+                   const StagedPipelineConfig& config);
+    ~StagedPipeline() override;
+
+    // Non-copyable (threads hold `this`)
+    StagedPipeline(const StagedPipeline&) = delete;
+    StagedPipeline& operator=(const StagedPipeline&) = delete;
+
+    // IStagedPipeline interface
+    void addFrameSink(std::shared_ptr<IFrameSink> sink) override;
+    void addDetectionSink(std::shared_ptr<IDetectionSink> sink) override;
+    void setCaptureFilter(std::shared_ptr<IFrameFilter> filter) override;
+    void setDetectionFilter(std::shared_ptr<IFrameFilter> filter) override;
+    bool start() override;
+    void stop() override;
+
+    std::shared_ptr<FrameData> acquireFrame() override;
+    std::shared_ptr<const DetectionSet> acquireDetections() override;
+
+    bool isDetectorConnected() const override;
+    ServerInfo getDetectorInfo() const override;
+    void setDetectionRate(int hz) override;
+    int getDetectionRate() const override;
+    void setDetectionInputWidth(int width) override;
+    int getDetectionInputWidth() const override;
+
+    std::vector<StageStats> getStats() const override;
+
+private:
+    /**
+     * Work/wait counters for a stage thread
+     */
+    struct StageCounters {
+        std::atomic<uint64_t> processed{0};
+        std::atomic<uint64_t> busy_ns{0};
+        std::atomic<uint64_t> wait_ns{0};
+        std::atomic<uint64_t> max_wait_ns{0};
+
+        void addBusy(std::chrono::steady_clock::duration d);
+        void addWait(std::chrono::steady_clock::duration d);
+        void fill(StageStats& stats) const;
+    };
+
+    /**
+     * Hot-path metrics, registered once in the global registry
+     */
+    struct PipelineMetrics {
+        explicit PipelineMetrics(MetricsRegistry& registry);
+
+        Counter& frames_captured;
+        Histogram& capture_pull;
+        Histogram& detect_send;
+        Histogram& detect_roundtrip;
+        Histogram& detect_result_age;
+        Histogram& detect_inference;
+        Counter& detections;
+        Counter& detector_reconnects;
+    };
+
+    void captureLoop();
+    void submitLoop();
+    void ingestLoop();
+    void recordLoop();
+
+    bool connectDetector();
+    void onDetectorLost(const char* reason);
+    void recordResultLatency(const DetectionSet& results);
+    void exportStats();
+
+    IVideoPipeline& video_;
+    IDetectionClient& detector_;
+    StagedPipelineConfig config_;
+
+    // Stage queues
+    StageQueue<std::shared_ptr<FrameData>> render_queue_;
+    StageQueue<std::shared_ptr<FrameData>> detect_queue_;
+    StageQueue<std::shared_ptr<const DetectionSet>> result_queue_;
+    StageQueue<std::shared_ptr<FrameData>> record_queue_;
+
+    // Per-stage counters
+    StageCounters capture_stats_;
+    StageCounters submit_stats_;
+    StageCounters ingest_stats_;
+    StageCounters record_stats_;
+    StageCounters render_stats_;
+
+    std::vector<std::shared_ptr<IFrameSink>> sinks_;
+    std::vector<std::shared_ptr<IDetectionSink>> detection_sinks_;
+    std::shared_ptr<IFrameFilter> capture_filter_;
+    std::shared_ptr<IFrameFilter> detection_filter_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<int> detection_rate_hz_;
+    std::atomic<int> detection_input_width_{0};
+    std::vector<uint8_t> scaled_pixels_;    // Submit thread only (downscaled detector input)
+    std::atomic<bool> detector_connected_{false};
+
+    mutable std::mutex info_mutex_;     // Protects server_info_
+    ServerInfo server_info_{};
+
+    // Metrics
+    PipelineMetrics metrics_;
+    int collector_id_ = 0;
+
+    // Last frame handed to the detector, for result latency (submit writes,
+    // ingest reads; frame id is re-checked to reject a torn read)
+    std::atomic<uint64_t> last_sent_frame_id_{UINT64_MAX};
+    std::atomic<uint64_t> last_sent_ns_{0};
+    std::atomic<uint64_t> last_sent_capture_ns_{0};
+
+    std::thread capture_thread_;
+    std::thread submit_thread_;
+    std::thread ingest_thread_;
+    std::thread record_thread_;
+};
+
+} // namespace robot_vision
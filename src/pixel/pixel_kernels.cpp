@@ -0,0 +1,127 @@
+/**
+ * @file pixel_kernels.cpp
+ * @brief CPU feature detection, kernel table selection, bilinear resize
+ */
+
+#include "pixel_kernels_internal.h"
+#include "util/logger.h"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+namespace robot_vision {
+
+namespace {
+
+bool cpuSupports(PixelIsa isa) {
+    switch (isa) {
+        case PixelIsa::Scalar:
+            return true;
+#if defined(__x86_64__)
+        // libgcc/compiler-rt check the CPUID bits and that the OS saves the
+        // AVX registers (XGETBV), so an AVX2 CPU under an old kernel says no
+        case PixelIsa::SSE41:
+            return __builtin_cpu_supports("sse4.1");
+        case PixelIsa::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+#if defined(__aarch64__)
+        case PixelIsa::NEON:
+#if defined(__linux__)
+            return (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+#else
+            return true;        // Mandatory on AArch64 (Apple silicon)
+#endif
+#endif
+        default:
+            return false;
+    }
+}
+
+const PixelKernels* builtTable(PixelIsa isa) {
+    switch (isa) {
+        case PixelIsa::Scalar: return pixel_detail::scalarKernels();
+        case PixelIsa::SSE41: return pixel_detail::sse41Kernels();
+        case PixelIsa::AVX2: return pixel_detail::avx2Kernels();
+        case PixelIsa::NEON: return pixel_detail::neonKernels();
+    }
+    return nullptr;
+}
+
+const PixelKernels& selectKernels() {
+    const PixelKernels* best = pixel_detail::scalarKernels();
+    for (PixelIsa isa : {PixelIsa::SSE41, PixelIsa::AVX2, PixelIsa::NEON}) {
+        if (const PixelKernels* table = pixelKernelsFor(isa)) {
+            best = table;
+        }
+    }
+    RV_LOG_INFO("pixel", "Pixel kernels: {}", best->name);
+    return *best;
+}
+
+} // namespace
+
+const PixelKernels* pixelKernelsFor(PixelIsa isa) {
+    const PixelKernels* table = builtTable(isa);
+    return table && cpuSupports(isa) ? table : nullptr;
+}
+
+const PixelKernels& pixelKernels() {
+    static const PixelKernels& kernels = selectKernels();
+    return kernels;
+}
+
+// ============================================================================
+// Bilinear Resize
+// ============================================================================
+
+void resizeBilinear(const PixelKernels& kernels, const uint8_t* src, int src_width, int src_height,
+                    int src_stride, uint8_t* dst, int dst_width, int dst_height, int dst_stride) {
+    if (src_width <= 0 || src_height <= 0 || dst_width <= 0 || dst_height <= 0) {
+        return;
+    }
+
+    // Source position of each output column: left neighbour and 8-bit weight
+    // of the right one, centres aligned and clamped at the edges
+    thread_local std::vector<int> left;
+    thread_local std::vector<int> weight;
+    thread_local std::vector<uint16_t> row;
+    left.resize(static_cast<size_t>(dst_width));
+    weight.resize(static_cast<size_t>(dst_width));
+    row.resize(static_cast<size_t>(src_width) + 1);
+
+    auto position = [](int i, int src_size, int dst_size, int& index, int& frac) {
+        // ((i + 0.5) * src / dst - 0.5) in 1/256 steps
+        const int64_t pos = ((2 * static_cast<int64_t>(i) + 1) * src_size * 256) / (2 * dst_size) - 128;
+        const int64_t clamped = std::max<int64_t>(0, std::min<int64_t>(pos, (src_size - 1) * 256));
+        index = static_cast<int>(clamped >> 8);
+        frac = static_cast<int>(clamped & 255);
+    };
+    for (int x = 0; x < dst_width; ++x) {
+        position(x, src_width, dst_width, left[x], weight[x]);
+    }
+
+    for (int y = 0; y < dst_height; ++y) {
+        int top = 0;
+        int wy = 0;
+        position(y, src_height, dst_height, top, wy);
+        const uint8_t* r0 = src + static_cast<ptrdiff_t>(top) * src_stride;
+        const uint8_t* r1 = top + 1 < src_height ? r0 + src_stride : r0;
+        kernels.lerp_rows(r0, r1, wy, row.data(), src_width);
+        row[src_width] = row[src_width - 1];    // Right neighbour of the last column
+
+        uint8_t* out = dst + static_cast<ptrdiff_t>(y) * dst_stride;
+        for (int x = 0; x < dst_width; ++x) {
+            const uint32_t a = row[left[x]];
+            const uint32_t b = row[left[x] + 1];
+            out[x] = static_cast<uint8_t>((a * (256 - weight[x]) + b * weight[x] + 32768) >> 16);
+        }
+    }
+}
+
+} // namespace robot_vision
@@ -0,0 +1,116 @@
+#pragma once
+
+/**
+ * @file pixel_kernels.h
+ * @brief CPU pixel kernels with SSE4.1, AVX2 and NEON variants picked at startup
+ *
+ *   const PixelKernels& k = pixelKernels();     // Best variant for this CPU
+ *   k.rgb_to_luma(frame.pixels.data(), luma.data(), pixel_count);
+ *
+ * Every variant computes exactly the same bytes as the scalar reference
+ * (same fixed-point coefficients, same rounding), so results never depend
+ * on which machine produced them; rv_bench checks each variant against
+ * the scalar one before timing it.
+ *
+ * TEACHING: Runtime Dispatch
+ * --------------------------
+ * Compiling the whole program with -mavx2 would make it crash with SIGILL
+ * on a CPU without AVX2. Instead only the AVX2 translation unit is built
+ * with -mavx2 (likewise SSE4.1), and pixelKernels() asks the CPU (CPUID on
+ * x86, hwcaps on ARM) which of the built variants it can run, once. After
+ * that a kernel call is one indirect call per row or frame - nothing per
+ * pixel.
+ *
+ * The SIMD translation units include no standard-library headers: an
+ * inline function instantiated there would be compiled with -mavx2 and
+ * could be picked by the linker for the rest of the program.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace robot_vision {
+
+/**
+ * Instruction set a kernel table was built for
+ */
+enum class PixelIsa {
+    Scalar,
+    SSE41,
+    AVX2,
+    NEON
+};
+
+/**
+ * One complete set of kernels
+ *
+ * Packed formats: RGB is 3 bytes per pixel, RGBA 4 (straight alpha).
+ * YUV is BT.601 limited range ("video" levels, what cameras and decoders
+ * produce); chroma is subsampled 2x2 and odd sizes round chroma up.
+ * Planes are 8-bit with a byte stride per row.
+ */
+struct PixelKernels {
+    PixelIsa isa;
+    const char* name;
+
+    // Swizzles (src and dst must not overlap)
+    void (*rgb_to_rgba)(const uint8_t* rgb, uint8_t* rgba, size_t pixels);     // alpha = 255
+    void (*rgba_to_rgb)(const uint8_t* rgba, uint8_t* rgb, size_t pixels);
+    void (*swap_rb)(const uint8_t* src, uint8_t* dst, size_t pixels);          // RGB <-> BGR
+
+    // YUV 4:2:0 -> RGB
+    void (*nv12_to_rgb)(const uint8_t* y, int y_stride, const uint8_t* uv, int uv_stride,
+                        uint8_t* rgb, int rgb_stride, int width, int height);
+    void (*i420_to_rgb)(const uint8_t* y, int y_stride, const uint8_t* u, int u_stride,
+                        const uint8_t* v, int v_stride, uint8_t* rgb, int rgb_stride,
+                        int width, int height);
+
+    // (77 R + 150 G + 29 B) >> 8, the weights lumaThumbnail() uses
+    void (*rgb_to_luma)(const uint8_t* rgb, uint8_t* luma, size_t pixels);
+
+    // 2x2 box average of a plane: dst = (a + b + c + d + 2) >> 2
+    void (*downscale_2x)(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+                         int dst_width, int dst_height);
+
+    // Vertical pass of resizeBilinear(): out = row0 * (256 - weight) + row1 * weight
+    void (*lerp_rows)(const uint8_t* row0, const uint8_t* row1, int weight, uint16_t* out, int width);
+
+    // Sum of absolute differences of two planes
+    uint64_t (*sad)(const uint8_t* a, int a_stride, const uint8_t* b, int b_stride, int width, int height);
+
+    // RGBA over RGB in place: rgb = (rgba * a + rgb * (255 - a)) / 255, rounded
+    void (*blend_rgba)(const uint8_t* rgba, uint8_t* rgb, size_t pixels);
+
+    // Bilinear gather of packed RGB through a remap table (lens undistortion).
+    // Output pixel i samples the source pixel at byte offsets[i] and its right,
+    // lower and lower-right neighbours (which must exist) with weights
+    // fracs[i] = fx | fy << 8 in 1/256 pixel; offsets[i] < 0 outputs black.
+    //   top = tl * (256 - fx) + tr * fx     (bottom likewise)
+    //   out = (top * (256 - fy) + bottom * fy + 32768) >> 16
+    void (*remap_rgb)(const uint8_t* src, int src_stride, const int32_t* offsets, const uint16_t* fracs,
+                      uint8_t* dst, int pixels);
+};
+
+/**
+ * Fastest kernel table this CPU can run (chosen and logged on first call)
+ */
+const PixelKernels& pixelKernels();
+
+/**
+ * Kernel table for one instruction set
+ *
+ * @return nullptr if it wasn't built for this architecture or the CPU lacks it
+ */
+const PixelKernels* pixelKernelsFor(PixelIsa isa);
+
+/**
+ * Bilinear resize of a plane (pixel centres aligned, edges clamped)
+ *
+ * The vertical pass is lerp_rows(); the horizontal pass gathers two
+ * neighbours per output pixel at arbitrary positions, which SIMD doesn't
+ * help with, and runs on the 16-bit row the vertical pass left in cache.
+ */
+void resizeBilinear(const PixelKernels& kernels, const uint8_t* src, int src_width, int src_height,
+                    int src_stride, uint8_t* dst, int dst_width, int dst_height, int dst_stride);
+
+} // namespace robot_vision
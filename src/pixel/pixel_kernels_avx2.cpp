@@ -0,0 +1,323 @@
+/**
+ * @file pixel_kernels_avx2.cpp
+ * @brief AVX2 kernels (built with -mavx2)
+ *
+ * The arithmetic runs on 256-bit vectors. Packed RGB is still split and
+ * joined with the 128-bit shuffles from pixel_kernels_x86.h: AVX2 shuffles
+ * can't move bytes between the two 128-bit halves, and a 3-byte pixel
+ * straddles them. The pure swizzles are load/store bound, so this table
+ * reuses the SSE4.1 ones.
+ */
+
+#include "pixel_kernels_internal.h"
+
+#if defined(__x86_64__)
+
+#include "pixel_kernels_x86.h"
+
+namespace robot_vision {
+namespace pixel_detail {
+
+namespace {
+
+using namespace x86;
+
+// Pack two vectors of 16 int16 into 32 bytes in order (packus works per 128-bit half)
+inline __m256i packus256(__m256i lo, __m256i hi) {
+    return _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+}
+
+// 16 int16 -> 16 bytes in order
+inline __m128i packus128(__m256i v) {
+    return _mm_packus_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+
+// ============================================================================
+// YUV -> RGB
+// ============================================================================
+
+// Widened Y, U, V for 16 pixels -> R, G, B as int16 (unclamped). unpack,
+// madd and packs all work within 128-bit halves, so the output order
+// matches the input order.
+inline void yuvToRgb16(__m256i y, __m256i u, __m256i v, __m256i& r, __m256i& g, __m256i& b) {
+    const __m256i c = _mm256_sub_epi16(y, _mm256_set1_epi16(16));
+    const __m256i d = _mm256_sub_epi16(u, _mm256_set1_epi16(128));
+    const __m256i e = _mm256_sub_epi16(v, _mm256_set1_epi16(128));
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i k_r = _mm256_set1_epi32((YUV_RV << 16) | YUV_Y);
+    const __m256i k_b = _mm256_set1_epi32((YUV_BU << 16) | YUV_Y);
+    const __m256i k_gu = _mm256_set1_epi32(static_cast<int>((static_cast<uint32_t>(YUV_GU) << 16) | YUV_Y));
+    const __m256i k_gv = _mm256_set1_epi32((YUV_ROUND << 16) | (YUV_GV & 0xFFFF));
+    const __m256i round = _mm256_set1_epi32(YUV_ROUND);
+
+    const __m256i ce_lo = _mm256_unpacklo_epi16(c, e);
+    const __m256i ce_hi = _mm256_unpackhi_epi16(c, e);
+    const __m256i cd_lo = _mm256_unpacklo_epi16(c, d);
+    const __m256i cd_hi = _mm256_unpackhi_epi16(c, d);
+    const __m256i e1_lo = _mm256_unpacklo_epi16(e, one);
+    const __m256i e1_hi = _mm256_unpackhi_epi16(e, one);
+
+    r = _mm256_packs_epi32(
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(ce_lo, k_r), round), 8),
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(ce_hi, k_r), round), 8));
+    g = _mm256_packs_epi32(
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(cd_lo, k_gu), _mm256_madd_epi16(e1_lo, k_gv)), 8),
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(cd_hi, k_gu), _mm256_madd_epi16(e1_hi, k_gv)), 8));
+    b = _mm256_packs_epi32(
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(cd_lo, k_b), round), 8),
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(cd_hi, k_b), round), 8));
+}
+
+inline void yuvToRgbStore16(__m128i y, __m128i u, __m128i v, uint8_t* out) {
+    __m256i r, g, b;
+    yuvToRgb16(_mm256_cvtepu8_epi16(y), _mm256_cvtepu8_epi16(u), _mm256_cvtepu8_epi16(v), r, g, b);
+    storeRgb16(out, packus128(r), packus128(g), packus128(b));
+}
+
+void nv12ToRgb(const uint8_t* y, int y_stride, const uint8_t* uv, int uv_stride,
+               uint8_t* rgb, int rgb_stride, int width, int height) {
+    const int vector_width = width & ~15;
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* py = y + static_cast<ptrdiff_t>(row) * y_stride;
+        const uint8_t* puv = uv + static_cast<ptrdiff_t>(row / 2) * uv_stride;
+        uint8_t* out = rgb + static_cast<ptrdiff_t>(row) * rgb_stride;
+        for (int x = 0; x < vector_width; x += 16) {
+            __m128i u, v;
+            splitUv16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(puv + x)), u, v);
+            yuvToRgbStore16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(py + x)), u, v, out + x * 3);
+        }
+    }
+    if (vector_width < width) {
+        scalarKernels()->nv12_to_rgb(y + vector_width, y_stride, uv + vector_width, uv_stride,
+                                     rgb + vector_width * 3, rgb_stride, width - vector_width, height);
+    }
+}
+
+void i420ToRgb(const uint8_t* y, int y_stride, const uint8_t* u, int u_stride,
+               const uint8_t* v, int v_stride, uint8_t* rgb, int rgb_stride, int width, int height) {
+    const int vector_width = width & ~15;
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* py = y + static_cast<ptrdiff_t>(row) * y_stride;
+        const uint8_t* pu = u + static_cast<ptrdiff_t>(row / 2) * u_stride;
+        const uint8_t* pv = v + static_cast<ptrdiff_t>(row / 2) * v_stride;
+        uint8_t* out = rgb + static_cast<ptrdiff_t>(row) * rgb_stride;
+        for (int x = 0; x < vector_width; x += 16) {
+            yuvToRgbStore16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(py + x)),
+                            dupLow8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pu + x / 2))),
+                            dupLow8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pv + x / 2))),
+                            out + x * 3);
+        }
+    }
+    if (vector_width < width) {
+        scalarKernels()->i420_to_rgb(y + vector_width, y_stride, u + vector_width / 2, u_stride,
+                                     v + vector_width / 2, v_stride, rgb + vector_width * 3, rgb_stride,
+                                     width - vector_width, height);
+    }
+}
+
+// ============================================================================
+// Luma, Scaling, Difference, Blend
+// ============================================================================
+
+void rgbToLuma(const uint8_t* rgb, uint8_t* luma, size_t pixels) {
+    const __m256i k_r = _mm256_set1_epi16(LUMA_R);
+    const __m256i k_g = _mm256_set1_epi16(LUMA_G);
+    const __m256i k_b = _mm256_set1_epi16(LUMA_B);
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i r, g, b;
+        loadRgb16(rgb + i * 3, r, g, b);
+        const __m256i sum = _mm256_add_epi16(
+            _mm256_add_epi16(_mm256_mullo_epi16(_mm256_cvtepu8_epi16(r), k_r),
+                             _mm256_mullo_epi16(_mm256_cvtepu8_epi16(g), k_g)),
+            _mm256_mullo_epi16(_mm256_cvtepu8_epi16(b), k_b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(luma + i), packus128(_mm256_srli_epi16(sum, 8)));
+    }
+    scalarKernels()->rgb_to_luma(rgb + i * 3, luma + i, pixels - i);
+}
+
+void downscale2x(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+                 int dst_width, int dst_height) {
+    const int vector_width = dst_width & ~31;
+    const __m256i ones = _mm256_set1_epi8(1);
+    const __m256i two = _mm256_set1_epi16(2);
+    for (int row = 0; row < dst_height; ++row) {
+        const uint8_t* r0 = src + static_cast<ptrdiff_t>(row) * 2 * src_stride;
+        const uint8_t* r1 = r0 + src_stride;
+        uint8_t* out = dst + static_cast<ptrdiff_t>(row) * dst_stride;
+        for (int x = 0; x < vector_width; x += 32) {
+            const __m256i lo = _mm256_add_epi16(
+                _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(r0 + 2 * x)), ones),
+                _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(r1 + 2 * x)), ones));
+            const __m256i hi = _mm256_add_epi16(
+                _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(r0 + 2 * x + 32)), ones),
+                _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(r1 + 2 * x + 32)), ones));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + x),
+                                packus256(_mm256_srli_epi16(_mm256_add_epi16(lo, two), 2),
+                                          _mm256_srli_epi16(_mm256_add_epi16(hi, two), 2)));
+        }
+    }
+    if (vector_width < dst_width) {
+        sse41Kernels()->downscale_2x(src + 2 * vector_width, src_stride, dst + vector_width, dst_stride,
+                                     dst_width - vector_width, dst_height);
+    }
+}
+
+void lerpRows(const uint8_t* row0, const uint8_t* row1, int weight, uint16_t* out, int width) {
+    const __m256i w0 = _mm256_set1_epi16(static_cast<short>(256 - weight));
+    const __m256i w1 = _mm256_set1_epi16(static_cast<short>(weight));
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x)));
+        const __m256i b = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + x),
+                            _mm256_add_epi16(_mm256_mullo_epi16(a, w0), _mm256_mullo_epi16(b, w1)));
+    }
+    scalarKernels()->lerp_rows(row0 + x, row1 + x, weight, out + x, width - x);
+}
+
+uint64_t sad(const uint8_t* a, int a_stride, const uint8_t* b, int b_stride, int width, int height) {
+    const int vector_width = width & ~31;
+    __m256i acc = _mm256_setzero_si256();
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* pa = a + static_cast<ptrdiff_t>(row) * a_stride;
+        const uint8_t* pb = b + static_cast<ptrdiff_t>(row) * b_stride;
+        for (int x = 0; x < vector_width; x += 32) {
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pa + x)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pb + x))));
+        }
+    }
+    const __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    uint64_t total = static_cast<uint64_t>(_mm_cvtsi128_si64(sum)) +
+                     static_cast<uint64_t>(_mm_extract_epi64(sum, 1));
+    if (vector_width < width) {
+        total += sse41Kernels()->sad(a + vector_width, a_stride, b + vector_width, b_stride,
+                                     width - vector_width, height);
+    }
+    return total;
+}
+
+void blendRgba(const uint8_t* rgba, uint8_t* rgb, size_t pixels) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i k255 = _mm256_set1_epi16(255);
+    const __m256i k128 = _mm256_set1_epi16(128);
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i px[4];
+        expandRgb16(rgb + i * 3, px);
+        for (int k = 0; k < 4; k += 2) {
+            // Two groups of 4 pixels, one per 128-bit half
+            const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + (i + 4 * k) * 4));
+            const __m256i d = _mm256_inserti128_si256(_mm256_castsi128_si256(px[k]), px[k + 1], 1);
+            __m256i halves[2];
+            for (int h = 0; h < 2; ++h) {
+                const __m256i s16 = h == 0 ? _mm256_unpacklo_epi8(s, zero) : _mm256_unpackhi_epi8(s, zero);
+                const __m256i d16 = h == 0 ? _mm256_unpacklo_epi8(d, zero) : _mm256_unpackhi_epi8(d, zero);
+                const __m256i a16 = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s16, 0xFF), 0xFF);
+                const __m256i x = _mm256_add_epi16(_mm256_mullo_epi16(s16, a16),
+                                                   _mm256_mullo_epi16(d16, _mm256_sub_epi16(k255, a16)));
+                const __m256i t = _mm256_add_epi16(x, k128);
+                halves[h] = _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+            }
+            const __m256i blended = _mm256_packus_epi16(halves[0], halves[1]);   // Per-half order kept
+            px[k] = _mm256_castsi256_si128(blended);
+            px[k + 1] = _mm256_extracti128_si256(blended, 1);
+        }
+        compactRgb16(px, rgb + i * 3);
+    }
+    scalarKernels()->blend_rgba(rgba + i * 4, rgb + i * 3, pixels - i);
+}
+
+// ============================================================================
+// Remap
+// ============================================================================
+
+// One channel of 8 gathered pixels as (left, right) int16 pairs, ready for
+// madd. `left` holds RGBx of the left pixel, `right` the 4 bytes starting
+// at its blue byte (xRGB of the right pixel), so the right pixel never
+// reads past the end of the frame.
+inline __m256i channelPairs(__m256i left, __m256i right, int c) {
+    const __m128i lo = _mm_setr_epi8(static_cast<char>(c), -1, -1, -1, static_cast<char>(4 + c), -1, -1, -1,
+                                     static_cast<char>(8 + c), -1, -1, -1, static_cast<char>(12 + c), -1, -1, -1);
+    const __m128i hi = _mm_setr_epi8(-1, -1, static_cast<char>(c + 1), -1, -1, -1, static_cast<char>(c + 5), -1,
+                                     -1, -1, static_cast<char>(c + 9), -1, -1, -1, static_cast<char>(c + 13), -1);
+    return _mm256_or_si256(_mm256_shuffle_epi8(left, _mm256_broadcastsi128_si256(lo)),
+                           _mm256_shuffle_epi8(right, _mm256_broadcastsi128_si256(hi)));
+}
+
+// 8 output pixels as RGBx in 32-bit lanes
+inline __m256i remap8(const uint8_t* src, int src_stride, const int32_t* offsets, const uint16_t* fracs) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i offset = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets));
+    const __m256i inside = _mm256_cmpgt_epi32(offset, _mm256_set1_epi32(-1));
+    const __m256i frac = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(fracs)));
+    const __m256i fx = _mm256_and_si256(frac, _mm256_set1_epi32(0xFF));
+    const __m256i fy = _mm256_srli_epi32(frac, 8);
+    const __m256i wx = _mm256_or_si256(_mm256_sub_epi32(_mm256_set1_epi32(256), fx), _mm256_slli_epi32(fx, 16));
+
+    // Masked lanes (outside the image) aren't loaded and stay zero
+    const uint8_t* below = src + src_stride;
+    const __m256i tl = _mm256_mask_i32gather_epi32(zero, reinterpret_cast<const int*>(src), offset, inside, 1);
+    const __m256i tr = _mm256_mask_i32gather_epi32(zero, reinterpret_cast<const int*>(src + 2), offset, inside, 1);
+    const __m256i bl = _mm256_mask_i32gather_epi32(zero, reinterpret_cast<const int*>(below), offset, inside, 1);
+    const __m256i br = _mm256_mask_i32gather_epi32(zero, reinterpret_cast<const int*>(below + 2), offset, inside, 1);
+
+    __m256i rgbx = zero;
+    for (int c = 0; c < 3; ++c) {
+        const __m256i top = _mm256_madd_epi16(channelPairs(tl, tr, c), wx);
+        const __m256i bottom = _mm256_madd_epi16(channelPairs(bl, br, c), wx);
+        // top * (256 - fy) + bottom * fy == (top << 8) + (bottom - top) * fy
+        const __m256i sum = _mm256_add_epi32(_mm256_slli_epi32(top, 8),
+                                             _mm256_mullo_epi32(_mm256_sub_epi32(bottom, top), fy));
+        const __m256i value = _mm256_srli_epi32(_mm256_add_epi32(sum, _mm256_set1_epi32(32768)), 16);
+        rgbx = _mm256_or_si256(rgbx, _mm256_slli_epi32(value, 8 * c));
+    }
+    return rgbx;
+}
+
+void remapRgb(const uint8_t* src, int src_stride, const int32_t* offsets, const uint16_t* fracs,
+              uint8_t* dst, int pixels) {
+    int i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        const __m256i a = remap8(src, src_stride, offsets + i, fracs + i);
+        const __m256i b = remap8(src, src_stride, offsets + i + 8, fracs + i + 8);
+        const __m128i px[4] = {
+            _mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1),
+            _mm256_castsi256_si128(b), _mm256_extracti128_si256(b, 1),
+        };
+        compactRgb16(px, dst + i * 3);
+    }
+    scalarKernels()->remap_rgb(src, src_stride, offsets + i, fracs + i, dst + i * 3, pixels - i);
+}
+
+} // namespace
+
+const PixelKernels* avx2Kernels() {
+    // Pure swizzles reuse SSE4.1: both widths saturate memory bandwidth
+    static const PixelKernels table = {
+        PixelIsa::AVX2, "avx2",
+        sse41Kernels()->rgb_to_rgba, sse41Kernels()->rgba_to_rgb, sse41Kernels()->swap_rb,
+        nv12ToRgb, i420ToRgb,
+        rgbToLuma, downscale2x, lerpRows, sad, blendRgba,
+        remapRgb,
+    };
+    return &table;
+}
+
+} // namespace pixel_detail
+} // namespace robot_vision
+
+#else
+
+namespace robot_vision {
+namespace pixel_detail {
+
+const PixelKernels* avx2Kernels() {
+    return nullptr;
+}
+
+} // namespace pixel_detail
+} // namespace robot_vision
+
+#endif
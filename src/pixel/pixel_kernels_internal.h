@@ -0,0 +1,42 @@
+#pragma once
+
+/**
+ * @file pixel_kernels_internal.h
+ * @brief Fixed-point constants and per-ISA tables shared by the kernel sources
+ *
+ * Not part of the public interface: use pixelKernels() / pixelKernelsFor().
+ */
+
+#include "pixel_kernels.h"
+
+namespace robot_vision {
+namespace pixel_detail {
+
+// BT.601 limited range, 8 fractional bits:
+//   c = Y - 16, d = U - 128, e = V - 128
+//   R = (298 c + 409 e + 128) >> 8
+//   G = (298 c - 100 d - 208 e + 128) >> 8
+//   B = (298 c + 516 d + 128) >> 8          (each clamped to 0..255)
+constexpr int YUV_Y = 298;
+constexpr int YUV_RV = 409;
+constexpr int YUV_GU = -100;
+constexpr int YUV_GV = -208;
+constexpr int YUV_BU = 516;
+constexpr int YUV_ROUND = 128;
+
+// Luma: (77 R + 150 G + 29 B) >> 8; the sum fits in 16 bits unsigned
+constexpr int LUMA_R = 77;
+constexpr int LUMA_G = 150;
+constexpr int LUMA_B = 29;
+
+// Every variant falls back to the scalar table for the pixels that don't
+// fill a whole vector (row tails, short inputs)
+const PixelKernels* scalarKernels();
+
+// nullptr when the source was built for another architecture
+const PixelKernels* sse41Kernels();
+const PixelKernels* avx2Kernels();
+const PixelKernels* neonKernels();
+
+} // namespace pixel_detail
+} // namespace robot_vision
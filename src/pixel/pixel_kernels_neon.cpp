@@ -0,0 +1,288 @@
+/**
+ * @file pixel_kernels_neon.cpp
+ * @brief NEON kernels (AArch64, where NEON is part of the base ISA)
+ *
+ * vld3/vst3 and vld4 split and join packed RGB/RGBA in one instruction,
+ * so none of the shuffle tables the x86 variants need appear here.
+ */
+
+#include "pixel_kernels_internal.h"
+
+#if defined(__aarch64__)
+
+#include <arm_neon.h>
+
+namespace robot_vision {
+namespace pixel_detail {
+
+namespace {
+
+// ============================================================================
+// Swizzles
+// ============================================================================
+
+void rgbToRgba(const uint8_t* rgb, uint8_t* rgba, size_t pixels) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        const uint8x16x3_t in = vld3q_u8(rgb + i * 3);
+        uint8x16x4_t out;
+        out.val[0] = in.val[0];
+        out.val[1] = in.val[1];
+        out.val[2] = in.val[2];
+        out.val[3] = vdupq_n_u8(255);
+        vst4q_u8(rgba + i * 4, out);
+    }
+    scalarKernels()->rgb_to_rgba(rgb + i * 3, rgba + i * 4, pixels - i);
+}
+
+void rgbaToRgb(const uint8_t* rgba, uint8_t* rgb, size_t pixels) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        const uint8x16x4_t in = vld4q_u8(rgba + i * 4);
+        uint8x16x3_t out;
+        out.val[0] = in.val[0];
+        out.val[1] = in.val[1];
+        out.val[2] = in.val[2];
+        vst3q_u8(rgb + i * 3, out);
+    }
+    scalarKernels()->rgba_to_rgb(rgba + i * 4, rgb + i * 3, pixels - i);
+}
+
+void swapRb(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        uint8x16x3_t px = vld3q_u8(src + i * 3);
+        const uint8x16_t r = px.val[0];
+        px.val[0] = px.val[2];
+        px.val[2] = r;
+        vst3q_u8(dst + i * 3, px);
+    }
+    scalarKernels()->swap_rb(src + i * 3, dst + i * 3, pixels - i);
+}
+
+// ============================================================================
+// YUV -> RGB
+// ============================================================================
+
+// 4 pixels: c * 298 + 128 + terms, >> 8 -> int32; vmull/vmlal keep 32-bit precision
+inline int16x4_t channel4(int16x4_t c, int16x4_t d, int16_t kd, int16x4_t e, int16_t ke) {
+    int32x4_t acc = vmlal_n_s16(vdupq_n_s32(YUV_ROUND), c, YUV_Y);
+    acc = vmlal_n_s16(acc, d, kd);
+    acc = vmlal_n_s16(acc, e, ke);
+    return vmovn_s32(vshrq_n_s32(acc, 8));
+}
+
+// 8 pixels of widened, offset Y (c), U (d), V (e) -> clamped R, G, B bytes
+inline void yuvToRgb8(int16x8_t c, int16x8_t d, int16x8_t e, uint8x8_t& r, uint8x8_t& g, uint8x8_t& b) {
+    const int16x4_t c_lo = vget_low_s16(c), c_hi = vget_high_s16(c);
+    const int16x4_t d_lo = vget_low_s16(d), d_hi = vget_high_s16(d);
+    const int16x4_t e_lo = vget_low_s16(e), e_hi = vget_high_s16(e);
+    r = vqmovun_s16(vcombine_s16(channel4(c_lo, d_lo, 0, e_lo, YUV_RV), channel4(c_hi, d_hi, 0, e_hi, YUV_RV)));
+    g = vqmovun_s16(vcombine_s16(channel4(c_lo, d_lo, YUV_GU, e_lo, YUV_GV),
+                                 channel4(c_hi, d_hi, YUV_GU, e_hi, YUV_GV)));
+    b = vqmovun_s16(vcombine_s16(channel4(c_lo, d_lo, YUV_BU, e_lo, 0), channel4(c_hi, d_hi, YUV_BU, e_hi, 0)));
+}
+
+// 16 pixels: Y bytes and 8 U, 8 V bytes (one per two pixels) -> packed RGB
+inline void yuvToRgb16(uint8x16_t y, uint8x8_t u, uint8x8_t v, uint8_t* out) {
+    const uint8x8x2_t uu = vzip_u8(u, u);
+    const uint8x8x2_t vv = vzip_u8(v, v);
+    const int16x8_t k16 = vdupq_n_s16(16);
+    const int16x8_t k128 = vdupq_n_s16(128);
+    uint8x16x3_t px;
+    uint8x8_t r_lo, g_lo, b_lo, r_hi, g_hi, b_hi;
+    yuvToRgb8(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(y))), k16),
+              vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(uu.val[0])), k128),
+              vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vv.val[0])), k128), r_lo, g_lo, b_lo);
+    yuvToRgb8(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(y))), k16),
+              vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(uu.val[1])), k128),
+              vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vv.val[1])), k128), r_hi, g_hi, b_hi);
+    px.val[0] = vcombine_u8(r_lo, r_hi);
+    px.val[1] = vcombine_u8(g_lo, g_hi);
+    px.val[2] = vcombine_u8(b_lo, b_hi);
+    vst3q_u8(out, px);
+}
+
+void nv12ToRgb(const uint8_t* y, int y_stride, const uint8_t* uv, int uv_stride,
+               uint8_t* rgb, int rgb_stride, int width, int height) {
+    const int vector_width = width & ~15;
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* py = y + static_cast<ptrdiff_t>(row) * y_stride;
+        const uint8_t* puv = uv + static_cast<ptrdiff_t>(row / 2) * uv_stride;
+        uint8_t* out = rgb + static_cast<ptrdiff_t>(row) * rgb_stride;
+        for (int x = 0; x < vector_width; x += 16) {
+            const uint8x8x2_t chroma = vld2_u8(puv + x);
+            yuvToRgb16(vld1q_u8(py + x), chroma.val[0], chroma.val[1], out + x * 3);
+        }
+    }
+    if (vector_width < width) {
+        scalarKernels()->nv12_to_rgb(y + vector_width, y_stride, uv + vector_width, uv_stride,
+                                     rgb + vector_width * 3, rgb_stride, width - vector_width, height);
+    }
+}
+
+void i420ToRgb(const uint8_t* y, int y_stride, const uint8_t* u, int u_stride,
+               const uint8_t* v, int v_stride, uint8_t* rgb, int rgb_stride, int width, int height) {
+    const int vector_width = width & ~15;
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* py = y + static_cast<ptrdiff_t>(row) * y_stride;
+        const uint8_t* pu = u + static_cast<ptrdiff_t>(row / 2) * u_stride;
+        const uint8_t* pv = v + static_cast<ptrdiff_t>(row / 2) * v_stride;
+        uint8_t* out = rgb + static_cast<ptrdiff_t>(row) * rgb_stride;
+        for (int x = 0; x < vector_width; x += 16) {
+            yuvToRgb16(vld1q_u8(py + x), vld1_u8(pu + x / 2), vld1_u8(pv + x / 2), out + x * 3);
+        }
+    }
+    if (vector_width < width) {
+        scalarKernels()->i420_to_rgb(y + vector_width, y_stride, u + vector_width / 2, u_stride,
+                                     v + vector_width / 2, v_stride, rgb + vector_width * 3, rgb_stride,
+                                     width - vector_width, height);
+    }
+}
+
+// ============================================================================
+// Luma, Scaling, Difference, Blend
+// ============================================================================
+
+void rgbToLuma(const uint8_t* rgb, uint8_t* luma, size_t pixels) {
+    const uint8x8_t k_r = vdup_n_u8(LUMA_R);
+    const uint8x8_t k_g = vdup_n_u8(LUMA_G);
+    const uint8x8_t k_b = vdup_n_u8(LUMA_B);
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        const uint8x16x3_t px = vld3q_u8(rgb + i * 3);
+        uint16x8_t lo = vmull_u8(vget_low_u8(px.val[0]), k_r);
+        lo = vmlal_u8(lo, vget_low_u8(px.val[1]), k_g);
+        lo = vmlal_u8(lo, vget_low_u8(px.val[2]), k_b);
+        uint16x8_t hi = vmull_u8(vget_high_u8(px.val[0]), k_r);
+        hi = vmlal_u8(hi, vget_high_u8(px.val[1]), k_g);
+        hi = vmlal_u8(hi, vget_high_u8(px.val[2]), k_b);
+        vst1q_u8(luma + i, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+    }
+    scalarKernels()->rgb_to_luma(rgb + i * 3, luma + i, pixels - i);
+}
+
+void downscale2x(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+                 int dst_width, int dst_height) {
+    const int vector_width = dst_width & ~15;
+    for (int row = 0; row < dst_height; ++row) {
+        const uint8_t* r0 = src + static_cast<ptrdiff_t>(row) * 2 * src_stride;
+        const uint8_t* r1 = r0 + src_stride;
+        uint8_t* out = dst + static_cast<ptrdiff_t>(row) * dst_stride;
+        for (int x = 0; x < vector_width; x += 16) {
+            // Pairwise add-long, then accumulate the second row's pairs: (a+b+c+d)
+            const uint16x8_t lo = vpadalq_u8(vpaddlq_u8(vld1q_u8(r0 + 2 * x)), vld1q_u8(r1 + 2 * x));
+            const uint16x8_t hi = vpadalq_u8(vpaddlq_u8(vld1q_u8(r0 + 2 * x + 16)), vld1q_u8(r1 + 2 * x + 16));
+            vst1q_u8(out + x, vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2)));   // (sum + 2) >> 2
+        }
+    }
+    if (vector_width < dst_width) {
+        scalarKernels()->downscale_2x(src + 2 * vector_width, src_stride, dst + vector_width, dst_stride,
+                                      dst_width - vector_width, dst_height);
+    }
+}
+
+void lerpRows(const uint8_t* row0, const uint8_t* row1, int weight, uint16_t* out, int width) {
+    const uint16x8_t w0 = vdupq_n_u16(static_cast<uint16_t>(256 - weight));
+    const uint16x8_t w1 = vdupq_n_u16(static_cast<uint16_t>(weight));
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const uint8x16_t a = vld1q_u8(row0 + x);
+        const uint8x16_t b = vld1q_u8(row1 + x);
+        vst1q_u16(out + x, vmlaq_u16(vmulq_u16(vmovl_u8(vget_low_u8(a)), w0), vmovl_u8(vget_low_u8(b)), w1));
+        vst1q_u16(out + x + 8, vmlaq_u16(vmulq_u16(vmovl_u8(vget_high_u8(a)), w0), vmovl_u8(vget_high_u8(b)), w1));
+    }
+    scalarKernels()->lerp_rows(row0 + x, row1 + x, weight, out + x, width - x);
+}
+
+uint64_t sad(const uint8_t* a, int a_stride, const uint8_t* b, int b_stride, int width, int height) {
+    const int vector_width = width & ~15;
+    uint64_t total = 0;
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* pa = a + static_cast<ptrdiff_t>(row) * a_stride;
+        const uint8_t* pb = b + static_cast<ptrdiff_t>(row) * b_stride;
+        // 16-bit lanes gain at most 2 * 255 per step: widen every 128 steps
+        uint32x4_t row_sum = vdupq_n_u32(0);
+        int x = 0;
+        while (x < vector_width) {
+            uint16x8_t acc = vdupq_n_u16(0);
+            const int end = vector_width - x > 128 * 16 ? x + 128 * 16 : vector_width;
+            for (; x < end; x += 16) {
+                acc = vpadalq_u8(acc, vabdq_u8(vld1q_u8(pa + x), vld1q_u8(pb + x)));
+            }
+            row_sum = vpadalq_u16(row_sum, acc);
+        }
+        total += vaddlvq_u32(row_sum);
+    }
+    if (vector_width < width) {
+        total += scalarKernels()->sad(a + vector_width, a_stride, b + vector_width, b_stride,
+                                      width - vector_width, height);
+    }
+    return total;
+}
+
+// round(x / 255) for 16-bit x <= 65025, as in the scalar reference
+inline uint8x8_t div255(uint16x8_t x) {
+    const uint16x8_t t = vaddq_u16(x, vdupq_n_u16(128));
+    return vshrn_n_u16(vsraq_n_u16(t, t, 8), 8);
+}
+
+void blendRgba(const uint8_t* rgba, uint8_t* rgb, size_t pixels) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        const uint8x16x4_t s = vld4q_u8(rgba + i * 4);
+        uint8x16x3_t d = vld3q_u8(rgb + i * 3);
+        const uint8x16_t a = s.val[3];
+        const uint8x16_t inv = vmvnq_u8(a);     // 255 - a
+        for (int c = 0; c < 3; ++c) {
+            uint16x8_t lo = vmull_u8(vget_low_u8(s.val[c]), vget_low_u8(a));
+            lo = vmlal_u8(lo, vget_low_u8(d.val[c]), vget_low_u8(inv));
+            uint16x8_t hi = vmull_u8(vget_high_u8(s.val[c]), vget_high_u8(a));
+            hi = vmlal_u8(hi, vget_high_u8(d.val[c]), vget_high_u8(inv));
+            d.val[c] = vcombine_u8(div255(lo), div255(hi));
+        }
+        vst3q_u8(rgb + i * 3, d);
+    }
+    scalarKernels()->blend_rgba(rgba + i * 4, rgb + i * 3, pixels - i);
+}
+
+// ============================================================================
+// Remap
+// ============================================================================
+
+// NEON has no gather either; same reasoning as the SSE4.1 table
+void remapRgb(const uint8_t* src, int src_stride, const int32_t* offsets, const uint16_t* fracs,
+              uint8_t* dst, int pixels) {
+    scalarKernels()->remap_rgb(src, src_stride, offsets, fracs, dst, pixels);
+}
+
+const PixelKernels NEON = {
+    PixelIsa::NEON, "neon",
+    rgbToRgba, rgbaToRgb, swapRb,
+    nv12ToRgb, i420ToRgb,
+    rgbToLuma, downscale2x, lerpRows, sad, blendRgba,
+    remapRgb,
+};
+
+} // namespace
+
+const PixelKernels* neonKernels() {
+    return &NEON;
+}
+
+} // namespace pixel_detail
+} // namespace robot_vision
+
+#else
+
+namespace robot_vision {
+namespace pixel_detail {
+
+const PixelKernels* neonKernels() {
+    return nullptr;
+}
+
+} // namespace pixel_detail
+} // namespace robot_vision
+
+#endif
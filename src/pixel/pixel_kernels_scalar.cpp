@@ -0,0 +1,180 @@
+/**
+ * @file pixel_kernels_scalar.cpp
+ * @brief Reference kernels: the definition every SIMD variant must match
+ */
+
+#include "pixel_kernels_internal.h"
+
+namespace robot_vision {
+namespace pixel_detail {
+
+namespace {
+
+inline uint8_t clamp8(int v) {
+    return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+// round(x / 255) for x in 0..65025
+inline uint8_t div255(uint32_t x) {
+    const uint32_t t = x + 128;
+    return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+}
+
+inline void yuvToRgb(int y, int u, int v, uint8_t* out) {
+    const int c = YUV_Y * (y - 16) + YUV_ROUND;
+    const int d = u - 128;
+    const int e = v - 128;
+    out[0] = clamp8((c + YUV_RV * e) >> 8);
+    out[1] = clamp8((c + YUV_GU * d + YUV_GV * e) >> 8);
+    out[2] = clamp8((c + YUV_BU * d) >> 8);
+}
+
+// ============================================================================
+// Swizzles
+// ============================================================================
+
+void rgbToRgba(const uint8_t* rgb, uint8_t* rgba, size_t pixels) {
+    for (size_t i = 0; i < pixels; ++i, rgb += 3, rgba += 4) {
+        rgba[0] = rgb[0];
+        rgba[1] = rgb[1];
+        rgba[2] = rgb[2];
+        rgba[3] = 255;
+    }
+}
+
+void rgbaToRgb(const uint8_t* rgba, uint8_t* rgb, size_t pixels) {
+    for (size_t i = 0; i < pixels; ++i, rgb += 3, rgba += 4) {
+        rgb[0] = rgba[0];
+        rgb[1] = rgba[1];
+        rgb[2] = rgba[2];
+    }
+}
+
+void swapRb(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    for (size_t i = 0; i < pixels; ++i, src += 3, dst += 3) {
+        dst[0] = src[2];
+        dst[1] = src[1];
+        dst[2] = src[0];
+    }
+}
+
+// ============================================================================
+// YUV -> RGB
+// ============================================================================
+
+void nv12ToRgb(const uint8_t* y, int y_stride, const uint8_t* uv, int uv_stride,
+               uint8_t* rgb, int rgb_stride, int width, int height) {
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* py = y + static_cast<ptrdiff_t>(row) * y_stride;
+        const uint8_t* puv = uv + static_cast<ptrdiff_t>(row / 2) * uv_stride;
+        uint8_t* out = rgb + static_cast<ptrdiff_t>(row) * rgb_stride;
+        for (int x = 0; x < width; ++x, out += 3) {
+            yuvToRgb(py[x], puv[(x / 2) * 2], puv[(x / 2) * 2 + 1], out);
+        }
+    }
+}
+
+void i420ToRgb(const uint8_t* y, int y_stride, const uint8_t* u, int u_stride,
+               const uint8_t* v, int v_stride, uint8_t* rgb, int rgb_stride, int width, int height) {
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* py = y + static_cast<ptrdiff_t>(row) * y_stride;
+        const uint8_t* pu = u + static_cast<ptrdiff_t>(row / 2) * u_stride;
+        const uint8_t* pv = v + static_cast<ptrdiff_t>(row / 2) * v_stride;
+        uint8_t* out = rgb + static_cast<ptrdiff_t>(row) * rgb_stride;
+        for (int x = 0; x < width; ++x, out += 3) {
+            yuvToRgb(py[x], pu[x / 2], pv[x / 2], out);
+        }
+    }
+}
+
+// ============================================================================
+// Luma, Scaling, Difference, Blend
+// ============================================================================
+
+void rgbToLuma(const uint8_t* rgb, uint8_t* luma, size_t pixels) {
+    for (size_t i = 0; i < pixels; ++i, rgb += 3) {
+        luma[i] = static_cast<uint8_t>((LUMA_R * rgb[0] + LUMA_G * rgb[1] + LUMA_B * rgb[2]) >> 8);
+    }
+}
+
+void downscale2x(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+                 int dst_width, int dst_height) {
+    for (int row = 0; row < dst_height; ++row) {
+        const uint8_t* r0 = src + static_cast<ptrdiff_t>(row) * 2 * src_stride;
+        const uint8_t* r1 = r0 + src_stride;
+        uint8_t* out = dst + static_cast<ptrdiff_t>(row) * dst_stride;
+        for (int x = 0; x < dst_width; ++x) {
+            out[x] = static_cast<uint8_t>((r0[2 * x] + r0[2 * x + 1] + r1[2 * x] + r1[2 * x + 1] + 2) >> 2);
+        }
+    }
+}
+
+void lerpRows(const uint8_t* row0, const uint8_t* row1, int weight, uint16_t* out, int width) {
+    const int w0 = 256 - weight;
+    for (int x = 0; x < width; ++x) {
+        out[x] = static_cast<uint16_t>(row0[x] * w0 + row1[x] * weight);
+    }
+}
+
+uint64_t sad(const uint8_t* a, int a_stride, const uint8_t* b, int b_stride, int width, int height) {
+    uint64_t total = 0;
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* pa = a + static_cast<ptrdiff_t>(row) * a_stride;
+        const uint8_t* pb = b + static_cast<ptrdiff_t>(row) * b_stride;
+        uint32_t sum = 0;
+        for (int x = 0; x < width; ++x) {
+            sum += static_cast<uint32_t>(pa[x] > pb[x] ? pa[x] - pb[x] : pb[x] - pa[x]);
+        }
+        total += sum;
+    }
+    return total;
+}
+
+void blendRgba(const uint8_t* rgba, uint8_t* rgb, size_t pixels) {
+    for (size_t i = 0; i < pixels; ++i, rgba += 4, rgb += 3) {
+        const uint32_t a = rgba[3];
+        for (int c = 0; c < 3; ++c) {
+            rgb[c] = div255(rgba[c] * a + rgb[c] * (255 - a));
+        }
+    }
+}
+
+// ============================================================================
+// Remap
+// ============================================================================
+
+void remapRgb(const uint8_t* src, int src_stride, const int32_t* offsets, const uint16_t* fracs,
+              uint8_t* dst, int pixels) {
+    for (int i = 0; i < pixels; ++i, dst += 3) {
+        if (offsets[i] < 0) {
+            dst[0] = dst[1] = dst[2] = 0;
+            continue;
+        }
+        const uint8_t* p0 = src + offsets[i];
+        const uint8_t* p1 = p0 + src_stride;
+        const int fx = fracs[i] & 0xFF;
+        const int fy = fracs[i] >> 8;
+        for (int c = 0; c < 3; ++c) {
+            const int top = p0[c] * (256 - fx) + p0[c + 3] * fx;
+            const int bottom = p1[c] * (256 - fx) + p1[c + 3] * fx;
+            dst[c] = static_cast<uint8_t>((top * (256 - fy) + bottom * fy + 32768) >> 16);
+        }
+    }
+}
+
+const PixelKernels SCALAR = {
+    PixelIsa::Scalar, "scalar",
+    rgbToRgba, rgbaToRgb, swapRb,
+    nv12ToRgb, i420ToRgb,
+    rgbToLuma, downscale2x, lerpRows, sad, blendRgba,
+    remapRgb,
+};
+
+} // namespace
+
+const PixelKernels* scalarKernels() {
+    return &SCALAR;
+}
+
+} // namespace pixel_detail
+} // namespace robot_vision
@@ -0,0 +1,285 @@
+/**
+ * @file pixel_kernels_sse41.cpp
+ * @brief SSE4.1 kernels (16 pixels per step; built with -msse4.1)
+ */
+
+#include "pixel_kernels_internal.h"
+
+#if defined(__x86_64__)
+
+#include "pixel_kernels_x86.h"
+
+namespace robot_vision {
+namespace pixel_detail {
+
+namespace {
+
+using namespace x86;
+
+// ============================================================================
+// Swizzles
+// ============================================================================
+
+void rgbToRgba(const uint8_t* rgb, uint8_t* rgba, size_t pixels) {
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i px[4];
+        expandRgb16(rgb + i * 3, px);
+        for (int k = 0; k < 4; ++k) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + (i + 4 * k) * 4), _mm_or_si128(px[k], alpha));
+        }
+    }
+    scalarKernels()->rgb_to_rgba(rgb + i * 3, rgba + i * 4, pixels - i);
+}
+
+void rgbaToRgb(const uint8_t* rgba, uint8_t* rgb, size_t pixels) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i px[4];
+        for (int k = 0; k < 4; ++k) {
+            px[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + (i + 4 * k) * 4));
+        }
+        compactRgb16(px, rgb + i * 3);
+    }
+    scalarKernels()->rgba_to_rgb(rgba + i * 4, rgb + i * 3, pixels - i);
+}
+
+void swapRb(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i r, g, b;
+        loadRgb16(src + i * 3, r, g, b);
+        storeRgb16(dst + i * 3, b, g, r);
+    }
+    scalarKernels()->swap_rb(src + i * 3, dst + i * 3, pixels - i);
+}
+
+// ============================================================================
+// YUV -> RGB
+// ============================================================================
+
+// 8 pixels of widened Y, U, V -> R, G, B as int16 (unclamped)
+inline void yuvToRgb8(__m128i y, __m128i u, __m128i v, __m128i& r, __m128i& g, __m128i& b) {
+    const __m128i c = _mm_sub_epi16(y, _mm_set1_epi16(16));
+    const __m128i d = _mm_sub_epi16(u, _mm_set1_epi16(128));
+    const __m128i e = _mm_sub_epi16(v, _mm_set1_epi16(128));
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i k_r = _mm_setr_epi16(YUV_Y, YUV_RV, YUV_Y, YUV_RV, YUV_Y, YUV_RV, YUV_Y, YUV_RV);
+    const __m128i k_b = _mm_setr_epi16(YUV_Y, YUV_BU, YUV_Y, YUV_BU, YUV_Y, YUV_BU, YUV_Y, YUV_BU);
+    const __m128i k_gu = _mm_setr_epi16(YUV_Y, YUV_GU, YUV_Y, YUV_GU, YUV_Y, YUV_GU, YUV_Y, YUV_GU);
+    const __m128i k_gv = _mm_setr_epi16(YUV_GV, YUV_ROUND, YUV_GV, YUV_ROUND, YUV_GV, YUV_ROUND, YUV_GV, YUV_ROUND);
+    const __m128i round = _mm_set1_epi32(YUV_ROUND);
+
+    // madd multiplies adjacent int16 pairs and sums them into int32:
+    // (c, e) . (298, 409) is the whole R numerator for one pixel
+    const __m128i ce_lo = _mm_unpacklo_epi16(c, e);
+    const __m128i ce_hi = _mm_unpackhi_epi16(c, e);
+    const __m128i cd_lo = _mm_unpacklo_epi16(c, d);
+    const __m128i cd_hi = _mm_unpackhi_epi16(c, d);
+    const __m128i e1_lo = _mm_unpacklo_epi16(e, one);     // G's 1 * 128 rounding rides along
+    const __m128i e1_hi = _mm_unpackhi_epi16(e, one);
+
+    r = _mm_packs_epi32(
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(ce_lo, k_r), round), 8),
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(ce_hi, k_r), round), 8));
+    g = _mm_packs_epi32(
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cd_lo, k_gu), _mm_madd_epi16(e1_lo, k_gv)), 8),
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cd_hi, k_gu), _mm_madd_epi16(e1_hi, k_gv)), 8));
+    b = _mm_packs_epi32(
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cd_lo, k_b), round), 8),
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cd_hi, k_b), round), 8));
+}
+
+// 16 pixels: Y bytes and duplicated U, V bytes -> packed RGB
+inline void yuvToRgb16(__m128i y, __m128i u, __m128i v, uint8_t* out) {
+    __m128i r_lo, g_lo, b_lo, r_hi, g_hi, b_hi;
+    yuvToRgb8(_mm_cvtepu8_epi16(y), _mm_cvtepu8_epi16(u), _mm_cvtepu8_epi16(v), r_lo, g_lo, b_lo);
+    yuvToRgb8(_mm_cvtepu8_epi16(_mm_srli_si128(y, 8)), _mm_cvtepu8_epi16(_mm_srli_si128(u, 8)),
+              _mm_cvtepu8_epi16(_mm_srli_si128(v, 8)), r_hi, g_hi, b_hi);
+    storeRgb16(out, _mm_packus_epi16(r_lo, r_hi), _mm_packus_epi16(g_lo, g_hi), _mm_packus_epi16(b_lo, b_hi));
+}
+
+void nv12ToRgb(const uint8_t* y, int y_stride, const uint8_t* uv, int uv_stride,
+               uint8_t* rgb, int rgb_stride, int width, int height) {
+    const int vector_width = width & ~15;
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* py = y + static_cast<ptrdiff_t>(row) * y_stride;
+        const uint8_t* puv = uv + static_cast<ptrdiff_t>(row / 2) * uv_stride;
+        uint8_t* out = rgb + static_cast<ptrdiff_t>(row) * rgb_stride;
+        for (int x = 0; x < vector_width; x += 16) {
+            __m128i u, v;
+            splitUv16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(puv + x)), u, v);
+            yuvToRgb16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(py + x)), u, v, out + x * 3);
+        }
+    }
+    if (vector_width < width) {
+        scalarKernels()->nv12_to_rgb(y + vector_width, y_stride, uv + vector_width, uv_stride,
+                                     rgb + vector_width * 3, rgb_stride, width - vector_width, height);
+    }
+}
+
+void i420ToRgb(const uint8_t* y, int y_stride, const uint8_t* u, int u_stride,
+               const uint8_t* v, int v_stride, uint8_t* rgb, int rgb_stride, int width, int height) {
+    const int vector_width = width & ~15;
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* py = y + static_cast<ptrdiff_t>(row) * y_stride;
+        const uint8_t* pu = u + static_cast<ptrdiff_t>(row / 2) * u_stride;
+        const uint8_t* pv = v + static_cast<ptrdiff_t>(row / 2) * v_stride;
+        uint8_t* out = rgb + static_cast<ptrdiff_t>(row) * rgb_stride;
+        for (int x = 0; x < vector_width; x += 16) {
+            yuvToRgb16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(py + x)),
+                       dupLow8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pu + x / 2))),
+                       dupLow8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pv + x / 2))),
+                       out + x * 3);
+        }
+    }
+    if (vector_width < width) {
+        scalarKernels()->i420_to_rgb(y + vector_width, y_stride, u + vector_width / 2, u_stride,
+                                     v + vector_width / 2, v_stride, rgb + vector_width * 3, rgb_stride,
+                                     width - vector_width, height);
+    }
+}
+
+// ============================================================================
+// Luma, Scaling, Difference, Blend
+// ============================================================================
+
+inline __m128i luma8(__m128i r, __m128i g, __m128i b) {
+    // Sum <= 255 * 256, so unsigned 16-bit lanes hold it exactly
+    const __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(LUMA_R)),
+                                                    _mm_mullo_epi16(g, _mm_set1_epi16(LUMA_G))),
+                                      _mm_mullo_epi16(b, _mm_set1_epi16(LUMA_B)));
+    return _mm_srli_epi16(sum, 8);
+}
+
+void rgbToLuma(const uint8_t* rgb, uint8_t* luma, size_t pixels) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i r, g, b;
+        loadRgb16(rgb + i * 3, r, g, b);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i lo = luma8(_mm_cvtepu8_epi16(r), _mm_cvtepu8_epi16(g), _mm_cvtepu8_epi16(b));
+        const __m128i hi = luma8(_mm_unpackhi_epi8(r, zero), _mm_unpackhi_epi8(g, zero),
+                                 _mm_unpackhi_epi8(b, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(luma + i), _mm_packus_epi16(lo, hi));
+    }
+    scalarKernels()->rgb_to_luma(rgb + i * 3, luma + i, pixels - i);
+}
+
+void downscale2x(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+                 int dst_width, int dst_height) {
+    const int vector_width = dst_width & ~15;
+    const __m128i ones = _mm_set1_epi8(1);
+    const __m128i two = _mm_set1_epi16(2);
+    for (int row = 0; row < dst_height; ++row) {
+        const uint8_t* r0 = src + static_cast<ptrdiff_t>(row) * 2 * src_stride;
+        const uint8_t* r1 = r0 + src_stride;
+        uint8_t* out = dst + static_cast<ptrdiff_t>(row) * dst_stride;
+        for (int x = 0; x < vector_width; x += 16) {
+            // maddubs with ones: horizontal pair sums as 16-bit
+            const __m128i lo = _mm_add_epi16(
+                _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + 2 * x)), ones),
+                _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + 2 * x)), ones));
+            const __m128i hi = _mm_add_epi16(
+                _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + 2 * x + 16)), ones),
+                _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + 2 * x + 16)), ones));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x),
+                             _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(lo, two), 2),
+                                              _mm_srli_epi16(_mm_add_epi16(hi, two), 2)));
+        }
+    }
+    if (vector_width < dst_width) {
+        scalarKernels()->downscale_2x(src + 2 * vector_width, src_stride, dst + vector_width, dst_stride,
+                                      dst_width - vector_width, dst_height);
+    }
+}
+
+void lerpRows(const uint8_t* row0, const uint8_t* row1, int weight, uint16_t* out, int width) {
+    const __m128i w0 = _mm_set1_epi16(static_cast<short>(256 - weight));
+    const __m128i w1 = _mm_set1_epi16(static_cast<short>(weight));
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        const __m128i a = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row0 + x)));
+        const __m128i b = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row1 + x)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x),
+                         _mm_add_epi16(_mm_mullo_epi16(a, w0), _mm_mullo_epi16(b, w1)));
+    }
+    scalarKernels()->lerp_rows(row0 + x, row1 + x, weight, out + x, width - x);
+}
+
+uint64_t sad(const uint8_t* a, int a_stride, const uint8_t* b, int b_stride, int width, int height) {
+    const int vector_width = width & ~15;
+    __m128i acc = _mm_setzero_si128();
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* pa = a + static_cast<ptrdiff_t>(row) * a_stride;
+        const uint8_t* pb = b + static_cast<ptrdiff_t>(row) * b_stride;
+        for (int x = 0; x < vector_width; x += 16) {
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pa + x)),
+                                                  _mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + x))));
+        }
+    }
+    uint64_t total = static_cast<uint64_t>(_mm_cvtsi128_si64(acc)) +
+                     static_cast<uint64_t>(_mm_extract_epi64(acc, 1));
+    if (vector_width < width) {
+        total += scalarKernels()->sad(a + vector_width, a_stride, b + vector_width, b_stride,
+                                      width - vector_width, height);
+    }
+    return total;
+}
+
+void blendRgba(const uint8_t* rgba, uint8_t* rgb, size_t pixels) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i px[4];
+        expandRgb16(rgb + i * 3, px);
+        for (int k = 0; k < 4; ++k) {
+            px[k] = blend4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + (i + 4 * k) * 4)), px[k]);
+        }
+        compactRgb16(px, rgb + i * 3);
+    }
+    scalarKernels()->blend_rgba(rgba + i * 4, rgb + i * 3, pixels - i);
+}
+
+// ============================================================================
+// Remap
+// ============================================================================
+
+// SSE has no gather; loading four neighbours per pixel with scalar
+// loads and then shuffling them into vectors is no faster than the scalar
+// kernel, so it forwards there
+void remapRgb(const uint8_t* src, int src_stride, const int32_t* offsets, const uint16_t* fracs,
+              uint8_t* dst, int pixels) {
+    scalarKernels()->remap_rgb(src, src_stride, offsets, fracs, dst, pixels);
+}
+
+const PixelKernels SSE41 = {
+    PixelIsa::SSE41, "sse4.1",
+    rgbToRgba, rgbaToRgb, swapRb,
+    nv12ToRgb, i420ToRgb,
+    rgbToLuma, downscale2x, lerpRows, sad, blendRgba,
+    remapRgb,
+};
+
+} // namespace
+
+const PixelKernels* sse41Kernels() {
+    return &SSE41;
+}
+
+} // namespace pixel_detail
+} // namespace robot_vision
+
+#else
+
+namespace robot_vision {
+namespace pixel_detail {
+
+const PixelKernels* sse41Kernels() {
+    return nullptr;
+}
+
+} // namespace pixel_detail
+} // namespace robot_vision
+
+#endif
@@ -0,0 +1,131 @@
+#pragma once
+
+/**
+ * @file pixel_kernels_x86.h
+ * @brief SSE helpers shared by the SSE4.1 and AVX2 kernel sources
+ *
+ * Included only by translation units built with -msse4.1 or -mavx2. All
+ * helpers are static so each unit gets its own copy, compiled for its own
+ * instruction set.
+ */
+
+#include "pixel_kernels_internal.h"
+
+#include <immintrin.h>
+
+namespace robot_vision {
+namespace pixel_detail {
+namespace x86 {
+
+/**
+ * 48 bytes of packed RGB (16 pixels) -> one vector per channel
+ */
+static inline void loadRgb16(const uint8_t* src, __m128i& r, __m128i& g, __m128i& b) {
+    const __m128i in0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i in1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+    const __m128i in2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+    r = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(in0, _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(in1, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(in2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13)));
+    g = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(in0, _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(in1, _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(in2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14)));
+    b = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(in0, _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(in1, _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(in2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15)));
+}
+
+/**
+ * One vector per channel (16 pixels) -> 48 bytes of packed RGB
+ */
+static inline void storeRgb16(uint8_t* dst, __m128i r, __m128i g, __m128i b) {
+    const __m128i out0 = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(r, _mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5)),
+            _mm_shuffle_epi8(g, _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1))),
+            _mm_shuffle_epi8(b, _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1)));
+    const __m128i out1 = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(r, _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1)),
+            _mm_shuffle_epi8(g, _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10))),
+            _mm_shuffle_epi8(b, _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1)));
+    const __m128i out2 = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(r, _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1)),
+            _mm_shuffle_epi8(g, _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1))),
+            _mm_shuffle_epi8(b, _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), out0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), out1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), out2);
+}
+
+/**
+ * 48 bytes of packed RGB -> four vectors of 4 pixels in RGBx layout
+ * (the fourth byte of each pixel is zero)
+ */
+static inline void expandRgb16(const uint8_t* src, __m128i out[4]) {
+    const __m128i in0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i in1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+    const __m128i in2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+    const __m128i expand = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    out[0] = _mm_shuffle_epi8(in0, expand);
+    out[1] = _mm_shuffle_epi8(_mm_alignr_epi8(in1, in0, 12), expand);
+    out[2] = _mm_shuffle_epi8(_mm_alignr_epi8(in2, in1, 8), expand);
+    out[3] = _mm_shuffle_epi8(_mm_srli_si128(in2, 4), expand);
+}
+
+/**
+ * Four vectors of 4 pixels in RGBx layout -> 48 bytes of packed RGB
+ */
+static inline void compactRgb16(const __m128i in[4], uint8_t* dst) {
+    const __m128i compact = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const __m128i p0 = _mm_shuffle_epi8(in[0], compact);
+    const __m128i p1 = _mm_shuffle_epi8(in[1], compact);
+    const __m128i p2 = _mm_shuffle_epi8(in[2], compact);
+    const __m128i p3 = _mm_shuffle_epi8(in[3], compact);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16),
+                     _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32),
+                     _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+}
+
+/**
+ * Duplicate each of the low 8 bytes (one chroma sample per two pixels)
+ */
+static inline __m128i dupLow8(__m128i v) {
+    return _mm_unpacklo_epi8(v, v);
+}
+
+/**
+ * Split 16 bytes of interleaved UV (NV12) into duplicated U and V for 16 pixels
+ */
+static inline void splitUv16(__m128i uv, __m128i& u, __m128i& v) {
+    u = _mm_shuffle_epi8(uv, _mm_setr_epi8(0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14));
+    v = _mm_shuffle_epi8(uv, _mm_setr_epi8(1, 1, 3, 3, 5, 5, 7, 7, 9, 9, 11, 11, 13, 13, 15, 15));
+}
+
+/**
+ * Two pixels widened to 16 bits: src over dst, divided by 255 with rounding
+ */
+static inline __m128i blendHalf(__m128i s16, __m128i d16) {
+    const __m128i a16 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s16, 0xFF), 0xFF);
+    const __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), a16);
+    const __m128i x = _mm_add_epi16(_mm_mullo_epi16(s16, a16), _mm_mullo_epi16(d16, inv));
+    const __m128i t = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+/**
+ * Four RGBA pixels over four RGBx pixels (the result's fourth byte is junk)
+ */
+static inline __m128i blend4(__m128i rgba, __m128i rgbx) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = blendHalf(_mm_unpacklo_epi8(rgba, zero), _mm_unpacklo_epi8(rgbx, zero));
+    const __m128i hi = blendHalf(_mm_unpackhi_epi8(rgba, zero), _mm_unpackhi_epi8(rgbx, zero));
+    return _mm_packus_epi16(lo, hi);
+}
+
+} // namespace x86
+} // namespace pixel_detail
+} // namespace robot_vision
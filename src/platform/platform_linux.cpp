@@ -10,8 +10,15 @@
  */
 
 #include "core/platform.h"
+#include "util/logger.h"
+#include "video/camera_prober.h"
+#include "video/mjpeg_decoder.h"
+#include <gst/gst.h>
 #include <sys/utsname.h>
 #include <fstream>
+#include <mutex>
+#include <set>
+#include <vector>
 
 namespace robot_vision {
 
@@ -75,7 +82,33 @@ public:
         return is_jetson_ ? "Jetson" : "Linux";
     }
 
-    std::string getCameraPipeline(int width, int height, int fps) const override {
+    std::string getCameraPipeline(int width, int height, int fps,
+                                  const std::string& device) const override {
+        /**
+         * Probed USB/V4L2 camera: the native mode that needs the least
+         * conversion (see camera_prober.h). On Jetson a hardware JPEG
+         * decoder makes MJPEG modes cheap; elsewhere MJPEG is decoded by
+         * libjpeg-turbo on several cores (MjpegDecoder) instead of one jpegdec.
+         */
+        const bool hw_jpeg = is_jetson_ && hasElement("nvjpegdec");
+        CameraChoice choice;
+        if (device != "csi" &&
+            chooseCameraMode(cameras(), width, height, fps, device, hw_jpeg, choice)) {
+            RV_LOG_INFO("platform", "Camera: '{}' ({}) {} - {}", choice.device_name, choice.device_path,
+                        choice.mode.toString(), choice.reason);
+            if (!choice.meets_request) {
+                RV_LOG_WARN("platform", "Camera: no native mode gives {}x{} @ {} fps; closest shown above",
+                            width, height, fps);
+            }
+            std::string jpeg_decoder = "jpegdec";
+            if (hw_jpeg) {
+                jpeg_decoder = "nvjpegdec";
+            } else if (MjpegDecoder::isAvailable()) {
+                jpeg_decoder = "";      // Application-side, multi-threaded
+            }
+            return cameraPipeline(choice, width, height, fps, jpeg_decoder);
+        }
+
         if (is_jetson_) {
             /**
              * Jetson CSI Camera Pipeline (nvarguscamerasrc)
@@ -83,7 +116,9 @@ public:
              * nvarguscamerasrc  - NVIDIA's camera source for CSI cameras
              * nvvidconv         - NVIDIA's hardware-accelerated format converter
              *
-             * Uses NVMM (NVIDIA Memory Management) for zero-copy performance
+             * Uses NVMM (NVIDIA Memory Management) for zero-copy performance.
+             * CSI sensors expose only Bayer formats to V4L2, so the prober
+             * never picks them; the ISP behind Argus does the conversion.
              */
             return
                 "nvarguscamerasrc ! "
@@ -93,20 +128,24 @@ public:
                 "nvvidconv ! "
                 "video/x-raw,format=RGB ! "
                 "appsink name=sink emit-signals=true max-buffers=1 drop=true";
-        } else {
-            /**
-             * Generic Linux USB Camera Pipeline (v4l2src)
-             *
-             * v4l2src - Video4Linux2 source, works with USB webcams
-             */
-            return
-                "v4l2src device=/dev/video0 ! "
-                "videoconvert ! "
-                "video/x-raw,format=RGB,width=" + std::to_string(width) +
-                ",height=" + std::to_string(height) +
-                ",framerate=" + std::to_string(fps) + "/1 ! "
-                "appsink name=sink emit-signals=true max-buffers=1 drop=true";
         }
+
+        /**
+         * Generic Linux USB Camera Pipeline (v4l2src)
+         *
+         * Nothing probed (no device monitor results, or no camera matches
+         * the configured device): let v4l2src and videoconvert negotiate.
+         */
+        const std::string path = device.empty() ? "/dev/video0" : device;
+        RV_LOG_WARN("platform", "Camera: no probed mode for '{}'; letting {} negotiate (may convert on the CPU)",
+                    device.empty() ? "any camera" : device, path);
+        return
+            "v4l2src device=" + path + " ! "
+            "videoconvert ! "
+            "video/x-raw,format=RGB,width=" + std::to_string(width) +
+            ",height=" + std::to_string(height) +
+            ",framerate=" + std::to_string(fps) + "/1 ! "
+            "appsink name=sink emit-signals=true max-buffers=1 drop=true";
     }
 
     std::string getDisplayPipeline() const override {
@@ -119,18 +158,48 @@ public:
         }
     }
 
+    std::string getH264EncoderPipeline(int bitrate_kbps, int keyframe_interval) const override {
+        if (is_jetson_) {
+            // Hardware encoder (NVENC); nvvidconv cannot take packed RGB, hence RGBA first
+            return
+                "videoconvert ! video/x-raw,format=RGBA ! "
+                "nvvidconv ! video/x-raw(memory:NVMM),format=I420 ! "
+                "nvv4l2h264enc bitrate=" + std::to_string(bitrate_kbps * 1000) +
+                " iframeinterval=" + std::to_string(keyframe_interval) +
+                " idrinterval=" + std::to_string(keyframe_interval) +
+                " insert-sps-pps=true maxperf-enable=true";
+        } else {
+            // Software encoder tuned for latency over compression
+            return
+                "videoconvert ! "
+                "x264enc tune=zerolatency speed-preset=ultrafast bframes=0"
+                " bitrate=" + std::to_string(bitrate_kbps) +
+                " key-int-max=" + std::to_string(keyframe_interval);
+        }
+    }
+
     bool hasCamera() const override {
-        // Check if /dev/video0 exists (common camera device)
+        if (!cameras().empty()) {
+            return true;
+        }
+        // Before gst_init, or a CSI sensor (Bayer only): is there a node at all?
         std::ifstream video_device("/dev/video0");
         return video_device.good();
     }
 
     bool supportsResolution(int width, int height) const override {
-        // Common supported resolutions
-        if (width == 640 && height == 480) return true;
-        if (width == 1280 && height == 720) return true;
-        if (width == 1920 && height == 1080) return true;
-
+        // Natively, by some camera (anything else is scaled on the CPU)
+        const auto& probed = cameras();
+        for (const auto& camera : probed) {
+            for (const auto& mode : camera.modes) {
+                if (mode.width == width && mode.height == height) {
+                    return true;
+                }
+            }
+        }
+        if (!probed.empty()) {
+            return false;
+        }
         return (width > 0 && width <= 4096 && height > 0 && height <= 4096);
     }
 
@@ -173,8 +242,45 @@ public:
     }
 
 private:
+    /**
+     * Cameras and their modes, probed once after gst_init()
+     */
+    const std::vector<CameraDevice>& cameras() const {
+        std::lock_guard<std::mutex> lock(camera_mutex_);
+        if (!cameras_probed_ && gst_is_initialized()) {
+            cameras_ = probeCameras();
+            cameras_probed_ = true;
+            for (const auto& camera : cameras_) {
+                std::set<std::string> formats;
+                for (const auto& mode : camera.modes) {
+                    formats.insert(mode.format);
+                }
+                std::string list;
+                for (const auto& format : formats) {
+                    list += (list.empty() ? "" : ",") + format;
+                }
+                RV_LOG_INFO("platform", "Camera: found '{}' at {} ({} modes: {})",
+                            camera.name, camera.path, camera.modes.size(), list);
+            }
+        }
+        return cameras_;
+    }
+
+    static bool hasElement(const char* name) {
+        GstElementFactory* factory = gst_element_factory_find(name);
+        if (!factory) {
+            return false;
+        }
+        gst_object_unref(factory);
+        return true;
+    }
+
     bool is_jetson_ = false;
     std::string os_version_;
+
+    mutable std::mutex camera_mutex_;
+    mutable bool cameras_probed_ = false;
+    mutable std::vector<CameraDevice> cameras_;     // Written once, under camera_mutex_
 };
 
 // Factory function
@@ -7,10 +7,10 @@
  */
 
 #include "core/platform.h"
+#include "util/logger.h"
 #include <sys/utsname.h>  // For uname() to get OS version
 #include <unistd.h>       // For usleep()
 #include <gst/gst.h>      // For camera probing
-#include <iostream>
 #include <vector>
 
 namespace robot_vision {
@@ -62,7 +62,8 @@ public:
         return "macOS";
     }
 
-    std::string getCameraPipeline(int width, int height, int fps) const override {
+    std::string getCameraPipeline(int width, int height, int fps,
+                                  const std::string& device) const override {
         /**
          * TEACHING: GStreamer Pipeline Syntax
          * ------------------------------------
@@ -77,8 +78,11 @@ public:
          * Camera Selection Strategy:
          * - Try external camera first (device-index=1)
          * - Fall back to built-in camera (device-index=0)
+         * - A numeric device ("1") picks the index directly
          */
-        int camera_index = getPreferredCameraIndex();
+        int camera_index = !device.empty() && device.find_first_not_of("0123456789") == std::string::npos
+            ? std::stoi(device)
+            : getPreferredCameraIndex();
 
         std::string pipeline =
             "avfvideosrc device-index=" + std::to_string(camera_index) + " ! "
@@ -100,6 +104,18 @@ public:
         return "autovideosink";
     }
 
+    std::string getH264EncoderPipeline(int bitrate_kbps, int keyframe_interval) const override {
+        /**
+         * vtenc_h264 uses VideoToolbox (hardware encoder on every recent Mac).
+         * Frame reordering is disabled so the stream has no B-frames.
+         */
+        return
+            "videoconvert ! "
+            "vtenc_h264 realtime=true allow-frame-reordering=false"
+            " bitrate=" + std::to_string(bitrate_kbps) +
+            " max-keyframe-interval=" + std::to_string(keyframe_interval);
+    }
+
     bool hasCamera() const override {
         /**
          * TEACHING: Camera Detection
@@ -178,19 +194,19 @@ private:
      * If multiple cameras exist, prefer the highest index (most recently added).
      */
     int getPreferredCameraIndex() const {
-        std::cout << "  Camera: Scanning available cameras...\n";
+        RV_LOG_INFO("platform", "Camera: Scanning available cameras...");
 
         // Scan indexes 0-3 to find all available cameras
         std::vector<int> available_cameras;
         for (int i = 0; i <= 3; ++i) {
             if (probeCameraExists(i)) {
-                std::cout << "    Found camera at device-index=" << i << "\n";
+                RV_LOG_INFO("platform", "  Found camera at device-index={}", i);
                 available_cameras.push_back(i);
             }
         }
 
         if (available_cameras.empty()) {
-            std::cout << "  Camera: No cameras found, defaulting to index 0\n";
+            RV_LOG_WARN("platform", "Camera: No cameras found, defaulting to index 0");
             return 0;
         }
 
@@ -204,9 +220,9 @@ private:
         }
 
         if (selected > 0) {
-            std::cout << "  Camera: Using external camera (device-index=" << selected << ")\n";
+            RV_LOG_INFO("platform", "Camera: Using external camera (device-index={})", selected);
         } else {
-            std::cout << "  Camera: Using built-in camera (device-index=0)\n";
+            RV_LOG_INFO("platform", "Camera: Using built-in camera (device-index=0)");
         }
 
         return selected;
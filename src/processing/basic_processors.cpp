@@ -0,0 +1,173 @@
+/**
+ * @file basic_processors.cpp
+ * @brief Sharpness, exposure and motion scores on the luma thumbnail
+ */
+
+#include "basic_processors.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace robot_vision {
+
+namespace {
+
+constexpr int DARK_LEVEL = 8;
+constexpr int BRIGHT_LEVEL = 247;
+constexpr int MOTION_THRESHOLD = 12;    // Luma steps above sensor noise on a box-filtered thumbnail
+
+} // namespace
+
+// ============================================================================
+// Sharpness
+// ============================================================================
+
+SharpnessProcessor::SharpnessProcessor()
+    : gauge_(MetricsRegistry::global().gauge("rv_frame_sharpness",
+                                             "Variance of the Laplacian of the luma thumbnail"))
+{
+}
+
+void SharpnessProcessor::process(FrameContext& context) {
+    const LumaPlane* luma = context.get<LumaPlane>(products::LUMA_THUMB);
+    if (!luma || luma->width < 3 || luma->height < 3) {
+        return;
+    }
+
+    const int w = luma->width;
+    const uint8_t* p = luma->data.data();
+    int64_t sum = 0;
+    int64_t sum_sq = 0;
+    for (int y = 1; y < luma->height - 1; ++y) {
+        const uint8_t* row = p + static_cast<size_t>(y) * w;
+        for (int x = 1; x < w - 1; ++x) {
+            const int lap = row[x - w] + row[x + w] + row[x - 1] + row[x + 1] - 4 * row[x];
+            sum += lap;
+            sum_sq += lap * lap;
+        }
+    }
+    const double n = static_cast<double>(w - 2) * (luma->height - 2);
+    const double mean = static_cast<double>(sum) / n;
+    const float variance = static_cast<float>(static_cast<double>(sum_sq) / n - mean * mean);
+
+    gauge_.set(variance);
+    context.put("sharpness", variance);
+}
+
+// ============================================================================
+// Exposure
+// ============================================================================
+
+ExposureProcessor::ExposureProcessor()
+    : mean_(MetricsRegistry::global().gauge("rv_frame_luma_mean", "Mean luma of the analysed frame (0-255)"))
+    , dark_(MetricsRegistry::global().gauge("rv_frame_clipped_fraction",
+                                            "Share of pixels crushed to black or blown to white",
+                                            "side=\"dark\""))
+    , bright_(MetricsRegistry::global().gauge("rv_frame_clipped_fraction",
+                                              "Share of pixels crushed to black or blown to white",
+                                              "side=\"bright\""))
+{
+}
+
+void ExposureProcessor::process(FrameContext& context) {
+    const LumaPlane* luma = context.get<LumaPlane>(products::LUMA_THUMB);
+    if (!luma || luma->data.empty()) {
+        return;
+    }
+
+    uint64_t sum = 0;
+    size_t dark = 0;
+    size_t bright = 0;
+    for (uint8_t v : luma->data) {
+        sum += v;
+        dark += v <= DARK_LEVEL;
+        bright += v >= BRIGHT_LEVEL;
+    }
+    const float n = static_cast<float>(luma->data.size());
+    ExposureStats stats;
+    stats.mean = static_cast<float>(sum) / n;
+    stats.dark_fraction = static_cast<float>(dark) / n;
+    stats.bright_fraction = static_cast<float>(bright) / n;
+
+    mean_.set(stats.mean);
+    dark_.set(stats.dark_fraction);
+    bright_.set(stats.bright_fraction);
+    context.put("exposure", stats);
+}
+
+// ============================================================================
+// Motion
+// ============================================================================
+
+MotionProcessor::MotionProcessor()
+    : gauge_(MetricsRegistry::global().gauge("rv_frame_motion",
+                                             "Share of thumbnail pixels that changed since the last analysed frame"))
+{
+}
+
+void MotionProcessor::process(FrameContext& context) {
+    const LumaPlane* luma = context.get<LumaPlane>(products::LUMA_THUMB);
+    const ExposureStats* exposure = context.get<ExposureStats>("exposure");
+    if (!luma || !exposure || luma->data.empty()) {
+        return;
+    }
+
+    if (luma->width == previous_width_ && luma->height == previous_height_) {
+        const int shift = static_cast<int>(std::lround(exposure->mean - previous_mean_));
+        size_t changed = 0;
+        for (size_t i = 0; i < luma->data.size(); ++i) {
+            const int diff = static_cast<int>(luma->data[i]) - static_cast<int>(previous_[i]) - shift;
+            changed += std::abs(diff) > MOTION_THRESHOLD;
+        }
+        const float motion = static_cast<float>(changed) / static_cast<float>(luma->data.size());
+        gauge_.set(motion);
+        context.put("motion", motion);
+    }
+
+    previous_ = luma->data;
+    previous_width_ = luma->width;
+    previous_height_ = luma->height;
+    previous_mean_ = exposure->mean;
+}
+
+// ============================================================================
+// Factory
+// ============================================================================
+
+std::shared_ptr<IFrameProcessor> createFrameProcessor(const std::string& name) {
+    if (name == "sharpness") {
+        return std::make_shared<SharpnessProcessor>();
+    }
+    if (name == "exposure") {
+        return std::make_shared<ExposureProcessor>();
+    }
+    if (name == "motion") {
+        return std::make_shared<MotionProcessor>();
+    }
+    return nullptr;
+}
+
+bool isBuiltinProcessor(const std::string& name) {
+    return name == "sharpness" || name == "exposure" || name == "motion";
+}
+
+std::vector<std::string> parseProcessorList(const std::string& list) {
+    std::vector<std::string> names;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        std::string name = list.substr(start, end - start);
+        const size_t first = name.find_first_not_of(" \t");
+        const size_t last = name.find_last_not_of(" \t");
+        if (first != std::string::npos) {
+            names.push_back(name.substr(first, last - first + 1));
+        }
+        start = end + 1;
+    }
+    return names;
+}
+
+} // namespace robot_vision
@@ -0,0 +1,109 @@
+#pragma once
+
+/**
+ * @file basic_processors.h
+ * @brief Built-in frame processors: sharpness, exposure, motion
+ *
+ * All three read the shared luma thumbnail, so enabling more of them costs
+ * their own arithmetic on a ~320x180 plane, not another pass over the frame.
+ * Results are published as products (for processors downstream) and as
+ * gauges (for dashboards and alerts):
+ *
+ *   sharpness  rv_frame_sharpness          variance of the Laplacian
+ *   exposure   rv_frame_luma_mean          mean luma, 0-255
+ *              rv_frame_clipped_fraction   share of pixels at <=8 / >=247
+ *   motion     rv_frame_motion             share of pixels that changed
+ */
+
+#include "metrics/metrics.h"
+#include "processing/frame_processor.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * Output of ExposureProcessor ("exposure")
+ */
+struct ExposureStats {
+    float mean = 0.0f;                  // Mean luma, 0-255
+    float dark_fraction = 0.0f;         // Pixels <= 8
+    float bright_fraction = 0.0f;       // Pixels >= 247
+};
+
+/**
+ * Focus/blur score: variance of the 4-neighbour Laplacian ("sharpness", float)
+ */
+class SharpnessProcessor : public IFrameProcessor {
+public:
+    SharpnessProcessor();
+
+    const char* name() const override { return "sharpness"; }
+    std::vector<std::string> inputs() const override { return {products::LUMA_THUMB}; }
+    std::vector<std::string> outputs() const override { return {"sharpness"}; }
+    void process(FrameContext& context) override;
+
+private:
+    Gauge& gauge_;
+};
+
+/**
+ * Brightness and clipping ("exposure", ExposureStats)
+ */
+class ExposureProcessor : public IFrameProcessor {
+public:
+    ExposureProcessor();
+
+    const char* name() const override { return "exposure"; }
+    std::vector<std::string> inputs() const override { return {products::LUMA_THUMB}; }
+    std::vector<std::string> outputs() const override { return {"exposure"}; }
+    void process(FrameContext& context) override;
+
+private:
+    Gauge& mean_;
+    Gauge& dark_;
+    Gauge& bright_;
+};
+
+/**
+ * Share of pixels that changed since the previous analysed frame ("motion", float)
+ *
+ * Reads "exposure" to subtract the change in mean brightness first, so
+ * auto-exposure stepping doesn't register as the whole scene moving.
+ */
+class MotionProcessor : public IFrameProcessor {
+public:
+    MotionProcessor();
+
+    const char* name() const override { return "motion"; }
+    std::vector<std::string> inputs() const override { return {products::LUMA_THUMB, "exposure"}; }
+    std::vector<std::string> outputs() const override { return {"motion"}; }
+    void process(FrameContext& context) override;
+
+private:
+    std::vector<uint8_t> previous_;
+    int previous_width_ = 0;
+    int previous_height_ = 0;
+    float previous_mean_ = 0.0f;
+    Gauge& gauge_;
+};
+
+/**
+ * Create a built-in processor by name (nullptr if unknown)
+ */
+std::shared_ptr<IFrameProcessor> createFrameProcessor(const std::string& name);
+
+/**
+ * Whether createFrameProcessor() knows this name (no metrics registered)
+ */
+bool isBuiltinProcessor(const std::string& name);
+
+/**
+ * Split a comma-separated list ("sharpness, motion") into names
+ */
+std::vector<std::string> parseProcessorList(const std::string& list);
+
+} // namespace robot_vision
@@ -0,0 +1,151 @@
+#pragma once
+
+/**
+ * @file frame_processor.h
+ * @brief Per-frame analysis plugin interface and the products it exchanges
+ *
+ * A processor declares which products it reads and which it writes:
+ *
+ *   class BlurScore : public IFrameProcessor {
+ *       const char* name() const override { return "sharpness"; }
+ *       std::vector<std::string> inputs() const override { return {products::LUMA_THUMB}; }
+ *       std::vector<std::string> outputs() const override { return {"sharpness"}; }
+ *       void process(FrameContext& context) override {
+ *           const LumaPlane* luma = context.get<LumaPlane>(products::LUMA_THUMB);
+ *           ...
+ *           context.put("sharpness", score);
+ *       }
+ *   };
+ *
+ * ProcessorGraph turns those declarations into a dependency graph: a
+ * processor runs as soon as everything it reads has been written, and
+ * processors that don't depend on each other run at the same time.
+ *
+ * TEACHING: Shared Intermediates
+ * ------------------------------
+ * Sharpness, exposure and motion scores all want a small grey image, not
+ * 6 MB of RGB. If each made its own, the frame would be read three times.
+ * Declaring LUMA_THUMB as an input instead makes the graph build it once
+ * per frame, before any of them start, and hand all three the same plane.
+ */
+
+#include "core/staged_pipeline.h"
+
+#include <any>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * Products every graph provides
+ */
+namespace products {
+
+constexpr const char* PIXELS = "pixels";            // FrameData: the captured RGB frame
+constexpr const char* LUMA_THUMB = "luma_thumb";    // LumaPlane: built once per frame when read
+constexpr const char* DETECTIONS = "detections";    // DetectionSet: newest results (may be absent)
+
+} // namespace products
+
+/**
+ * Downscaled 8-bit luma
+ */
+struct LumaPlane {
+    std::vector<uint8_t> data;      // width * height, no padding
+    int width = 0;
+    int height = 0;
+    float scale = 1.0f;             // Source pixels per thumbnail pixel
+};
+
+/**
+ * Everything known about one frame while the graph runs
+ *
+ * Each product has one slot, written by its single producer before any
+ * reader is scheduled, so put() and get() need no locking.
+ */
+class FrameContext {
+public:
+    const FrameData& frame() const { return *frame_; }
+
+    /**
+     * Newest detection results when the frame was taken (nullptr if none yet)
+     *
+     * Detections lag the frame by the detector's latency; compare frame_id
+     * with frame().frame_number when that matters.
+     */
+    const DetectionSet* detections() const { return detections_.get(); }
+
+    /**
+     * Publish one of the calling processor's declared outputs
+     */
+    template <typename T>
+    void put(const char* product, T value) {
+        size_t slot = slotOf(product);
+        if (slot < slots_.size()) {
+            slots_[slot] = std::move(value);
+        }
+    }
+
+    /**
+     * Read a product (nullptr if its producer published nothing this frame)
+     */
+    template <typename T>
+    const T* get(const char* product) const {
+        size_t slot = slotOf(product);
+        return slot < slots_.size() ? std::any_cast<T>(&slots_[slot]) : nullptr;
+    }
+
+private:
+    friend class ProcessorGraph;
+
+    // A handful of products: a linear scan beats hashing the name
+    size_t slotOf(const char* product) const {
+        for (size_t i = 0; i < names_.size(); ++i) {
+            if (std::strcmp(names_[i].c_str(), product) == 0) {
+                return i;
+            }
+        }
+        return slots_.size();
+    }
+
+    std::shared_ptr<FrameData> frame_;
+    std::shared_ptr<const DetectionSet> detections_;
+    std::vector<std::string> names_;        // Fixed when the graph starts
+    std::vector<std::any> slots_;
+};
+
+/**
+ * Per-frame analysis step
+ *
+ * process() runs on a pool thread, but never concurrently with itself:
+ * the graph finishes one frame before starting the next, so a processor
+ * may keep state between frames (previous thumbnail, running averages)
+ * without locking.
+ */
+class IFrameProcessor {
+public:
+    virtual ~IFrameProcessor() = default;
+
+    /**
+     * Unique name (string literal: used for trace spans and metric labels)
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * Products read (built-ins from products::, or another processor's outputs)
+     */
+    virtual std::vector<std::string> inputs() const = 0;
+
+    /**
+     * Products written with FrameContext::put()
+     */
+    virtual std::vector<std::string> outputs() const { return {}; }
+
+    virtual void process(FrameContext& context) = 0;
+};
+
+} // namespace robot_vision
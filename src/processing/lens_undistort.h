@@ -0,0 +1,164 @@
+#pragma once
+
+/**
+ * @file lens_undistort.h
+ * @brief Lens undistortion from camera intrinsics through a precomputed remap table
+ *
+ *   capture ──> [undistort] ──┬──> render / record / detect     (apply_to = all)
+ *
+ *   capture ──┬──> render / record
+ *             └──> detect-submit ──> [undistort] ──> detector   (apply_to = detection)
+ *
+ * With gpu_display the displayed video is corrected in the video shader
+ * instead (TextureRenderer), at no CPU cost; apply_to = detection plus
+ * gpu_display keeps the boxes on the display lined up with the image.
+ *
+ * Wide-angle lenses bend straight lines (barrel distortion), stretching
+ * objects near the edges and skewing the boxes drawn around them. The
+ * Brown-Conrady model (radial k1, k2, k3 and tangential p1, p2, the same
+ * coefficients OpenCV's calibrateCamera() produces) says where in the
+ * captured image each pixel of an ideal pinhole image came from.
+ *
+ * TEACHING: Remap Tables
+ * ----------------------
+ * The model costs a few dozen floating-point operations per pixel, but its
+ * answer depends only on the pixel position, never on the image content.
+ * So it is evaluated once per resolution into a table: for each output
+ * pixel, the byte offset of the source pixel to its upper left and the
+ * bilinear weights in 1/256 pixel. Per frame, what remains is a gather of
+ * four neighbours and two lerps - PixelKernels::remap_rgb(), AVX2 gather
+ * where the CPU has it.
+ *
+ * The gather reads source rows along a curve, not in order: near the top
+ * of a 1080p frame one output row touches ~90 source rows. The output is
+ * processed in bands of BAND_HEIGHT rows, so the source region one band
+ * reads (~0.6 MB at worst for 1080p) stays in that core's L2 while it is
+ * being reused. Bands are full width: narrower tiles cut every table and
+ * source row into short runs, and on a 2 MB L2 Xeon 128-pixel tiles were
+ * ~40% slower than bands. Bands are handed out to the calling thread and a
+ * small pool one at a time, so a slow core never holds up a fixed share
+ * of the frame.
+ */
+
+#include "core/staged_pipeline.h"
+#include "metrics/metrics.h"
+#include "pixel/pixel_kernels.h"
+#include "processing/undistort_config.h"
+#include "util/work_stealing_pool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * Brown-Conrady lens at one resolution (intrinsics scaled from calibration)
+ *
+ * The undistorted image is an ideal pinhole camera with the same centre
+ * and focal lengths out_fx/out_fy (fx/fy times zoom).
+ */
+struct LensModel {
+    LensModel(const UndistortConfig& config, int width, int height);
+
+    /**
+     * Where undistorted pixel (u, v) came from in the captured image
+     */
+    void sourceOf(double u, double v, double& src_x, double& src_y) const;
+
+    double fx, fy, cx, cy;              // Captured image, pixels
+    double out_fx, out_fy;              // Undistorted image
+    double k1, k2, k3, p1, p2;
+};
+
+/**
+ * Remap table for one resolution (output and input the same size)
+ */
+struct UndistortMap {
+    int width = 0;
+    int height = 0;
+    std::vector<int32_t> offsets;       // Byte offset of the upper-left source pixel (-1 = outside)
+    std::vector<uint16_t> fracs;        // fx | fy << 8, 1/256 pixel
+    size_t outside = 0;                 // Output pixels with no source (black)
+};
+
+/**
+ * Evaluate the distortion model for every output pixel
+ */
+UndistortMap buildUndistortMap(const UndistortConfig& config, int width, int height);
+
+/**
+ * Undistorting frame filter for the staged pipeline
+ */
+class LensUndistorter : public IFrameFilter {
+public:
+    static constexpr int BAND_HEIGHT = 32;      // Output rows per work item
+
+    /**
+     * @param config Intrinsics and distortion
+     * @param role Thread policy role for the pool (the stage it serves)
+     */
+    LensUndistorter(const UndistortConfig& config, const std::string& role);
+    ~LensUndistorter() override;
+
+    // Non-copyable (owns threads)
+    LensUndistorter(const LensUndistorter&) = delete;
+    LensUndistorter& operator=(const LensUndistorter&) = delete;
+
+    void start();
+
+    /**
+     * Join the pool (idempotent) and log the average cost per frame
+     */
+    void stop();
+
+    /**
+     * Undistort one frame (builds the table on the first frame of each
+     * resolution)
+     */
+    std::shared_ptr<FrameData> apply(const std::shared_ptr<FrameData>& frame) override;
+
+    /**
+     * Undistort packed RGB (width * 3 byte rows) with the table for this
+     * resolution - apply() without the frame bookkeeping, for benchmarks
+     */
+    void remap(const uint8_t* src, uint8_t* dst, int width, int height);
+
+private:
+    /**
+     * One frame's bands, shared by the threads working on it
+     */
+    struct Job {
+        const uint8_t* src = nullptr;
+        uint8_t* dst = nullptr;
+        int bands = 0;
+        std::atomic<int> next{0};
+    };
+
+    void runBands(Job& job);
+    const UndistortMap& mapFor(int width, int height);
+    std::shared_ptr<FrameData> takeOutputFrame();
+
+    UndistortConfig config_;
+    const PixelKernels& kernels_;
+    UndistortMap map_;                  // Stage thread only (rebuilt on resolution change)
+
+    std::unique_ptr<WorkStealingPool> pool_;    // threads - 1 helpers (none if 1)
+    std::atomic<bool> running_{false};
+    std::mutex done_mutex_;
+    std::condition_variable done_cv_;
+    int helpers_running_ = 0;           // Protected by done_mutex_
+
+    // Output frames recycled once every consumer has released them
+    std::vector<std::shared_ptr<FrameData>> frame_pool_;
+
+    Histogram& remap_hist_;
+    uint64_t frames_ = 0;
+    uint64_t total_ns_ = 0;
+};
+
+} // namespace robot_vision
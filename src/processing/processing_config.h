@@ -0,0 +1,28 @@
+#pragma once
+
+/**
+ * @file processing_config.h
+ * @brief Frame processing settings
+ */
+
+#include <string>
+
+namespace robot_vision {
+
+/**
+ * Frame processing configuration
+ */
+struct ProcessingConfig {
+    bool enabled = false;
+    std::string processors = "sharpness,exposure,motion";  // Built-in processors to run
+    int threads = 2;                    // Pool workers
+    int rate_hz = 10;                   // Frames analysed per second (0 = every frame)
+    int thumb_width = 320;              // Luma thumbnail width (height keeps aspect)
+
+    bool isValid() const {
+        return !processors.empty() && threads >= 1 && threads <= 16 &&
+               rate_hz >= 0 && rate_hz <= 120 && thumb_width >= 16 && thumb_width <= 1920;
+    }
+};
+
+} // namespace robot_vision
@@ -0,0 +1,383 @@
+/**
+ * @file processor_graph.cpp
+ * @brief Dependency resolution, per-frame scheduling and the dispatcher thread
+ */
+
+#include "processor_graph.h"
+#include "trace/trace.h"
+#include "util/image_scale.h"
+#include "util/logger.h"
+#include "util/thread_policy.h"
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace robot_vision {
+
+namespace {
+
+// Built-in sources: always present, nothing schedules them
+bool isSource(const std::string& product) {
+    return product == products::PIXELS || product == products::DETECTIONS;
+}
+
+void setThreadName(const char* name) {
+#ifdef PLATFORM_MACOS
+    pthread_setname_np(name);
+#else
+    pthread_setname_np(pthread_self(), name);
+#endif
+}
+
+} // namespace
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+ProcessorGraph::ProcessorGraph(const ProcessingConfig& config)
+    : config_(config)
+    , pool_(config.threads, "rv-proc", "background")
+    , graph_hist_(MetricsRegistry::global().histogram("rv_processor_graph_seconds",
+                                                      "Wall time to run every processor on one frame"))
+    , frames_(MetricsRegistry::global().counter("rv_processor_frames_total",
+                                                "Frames run through the processor graph"))
+    , skipped_(MetricsRegistry::global().counter("rv_processor_frames_skipped_total",
+                                                 "Frames replaced by a newer one before the graph took them"))
+    , steals_(MetricsRegistry::global().counter("rv_processor_steals_total",
+                                                "Processor tasks a pool worker took from another's queue"))
+{
+}
+
+ProcessorGraph::~ProcessorGraph() {
+    stop();
+}
+
+void ProcessorGraph::add(std::shared_ptr<IFrameProcessor> processor) {
+    if (processor) {
+        processors_.push_back(std::move(processor));
+    }
+}
+
+bool ProcessorGraph::start() {
+    if (running_) {
+        return true;
+    }
+    if (!config_.isValid()) {
+        setError("Invalid processing configuration");
+        return false;
+    }
+    if (!resolve()) {
+        return false;
+    }
+
+    pool_.start();
+    running_ = true;
+    dispatch_thread_ = std::thread(&ProcessorGraph::dispatchLoop, this);
+
+    std::string names;
+    for (const auto& node : nodes_) {
+        names += names.empty() ? node->name : std::string(", ") + node->name;
+    }
+    RV_LOG_INFO("processing", "Frame processors on {} threads: {}", pool_.size(), names);
+    return true;
+}
+
+void ProcessorGraph::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(frame_mutex_);
+    }
+    frame_cv_.notify_all();
+    if (dispatch_thread_.joinable()) {
+        dispatch_thread_.join();
+    }
+    pool_.stop();
+    logSummary();
+}
+
+// ============================================================================
+// Dependency Resolution
+// ============================================================================
+
+bool ProcessorGraph::resolve() {
+    nodes_.clear();
+    roots_.clear();
+    context_.names_.clear();
+
+    // Who writes each product (index into nodes_)
+    std::vector<std::string> produced;
+    std::vector<size_t> producer;
+    auto findProducer = [&](const std::string& product) -> size_t {
+        for (size_t i = 0; i < produced.size(); ++i) {
+            if (produced[i] == product) {
+                return producer[i];
+            }
+        }
+        return nodes_.size() + processors_.size() + 1;
+    };
+
+    // The luma thumbnail is a node like any other, present only if someone reads it
+    bool wants_luma = false;
+    for (const auto& processor : processors_) {
+        for (const auto& input : processor->inputs()) {
+            wants_luma = wants_luma || input == products::LUMA_THUMB;
+        }
+    }
+    if (wants_luma) {
+        auto node = std::make_unique<Node>();
+        node->name = products::LUMA_THUMB;
+        nodes_.push_back(std::move(node));
+        produced.push_back(products::LUMA_THUMB);
+        producer.push_back(0);
+    }
+
+    for (const auto& processor : processors_) {
+        auto node = std::make_unique<Node>();
+        node->name = processor->name();
+        node->processor = processor;
+        for (const auto& output : processor->outputs()) {
+            if (isSource(output) || findProducer(output) < nodes_.size()) {
+                setError("Product '" + output + "' of processor '" + processor->name() +
+                         "' already has a producer");
+                return false;
+            }
+            produced.push_back(output);
+            producer.push_back(nodes_.size());
+        }
+        nodes_.push_back(std::move(node));
+    }
+
+    for (auto& node : nodes_) {
+        if (!node->processor) {
+            continue;
+        }
+        for (const auto& input : node->processor->inputs()) {
+            if (isSource(input)) {
+                continue;
+            }
+            size_t dep = findProducer(input);
+            if (dep >= nodes_.size()) {
+                setError(std::string("Processor '") + node->name + "' reads '" + input +
+                         "', which nothing produces");
+                return false;
+            }
+            if (std::find(node->deps.begin(), node->deps.end(), dep) == node->deps.end()) {
+                node->deps.push_back(dep);
+            }
+        }
+    }
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        for (size_t dep : nodes_[i]->deps) {
+            nodes_[dep]->dependents.push_back(i);
+        }
+        if (nodes_[i]->deps.empty()) {
+            roots_.push_back(i);
+        }
+    }
+
+    // Cycle check (Kahn): every node must become ready eventually
+    std::vector<size_t> pending(nodes_.size());
+    std::vector<size_t> ready = roots_;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        pending[i] = nodes_[i]->deps.size();
+    }
+    size_t visited = 0;
+    while (!ready.empty()) {
+        size_t done = ready.back();
+        ready.pop_back();
+        ++visited;
+        for (size_t next : nodes_[done]->dependents) {
+            if (--pending[next] == 0) {
+                ready.push_back(next);
+            }
+        }
+    }
+    if (visited != nodes_.size()) {
+        setError("Frame processors have a dependency cycle");
+        return false;
+    }
+
+    auto& registry = MetricsRegistry::global();
+    for (auto& node : nodes_) {
+        node->timing = &registry.histogram("rv_processor_seconds", "Run time of each frame processor",
+                                           std::string("processor=\"") + node->name + "\"");
+    }
+    context_.names_ = produced;
+    context_.slots_.assign(produced.size(), std::any());
+    return true;
+}
+
+// ============================================================================
+// Record / Ingest Threads
+// ============================================================================
+
+void ProcessorGraph::consumeFrame(const std::shared_ptr<FrameData>& frame) {
+    if (!frame || !running_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (config_.rate_hz > 0) {
+        if (frame->capture_time_ns < next_frame_ns_) {
+            return;
+        }
+        next_frame_ns_ = std::max<uint64_t>(next_frame_ns_ + 1000000000ull / config_.rate_hz,
+                                            frame->capture_time_ns);
+    }
+    {
+        std::lock_guard<std::mutex> lock(frame_mutex_);
+        if (frame_slot_) {
+            skipped_.inc();     // Graph still busy with an earlier frame
+        }
+        frame_slot_ = frame;
+    }
+    frame_cv_.notify_one();
+}
+
+void ProcessorGraph::consumeDetections(const std::shared_ptr<const DetectionSet>& results) {
+    std::lock_guard<std::mutex> lock(detections_mutex_);
+    detections_ = results;
+}
+
+// ============================================================================
+// Scheduling
+// ============================================================================
+
+void ProcessorGraph::dispatchLoop() {
+    setThreadName("rv-proc");
+    ScopedThreadRole thread_role("background");
+
+    while (true) {
+        std::shared_ptr<FrameData> frame;
+        {
+            std::unique_lock<std::mutex> lock(frame_mutex_);
+            frame_cv_.wait(lock, [this] { return frame_slot_ || !running_; });
+            if (!running_) {
+                return;
+            }
+            frame = std::move(frame_slot_);
+        }
+        processFrame(frame);
+    }
+}
+
+void ProcessorGraph::processFrame(const std::shared_ptr<FrameData>& frame) {
+    if (!frame || !frame->isValid() || nodes_.empty()) {
+        return;
+    }
+    TRACE_SCOPE_FRAME("processor_graph", span);
+    span.setFrame(frame->frame_number);
+    const uint64_t start = metricsNowNs();
+
+    context_.frame_ = frame;
+    {
+        std::lock_guard<std::mutex> lock(detections_mutex_);
+        context_.detections_ = detections_;
+    }
+    for (auto& slot : context_.slots_) {
+        slot.reset();
+    }
+
+    // Counters are set before the first task is queued; the pool's queue
+    // hand-off orders these writes before any worker reads them
+    remaining_.store(nodes_.size(), std::memory_order_relaxed);
+    for (auto& node : nodes_) {
+        node->pending.store(node->deps.size(), std::memory_order_relaxed);
+    }
+    for (size_t root : roots_) {
+        pool_.submit([this, root] { runNode(root); });
+    }
+    {
+        std::unique_lock<std::mutex> lock(done_mutex_);
+        done_cv_.wait(lock, [this] { return remaining_.load(std::memory_order_acquire) == 0; });
+    }
+
+    context_.frame_.reset();
+    context_.detections_.reset();
+    graph_hist_.record(metricsNowNs() - start);
+    frames_.inc();
+    steals_.set(pool_.steals());
+}
+
+void ProcessorGraph::runNode(size_t index) {
+    Node& node = *nodes_[index];
+    {
+        TRACE_SCOPE_FRAME(node.name, span);
+        span.setFrame(context_.frame_->frame_number);
+        const uint64_t start = metricsNowNs();
+        if (node.processor) {
+            node.processor->process(context_);
+        } else {
+            buildLumaThumbnail();
+        }
+        const uint64_t ns = metricsNowNs() - start;
+        node.timing->record(ns);
+        node.runs.fetch_add(1, std::memory_order_relaxed);
+        node.total_ns.fetch_add(ns, std::memory_order_relaxed);
+        if (ns > node.max_ns.load(std::memory_order_relaxed)) {
+            node.max_ns.store(ns, std::memory_order_relaxed);   // Only this node's runner writes it
+        }
+    }
+
+    // Release dependents whose last input this was (onto this worker's own queue)
+    for (size_t next : node.dependents) {
+        if (nodes_[next]->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            pool_.submit([this, next] { runNode(next); });
+        }
+    }
+    if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        {
+            std::lock_guard<std::mutex> lock(done_mutex_);
+        }
+        done_cv_.notify_one();
+    }
+}
+
+void ProcessorGraph::buildLumaThumbnail() {
+    const FrameData& frame = *context_.frame_;
+    LumaPlane luma;
+    luma.width = std::min(config_.thumb_width, frame.width);
+    luma.height = std::max(1, static_cast<int>(std::lround(
+        static_cast<double>(frame.height) * luma.width / frame.width)));
+    luma.scale = static_cast<float>(frame.width) / static_cast<float>(luma.width);
+    lumaThumbnail(frame.pixels.data(), frame.width, frame.height, luma.data, luma.width, luma.height);
+    context_.put(products::LUMA_THUMB, std::move(luma));
+}
+
+// ============================================================================
+// Diagnostics
+// ============================================================================
+
+std::vector<ProcessorStats> ProcessorGraph::getStats() const {
+    std::vector<ProcessorStats> stats;
+    for (const auto& node : nodes_) {
+        ProcessorStats s;
+        s.name = node->name;
+        s.runs = node->runs.load(std::memory_order_relaxed);
+        s.total_ns = node->total_ns.load(std::memory_order_relaxed);
+        s.max_ns = node->max_ns.load(std::memory_order_relaxed);
+        stats.push_back(s);
+    }
+    return stats;
+}
+
+void ProcessorGraph::logSummary() const {
+    for (const auto& s : getStats()) {
+        if (s.runs == 0) {
+            continue;
+        }
+        RV_LOG_INFO("processing", "  {}: {} runs, mean {:.2f} ms, max {:.2f} ms", s.name, s.runs,
+                    static_cast<double>(s.total_ns) / static_cast<double>(s.runs) / 1e6,
+                    static_cast<double>(s.max_ns) / 1e6);
+    }
+}
+
+void ProcessorGraph::setError(const std::string& error) {
+    last_error_ = error;
+    RV_LOG_ERROR("processing", "{}", error);
+}
+
+} // namespace robot_vision
@@ -0,0 +1,146 @@
+#pragma once
+
+/**
+ * @file processor_graph.h
+ * @brief Runs frame processors as a dependency graph on a work-stealing pool
+ *
+ *   record stage --frame--> [rv-proc] newest frame --> graph --> [rv-proc-N] pool
+ *   result ingest --detections--> newest results ----^
+ *
+ *   luma_thumb --+--> sharpness
+ *                +--> exposure --> motion
+ *
+ * The record thread only hands over a pointer (rate-limited, newest frame
+ * wins); the dispatcher thread runs the graph for one frame at a time and
+ * waits for it to finish. Within a frame, every processor whose inputs are
+ * ready is queued on the pool, so independent ones run in parallel and a
+ * frame costs the longest chain through the graph, not the sum.
+ *
+ * Per-processor run times are exported as rv_processor_seconds{processor=...}
+ * and summarized in the log at stop().
+ */
+
+#include "core/staged_pipeline.h"
+#include "metrics/metrics.h"
+#include "processing/frame_processor.h"
+#include "processing/processing_config.h"
+#include "util/work_stealing_pool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * Run-time totals for one processor (snapshot)
+ */
+struct ProcessorStats {
+    std::string name;
+    uint64_t runs = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+};
+
+/**
+ * Processor dependency graph (frame and detection sink)
+ */
+class ProcessorGraph : public IFrameSink, public IDetectionSink {
+public:
+    explicit ProcessorGraph(const ProcessingConfig& config);
+    ~ProcessorGraph() override;
+
+    // Non-copyable (owns threads)
+    ProcessorGraph(const ProcessorGraph&) = delete;
+    ProcessorGraph& operator=(const ProcessorGraph&) = delete;
+
+    /**
+     * Add a processor (before start())
+     */
+    void add(std::shared_ptr<IFrameProcessor> processor);
+
+    /**
+     * Resolve dependencies and start the pool and dispatcher thread
+     *
+     * @return false if an input has no producer, a product has two
+     *         producers, or the dependencies form a cycle
+     */
+    bool start();
+
+    /**
+     * Finish the frame in progress and join all threads (idempotent)
+     */
+    void stop();
+
+    // IFrameSink (record thread): rate gate + pointer handoff, never blocks
+    void consumeFrame(const std::shared_ptr<FrameData>& frame) override;
+
+    // IDetectionSink (ingest thread): keeps the newest set
+    void consumeDetections(const std::shared_ptr<const DetectionSet>& results) override;
+
+    /**
+     * Run the graph on one frame and wait for it (after start(); not
+     * concurrently with the dispatcher - for benchmarks and tools)
+     */
+    void processFrame(const std::shared_ptr<FrameData>& frame);
+
+    std::vector<ProcessorStats> getStats() const;
+    const std::string& getLastError() const { return last_error_; }
+
+private:
+    struct Node {
+        const char* name = "";
+        std::shared_ptr<IFrameProcessor> processor;     // nullptr: built-in luma thumbnail
+        std::vector<size_t> deps;
+        std::vector<size_t> dependents;
+        std::atomic<size_t> pending{0};                 // Unfinished deps this frame
+        Histogram* timing = nullptr;
+        std::atomic<uint64_t> runs{0};
+        std::atomic<uint64_t> total_ns{0};
+        std::atomic<uint64_t> max_ns{0};
+    };
+
+    bool resolve();
+    void dispatchLoop();
+    void runNode(size_t index);
+    void buildLumaThumbnail();
+    void logSummary() const;
+    void setError(const std::string& error);
+
+    ProcessingConfig config_;
+    std::vector<std::shared_ptr<IFrameProcessor>> processors_;
+    std::vector<std::unique_ptr<Node>> nodes_;
+    std::vector<size_t> roots_;
+    WorkStealingPool pool_;
+    std::atomic<bool> running_{false};
+    std::string last_error_;
+
+    // Current frame (owned by the dispatcher between frames)
+    FrameContext context_;
+    std::atomic<size_t> remaining_{0};
+    std::mutex done_mutex_;
+    std::condition_variable done_cv_;
+
+    // Record thread -> dispatcher: newest frame only
+    std::mutex frame_mutex_;
+    std::condition_variable frame_cv_;
+    std::shared_ptr<FrameData> frame_slot_;
+    uint64_t next_frame_ns_ = 0;        // Record thread only
+
+    std::mutex detections_mutex_;
+    std::shared_ptr<const DetectionSet> detections_;
+
+    std::thread dispatch_thread_;
+
+    Histogram& graph_hist_;
+    Counter& frames_;
+    Counter& skipped_;
+    Counter& steals_;
+};
+
+} // namespace robot_vision
@@ -0,0 +1,45 @@
+#pragma once
+
+/**
+ * @file undistort_config.h
+ * @brief Lens undistortion settings (camera intrinsics)
+ */
+
+#include <string>
+
+namespace robot_vision {
+
+/**
+ * Lens undistortion configuration
+ *
+ * Intrinsics are in pixels at calib_width x calib_height and are scaled to
+ * the capture resolution, so one calibration serves every capture mode
+ * with the same field of view.
+ */
+struct UndistortConfig {
+    bool enabled = false;
+    std::string apply_to = "all";       // CPU: "all" frames, the "detection" branch, or "none"
+    bool gpu_display = false;           // Correct the displayed video in the shader
+    int calib_width = 0;                // Calibration resolution (0 = capture resolution)
+    int calib_height = 0;
+    float fx = 0.0f;                    // Focal lengths (pixels)
+    float fy = 0.0f;
+    float cx = 0.0f;                    // Principal point (pixels, 0 = image centre)
+    float cy = 0.0f;
+    float k1 = 0.0f;                    // Radial distortion
+    float k2 = 0.0f;
+    float k3 = 0.0f;
+    float p1 = 0.0f;                    // Tangential distortion
+    float p2 = 0.0f;
+    float zoom = 1.0f;                  // Output focal length / fx (< 1 keeps more of the field of view)
+    int threads = 2;                    // Threads per frame, including the stage thread
+
+    bool isValid() const {
+        return (apply_to == "all" || apply_to == "detection" || apply_to == "none") &&
+               calib_width >= 0 && calib_height >= 0 && (calib_width > 0) == (calib_height > 0) &&
+               (!enabled || (fx > 0.0f && fy > 0.0f)) && cx >= 0.0f && cy >= 0.0f &&
+               zoom >= 0.25f && zoom <= 4.0f && threads >= 1 && threads <= 16;
+    }
+};
+
+} // namespace robot_vision
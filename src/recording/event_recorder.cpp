@@ -0,0 +1,459 @@
+/**
+ * @file event_recorder.cpp
+ * @brief GOP ring, trigger handling and MP4 clip writer thread
+ */
+
+#include "event_recorder.h"
+#include "util/logger.h"
+#include "trace/trace.h"
+#include "util/file_util.h"
+#include "util/thread_policy.h"
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace robot_vision {
+
+namespace {
+
+constexpr uint64_t NS_PER_SECOND = 1000000000ull;
+
+/**
+ * Clip buffer destroy notify: releases the encoded frame the buffer wrapped
+ */
+void releaseEncodedFrame(gpointer data) {
+    delete static_cast<std::shared_ptr<const EncodedFrame>*>(data);
+}
+
+/**
+ * One MP4 file being written: appsrc ! h264parse ! mp4mux ! filesink
+ *
+ * Encoded frames are handed to GStreamer without a copy; each buffer
+ * holds a reference to its EncodedFrame (which may still be in the ring).
+ */
+class Mp4Clip {
+public:
+    ~Mp4Clip() {
+        close();
+    }
+
+    bool open(const std::string& path, int width, int height, int fps) {
+        std::string pipeline_str =
+            "appsrc name=src ! h264parse ! mp4mux ! filesink location=\"" + path + "\"";
+
+        GError* error = nullptr;
+        pipeline_ = gst_parse_launch(pipeline_str.c_str(), &error);
+        if (error) {
+            RV_LOG_ERROR("recorder", "Clip pipeline parse error: {}", error->message);
+            g_error_free(error);
+            close();
+            return false;
+        }
+        if (!pipeline_) {
+            return false;
+        }
+
+        appsrc_ = gst_bin_get_by_name(GST_BIN(pipeline_), "src");
+        if (!appsrc_) {
+            close();
+            return false;
+        }
+        gst_object_unref(appsrc_);  // Pipeline owns it
+
+        // block=true: this is the writer's own thread, it may wait for the disk
+        GstCaps* caps = gst_caps_from_string(
+            ("video/x-h264,stream-format=byte-stream,alignment=au,width=" +
+             std::to_string(width) + ",height=" + std::to_string(height) +
+             ",framerate=" + std::to_string(fps) + "/1").c_str());
+        g_object_set(appsrc_,
+            "caps", caps,
+            "format", GST_FORMAT_TIME,
+            "block", TRUE,
+            nullptr);
+        gst_caps_unref(caps);
+
+        if (gst_element_set_state(pipeline_, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+            RV_LOG_ERROR("recorder", "Failed to start clip pipeline");
+            close();
+            return false;
+        }
+        base_ns_ = 0;
+        return true;
+    }
+
+    bool write(const std::shared_ptr<const EncodedFrame>& frame) {
+        if (!appsrc_) {
+            return false;
+        }
+        if (base_ns_ == 0) {
+            base_ns_ = frame->pts_ns;
+        }
+
+        auto* holder = new std::shared_ptr<const EncodedFrame>(frame);
+        GstBuffer* buffer = gst_buffer_new_wrapped_full(
+            GST_MEMORY_FLAG_READONLY, const_cast<uint8_t*>(frame->data.data()),
+            frame->data.size(), 0, frame->data.size(), holder, releaseEncodedFrame);
+
+        // No B-frames, so decode order == presentation order
+        GstClockTime pts = frame->pts_ns >= base_ns_ ? frame->pts_ns - base_ns_ : 0;
+        GST_BUFFER_PTS(buffer) = pts;
+        GST_BUFFER_DTS(buffer) = pts;
+        return gst_app_src_push_buffer(GST_APP_SRC(appsrc_), buffer) == GST_FLOW_OK;
+    }
+
+    /**
+     * Send EOS and wait for the muxer to write the index (moov atom)
+     */
+    bool finish() {
+        if (!appsrc_) {
+            return false;
+        }
+        gst_app_src_end_of_stream(GST_APP_SRC(appsrc_));
+
+        bool ok = false;
+        GstBus* bus = gst_element_get_bus(pipeline_);
+        GstMessage* msg = gst_bus_timed_pop_filtered(
+            bus, 10 * GST_SECOND,
+            static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+        if (msg) {
+            ok = GST_MESSAGE_TYPE(msg) == GST_MESSAGE_EOS;
+            if (!ok) {
+                GError* error = nullptr;
+                gst_message_parse_error(msg, &error, nullptr);
+                RV_LOG_ERROR("recorder", "Clip writer: {}", error ? error->message : "unknown");
+                if (error) {
+                    g_error_free(error);
+                }
+            }
+            gst_message_unref(msg);
+        }
+        gst_object_unref(bus);
+
+        close();
+        return ok;
+    }
+
+    void close() {
+        if (pipeline_) {
+            gst_element_set_state(pipeline_, GST_STATE_NULL);
+            gst_object_unref(pipeline_);
+            pipeline_ = nullptr;
+        }
+        appsrc_ = nullptr;
+    }
+
+private:
+    GstElement* pipeline_ = nullptr;
+    GstElement* appsrc_ = nullptr;
+    uint64_t base_ns_ = 0;
+};
+
+} // namespace
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+EventRecorder::EventRecorder(const EventRecordingConfig& config, IPlatform& platform, int fps)
+    : config_(config)
+    , encoder_(platform)
+    , buffer_bytes_(MetricsRegistry::global().gauge("rv_preroll_buffer_bytes",
+                                                    "Encoded video held in the pre-roll ring"))
+    , buffer_seconds_(MetricsRegistry::global().gauge("rv_preroll_buffer_seconds",
+                                                      "Time span of the pre-roll ring"))
+    , frames_dropped_(MetricsRegistry::global().counter("rv_recorder_frames_dropped_total",
+                                                        "Frames not encoded because the encoder was behind"))
+    , clips_written_(MetricsRegistry::global().counter("rv_event_clips_written_total",
+                                                       "Event clips written"))
+    , clips_failed_(MetricsRegistry::global().counter("rv_event_clips_failed_total",
+                                                      "Event clips that failed to write"))
+{
+    encoder_config_.fps = fps;
+    encoder_config_.bitrate_kbps = config.bitrate_kbps;
+    encoder_config_.keyframe_interval = config.keyframe_interval;
+}
+
+EventRecorder::~EventRecorder() {
+    stop();
+}
+
+bool EventRecorder::start() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (running_) {
+            return true;
+        }
+    }
+
+    if (!makeDirectories(config_.directory)) {
+        RV_LOG_ERROR("recorder", "Cannot create recording directory {}: {}",
+                     config_.directory, std::strerror(errno));
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        running_ = true;
+    }
+    writer_ = std::thread(&EventRecorder::writerLoop, this);
+
+    RV_LOG_INFO("recorder", "Event recording: {}s pre-roll + {}s on '{}' to {}",
+                config_.preroll_s, config_.postroll_s, config_.trigger_label, config_.directory);
+    return true;
+}
+
+void EventRecorder::stop() {
+    if (clip_open_) {
+        endClip();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    queue_cv_.notify_all();
+    if (writer_.joinable()) {
+        writer_.join();     // Drains the queue first
+    }
+    encoder_.stop();
+    ring_.clear();
+    ring_bytes_ = 0;
+}
+
+// ============================================================================
+// Trigger (result thread)
+// ============================================================================
+
+void EventRecorder::consumeDetections(const std::shared_ptr<const DetectionSet>& results) {
+    int matches = 0;
+    for (const auto& det : results->detections) {
+        if (det.confidence >= config_.trigger_confidence &&
+            (config_.trigger_label == "*" || config_.trigger_label == det.label)) {
+            ++matches;
+        }
+    }
+    if (matches >= config_.trigger_count) {
+        trigger_ns_.store(results->received_ns, std::memory_order_release);
+    }
+}
+
+// ============================================================================
+// Encoding and Ring (record thread)
+// ============================================================================
+
+void EventRecorder::consumeFrame(const std::shared_ptr<FrameData>& frame) {
+    if (encoder_failed_) {
+        return;
+    }
+    if (encoder_.isRunning() &&
+        (frame->width != encoder_config_.width || frame->height != encoder_config_.height)) {
+        // Capture size changed (performance governor): GOPs of different
+        // sizes cannot share an MP4, so close the clip and start over
+        RV_LOG_INFO("recorder", "Frame size now {}x{}, restarting encoder", frame->width, frame->height);
+        if (clip_open_) {
+            endClip();
+        }
+        ring_.clear();
+        ring_bytes_ = 0;
+        encoder_.stop();
+    }
+    if (!encoder_.isRunning()) {
+        encoder_config_.width = frame->width;
+        encoder_config_.height = frame->height;
+        if (!encoder_.initialize(encoder_config_)) {
+            RV_LOG_WARN("recorder", "Event recording disabled (encoder failed)");
+            encoder_failed_ = true;
+            return;
+        }
+    }
+
+    encoded_.clear();
+    if (!encoder_.encode(frame, encoded_)) {
+        frames_dropped_.inc();
+    }
+    for (const auto& unit : encoded_) {
+        append(unit);
+    }
+
+    uint64_t trigger = trigger_ns_.exchange(0, std::memory_order_acq_rel);
+    if (trigger != 0) {
+        if (!clip_open_) {
+            beginClip(trigger);
+        } else {
+            clip_end_ns_ = std::max(clip_end_ns_,
+                                    trigger + static_cast<uint64_t>(config_.postroll_s) * NS_PER_SECOND);
+        }
+    }
+
+    if (clip_open_ && !clip_pending_.empty()) {
+        bool done = clip_pending_.back()->pts_ns >= clip_end_ns_;
+        ClipChunk chunk;
+        chunk.clip_id = clip_id_;
+        chunk.path = clip_path_;
+        chunk.width = clip_width_;
+        chunk.height = clip_height_;
+        chunk.fps = clip_fps_;
+        chunk.frames.swap(clip_pending_);
+        pushChunk(std::move(chunk));
+        if (done) {
+            endClip();
+        }
+    }
+}
+
+void EventRecorder::append(const std::shared_ptr<const EncodedFrame>& frame) {
+    if (frame->keyframe) {
+        ring_.emplace_back();
+    } else if (ring_.empty()) {
+        return;     // Undecodable without its keyframe
+    }
+    ring_.back().frames.push_back(frame);
+    ring_.back().bytes += frame->data.size();
+    ring_bytes_ += frame->data.size();
+
+    if (clip_open_) {
+        clip_pending_.push_back(frame);
+    }
+
+    /**
+     * TEACHING: Evicting Whole GOPs
+     * -----------------------------
+     * The oldest GOP can go once the NEXT one alone still reaches back
+     * `preroll_s` - then a clip starting at the new front keyframe still
+     * covers the full pre-roll. Evicting frame by frame would leave a head
+     * of P-frames with no keyframe to decode them from.
+     */
+    uint64_t preroll_ns = static_cast<uint64_t>(config_.preroll_s) * NS_PER_SECOND;
+    while (ring_.size() > 1 &&
+           (ring_bytes_ > config_.max_buffer_bytes ||
+            ring_[1].frames.front()->pts_ns + preroll_ns <= frame->pts_ns)) {
+        ring_bytes_ -= ring_.front().bytes;
+        ring_.pop_front();
+    }
+
+    buffer_bytes_.set(static_cast<double>(ring_bytes_));
+    buffer_seconds_.set(static_cast<double>(frame->pts_ns - ring_.front().frames.front()->pts_ns) /
+                        NS_PER_SECOND);
+}
+
+void EventRecorder::beginClip(uint64_t trigger_ns) {
+    if (ring_.empty()) {
+        return;     // No keyframe yet; the next match will try again
+    }
+
+    clip_open_ = true;
+    clip_id_++;
+    clip_path_ = config_.directory + "/event_" + wallTimestamp() + "_" +
+                 std::to_string(clip_id_) + ".mp4";
+    clip_end_ns_ = trigger_ns + static_cast<uint64_t>(config_.postroll_s) * NS_PER_SECOND;
+    // The writer opens the file later; a resize by then must not change its caps
+    clip_width_ = encoder_config_.width;
+    clip_height_ = encoder_config_.height;
+    clip_fps_ = encoder_config_.fps;
+
+    // Pre-roll: everything in the ring (shared, not copied)
+    clip_pending_.clear();
+    for (const auto& gop : ring_) {
+        clip_pending_.insert(clip_pending_.end(), gop.frames.begin(), gop.frames.end());
+    }
+
+    RV_LOG_INFO("recorder", "Event: recording {} ({} ms pre-roll)", clip_path_,
+                (trigger_ns - std::min(trigger_ns, clip_pending_.front()->pts_ns)) / 1000000);
+}
+
+void EventRecorder::endClip() {
+    ClipChunk chunk;
+    chunk.clip_id = clip_id_;
+    chunk.path = clip_path_;
+    chunk.width = clip_width_;
+    chunk.height = clip_height_;
+    chunk.fps = clip_fps_;
+    chunk.frames.swap(clip_pending_);
+    chunk.last = true;
+    pushChunk(std::move(chunk));
+    clip_open_ = false;
+}
+
+void EventRecorder::pushChunk(ClipChunk chunk) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!running_) {
+            return;
+        }
+        queue_.push_back(std::move(chunk));
+    }
+    queue_cv_.notify_one();
+}
+
+// ============================================================================
+// Clip Writer Thread
+// ============================================================================
+
+void EventRecorder::writerLoop() {
+#ifdef PLATFORM_MACOS
+    pthread_setname_np("rv-clip");
+#else
+    pthread_setname_np(pthread_self(), "rv-clip");
+#endif
+    ScopedThreadRole thread_role("background");
+
+    Mp4Clip clip;
+    uint64_t open_id = 0;
+    bool ok = false;
+    std::string tmp;
+
+    while (true) {
+        ClipChunk chunk;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return !running_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                break;      // Stopped and drained
+            }
+            chunk = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        TRACE_SCOPE("clipWrite");
+        if (chunk.clip_id != open_id) {
+            if (open_id != 0) {
+                clip.close();   // Previous clip never got its last chunk
+                std::remove(tmp.c_str());
+                clips_failed_.inc();
+            }
+            open_id = chunk.clip_id;
+            tmp = chunk.path + ".tmp";
+            ok = clip.open(tmp, chunk.width, chunk.height, chunk.fps);
+        }
+
+        for (const auto& frame : chunk.frames) {
+            ok = ok && clip.write(frame);
+        }
+
+        if (chunk.last) {
+            ok = clip.finish() && ok;
+            if (ok && std::rename(tmp.c_str(), chunk.path.c_str()) == 0) {
+                clips_written_.inc();
+                RV_LOG_INFO("recorder", "Event: saved {}", chunk.path);
+            } else {
+                RV_LOG_WARN("recorder", "Failed writing event clip {}", chunk.path);
+                std::remove(tmp.c_str());
+                clips_failed_.inc();
+            }
+            open_id = 0;
+        }
+    }
+
+    if (open_id != 0) {
+        clip.close();
+        std::remove(tmp.c_str());
+    }
+}
+
+} // namespace robot_vision
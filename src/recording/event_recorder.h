@@ -0,0 +1,140 @@
+#pragma once
+
+/**
+ * @file event_recorder.h
+ * @brief Pre-roll event clips from an in-memory ring of encoded video
+ *
+ * Every captured frame is H.264-encoded on the record stage and kept in a
+ * ring of whole GOPs covering the last `preroll_s` seconds (and at most
+ * `max_buffer_bytes`). When a detection rule fires (label, confidence,
+ * minimum count), the ring's contents plus the next `postroll_s` seconds
+ * are written to an MP4 file by a background thread. Another match while
+ * a clip is open extends it.
+ *
+ * TEACHING: Why Buffer Compressed Video?
+ * --------------------------------------
+ * Five seconds of raw 720p RGB at 30 FPS is 415 MB; the same five seconds
+ * of H.264 at 4 Mbit/s is 2.5 MB. Keeping encoded GOPs makes a pre-roll
+ * buffer affordable on a Jetson, and the steady-state cost is only the
+ * encoder (a hardware block on Jetson/macOS) plus that memory. Writing is
+ * rare and happens on its own thread, so the disk never touches the
+ * capture or render loops.
+ */
+
+#include "core/platform.h"
+#include "core/staged_pipeline.h"
+#include "metrics/metrics.h"
+#include "recording/event_recording_config.h"
+#include "video/h264_encoder.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * Pre-roll buffer and event clip writer
+ */
+class EventRecorder : public IFrameSink, public IDetectionSink {
+public:
+    /**
+     * @param fps Capture frame rate (encoder timing)
+     */
+    EventRecorder(const EventRecordingConfig& config, IPlatform& platform, int fps);
+    ~EventRecorder() override;
+
+    // Non-copyable (owns threads and the encoder)
+    EventRecorder(const EventRecorder&) = delete;
+    EventRecorder& operator=(const EventRecorder&) = delete;
+
+    /**
+     * Create the output directory and start the clip writer thread
+     *
+     * The encoder starts on the first frame, once the frame size is known.
+     */
+    bool start();
+
+    /**
+     * Close an open clip, finish writing and stop the encoder (idempotent)
+     *
+     * Call after the record stage has stopped.
+     */
+    void stop();
+
+    // IFrameSink (record thread): encode, fill the ring, feed an open clip
+    void consumeFrame(const std::shared_ptr<FrameData>& frame) override;
+
+    // IDetectionSink (result thread): evaluates the trigger rule
+    void consumeDetections(const std::shared_ptr<const DetectionSet>& results) override;
+
+private:
+    using FrameList = std::vector<std::shared_ptr<const EncodedFrame>>;
+
+    struct Gop {
+        FrameList frames;           // frames[0] is the keyframe
+        size_t bytes = 0;
+    };
+
+    // Work for the writer thread: frames for one clip, in order
+    struct ClipChunk {
+        uint64_t clip_id = 0;
+        std::string path;
+        int width = 0;              // Stream caps, fixed when the clip began
+        int height = 0;
+        int fps = 0;
+        FrameList frames;
+        bool last = false;          // Finalize the file after these frames
+    };
+
+    // Record thread
+    void append(const std::shared_ptr<const EncodedFrame>& frame);
+    void beginClip(uint64_t trigger_ns);
+    void endClip();
+    void pushChunk(ClipChunk chunk);
+
+    // Writer thread
+    void writerLoop();
+
+    EventRecordingConfig config_;
+    H264Encoder encoder_;
+    H264EncoderConfig encoder_config_;     // Record thread only (size follows the capture)
+    bool encoder_failed_ = false;
+
+    // Latest rule match (steady-clock ns, 0 = none): result thread -> record thread
+    std::atomic<uint64_t> trigger_ns_{0};
+
+    // Record thread only
+    std::deque<Gop> ring_;
+    size_t ring_bytes_ = 0;
+    FrameList encoded_;             // Scratch for encoder output
+    FrameList clip_pending_;        // Frames for the open clip, not yet queued
+    bool clip_open_ = false;
+    uint64_t clip_id_ = 0;
+    std::string clip_path_;
+    int clip_width_ = 0;                // Encoder size and rate at beginClip()
+    int clip_height_ = 0;
+    int clip_fps_ = 0;
+    uint64_t clip_end_ns_ = 0;
+
+    // Writer queue (rare events: a mutex and condvar are fine here)
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::deque<ClipChunk> queue_;
+    bool running_ = false;          // Guarded by queue_mutex_
+    std::thread writer_;
+
+    Gauge& buffer_bytes_;
+    Gauge& buffer_seconds_;
+    Counter& frames_dropped_;
+    Counter& clips_written_;
+    Counter& clips_failed_;
+};
+
+} // namespace robot_vision
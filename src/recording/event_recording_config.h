@@ -0,0 +1,39 @@
+#pragma once
+
+/**
+ * @file event_recording_config.h
+ * @brief Event clip recording settings
+ */
+
+#include <cstddef>
+#include <string>
+
+namespace robot_vision {
+
+/**
+ * Event recording configuration
+ */
+struct EventRecordingConfig {
+    bool enabled = false;                       // Encode continuously, record on events
+    std::string directory = "recordings";       // Output directory (created if missing)
+    int preroll_s = 5;                          // Video kept from before the trigger
+    int postroll_s = 10;                        // Video recorded after the last trigger
+    size_t max_buffer_bytes = 32 * 1024 * 1024; // Hard cap on the pre-roll ring
+    int bitrate_kbps = 4000;                    // Encoder target bitrate
+    int keyframe_interval = 30;                 // Frames per GOP (pre-roll granularity)
+    std::string trigger_label = "person";       // Detection label ("*" = any)
+    float trigger_confidence = 0.5f;            // Minimum confidence to count
+    int trigger_count = 1;                      // Matching detections needed in one result
+
+    bool isValid() const {
+        return !directory.empty() &&
+               preroll_s >= 0 && preroll_s <= 300 &&
+               postroll_s >= 0 && postroll_s <= 3600 &&
+               max_buffer_bytes >= 1024 * 1024 &&
+               bitrate_kbps > 0 && keyframe_interval > 0 &&
+               !trigger_label.empty() && trigger_count >= 1 &&
+               trigger_confidence >= 0.0f && trigger_confidence <= 1.0f;
+    }
+};
+
+} // namespace robot_vision
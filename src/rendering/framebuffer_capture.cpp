@@ -0,0 +1,210 @@
+/**
+ * @file framebuffer_capture.cpp
+ * @brief glReadPixels-based framebuffer capture, synchronous and through PBOs
+ */
+
+#include "framebuffer_capture.h"
+#include "core/opengl.h"
+#include "trace/trace.h"
+#include "util/logger.h"
+
+#ifdef PLATFORM_JETSON
+#include <GLES3/gl3.h>      // Pixel-pack buffers (the context is ES 3.x at runtime)
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace robot_vision {
+
+namespace {
+
+// Images kept for reuse: one being encoded, one queued, one being filled
+constexpr size_t MAX_POOLED_IMAGES = 4;
+
+uint64_t steadyNowNs() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * Pixel-pack buffers: desktop GL 2.1 (macOS) or OpenGL ES 3.0
+ */
+bool hasPixelPackBuffers() {
+#ifdef PLATFORM_MACOS
+    return true;
+#else
+    const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    const char prefix[] = "OpenGL ES ";
+    return version && std::strncmp(version, prefix, sizeof(prefix) - 1) == 0 &&
+           std::atoi(version + sizeof(prefix) - 1) >= 3;
+#endif
+}
+
+} // namespace
+
+// ============================================================================
+// Synchronous Capture
+// ============================================================================
+
+std::shared_ptr<FrameData> captureFramebuffer(int width, int height) {
+    TRACE_SCOPE("captureFramebuffer");
+    if (width <= 0 || height <= 0) {
+        return nullptr;
+    }
+
+    /**
+     * TEACHING: Why Read RGBA?
+     * ------------------------
+     * OpenGL ES 2.0 only guarantees GL_RGBA/GL_UNSIGNED_BYTE for
+     * glReadPixels, and GL's origin is bottom-left. Reading RGBA and
+     * repacking to RGB while flipping rows works on every platform.
+     */
+    std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+
+    auto frame = std::make_shared<FrameData>();
+    frame->width = width;
+    frame->height = height;
+    frame->capture_time_ns = steadyNowNs();
+    frame->pixels.resize(static_cast<size_t>(width) * height * 3);
+
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* src = rgba.data() + static_cast<size_t>(height - 1 - y) * width * 4;
+        uint8_t* dst = frame->pixels.data() + static_cast<size_t>(y) * width * 3;
+        for (int x = 0; x < width; ++x) {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            src += 4;
+            dst += 3;
+        }
+    }
+    return frame;
+}
+
+// ============================================================================
+// Asynchronous Readback
+// ============================================================================
+
+void FramebufferReadback::init() {
+    initialized_ = true;
+    use_pbo_ = hasPixelPackBuffers();
+    if (use_pbo_) {
+        for (auto& slot : slots_) {
+            GLuint buffer = 0;
+            glGenBuffers(1, &buffer);
+            slot.buffer = buffer;
+        }
+        RV_LOG_INFO("render", "Framebuffer readback: asynchronous (pixel-pack buffers)");
+    } else {
+        RV_LOG_WARN("render", "Framebuffer readback: no pixel-pack buffers, reading synchronously");
+    }
+}
+
+void FramebufferReadback::start(int width, int height) {
+    TRACE_SCOPE("readbackStart");
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    if (!initialized_) {
+        init();
+    }
+    const size_t bytes = static_cast<size_t>(width) * height * 4;
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    if (!use_pbo_) {
+        auto image = takeImage();
+        image->width = width;
+        image->height = height;
+        image->capture_time_ns = steadyNowNs();
+        image->rgba.resize(bytes);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, image->rgba.data());
+        ready_ = std::move(image);
+        return;
+    }
+
+    // An uncollected read in this slot is simply replaced
+    Slot& slot = slots_[next_];
+    next_ ^= 1;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    if (slot.capacity != bytes) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_READ);
+        slot.capacity = bytes;
+    }
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);   // Offset 0 in the PBO
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.pending = true;
+    slot.width = width;
+    slot.height = height;
+    slot.capture_time_ns = steadyNowNs();
+}
+
+std::shared_ptr<FramebufferImage> FramebufferReadback::collect() {
+    TRACE_SCOPE("readbackCollect");
+    if (!use_pbo_) {
+        return std::move(ready_);
+    }
+
+    // The last start() used the slot before next_
+    Slot& slot = slots_[next_ ^ 1];
+    if (!slot.pending) {
+        return nullptr;
+    }
+    slot.pending = false;
+
+    const size_t bytes = static_cast<size_t>(slot.width) * slot.height * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+#ifdef PLATFORM_MACOS
+    const void* data = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+#else
+    const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                                        GL_MAP_READ_BIT);
+#endif
+    std::shared_ptr<FramebufferImage> image;
+    if (data) {
+        image = takeImage();
+        image->width = slot.width;
+        image->height = slot.height;
+        image->capture_time_ns = slot.capture_time_ns;
+        image->rgba.resize(bytes);
+        std::memcpy(image->rgba.data(), data, bytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return image;
+}
+
+void FramebufferReadback::release() {
+    for (auto& slot : slots_) {
+        if (slot.buffer != 0) {
+            GLuint buffer = slot.buffer;
+            glDeleteBuffers(1, &buffer);
+        }
+        slot = Slot{};
+    }
+    ready_.reset();
+    initialized_ = false;
+}
+
+std::shared_ptr<FramebufferImage> FramebufferReadback::takeImage() {
+    for (const auto& image : pool_) {
+        if (image.use_count() == 1) {
+            // The consumer's release happens-before our writes
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return image;
+        }
+    }
+    if (pool_.size() < MAX_POOLED_IMAGES) {
+        pool_.push_back(std::make_shared<FramebufferImage>());
+        return pool_.back();
+    }
+    return std::make_shared<FramebufferImage>();  // The consumer is holding every pooled image
+}
+
+} // namespace robot_vision
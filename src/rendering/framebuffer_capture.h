@@ -0,0 +1,105 @@
+#pragma once
+
+/**
+ * @file framebuffer_capture.h
+ * @brief Read the composited framebuffer (video + OSD) back into a frame
+ *
+ * Two ways to read it:
+ * - captureFramebuffer(): synchronous, RGB, top row first - for the odd
+ *   on-demand capture (snapshot key)
+ * - FramebufferReadback: asynchronous through pixel-pack buffers, the
+ *   image exactly as GL returns it - for every-frame consumers (the
+ *   composited stream), which flip and repack on their own thread
+ */
+
+#include "core/video_pipeline.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * Copy the current framebuffer into a new RGB frame (top row first)
+ *
+ * Call on the render thread after the OSD is drawn and before the buffer
+ * swap. glReadPixels stalls until the GPU has finished the frame, so use
+ * it only on demand (e.g. a snapshot key press), never every frame.
+ *
+ * @return Frame, or nullptr if the size is invalid
+ */
+std::shared_ptr<FrameData> captureFramebuffer(int width, int height);
+
+/**
+ * One framebuffer readback as GL returns it
+ */
+struct FramebufferImage {
+    std::vector<uint8_t> rgba;      // RGBA, bottom row first (width * height * 4 bytes)
+    int width = 0;
+    int height = 0;
+    uint64_t capture_time_ns = 0;   // Steady clock when the read was issued
+};
+
+/**
+ * Framebuffer readback that does not wait for the GPU (render thread only)
+ *
+ * TEACHING: Pixel Buffer Objects
+ * ------------------------------
+ * glReadPixels into client memory must return the pixels, so it waits for
+ * the GPU to finish every queued draw. Into a GL_PIXEL_PACK_BUFFER it only
+ * queues a copy and returns. A frame later the copy is long done, and
+ * mapping the buffer costs a memcpy. Two buffers alternate so a new read
+ * never targets the one being collected.
+ *
+ * Call collect() then start() once per frame, after the OSD is drawn and
+ * before the buffer swap. Without PBOs (an OpenGL ES 2.0 context) start()
+ * falls back to a synchronous read; the image is still handed over raw.
+ */
+class FramebufferReadback {
+public:
+    FramebufferReadback() = default;
+
+    // Non-copyable (owns GL buffers)
+    FramebufferReadback(const FramebufferReadback&) = delete;
+    FramebufferReadback& operator=(const FramebufferReadback&) = delete;
+
+    /**
+     * Queue a read of the current framebuffer
+     */
+    void start(int width, int height);
+
+    /**
+     * The image of the last start() in an earlier frame, or nullptr
+     */
+    std::shared_ptr<FramebufferImage> collect();
+
+    /**
+     * Delete the GL buffers (before the context goes away)
+     */
+    void release();
+
+private:
+    struct Slot {
+        unsigned int buffer = 0;    // GLuint
+        size_t capacity = 0;        // Bytes allocated for the buffer
+        bool pending = false;       // Read issued, not yet collected
+        int width = 0;
+        int height = 0;
+        uint64_t capture_time_ns = 0;
+    };
+
+    void init();
+    std::shared_ptr<FramebufferImage> takeImage();
+
+    bool initialized_ = false;
+    bool use_pbo_ = false;
+    Slot slots_[2];
+    int next_ = 0;                  // Slot the next start() reads into
+    std::shared_ptr<FramebufferImage> ready_;   // Synchronous fallback result
+
+    // Images recycled once the consumer has released them
+    std::vector<std::shared_ptr<FramebufferImage>> pool_;
+};
+
+} // namespace robot_vision
@@ -4,12 +4,13 @@
  */
 
 #include "glfw_window.h"
+#include "util/logger.h"
 
 // OpenGL must be included before GLFW on macOS
 #include "core/opengl.h"
 
 #include <GLFW/glfw3.h>
-#include <iostream>
+#include <utility>
 
 namespace robot_vision {
 
@@ -33,12 +34,12 @@ GLFWWindow::~GLFWWindow() {
 
 bool GLFWWindow::initialize(const WindowConfig& config) {
     if (window_) {
-        std::cerr << "  Window already initialized\n";
+        RV_LOG_ERROR("render", "Window already initialized");
         return false;
     }
 
     if (!config.isValid()) {
-        std::cerr << "  Invalid window configuration\n";
+        RV_LOG_ERROR("render", "Invalid window configuration");
         return false;
     }
 
@@ -51,11 +52,11 @@ bool GLFWWindow::initialize(const WindowConfig& config) {
      */
     if (!glfw_initialized_) {
         if (!glfwInit()) {
-            std::cerr << "  Failed to initialize GLFW\n";
+            RV_LOG_ERROR("render", "Failed to initialize GLFW");
             return false;
         }
         glfw_initialized_ = true;
-        std::cout << "  GLFW initialized: " << glfwGetVersionString() << "\n";
+        RV_LOG_INFO("render", "GLFW initialized: {}", glfwGetVersionString());
     }
 
     /**
@@ -77,6 +78,7 @@ bool GLFWWindow::initialize(const WindowConfig& config) {
 #endif
 
     glfwWindowHint(GLFW_RESIZABLE, config.resizable ? GLFW_TRUE : GLFW_FALSE);
+    glfwWindowHint(GLFW_VISIBLE, config.visible ? GLFW_TRUE : GLFW_FALSE);
 
     // Create window
     window_ = glfwCreateWindow(
@@ -88,13 +90,17 @@ bool GLFWWindow::initialize(const WindowConfig& config) {
     );
 
     if (!window_) {
-        std::cerr << "  Failed to create GLFW window\n";
+        RV_LOG_ERROR("render", "Failed to create GLFW window");
         return false;
     }
 
     // Make OpenGL context current
     glfwMakeContextCurrent(window_);
 
+    // Route GLFW callbacks back to this object
+    glfwSetWindowUserPointer(window_, this);
+    glfwSetKeyCallback(window_, &GLFWWindow::onKey);
+
     // Enable/disable VSync
     glfwSwapInterval(config.vsync ? 1 : 0);
 
@@ -104,15 +110,16 @@ bool GLFWWindow::initialize(const WindowConfig& config) {
 
     window_count_++;
 
-    std::cout << "  Window created: " << width_ << "x" << height_;
     if (fb_width_ != width_) {
-        std::cout << " (framebuffer: " << fb_width_ << "x" << fb_height_ << ")";
+        RV_LOG_INFO("render", "Window created: {}x{} (framebuffer: {}x{})",
+                    width_, height_, fb_width_, fb_height_);
+    } else {
+        RV_LOG_INFO("render", "Window created: {}x{}", width_, height_);
     }
-    std::cout << "\n";
 
     // Print OpenGL info
-    std::cout << "  OpenGL: " << glGetString(GL_VERSION) << "\n";
-    std::cout << "  Renderer: " << glGetString(GL_RENDERER) << "\n";
+    RV_LOG_INFO("render", "OpenGL: {}", reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+    RV_LOG_INFO("render", "Renderer: {}", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
 
     return true;
 }
@@ -127,7 +134,7 @@ void GLFWWindow::shutdown() {
         if (window_count_ == 0 && glfw_initialized_) {
             glfwTerminate();
             glfw_initialized_ = false;
-            std::cout << "  GLFW terminated\n";
+            RV_LOG_INFO("render", "GLFW terminated");
         }
     }
 }
@@ -188,6 +195,18 @@ void GLFWWindow::requestClose() {
     }
 }
 
+void GLFWWindow::setKeyCallback(KeyCallback callback) {
+    key_callback_ = std::move(callback);
+}
+
+void GLFWWindow::onKey(GLFWwindow* window, int key, int /*scancode*/, int action, int /*mods*/) {
+    // GLFW key codes for letters and digits are already uppercase ASCII
+    auto* self = static_cast<GLFWWindow*>(glfwGetWindowUserPointer(window));
+    if (self && self->key_callback_ && action == GLFW_PRESS) {
+        self->key_callback_(key);
+    }
+}
+
 // ============================================================================
 // Factory Function
 // ============================================================================
@@ -49,12 +49,17 @@ public:
     void setTitle(const std::string& title) override;
     void requestClose() override;
 
+    void setKeyCallback(KeyCallback callback) override;
+
 private:
+    static void onKey(GLFWwindow* window, int key, int scancode, int action, int mods);
+
     GLFWwindow* window_ = nullptr;
     int width_ = 0;
     int height_ = 0;
     int fb_width_ = 0;   // Framebuffer width (for Retina)
     int fb_height_ = 0;  // Framebuffer height
+    KeyCallback key_callback_;
 
     static bool glfw_initialized_;
     static int window_count_;
@@ -0,0 +1,29 @@
+#pragma once
+
+/**
+ * @file stabilize_config.h
+ * @brief Video stabilisation settings
+ */
+
+namespace robot_vision {
+
+/**
+ * Stabilisation configuration
+ */
+struct StabilizeConfig {
+    bool enabled = false;
+    float smoothing_ms = 400.0f;        // Time constant of the smoothed camera path
+    float max_angle_deg = 10.0f;        // Largest correction per axis (bigger moves are followed)
+    float crop = 0.85f;                 // Fraction of the frame shown (room for the correction)
+    float hfov_deg = 120.0f;            // Horizontal field of view without lens intrinsics
+    float camera_tilt_deg = 0.0f;       // Camera uptilt relative to the airframe (FPV)
+
+    bool isValid() const {
+        return smoothing_ms >= 10.0f && smoothing_ms <= 10000.0f &&
+               max_angle_deg > 0.0f && max_angle_deg <= 45.0f &&
+               crop >= 0.5f && crop <= 1.0f && hfov_deg >= 20.0f && hfov_deg <= 170.0f &&
+               camera_tilt_deg >= -90.0f && camera_tilt_deg <= 90.0f;
+    }
+};
+
+} // namespace robot_vision
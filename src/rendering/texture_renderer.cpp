@@ -4,13 +4,69 @@
  */
 
 #include "texture_renderer.h"
+#include "util/logger.h"
 #include "core/opengl.h"
+#include "trace/trace.h"
 
-#include <iostream>
 #include <algorithm>
+#include <cmath>
 
 namespace robot_vision {
 
+namespace {
+
+const char* VIDEO_VERTEX_SHADER = R"(
+#version 120
+void main() {
+    gl_TexCoord[0] = gl_MultiTexCoord0;
+    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+}
+)";
+
+// Displayed texcoord -> (homography) -> undistorted texcoord -> (map) ->
+// video texcoord. Map entries hold the video texcoord as (t + 0.5) / 2 so
+// sources a little outside the frame still encode; they then turn black.
+const char* VIDEO_FRAGMENT_SHADER = R"(
+#version 120
+uniform sampler2D u_video;
+uniform sampler2D u_map;
+uniform mat3 u_homography;
+uniform bool u_use_map;
+uniform vec2 u_map_scale;
+uniform vec2 u_map_offset;
+
+bool outside(vec2 uv) {
+    return any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0)));
+}
+
+void main() {
+    vec3 p = u_homography * vec3(gl_TexCoord[0].st, 1.0);
+    vec2 uv = p.xy / p.z;
+    if (u_use_map && !outside(uv)) {
+        uv = texture2D(u_map, uv * u_map_scale + u_map_offset).rg * 2.0 - 0.5;
+    }
+    gl_FragColor = outside(uv) ? vec4(0.0, 0.0, 0.0, 1.0) : vec4(texture2D(u_video, uv).rgb, 1.0);
+}
+)";
+
+unsigned int compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (ok != GL_TRUE) {
+        char log[1024] = {};
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        RV_LOG_ERROR("render", "Video shader compile failed: {}", log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+} // namespace
+
 TextureRenderer::TextureRenderer() = default;
 
 TextureRenderer::~TextureRenderer() {
@@ -60,7 +116,7 @@ bool TextureRenderer::initialize(int width, int height) {
     texture_height_ = height;
     initialized_ = true;
 
-    std::cout << "  Texture renderer initialized: " << width << "x" << height << "\n";
+    RV_LOG_INFO("render", "Texture renderer initialized: {}x{}", width, height);
     return true;
 }
 
@@ -68,6 +124,7 @@ void TextureRenderer::updateTexture(const std::vector<uint8_t>& pixels, int widt
     if (!initialized_ || pixels.empty()) {
         return;
     }
+    TRACE_SCOPE("updateTexture");
 
     glBindTexture(GL_TEXTURE_2D, texture_id_);
 
@@ -105,6 +162,7 @@ void TextureRenderer::updateTexture(const std::vector<uint8_t>& pixels, int widt
         );
         texture_width_ = width;
         texture_height_ = height;
+        map_width_ = 0;     // Distortion map is per resolution
     }
 }
 
@@ -112,6 +170,7 @@ void TextureRenderer::render(int viewport_width, int viewport_height) {
     if (!initialized_) {
         return;
     }
+    TRACE_SCOPE("renderTexture");
 
     /**
      * TEACHING: Aspect Ratio Preservation
@@ -139,6 +198,12 @@ void TextureRenderer::render(int viewport_width, int viewport_height) {
         x_offset = (viewport_width - render_width) / 2.0f;
     }
 
+    if (lens_enabled_ && map_width_ == 0) {
+        buildDistortionMap();
+    }
+    const bool use_map = lens_enabled_ && map_width_ > 0;
+    const bool use_shader = (use_map || stabilize_) && ensureProgram();
+
     // Setup OpenGL state
     glViewport(0, 0, viewport_width, viewport_height);
 
@@ -154,9 +219,50 @@ void TextureRenderer::render(int viewport_width, int viewport_height) {
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
 
-    // Enable texturing
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, texture_id_);
+    if (use_shader) {
+        /**
+         * TEACHING: Pixel vs Texture Coordinates
+         * --------------------------------------
+         * The homography works in pixels (pixel centres at integers);
+         * the shader sees texcoords (0..1, pixel centres at (i + 0.5) / w).
+         * With N = texcoord -> pixel, the shader needs N^-1 H N.
+         */
+        const float w = static_cast<float>(texture_width_);
+        const float h = static_cast<float>(texture_height_);
+        float hn[9];
+        for (int r = 0; r < 3; ++r) {
+            // Right-multiply by N: columns scale by (w, h), the third picks up -0.5 of each
+            const float* row = &homography_[r * 3];
+            hn[r * 3 + 0] = row[0] * w;
+            hn[r * 3 + 1] = row[1] * h;
+            hn[r * 3 + 2] = row[2] - 0.5f * (row[0] + row[1]);
+        }
+        for (int c = 0; c < 3; ++c) {
+            // Left-multiply by N^-1: x' = (x + 0.5 z) / w, y' = (y + 0.5 z) / h
+            hn[0 * 3 + c] = (hn[0 * 3 + c] + 0.5f * hn[2 * 3 + c]) / w;
+            hn[1 * 3 + c] = (hn[1 * 3 + c] + 0.5f * hn[2 * 3 + c]) / h;
+        }
+
+        glUseProgram(program_);
+        glUniformMatrix3fv(u_homography_, 1, GL_TRUE, hn);
+        glUniform1i(u_use_map_, use_map ? 1 : 0);
+        glUniform1i(u_video_, 0);
+        glUniform1i(u_map_, 1);
+        if (use_map) {
+            // Undistorted texcoord -> map texcoord (entry i is pixel i * MAP_STEP)
+            glUniform2f(u_map_scale_, w / (MAP_STEP * map_width_), h / (MAP_STEP * map_height_));
+            glUniform2f(u_map_offset_, (0.5f - 0.5f / MAP_STEP) / map_width_,
+                        (0.5f - 0.5f / MAP_STEP) / map_height_);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, map_texture_id_);
+            glActiveTexture(GL_TEXTURE0);
+        }
+        glBindTexture(GL_TEXTURE_2D, texture_id_);
+    } else {
+        // Enable texturing
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, texture_id_);
+    }
 
     /**
      * TEACHING: Textured Quad Rendering
@@ -190,10 +296,134 @@ void TextureRenderer::render(int viewport_width, int viewport_height) {
 
     glEnd();
 
-    glDisable(GL_TEXTURE_2D);
+    if (use_shader) {
+        glUseProgram(0);
+    } else {
+        glDisable(GL_TEXTURE_2D);
+    }
+}
+
+// ============================================================================
+// Lens Correction and Stabilisation
+// ============================================================================
+
+void TextureRenderer::setLensCorrection(const UndistortConfig& lens) {
+    lens_ = lens;
+    lens_enabled_ = true;
+    map_width_ = 0;     // Rebuilt on the next render
+}
+
+void TextureRenderer::setStabilization(const float* homography) {
+    stabilize_ = homography != nullptr;
+    if (stabilize_) {
+        std::copy(homography, homography + 9, homography_);
+    } else {
+        const float identity[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+        std::copy(identity, identity + 9, homography_);
+    }
+}
+
+bool TextureRenderer::ensureProgram() {
+    if (program_ != 0) {
+        return true;
+    }
+    if (program_failed_) {
+        return false;
+    }
+
+    vertex_shader_ = compileShader(GL_VERTEX_SHADER, VIDEO_VERTEX_SHADER);
+    fragment_shader_ = compileShader(GL_FRAGMENT_SHADER, VIDEO_FRAGMENT_SHADER);
+    if (vertex_shader_ != 0 && fragment_shader_ != 0) {
+        program_ = glCreateProgram();
+        glAttachShader(program_, vertex_shader_);
+        glAttachShader(program_, fragment_shader_);
+        glLinkProgram(program_);
+        GLint ok = GL_FALSE;
+        glGetProgramiv(program_, GL_LINK_STATUS, &ok);
+        if (ok != GL_TRUE) {
+            char log[1024] = {};
+            glGetProgramInfoLog(program_, sizeof(log), nullptr, log);
+            RV_LOG_ERROR("render", "Video shader link failed: {}", log);
+            glDeleteProgram(program_);
+            program_ = 0;
+        }
+    }
+    if (program_ == 0) {
+        program_failed_ = true;
+        RV_LOG_ERROR("render", "Lens correction and stabilisation disabled (no video shader)");
+        return false;
+    }
+
+    u_video_ = glGetUniformLocation(program_, "u_video");
+    u_map_ = glGetUniformLocation(program_, "u_map");
+    u_homography_ = glGetUniformLocation(program_, "u_homography");
+    u_use_map_ = glGetUniformLocation(program_, "u_use_map");
+    u_map_scale_ = glGetUniformLocation(program_, "u_map_scale");
+    u_map_offset_ = glGetUniformLocation(program_, "u_map_offset");
+    RV_LOG_INFO("render", "Video shader ready (lens correction {}, stabilisation {})",
+                lens_enabled_ ? "on" : "off", stabilize_ ? "on" : "off");
+    return true;
+}
+
+void TextureRenderer::buildDistortionMap() {
+    const int w = texture_width_;
+    const int h = texture_height_;
+    if (w < 2 || h < 2) {
+        return;
+    }
+    const int mw = (w - 1 + MAP_STEP - 1) / MAP_STEP + 1;
+    const int mh = (h - 1 + MAP_STEP - 1) / MAP_STEP + 1;
+
+    // RGBA16: the source texcoord in R and G at 1/65535 of the [-0.5, 1.5]
+    // range, ~0.06 pixel at 1080p
+    const LensModel lens(lens_, w, h);
+    std::vector<uint16_t> entries(static_cast<size_t>(mw) * mh * 4, 0);
+    size_t i = 0;
+    for (int my = 0; my < mh; ++my) {
+        for (int mx = 0; mx < mw; ++mx, i += 4) {
+            double src_x = 0.0;
+            double src_y = 0.0;
+            lens.sourceOf(mx * MAP_STEP, my * MAP_STEP, src_x, src_y);
+            const double tx = ((src_x + 0.5) / w + 0.5) * 0.5;
+            const double ty = ((src_y + 0.5) / h + 0.5) * 0.5;
+            entries[i + 0] = static_cast<uint16_t>(std::lround(std::clamp(tx, 0.0, 1.0) * 65535.0));
+            entries[i + 1] = static_cast<uint16_t>(std::lround(std::clamp(ty, 0.0, 1.0) * 65535.0));
+        }
+    }
+
+    if (map_texture_id_ == 0) {
+        glGenTextures(1, &map_texture_id_);
+    }
+    glBindTexture(GL_TEXTURE_2D, map_texture_id_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16, mw, mh, 0, GL_RGBA, GL_UNSIGNED_SHORT, entries.data());
+
+    map_width_ = mw;
+    map_height_ = mh;
+    RV_LOG_INFO("render", "Distortion map for {}x{}: {}x{} entries", w, h, mw, mh);
 }
 
 void TextureRenderer::shutdown() {
+    if (program_ != 0) {
+        glDeleteProgram(program_);
+        program_ = 0;
+    }
+    if (vertex_shader_ != 0) {
+        glDeleteShader(vertex_shader_);
+        vertex_shader_ = 0;
+    }
+    if (fragment_shader_ != 0) {
+        glDeleteShader(fragment_shader_);
+        fragment_shader_ = 0;
+    }
+    if (map_texture_id_ != 0) {
+        glDeleteTextures(1, &map_texture_id_);
+        map_texture_id_ = 0;
+        map_width_ = 0;
+    }
     if (texture_id_ != 0) {
         glDeleteTextures(1, &texture_id_);
         texture_id_ = 0;
@@ -5,9 +5,12 @@
  * @brief OpenGL texture renderer for video frames
  *
  * Renders video frames as full-screen textured quads.
- * Uses OpenGL 2.1 fixed-function pipeline for simplicity.
+ * Uses OpenGL 2.1 fixed-function pipeline for simplicity; lens correction
+ * and stabilisation switch the same quad to a small GLSL 1.20 program.
  */
 
+#include "processing/lens_undistort.h"
+
 #include <cstdint>
 #include <vector>
 
@@ -26,6 +29,21 @@ namespace robot_vision {
  *
  * Modern OpenGL (3.3+) requires shaders for everything,
  * but NanoVG handles that complexity for us in Phase 3.
+ *
+ * TEACHING: Warping in the Fragment Shader
+ * ----------------------------------------
+ * Undistorting or stabilising on the CPU touches every pixel every
+ * frame. The GPU already samples the video texture once per screen pixel
+ * to draw the quad; changing *where* it samples costs nothing extra:
+ *
+ *   screen texcoord --homography--> undistorted texcoord
+ *                   --distortion map (texture lookup)--> video texcoord
+ *
+ * The distortion map is a small texture (one entry per 8x8 pixels)
+ * evaluated once from the lens intrinsics; bilinear filtering between
+ * entries is far below a pixel of error for a smooth lens model. The
+ * homography is 9 uniforms updated per frame. Without either, rendering
+ * stays on the fixed-function path.
  */
 class TextureRenderer {
 public:
@@ -69,16 +87,57 @@ public:
      */
     void render(int viewport_width, int viewport_height);
 
+    /**
+     * Undistort the displayed video in the shader (map built on the next
+     * render, and again whenever the frame size changes)
+     */
+    void setLensCorrection(const UndistortConfig& lens);
+
+    /**
+     * Stabilising homography for the next frames
+     *
+     * @param homography Row-major 3x3 from displayed pixel to video pixel
+     *                   (undistorted pixels with lens correction), or
+     *                   nullptr for none
+     */
+    void setStabilization(const float* homography);
+
     /**
      * Cleanup OpenGL resources
      */
     void shutdown();
 
 private:
+    static constexpr int MAP_STEP = 8;  // Video pixels per distortion map entry
+
+    bool ensureProgram();
+    void buildDistortionMap();
+
     unsigned int texture_id_ = 0;  // OpenGL texture ID
     int texture_width_ = 0;
     int texture_height_ = 0;
     bool initialized_ = false;
+
+    // Shader path (created on first use; fixed function if it fails)
+    unsigned int program_ = 0;
+    unsigned int vertex_shader_ = 0;
+    unsigned int fragment_shader_ = 0;
+    bool program_failed_ = false;
+    int u_video_ = -1;
+    int u_map_ = -1;
+    int u_homography_ = -1;
+    int u_use_map_ = -1;
+    int u_map_scale_ = -1;
+    int u_map_offset_ = -1;
+
+    bool lens_enabled_ = false;
+    UndistortConfig lens_;
+    unsigned int map_texture_id_ = 0;
+    int map_width_ = 0;                 // Entries; 0 = not built for this frame size
+    int map_height_ = 0;
+
+    bool stabilize_ = false;
+    float homography_[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
 };
 
 } // namespace robot_vision
@@ -0,0 +1,170 @@
+/**
+ * @file video_stabilizer.cpp
+ * @brief Attitude smoothing and the re-projection homography
+ */
+
+#include "video_stabilizer.h"
+#include "processing/lens_undistort.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace robot_vision {
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double DEG = PI / 180.0;
+
+struct Mat3 {
+    double m[3][3];
+
+    Mat3 operator*(const Mat3& o) const {
+        Mat3 r{};
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                r.m[i][j] = m[i][0] * o.m[0][j] + m[i][1] * o.m[1][j] + m[i][2] * o.m[2][j];
+            }
+        }
+        return r;
+    }
+
+    Mat3 transposed() const {
+        Mat3 r{};
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                r.m[i][j] = m[j][i];
+            }
+        }
+        return r;
+    }
+};
+
+Mat3 rotX(double a) {
+    const double c = std::cos(a), s = std::sin(a);
+    return {{{1, 0, 0}, {0, c, -s}, {0, s, c}}};
+}
+
+Mat3 rotY(double a) {
+    const double c = std::cos(a), s = std::sin(a);
+    return {{{c, 0, s}, {0, 1, 0}, {-s, 0, c}}};
+}
+
+Mat3 rotZ(double a) {
+    const double c = std::cos(a), s = std::sin(a);
+    return {{{c, -s, 0}, {s, c, 0}, {0, 0, 1}}};
+}
+
+// Body (x forward, y right, z down) -> world (north, east, down)
+Mat3 bodyToWorld(const float attitude[3]) {
+    return rotZ(attitude[2]) * rotY(attitude[1]) * rotX(attitude[0]);
+}
+
+double wrapPi(double a) {
+    return std::remainder(a, 2.0 * PI);
+}
+
+} // namespace
+
+// ============================================================================
+// VideoStabilizer
+// ============================================================================
+
+VideoStabilizer::VideoStabilizer(const StabilizeConfig& config, const UndistortConfig* lens)
+    : config_(config)
+    , have_lens_(lens != nullptr)
+    , lens_(lens ? *lens : UndistortConfig{})
+    , correction_(MetricsRegistry::global().gauge("rv_stabilization_correction_degrees",
+                                                  "Largest per-axis rotation the stabiliser removes"))
+{
+}
+
+void VideoStabilizer::reset() {
+    have_state_ = false;
+    correction_.set(0.0);
+}
+
+void VideoStabilizer::update(uint64_t time_ns, float roll, float pitch, float yaw) {
+    const float input[3] = {roll, pitch, yaw};
+    if (!have_state_) {
+        std::copy(input, input + 3, actual_);
+        std::copy(input, input + 3, smooth_);
+        last_ns_ = time_ns;
+        have_state_ = true;
+        return;
+    }
+
+    /**
+     * TEACHING: Frame-Rate Independent Smoothing
+     * ------------------------------------------
+     * An exponential filter with a fixed weight per update smooths more
+     * at 60 fps than at 30. Deriving the weight from the elapsed time,
+     * alpha = 1 - exp(-dt / tau), gives the same time constant at any
+     * frame rate (and after dropped frames).
+     */
+    const double dt_ms = time_ns > last_ns_ ? static_cast<double>(time_ns - last_ns_) / 1e6 : 0.0;
+    last_ns_ = time_ns;
+    const double alpha = 1.0 - std::exp(-std::min(dt_ms, 500.0) / config_.smoothing_ms);
+    const double max_angle = config_.max_angle_deg * DEG;
+
+    double largest = 0.0;
+    for (int axis = 0; axis < 3; ++axis) {
+        double smooth = smooth_[axis] + alpha * wrapPi(input[axis] - smooth_[axis]);
+        // Past max_angle the smoothed path is dragged along: a deliberate
+        // turn is followed instead of running out of crop margin
+        const double error = wrapPi(input[axis] - smooth);
+        if (std::fabs(error) > max_angle) {
+            smooth = input[axis] - std::copysign(max_angle, error);
+        }
+        smooth_[axis] = static_cast<float>(wrapPi(smooth));
+        actual_[axis] = input[axis];
+        largest = std::max(largest, std::fabs(wrapPi(input[axis] - smooth)));
+    }
+    correction_.set(largest / DEG);
+}
+
+bool VideoStabilizer::homography(int width, int height, float out[9]) const {
+    if (!have_state_ || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    // Pinhole intrinsics of the image the homography acts on
+    double fx, fy, cx, cy;
+    if (have_lens_) {
+        const LensModel lens(lens_, width, height);
+        fx = lens.out_fx;
+        fy = lens.out_fy;
+        cx = lens.cx;
+        cy = lens.cy;
+    } else {
+        fx = fy = 0.5 * width / std::tan(0.5 * config_.hfov_deg * DEG);
+        cx = (width - 1) * 0.5;
+        cy = (height - 1) * 0.5;
+    }
+    const Mat3 k = {{{fx, 0, cx}, {0, fy, cy}, {0, 0, 1}}};
+    const Mat3 k_inv = {{{1 / fx, 0, -cx / fx}, {0, 1 / fy, -cy / fy}, {0, 0, 1}}};
+
+    // Body -> camera (x right, y down, z along the lens), through the uptilt
+    const Mat3 axes = {{{0, 1, 0}, {0, 0, 1}, {1, 0, 0}}};
+    const Mat3 body_to_cam = axes * rotY(config_.camera_tilt_deg * DEG).transposed();
+
+    // Ray in the smoothed camera -> same ray in the actual camera
+    const Mat3 relative = bodyToWorld(actual_).transposed() * bodyToWorld(smooth_);
+    const Mat3 rotation = body_to_cam * relative * body_to_cam.transposed();
+
+    // Zoom in about the image centre so the correction stays inside the frame
+    const double crop = config_.crop;
+    const double mx = (width - 1) * 0.5;
+    const double my = (height - 1) * 0.5;
+    const Mat3 zoom = {{{crop, 0, mx * (1 - crop)}, {0, crop, my * (1 - crop)}, {0, 0, 1}}};
+
+    const Mat3 h = k * rotation * k_inv * zoom;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            out[i * 3 + j] = static_cast<float>(h.m[i][j]);
+        }
+    }
+    return true;
+}
+
+} // namespace robot_vision
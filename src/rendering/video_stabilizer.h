@@ -0,0 +1,81 @@
+#pragma once
+
+/**
+ * @file video_stabilizer.h
+ * @brief Stabilising homography for the displayed video from vehicle attitude
+ *
+ *   telemetry attitude at the frame's capture time
+ *        |                 low-pass ("where the pilot is pointing")
+ *        v                      |
+ *   R_actual  ----------->  R_smooth
+ *        \                    /
+ *         H = K P R_actual^T R_smooth P^T K^-1 C   -->  TextureRenderer
+ *
+ * TEACHING: Rotation-Only Stabilisation
+ * -------------------------------------
+ * Shake on a drone is almost all rotation, and a pure camera rotation
+ * moves every pixel by the same homography K R K^-1, whatever the scene
+ * depth - no image analysis needed, only the attitude the autopilot
+ * already measures at up to 100 Hz. The stabiliser keeps a smoothed
+ * attitude (the camera path the viewer should see), and each frame is
+ * re-projected from where the camera actually pointed to where the
+ * smoothed path says it should have. C zooms in slightly (crop) so the
+ * shifted image still fills the screen.
+ *
+ * The homography is exact only for a pinhole image; with a distorted lens
+ * turn on lens correction (undistort.*) so the renderer applies it in
+ * undistorted space.
+ */
+
+#include "metrics/metrics.h"
+#include "processing/undistort_config.h"
+#include "rendering/stabilize_config.h"
+
+#include <cstdint>
+
+namespace robot_vision {
+
+/**
+ * Attitude-driven stabiliser (render thread only)
+ */
+class VideoStabilizer {
+public:
+    /**
+     * @param config Smoothing and crop
+     * @param lens Intrinsics of the displayed (undistorted) image, or
+     *             nullptr to derive them from hfov_deg
+     */
+    VideoStabilizer(const StabilizeConfig& config, const UndistortConfig* lens);
+
+    /**
+     * Feed the attitude at a frame's capture time (radians, aerospace
+     * convention: roll right, pitch up, yaw clockwise from north)
+     */
+    void update(uint64_t time_ns, float roll, float pitch, float yaw);
+
+    /**
+     * Forget the smoothed path (attitude lost); the next update starts over
+     */
+    void reset();
+
+    /**
+     * Output pixel -> video pixel for a width x height frame (row-major 3x3)
+     *
+     * @return false before the first update (no correction to apply)
+     */
+    bool homography(int width, int height, float out[9]) const;
+
+private:
+    StabilizeConfig config_;
+    bool have_lens_ = false;
+    UndistortConfig lens_;
+
+    bool have_state_ = false;
+    uint64_t last_ns_ = 0;
+    float actual_[3] = {0.0f, 0.0f, 0.0f};      // roll, pitch, yaw
+    float smooth_[3] = {0.0f, 0.0f, 0.0f};
+
+    Gauge& correction_;
+};
+
+} // namespace robot_vision
@@ -0,0 +1,194 @@
+/**
+ * @file image_encoder.cpp
+ * @brief JPEG / PNG / PPM encoding of RGB frames
+ */
+
+#include "image_encoder.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef HAS_JPEG
+#include <jpeglib.h>
+#include <csetjmp>
+#endif
+
+#ifdef HAS_PNG
+#include <png.h>
+#endif
+
+namespace robot_vision {
+
+namespace {
+
+bool encodePpm(const FrameData& frame, std::vector<uint8_t>& out) {
+    char header[64];
+    int n = std::snprintf(header, sizeof(header), "P6\n%d %d\n255\n", frame.width, frame.height);
+    out.assign(header, header + n);
+    out.insert(out.end(), frame.pixels.begin(), frame.pixels.end());
+    return true;
+}
+
+#ifdef HAS_JPEG
+/**
+ * TEACHING: libjpeg Error Handling
+ * --------------------------------
+ * libjpeg's default error handler calls exit(). We install one that
+ * longjmp()s back into encodeJpeg instead, so a bad frame costs one
+ * snapshot, not the whole process.
+ */
+struct JpegErrorManager {
+    jpeg_error_mgr base;
+    std::jmp_buf jump;
+    char message[JMSG_LENGTH_MAX];
+};
+
+void jpegErrorExit(j_common_ptr cinfo) {
+    auto* err = reinterpret_cast<JpegErrorManager*>(cinfo->err);
+    (*cinfo->err->format_message)(cinfo, err->message);
+    std::longjmp(err->jump, 1);
+}
+
+bool encodeJpeg(const FrameData& frame, int quality, std::vector<uint8_t>& out, std::string& error) {
+    jpeg_compress_struct cinfo;
+    JpegErrorManager jerr;
+    unsigned char* buffer = nullptr;
+    unsigned long size = 0;
+
+    cinfo.err = jpeg_std_error(&jerr.base);
+    jerr.base.error_exit = jpegErrorExit;
+    if (setjmp(jerr.jump)) {
+        error = std::string("JPEG encode failed: ") + jerr.message;
+        jpeg_destroy_compress(&cinfo);
+        std::free(buffer);
+        return false;
+    }
+
+    jpeg_create_compress(&cinfo);
+    jpeg_mem_dest(&cinfo, &buffer, &size);
+
+    cinfo.image_width = static_cast<JDIMENSION>(frame.width);
+    cinfo.image_height = static_cast<JDIMENSION>(frame.height);
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, quality, TRUE);
+    cinfo.dct_method = JDCT_IFAST;      // libjpeg-turbo's SIMD path; quality loss is negligible
+
+    jpeg_start_compress(&cinfo, TRUE);
+    const size_t stride = static_cast<size_t>(frame.width) * 3;
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = const_cast<JSAMPROW>(frame.pixels.data() + cinfo.next_scanline * stride);
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+
+    out.assign(buffer, buffer + size);
+    jpeg_destroy_compress(&cinfo);
+    std::free(buffer);
+    return true;
+}
+#endif
+
+#ifdef HAS_PNG
+void pngWriteToVector(png_structp png, png_bytep data, png_size_t length) {
+    auto* out = static_cast<std::vector<uint8_t>*>(png_get_io_ptr(png));
+    out->insert(out->end(), data, data + length);
+}
+
+void pngFlush(png_structp) {
+}
+
+bool encodePng(const FrameData& frame, std::vector<uint8_t>& out, std::string& error) {
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info = png ? png_create_info_struct(png) : nullptr;
+    if (!png || !info) {
+        png_destroy_write_struct(&png, nullptr);
+        error = "PNG encoder initialization failed";
+        return false;
+    }
+    if (setjmp(png_jmpbuf(png))) {
+        png_destroy_write_struct(&png, &info);
+        error = "PNG encode failed";
+        return false;
+    }
+
+    out.clear();
+    png_set_write_fn(png, &out, pngWriteToVector, pngFlush);
+    png_set_IHDR(png, info, static_cast<png_uint_32>(frame.width), static_cast<png_uint_32>(frame.height),
+                 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE,
+                 PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_set_compression_level(png, 3);      // Snapshots favour speed over size
+    png_write_info(png, info);
+
+    const size_t stride = static_cast<size_t>(frame.width) * 3;
+    for (int y = 0; y < frame.height; ++y) {
+        png_write_row(png, const_cast<png_bytep>(frame.pixels.data() + y * stride));
+    }
+    png_write_end(png, nullptr);
+    png_destroy_write_struct(&png, &info);
+    return true;
+}
+#endif
+
+} // namespace
+
+bool parseImageFormat(const std::string& name, ImageFormat& format) {
+    if (name == "jpeg" || name == "jpg") {
+        format = ImageFormat::JPEG;
+    } else if (name == "png") {
+        format = ImageFormat::PNG;
+    } else if (name == "ppm") {
+        format = ImageFormat::PPM;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool isImageFormatAvailable(ImageFormat format) {
+    switch (format) {
+#ifdef HAS_JPEG
+        case ImageFormat::JPEG: return true;
+#endif
+#ifdef HAS_PNG
+        case ImageFormat::PNG: return true;
+#endif
+        case ImageFormat::PPM: return true;
+        default: return false;
+    }
+}
+
+const char* imageFormatExtension(ImageFormat format) {
+    switch (format) {
+        case ImageFormat::JPEG: return "jpg";
+        case ImageFormat::PNG: return "png";
+        case ImageFormat::PPM: return "ppm";
+    }
+    return "bin";
+}
+
+bool encodeImage(const FrameData& frame, ImageFormat format, int jpeg_quality,
+                 std::vector<uint8_t>& out, std::string& error) {
+    if (frame.width <= 0 || frame.height <= 0 ||
+        frame.pixels.size() < static_cast<size_t>(frame.width) * frame.height * 3) {
+        error = "Frame is empty or not packed RGB";
+        return false;
+    }
+
+    switch (format) {
+#ifdef HAS_JPEG
+        case ImageFormat::JPEG: return encodeJpeg(frame, jpeg_quality, out, error);
+#endif
+#ifdef HAS_PNG
+        case ImageFormat::PNG: return encodePng(frame, out, error);
+#endif
+        case ImageFormat::PPM: return encodePpm(frame, out);
+        default:
+            error = std::string("Format not built in: ") + imageFormatExtension(format);
+            return false;
+    }
+}
+
+} // namespace robot_vision
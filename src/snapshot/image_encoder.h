@@ -0,0 +1,59 @@
+#pragma once
+
+/**
+ * @file image_encoder.h
+ * @brief Still-image encoders for RGB frames (JPEG, PNG, PPM)
+ *
+ * JPEG uses libjpeg (libjpeg-turbo where installed, HAS_JPEG) and PNG uses
+ * libpng (HAS_PNG). PPM needs no library and is always available, so a
+ * snapshot can always be written even on a minimal build.
+ */
+
+#include "core/video_pipeline.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * Output image formats
+ */
+enum class ImageFormat {
+    JPEG,
+    PNG,
+    PPM         // Uncompressed, no dependency
+};
+
+/**
+ * Parse "jpeg" / "jpg" / "png" / "ppm"
+ *
+ * @return false if the name is unknown
+ */
+bool parseImageFormat(const std::string& name, ImageFormat& format);
+
+/**
+ * Check if support for a format was compiled in
+ */
+bool isImageFormatAvailable(ImageFormat format);
+
+/**
+ * File extension without the dot ("jpg", "png", "ppm")
+ */
+const char* imageFormatExtension(ImageFormat format);
+
+/**
+ * Encode an RGB frame into an in-memory image file
+ *
+ * @param frame Frame with tightly packed RGB pixels
+ * @param format Output format (must be available)
+ * @param jpeg_quality 1..100, JPEG only
+ * @param out Encoded file bytes
+ * @param error Set on failure
+ * @return true on success
+ */
+bool encodeImage(const FrameData& frame, ImageFormat format, int jpeg_quality,
+                 std::vector<uint8_t>& out, std::string& error);
+
+} // namespace robot_vision
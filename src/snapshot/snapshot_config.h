@@ -0,0 +1,42 @@
+#pragma once
+
+/**
+ * @file snapshot_config.h
+ * @brief Snapshot trigger and encoder settings
+ */
+
+#include "snapshot/image_encoder.h"
+
+#include <cstddef>
+#include <string>
+
+namespace robot_vision {
+
+/**
+ * Snapshot configuration
+ */
+struct SnapshotConfig {
+    bool enabled = true;                    // Create the writer (key S, rules below)
+    std::string directory = "snapshots";    // Output directory (created if missing)
+    std::string format = "jpeg";            // jpeg | png | ppm
+    int jpeg_quality = 90;                  // 1..100
+    int workers = 2;                        // Encoder threads
+    size_t queue_depth = 4;                 // Pending snapshots (oldest dropped when full)
+    bool composited = true;                 // Key snapshots include the OSD overlay
+    int interval_s = 0;                     // Periodic snapshot (0 = off)
+    std::string trigger_label = "";         // Detection label that triggers ("" = off, "*" = any)
+    float trigger_confidence = 0.5f;        // Minimum confidence for the trigger
+    int trigger_cooldown_ms = 2000;         // Minimum gap between detection snapshots
+
+    bool isValid() const {
+        ImageFormat f;
+        return parseImageFormat(format, f) && !directory.empty() &&
+               jpeg_quality >= 1 && jpeg_quality <= 100 &&
+               workers >= 1 && workers <= 16 &&
+               queue_depth >= 1 && queue_depth <= 256 &&
+               interval_s >= 0 && trigger_cooldown_ms >= 0 &&
+               trigger_confidence >= 0.0f && trigger_confidence <= 1.0f;
+    }
+};
+
+} // namespace robot_vision
@@ -0,0 +1,244 @@
+/**
+ * @file snapshot_writer.cpp
+ * @brief Snapshot triggers, bounded job queue and encoder threads
+ */
+
+#include "snapshot_writer.h"
+#include "util/logger.h"
+#include "trace/trace.h"
+#include "util/file_util.h"
+#include "util/thread_policy.h"
+
+#include <pthread.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace robot_vision {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+SnapshotWriter::SnapshotWriter(const SnapshotConfig& config)
+    : config_(config)
+    , written_(MetricsRegistry::global().counter("rv_snapshots_written_total",
+                                                 "Snapshot images written"))
+    , dropped_(MetricsRegistry::global().counter("rv_snapshots_dropped_total",
+                                                 "Snapshots discarded because the queue was full"))
+    , failed_(MetricsRegistry::global().counter("rv_snapshots_failed_total",
+                                                "Snapshots that failed to encode or write"))
+    , encode_time_(MetricsRegistry::global().histogram("rv_snapshot_encode_seconds",
+                                                       "Time to encode one snapshot"))
+{
+    if (!parseImageFormat(config_.format, format_) || !isImageFormatAvailable(format_)) {
+        RV_LOG_WARN("snapshot", "Snapshot format '{}' not available in this build, using ppm",
+                    config_.format);
+        format_ = ImageFormat::PPM;
+    }
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    stop();
+}
+
+bool SnapshotWriter::start() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (running_) {
+            return true;
+        }
+    }
+
+    if (!makeDirectories(config_.directory)) {
+        RV_LOG_ERROR("snapshot", "Cannot create snapshot directory {}: {}",
+                     config_.directory, std::strerror(errno));
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        running_ = true;
+    }
+    for (int i = 0; i < config_.workers; ++i) {
+        workers_.emplace_back(&SnapshotWriter::workerLoop, this, i);
+    }
+    if (config_.interval_s > 0) {
+        next_interval_ns_ = nowNs() + static_cast<uint64_t>(config_.interval_s) * 1000000000ull;
+    }
+
+    RV_LOG_INFO("snapshot", "Snapshots: {} to {} ({} encoder threads)",
+                imageFormatExtension(format_), config_.directory, config_.workers);
+    return true;
+}
+
+void SnapshotWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    queue_cv_.notify_all();
+    for (auto& t : workers_) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+    workers_.clear();
+}
+
+// ============================================================================
+// Triggers
+// ============================================================================
+
+void SnapshotWriter::requestSnapshot(const char* reason) {
+    pending_reason_.store(reason, std::memory_order_release);
+}
+
+bool SnapshotWriter::submit(std::shared_ptr<FrameData> frame, const std::string& reason) {
+    if (!frame) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!running_) {
+            return false;
+        }
+        // Drop-oldest: under pressure the newest moment is the one worth keeping
+        if (queue_.size() >= config_.queue_depth) {
+            queue_.pop_front();
+            dropped_.inc();
+        }
+        queue_.push_back(Job{std::move(frame), reason});
+    }
+    queue_cv_.notify_one();
+    return true;
+}
+
+void SnapshotWriter::consumeFrame(const std::shared_ptr<FrameData>& frame) {
+    const char* reason = pending_reason_.exchange(nullptr, std::memory_order_acq_rel);
+
+    if (!reason && next_interval_ns_ != 0) {
+        uint64_t now = nowNs();
+        if (now >= next_interval_ns_) {
+            reason = "interval";
+            next_interval_ns_ = now + static_cast<uint64_t>(config_.interval_s) * 1000000000ull;
+        }
+    }
+
+    if (reason) {
+        submit(frame, reason);
+    }
+}
+
+void SnapshotWriter::consumeDetections(const std::shared_ptr<const DetectionSet>& results) {
+    if (config_.trigger_label.empty()) {
+        return;
+    }
+
+    bool match = false;
+    for (const auto& det : results->detections) {
+        if (det.confidence >= config_.trigger_confidence &&
+            (config_.trigger_label == "*" || config_.trigger_label == det.label)) {
+            match = true;
+            break;
+        }
+    }
+    if (!match) {
+        return;
+    }
+
+    uint64_t now = nowNs();
+    uint64_t last = last_trigger_ns_.load(std::memory_order_relaxed);
+    uint64_t cooldown = static_cast<uint64_t>(config_.trigger_cooldown_ms) * 1000000ull;
+    if (last != 0 && now - last < cooldown) {
+        return;
+    }
+    last_trigger_ns_.store(now, std::memory_order_relaxed);
+    requestSnapshot("detection");
+}
+
+// ============================================================================
+// Workers
+// ============================================================================
+
+void SnapshotWriter::workerLoop(int index) {
+    std::string name = "rv-snap-" + std::to_string(index);
+#ifdef PLATFORM_MACOS
+    pthread_setname_np(name.c_str());
+#else
+    pthread_setname_np(pthread_self(), name.c_str());
+#endif
+    ScopedThreadRole thread_role("background");
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return !running_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;     // Stopped and drained
+            }
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        if (writeJob(job)) {
+            written_.inc();
+        } else {
+            failed_.inc();
+        }
+    }
+}
+
+bool SnapshotWriter::writeJob(const Job& job) {
+    TRACE_SCOPE_FRAME("snapshot", span);
+    span.setFrame(job.frame->frame_number);
+
+    std::vector<uint8_t> encoded;
+    std::string error;
+    auto t0 = Clock::now();
+    if (!encodeImage(*job.frame, format_, config_.jpeg_quality, encoded, error)) {
+        RV_LOG_WARN("snapshot", "Snapshot encode failed: {}", error);
+        return false;
+    }
+    encode_time_.record(Clock::now() - t0);
+
+    std::string path = config_.directory + "/snap_" + wallTimestamp() + "_" +
+                       std::to_string(sequence_.fetch_add(1)) + "_" + job.reason + "." +
+                       imageFormatExtension(format_);
+    std::string tmp = path + ".tmp";
+
+    std::FILE* file = std::fopen(tmp.c_str(), "wb");
+    if (!file) {
+        RV_LOG_WARN("snapshot", "Cannot write snapshot {}: {}", tmp, std::strerror(errno));
+        return false;
+    }
+    bool ok = std::fwrite(encoded.data(), 1, encoded.size(), file) == encoded.size();
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        RV_LOG_WARN("snapshot", "Failed writing snapshot {}", path);
+        std::remove(tmp.c_str());
+        return false;
+    }
+
+    RV_LOG_INFO("snapshot", "Snapshot: {}", path);
+    return true;
+}
+
+} // namespace robot_vision
@@ -0,0 +1,31 @@
+#pragma once
+
+/**
+ * @file mjpeg_config.h
+ * @brief MJPEG server settings
+ */
+
+#include <string>
+
+namespace robot_vision {
+
+/**
+ * MJPEG server configuration
+ */
+struct MjpegConfig {
+    bool enabled = false;
+    std::string listen = "127.0.0.1:8080";  // [host:]port (0.0.0.0 to allow other machines)
+    int fps = 10;                           // Encoded frames per second (while clients watch)
+    int width = 640;                        // Encoded width, height keeps aspect (0 = capture size)
+    int jpeg_quality = 75;                  // 1..100
+    int max_clients = 8;
+    int client_timeout_ms = 5000;           // Drop a client whose socket made no progress this long
+
+    bool isValid() const {
+        return !listen.empty() && fps > 0 && fps <= 60 && width >= 0 && width <= 4096 &&
+               jpeg_quality >= 1 && jpeg_quality <= 100 &&
+               max_clients >= 1 && max_clients <= 256 && client_timeout_ms >= 100;
+    }
+};
+
+} // namespace robot_vision
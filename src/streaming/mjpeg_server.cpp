@@ -0,0 +1,507 @@
+/**
+ * @file mjpeg_server.cpp
+ * @brief Encode-once MJPEG HTTP fan-out
+ */
+
+#include "mjpeg_server.h"
+#include "snapshot/image_encoder.h"
+#include "trace/trace.h"
+#include "util/image_scale.h"
+#include "util/logger.h"
+#include "util/thread_policy.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace robot_vision {
+
+namespace {
+
+// Longest the server sleeps in poll() before re-checking running_
+constexpr int POLL_SLICE_MS = 200;
+
+// Largest request we read (headers only, no body expected)
+constexpr size_t MAX_REQUEST_BYTES = 4096;
+
+constexpr const char* BOUNDARY = "rvframe";
+constexpr const char* PART_TRAILER = "\r\n";
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;       // SIGPIPE is ignored process-wide (main.cpp)
+#endif
+
+void setNonBlocking(int fd) {
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+void setThreadName(const char* name) {
+#ifdef PLATFORM_MACOS
+    pthread_setname_np(name);
+#else
+    pthread_setname_np(pthread_self(), name);
+#endif
+}
+
+} // namespace
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+MjpegServer::MjpegServer(const MjpegConfig& config)
+    : config_(config)
+    , clients_gauge_(MetricsRegistry::global().gauge("rv_mjpeg_clients", "Connected MJPEG viewers"))
+    , encoded_(MetricsRegistry::global().counter("rv_mjpeg_frames_encoded_total",
+                                                 "Frames JPEG-encoded for MJPEG viewers"))
+    , skipped_(MetricsRegistry::global().counter("rv_mjpeg_frames_skipped_total",
+                                                 "Frames a slow viewer skipped (summed over viewers)"))
+    , encode_hist_(MetricsRegistry::global().histogram("rv_mjpeg_encode_seconds",
+                                                       "JPEG encode time (incl. downscale)"))
+{
+}
+
+MjpegServer::~MjpegServer() {
+    stop();
+}
+
+bool MjpegServer::start() {
+    if (running_) {
+        return true;
+    }
+    if (!config_.isValid()) {
+        setError("Invalid MJPEG configuration");
+        return false;
+    }
+    if (!isImageFormatAvailable(ImageFormat::JPEG)) {
+        setError("JPEG support was not compiled in (libjpeg not found)");
+        return false;
+    }
+    if (!openListener()) {
+        return false;
+    }
+    if (::pipe(wake_fds_) != 0) {
+        setError(std::string("pipe() failed: ") + std::strerror(errno));
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    setNonBlocking(wake_fds_[0]);
+    setNonBlocking(wake_fds_[1]);
+
+    running_ = true;
+    encoder_thread_ = std::thread(&MjpegServer::encoderLoop, this);
+    server_thread_ = std::thread(&MjpegServer::serverLoop, this);
+    RV_LOG_INFO("stream", "MJPEG: http://{}/ ({} fps, {})", config_.listen, config_.fps,
+                config_.width > 0 ? std::to_string(config_.width) + " px wide" : std::string("capture size"));
+    return true;
+}
+
+void MjpegServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    encode_cv_.notify_all();
+    wake();
+    if (encoder_thread_.joinable()) {
+        encoder_thread_.join();
+    }
+    if (server_thread_.joinable()) {
+        server_thread_.join();
+    }
+    for (auto& client : clients_) {
+        closeClient(client);
+    }
+    clients_.clear();
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+    for (int& fd : wake_fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+}
+
+bool MjpegServer::openListener() {
+    // [host:]port, host defaults to loopback
+    std::string host = "127.0.0.1";
+    std::string port = config_.listen;
+    size_t colon = config_.listen.rfind(':');
+    if (colon != std::string::npos) {
+        if (colon > 0) {
+            host = config_.listen.substr(0, colon);
+        }
+        port = config_.listen.substr(colon + 1);
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    int port_num = std::atoi(port.c_str());
+    if (port_num <= 0 || port_num > 65535 || ::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        setError("Invalid MJPEG listen address: " + config_.listen);
+        return false;
+    }
+    addr.sin_port = htons(static_cast<uint16_t>(port_num));
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        setError(std::string("socket() failed: ") + std::strerror(errno));
+        return false;
+    }
+    int yes = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listen_fd_, 8) < 0) {
+        setError("Cannot listen on " + config_.listen + ": " + std::strerror(errno));
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    setNonBlocking(listen_fd_);
+    return true;
+}
+
+// ============================================================================
+// Record Thread
+// ============================================================================
+
+void MjpegServer::consumeFrame(const std::shared_ptr<FrameData>& frame) {
+    if (!frame || client_count_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    if (frame->capture_time_ns < next_frame_ns_) {
+        return;
+    }
+    next_frame_ns_ = std::max<uint64_t>(next_frame_ns_ + 1000000000ull / config_.fps,
+                                        frame->capture_time_ns);
+    {
+        std::lock_guard<std::mutex> lock(encode_mutex_);
+        encode_slot_ = frame;   // An unencoded older frame is simply replaced
+    }
+    encode_cv_.notify_one();
+}
+
+// ============================================================================
+// Encoder Thread
+// ============================================================================
+
+void MjpegServer::encoderLoop() {
+    setThreadName("rv-mjpeg-enc");
+    ScopedThreadRole thread_role("background");
+
+    FrameData scaled;
+    while (true) {
+        std::shared_ptr<FrameData> frame;
+        {
+            std::unique_lock<std::mutex> lock(encode_mutex_);
+            encode_cv_.wait(lock, [this] { return encode_slot_ || !running_; });
+            if (!running_) {
+                return;
+            }
+            frame = std::move(encode_slot_);
+        }
+
+        TRACE_SCOPE_FRAME("mjpegEncode", span);
+        span.setFrame(frame->frame_number);
+        uint64_t t0 = metricsNowNs();
+
+        const FrameData* source = frame.get();
+        if (config_.width > 0 && config_.width < frame->width) {
+            scaled.width = config_.width;
+            scaled.height = std::max(2, frame->height * config_.width / frame->width) & ~1;
+            scaleNearestRGB(frame->pixels.data(), frame->width, frame->height, scaled.pixels,
+                            scaled.width, scaled.height);
+            source = &scaled;
+        }
+
+        auto encoded = std::make_shared<EncodedJpeg>();
+        std::string error;
+        if (!encodeImage(*source, ImageFormat::JPEG, config_.jpeg_quality, encoded->jpeg, error)) {
+            RV_LOG_WARN("stream", "MJPEG encode failed: {}", error);
+            continue;
+        }
+        encoded->part_header = std::string("--") + BOUNDARY + "\r\n"
+                               "Content-Type: image/jpeg\r\n"
+                               "Content-Length: " + std::to_string(encoded->jpeg.size()) + "\r\n\r\n";
+        encode_hist_.record(metricsNowNs() - t0);
+        encoded_.inc();
+
+        {
+            std::lock_guard<std::mutex> lock(publish_mutex_);
+            published_ = std::move(encoded);
+        }
+        wake();
+    }
+}
+
+// ============================================================================
+// Server Thread
+// ============================================================================
+
+void MjpegServer::serverLoop() {
+    setThreadName("rv-mjpeg");
+    ScopedThreadRole thread_role("background");
+
+    std::vector<pollfd> fds;
+    while (running_.load(std::memory_order_relaxed)) {
+        fds.clear();
+        fds.push_back(pollfd{listen_fd_, POLLIN, 0});
+        fds.push_back(pollfd{wake_fds_[0], POLLIN, 0});
+        for (const auto& client : clients_) {
+            // Sending: wait for room. Otherwise: read the request / notice a close.
+            fds.push_back(pollfd{client.fd, static_cast<short>(client.sending ? POLLOUT : POLLIN), 0});
+        }
+
+        if (::poll(fds.data(), fds.size(), POLL_SLICE_MS) < 0 && errno != EINTR) {
+            RV_LOG_ERROR("stream", "MJPEG poll failed: {}", std::strerror(errno));
+            break;
+        }
+
+        // Client events first: indices match clients_ until accept/offer change it
+        for (size_t i = 0; i < clients_.size(); ++i) {
+            Client& client = clients_[i];
+            short revents = fds[i + 2].revents;
+            bool keep = true;
+            if (revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                keep = false;
+            } else if ((revents & POLLIN) && !client.sending) {
+                keep = readRequest(client);
+            } else if ((revents & POLLOUT) && client.sending) {
+                keep = flush(client);
+            }
+            // Stuck mid-frame, or connected without ever finishing a request.
+            // Read after the events: flush() may have just recorded progress.
+            const uint64_t now = metricsNowNs();
+            bool waiting = client.sending || (!client.streaming && !client.single);
+            if (keep && waiting &&
+                now - client.last_progress_ns > static_cast<uint64_t>(config_.client_timeout_ms) * 1000000ull) {
+                RV_LOG_INFO("stream", "MJPEG client stalled, disconnecting");
+                keep = false;
+            }
+            if (!keep) {
+                closeClient(client);
+            }
+        }
+        clients_.erase(std::remove_if(clients_.begin(), clients_.end(),
+                                      [](const Client& c) { return c.fd < 0; }),
+                       clients_.end());
+
+        if (fds[0].revents & POLLIN) {
+            acceptClients();
+        }
+
+        if (fds[1].revents & POLLIN) {
+            char drain[64];
+            while (::read(wake_fds_[0], drain, sizeof(drain)) > 0) {
+            }
+            std::shared_ptr<const EncodedJpeg> frame;
+            {
+                std::lock_guard<std::mutex> lock(publish_mutex_);
+                frame = std::move(published_);
+            }
+            if (frame) {
+                for (auto& client : clients_) {
+                    offerFrame(client, frame);
+                }
+                clients_.erase(std::remove_if(clients_.begin(), clients_.end(),
+                                              [](const Client& c) { return c.fd < 0; }),
+                               clients_.end());
+            }
+        }
+
+        client_count_.store(static_cast<int>(clients_.size()), std::memory_order_relaxed);
+        clients_gauge_.set(static_cast<double>(clients_.size()));
+    }
+}
+
+void MjpegServer::acceptClients() {
+    while (true) {
+        int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            return;     // EAGAIN: backlog drained
+        }
+        if (static_cast<int>(clients_.size()) >= config_.max_clients) {
+            static const char busy[] = "HTTP/1.0 503 Service Unavailable\r\n"
+                                       "Content-Type: text/plain\r\n\r\nToo many viewers\n";
+            ::send(fd, busy, sizeof(busy) - 1, SEND_FLAGS);
+            ::close(fd);
+            continue;
+        }
+        setNonBlocking(fd);
+#ifdef SO_NOSIGPIPE
+        int yes = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(yes));
+#endif
+        Client client;
+        client.fd = fd;
+        client.last_progress_ns = metricsNowNs();
+        clients_.push_back(std::move(client));
+    }
+}
+
+bool MjpegServer::readRequest(Client& client) {
+    char buf[1024];
+    ssize_t n = ::recv(client.fd, buf, sizeof(buf), 0);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        return false;   // Closed by the viewer
+    }
+    if (n < 0 || client.streaming || client.single) {
+        return true;    // Nothing new, or extra bytes after the request (ignored)
+    }
+
+    client.request.append(buf, static_cast<size_t>(n));
+    if (client.request.find("\r\n\r\n") == std::string::npos &&
+        client.request.find("\n\n") == std::string::npos) {
+        return client.request.size() < MAX_REQUEST_BYTES;
+    }
+
+    char method[8] = {0};
+    char path[256] = {0};
+    if (std::sscanf(client.request.c_str(), "%7s %255s", method, path) != 2 ||
+        std::strcmp(method, "GET") != 0) {
+        static const char bad[] = "HTTP/1.0 400 Bad Request\r\n\r\n";
+        ::send(client.fd, bad, sizeof(bad) - 1, SEND_FLAGS);
+        return false;
+    }
+
+    std::string target = path;
+    if (target == "/" || target == "/stream") {
+        client.streaming = true;
+        client.head = std::string("HTTP/1.0 200 OK\r\n"
+                                  "Content-Type: multipart/x-mixed-replace; boundary=") + BOUNDARY + "\r\n"
+                      "Cache-Control: no-cache, no-store\r\n"
+                      "Connection: close\r\n\r\n";
+    } else if (target == "/frame.jpg") {
+        client.single = true;       // Head is built when the frame (and its size) is known
+    } else {
+        static const char missing[] = "HTTP/1.0 404 Not Found\r\n"
+                                      "Content-Type: text/plain\r\n\r\nTry / or /frame.jpg\n";
+        ::send(client.fd, missing, sizeof(missing) - 1, SEND_FLAGS);
+        return false;
+    }
+    client.request.clear();
+    client.request.shrink_to_fit();
+    RV_LOG_DEBUG("stream", "MJPEG viewer: {}", target);
+    return true;
+}
+
+void MjpegServer::offerFrame(Client& client, const std::shared_ptr<const EncodedJpeg>& frame) {
+    if (client.fd < 0 || (!client.streaming && !client.single)) {
+        return;
+    }
+    if (client.sending) {
+        // Socket still busy with an older frame: keep only the newest
+        if (client.pending) {
+            skipped_.inc();
+        }
+        client.pending = frame;
+        return;
+    }
+    if (client.single) {
+        client.head = "HTTP/1.0 200 OK\r\nContent-Type: image/jpeg\r\n"
+                      "Content-Length: " + std::to_string(frame->jpeg.size()) + "\r\n"
+                      "Cache-Control: no-cache, no-store\r\nConnection: close\r\n\r\n";
+    }
+    client.sending = frame;
+    client.offset = 0;
+    client.last_progress_ns = metricsNowNs();
+    if (!flush(client)) {
+        closeClient(client);
+    }
+}
+
+bool MjpegServer::flush(Client& client) {
+    while (client.sending) {
+        const EncodedJpeg& frame = *client.sending;
+
+        // head (first frame only), part header, JPEG, trailer - straight from
+        // the shared buffers, skipping whatever already went out
+        const std::string* part = client.single ? nullptr : &frame.part_header;
+        iovec pieces[4] = {
+            {const_cast<char*>(client.head.data()), client.head.size()},
+            {const_cast<char*>(part ? part->data() : nullptr), part ? part->size() : 0},
+            {const_cast<uint8_t*>(frame.jpeg.data()), frame.jpeg.size()},
+            {const_cast<char*>(PART_TRAILER), client.single ? 0 : std::strlen(PART_TRAILER)},
+        };
+        iovec iov[4];
+        int count = 0;
+        size_t skip = client.offset;
+        for (const auto& piece : pieces) {
+            if (skip >= piece.iov_len) {
+                skip -= piece.iov_len;
+                continue;
+            }
+            iov[count].iov_base = static_cast<char*>(piece.iov_base) + skip;
+            iov[count].iov_len = piece.iov_len - skip;
+            skip = 0;
+            ++count;
+        }
+
+        if (count == 0) {
+            // Frame complete
+            client.head.clear();
+            client.sending.reset();
+            client.offset = 0;
+            if (client.single) {
+                return false;   // Done: close
+            }
+            if (client.pending) {
+                client.sending = std::move(client.pending);
+            }
+            continue;
+        }
+
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+        ssize_t sent = ::sendmsg(client.fd, &msg, SEND_FLAGS);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;     // Full: wait for POLLOUT
+        }
+        client.offset += static_cast<size_t>(sent);
+        client.last_progress_ns = metricsNowNs();
+    }
+    return true;
+}
+
+void MjpegServer::closeClient(Client& client) {
+    if (client.fd >= 0) {
+        ::close(client.fd);
+        client.fd = -1;
+    }
+    client.sending.reset();
+    client.pending.reset();
+}
+
+void MjpegServer::wake() {
+    if (wake_fds_[1] >= 0) {
+        char byte = 1;
+        (void)::write(wake_fds_[1], &byte, 1);  // Full pipe = wake-up already pending
+    }
+}
+
+void MjpegServer::setError(const std::string& error) {
+    last_error_ = error;
+    RV_LOG_ERROR("stream", "{}", error);
+}
+
+} // namespace robot_vision
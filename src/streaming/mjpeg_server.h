@@ -0,0 +1,135 @@
+#pragma once
+
+/**
+ * @file mjpeg_server.h
+ * @brief MJPEG-over-HTTP preview for browsers, encoded once per frame
+ *
+ *   record stage --frame--> [rv-mjpeg-enc] JPEG --shared buffer--> [rv-mjpeg] --> N clients
+ *
+ *   GET /            multipart/x-mixed-replace stream (open in any browser)
+ *   GET /frame.jpg   the next encoded frame, once
+ *
+ * Nothing happens per frame unless a client is connected. The record
+ * thread only checks the rate and hands over a pointer; encoding runs on
+ * its own thread, and one thread serves every client from non-blocking
+ * sockets.
+ *
+ * TEACHING: Encode Once, Send Many
+ * --------------------------------
+ * Encoding is the expensive part (milliseconds); sending is a copy into a
+ * socket buffer. So each selected frame is JPEG-encoded exactly once and
+ * every client is handed the SAME immutable buffer (shared_ptr) - the
+ * header, JPEG and trailer go out in one sendmsg() with an iovec each,
+ * never concatenated into a per-client copy.
+ *
+ * Each client has one frame in flight and one pending slot. A slow client
+ * whose socket is full keeps sending its current frame while newer frames
+ * overwrite its pending slot: it sees a lower frame rate, never growing
+ * latency, and never slows anyone else down.
+ */
+
+#include "core/staged_pipeline.h"
+#include "metrics/metrics.h"
+#include "streaming/mjpeg_config.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * MJPEG HTTP server (frame sink)
+ */
+class MjpegServer : public IFrameSink {
+public:
+    explicit MjpegServer(const MjpegConfig& config);
+    ~MjpegServer() override;
+
+    // Non-copyable (owns sockets and threads)
+    MjpegServer(const MjpegServer&) = delete;
+    MjpegServer& operator=(const MjpegServer&) = delete;
+
+    /**
+     * Bind the listener and start the encoder and server threads
+     *
+     * @return false if JPEG support is missing or the port can't be bound
+     */
+    bool start();
+
+    /**
+     * Disconnect clients and join the threads (idempotent)
+     */
+    void stop();
+
+    // IFrameSink (record thread): rate gate + pointer handoff, never blocks
+    void consumeFrame(const std::shared_ptr<FrameData>& frame) override;
+
+    int clientCount() const { return client_count_.load(std::memory_order_relaxed); }
+    const std::string& getLastError() const { return last_error_; }
+
+private:
+    /**
+     * One encoded frame, shared by every client sending it
+     */
+    struct EncodedJpeg {
+        std::string part_header;        // Multipart boundary + part headers
+        std::vector<uint8_t> jpeg;
+    };
+
+    struct Client {
+        int fd = -1;
+        std::string request;            // Until the blank line
+        bool streaming = false;         // Request parsed: multipart stream
+        bool single = false;            // Request parsed: one frame, then close
+        std::string head;               // HTTP response head, sent with the first frame
+        std::shared_ptr<const EncodedJpeg> sending;
+        size_t offset = 0;              // Bytes of head + frame already sent
+        std::shared_ptr<const EncodedJpeg> pending;
+        uint64_t last_progress_ns = 0;
+    };
+
+    bool openListener();
+    void encoderLoop();
+    void serverLoop();
+    void acceptClients();
+    bool readRequest(Client& client);
+    void offerFrame(Client& client, const std::shared_ptr<const EncodedJpeg>& frame);
+    bool flush(Client& client);
+    void closeClient(Client& client);
+    void wake();
+    void setError(const std::string& error);
+
+    MjpegConfig config_;
+    std::atomic<bool> running_{false};
+    std::atomic<int> client_count_{0};
+    std::string last_error_;
+
+    // Record thread -> encoder: newest frame only
+    std::mutex encode_mutex_;
+    std::condition_variable encode_cv_;
+    std::shared_ptr<FrameData> encode_slot_;
+    uint64_t next_frame_ns_ = 0;        // Record thread only
+
+    // Encoder -> server: newest encoded frame
+    std::mutex publish_mutex_;
+    std::shared_ptr<const EncodedJpeg> published_;
+    int wake_fds_[2] = {-1, -1};        // Self-pipe that interrupts poll()
+
+    int listen_fd_ = -1;
+    std::vector<Client> clients_;       // Server thread only
+    std::thread encoder_thread_;
+    std::thread server_thread_;
+
+    Gauge& clients_gauge_;
+    Counter& encoded_;
+    Counter& skipped_;
+    Histogram& encode_hist_;
+};
+
+} // namespace robot_vision
@@ -0,0 +1,238 @@
+/**
+ * @file rtp_streamer.cpp
+ * @brief appsrc -> encoder -> RTP/UDP pipeline
+ */
+
+#include "rtp_streamer.h"
+#include "util/logger.h"
+#include "trace/trace.h"
+
+#include <gst/app/gstappsrc.h>
+
+namespace robot_vision {
+
+namespace {
+
+/**
+ * appsrc buffer destroy notify: releases the frame the buffer wrapped
+ */
+void releaseFrame(gpointer data) {
+    delete static_cast<std::shared_ptr<const void>*>(data);
+}
+
+} // namespace
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+RtpStreamer::RtpStreamer(const StreamConfig& config, IPlatform& platform,
+                         int capture_width, int capture_height)
+    : config_(config)
+    , platform_(platform)
+    , width_(config.width > 0 ? config.width : capture_width)
+    , height_(config.height > 0 ? config.height : capture_height)
+    , sent_(MetricsRegistry::global().counter("rv_stream_frames_sent_total",
+                                              "Frames handed to the RTP stream encoder"))
+    , dropped_(MetricsRegistry::global().counter("rv_stream_frames_dropped_total",
+                                                 "Stream frames dropped (encoder or network behind)"))
+{
+}
+
+RtpStreamer::~RtpStreamer() {
+    stop();
+}
+
+bool RtpStreamer::start() {
+    if (pipeline_) {
+        return true;
+    }
+    if (!config_.isValid()) {
+        setError("Invalid stream configuration");
+        return false;
+    }
+
+    /**
+     * TEACHING: RTP Packetisation
+     * ---------------------------
+     * rtph264pay splits each access unit into MTU-sized packets (FU-A) and
+     * stamps them with a 90 kHz timestamp and sequence number; the receiver
+     * uses these to reorder and to notice loss. config-interval=-1 resends
+     * SPS/PPS with every keyframe, so a receiver that joins late (or lost
+     * packets) can start decoding at the next keyframe.
+     */
+    std::string pipeline_str =
+        std::string("appsrc name=src ! ") +
+        (isComposited() ? "videoflip method=vertical-flip ! " : "") +
+        "videoscale ! "
+        "video/x-raw,width=" + std::to_string(width_) + ",height=" + std::to_string(height_) + " ! " +
+        platform_.getH264EncoderPipeline(config_.bitrate_kbps, config_.keyframe_interval) + " ! "
+        "h264parse config-interval=-1 ! "
+        "rtph264pay pt=96 config-interval=-1 mtu=" + std::to_string(config_.mtu) + " ! "
+        "udpsink host=" + config_.host + " port=" + std::to_string(config_.port) +
+        " sync=false async=false";
+    RV_LOG_INFO("stream", "Creating stream: {}", pipeline_str);
+
+    GError* error = nullptr;
+    pipeline_ = gst_parse_launch(pipeline_str.c_str(), &error);
+    if (error) {
+        setError(std::string("Stream parse error: ") + error->message);
+        g_error_free(error);
+        stop();
+        return false;
+    }
+    if (!pipeline_) {
+        setError("Failed to create stream pipeline");
+        return false;
+    }
+
+    appsrc_ = gst_bin_get_by_name(GST_BIN(pipeline_), "src");
+    if (!appsrc_) {
+        setError("Stream pipeline is missing appsrc");
+        stop();
+        return false;
+    }
+    gst_object_unref(appsrc_);  // Pipeline owns it
+
+    // Caps are set per frame size in submit(); never block the caller
+    g_object_set(appsrc_,
+        "format", GST_FORMAT_TIME,
+        "is-live", TRUE,
+        "do-timestamp", FALSE,
+        "block", FALSE,
+        nullptr);
+
+    if (gst_element_set_state(pipeline_, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        setError("Failed to start stream pipeline");
+        stop();
+        return false;
+    }
+
+    running_ = true;
+    RV_LOG_INFO("stream", "Streaming {} video {}x{} @ {} fps to rtp://{}:{}", config_.source,
+                width_, height_, config_.fps, config_.host, config_.port);
+    return true;
+}
+
+void RtpStreamer::stop() {
+    running_ = false;
+    if (pipeline_) {
+        gst_element_set_state(pipeline_, GST_STATE_NULL);
+        gst_object_unref(pipeline_);
+        pipeline_ = nullptr;
+    }
+    appsrc_ = nullptr;
+    caps_width_ = 0;
+    caps_height_ = 0;
+    base_ns_ = 0;
+}
+
+// ============================================================================
+// Frames
+// ============================================================================
+
+bool RtpStreamer::wantsCompositedFrame() {
+    if (!running_ || !isComposited()) {
+        return false;
+    }
+    return due(metricsNowNs());
+}
+
+void RtpStreamer::consumeFrame(const std::shared_ptr<FrameData>& frame) {
+    if (!running_ || isComposited() || !frame) {
+        return;
+    }
+    // Decimate the capture rate to the stream rate
+    if (due(frame->capture_time_ns)) {
+        submit(frame);
+    }
+}
+
+bool RtpStreamer::submit(const std::shared_ptr<FrameData>& frame) {
+    if (!frame || isComposited()) {
+        return false;
+    }
+    const size_t frame_bytes = static_cast<size_t>(frame->width) * frame->height * 3;
+    if (frame->pixels.size() < frame_bytes) {
+        return false;
+    }
+    return push(frame, frame->pixels.data(), frame_bytes, frame->width, frame->height,
+                frame->capture_time_ns);
+}
+
+bool RtpStreamer::submit(const std::shared_ptr<FramebufferImage>& image) {
+    if (!image || !isComposited()) {
+        return false;
+    }
+    const size_t image_bytes = static_cast<size_t>(image->width) * image->height * 4;
+    if (image->rgba.size() < image_bytes) {
+        return false;
+    }
+    return push(image, image->rgba.data(), image_bytes, image->width, image->height,
+                image->capture_time_ns);
+}
+
+bool RtpStreamer::push(std::shared_ptr<const void> owner, const uint8_t* pixels, size_t bytes,
+                       int width, int height, uint64_t capture_time_ns) {
+    TRACE_SCOPE("streamSubmit");
+    if (!running_ || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    // One frame may wait for the encoder; anything more is stale by the time it's sent
+    if (gst_app_src_get_current_level_bytes(GST_APP_SRC(appsrc_)) >= bytes) {
+        dropped_.inc();
+        return false;
+    }
+
+    // New input size (window resize, governor capture step): videoscale adapts
+    if (width != caps_width_ || height != caps_height_) {
+        GstCaps* caps = gst_caps_from_string(
+            ("video/x-raw,format=" + std::string(isComposited() ? "RGBA" : "RGB") +
+             ",width=" + std::to_string(width) +
+             ",height=" + std::to_string(height) +
+             ",framerate=" + std::to_string(config_.fps) + "/1").c_str());
+        g_object_set(appsrc_, "caps", caps, nullptr);
+        gst_caps_unref(caps);
+        caps_width_ = width;
+        caps_height_ = height;
+    }
+
+    if (base_ns_ == 0) {
+        base_ns_ = capture_time_ns;
+    }
+
+    // Zero-copy: the buffer keeps the pixels' owner alive until the encoder is done with them
+    auto* holder = new std::shared_ptr<const void>(std::move(owner));
+    GstBuffer* buffer = gst_buffer_new_wrapped_full(
+        GST_MEMORY_FLAG_READONLY, const_cast<uint8_t*>(pixels), bytes,
+        0, bytes, holder, releaseFrame);
+    GST_BUFFER_PTS(buffer) = capture_time_ns > base_ns_ ? capture_time_ns - base_ns_ : 0;
+    GST_BUFFER_DURATION(buffer) = GST_SECOND / static_cast<GstClockTime>(config_.fps);
+
+    // push_buffer takes ownership of the buffer whatever it returns
+    if (gst_app_src_push_buffer(GST_APP_SRC(appsrc_), buffer) != GST_FLOW_OK) {
+        dropped_.inc();
+        return false;
+    }
+    sent_.inc();
+    return true;
+}
+
+bool RtpStreamer::due(uint64_t now_ns) {
+    if (now_ns < next_frame_ns_) {
+        return false;
+    }
+    // Next slot one period on; if we fell behind (or this is the first
+    // frame), one period from now - never a slot already due (catch-up burst)
+    const uint64_t period = 1000000000ull / static_cast<uint64_t>(config_.fps);
+    next_frame_ns_ = next_frame_ns_ + period > now_ns ? next_frame_ns_ + period : now_ns + period;
+    return true;
+}
+
+void RtpStreamer::setError(const std::string& error) {
+    last_error_ = error;
+    RV_LOG_ERROR("stream", "{}", error);
+}
+
+} // namespace robot_vision
@@ -0,0 +1,141 @@
+#pragma once
+
+/**
+ * @file rtp_streamer.h
+ * @brief Low-latency H.264 RTP/UDP stream for ground stations
+ *
+ *   appsrc (RGB, any size) ! videoscale ! <stream size> ! <platform encoder>
+ *       ! h264parse ! rtph264pay ! udpsink host=... port=...
+ *
+ * Two sources:
+ * - raw:        captured frames, taken from the record stage (IFrameSink)
+ * - composited: video + OSD read back from the framebuffer by the render
+ *               thread at the stream rate - what the operator sees. The
+ *               readback is asynchronous (FramebufferReadback) and arrives
+ *               as GL returns it; videoflip turns it upright on the
+ *               stream's own thread:
+ *
+ *   appsrc (RGBA, bottom row first) ! videoflip method=vertical-flip ! videoscale ! ...
+ *
+ * Receive with (any machine that can reach host:port):
+ *
+ *   gst-launch-1.0 udpsrc port=5600 caps="application/x-rtp,media=video,\
+ *       encoding-name=H264,payload=96,clock-rate=90000" ! rtpjitterbuffer latency=0 \
+ *       ! rtph264depay ! avdec_h264 ! autovideosink sync=false
+ *
+ * TEACHING: Drop, Don't Queue
+ * ---------------------------
+ * A live view is only useful if it is current. When the link or the
+ * encoder can't keep up, a queue turns a bandwidth problem into a latency
+ * problem that never recovers. So the only buffer is appsrc's (one frame):
+ * if udpsink blocks on a full socket, back-pressure reaches the encoder,
+ * appsrc fills, and new frames are dropped - whole frames, so the receiver
+ * sees a lower frame rate rather than corrupt slices.
+ */
+
+#include "core/platform.h"
+#include "core/staged_pipeline.h"
+#include "metrics/metrics.h"
+#include "rendering/framebuffer_capture.h"
+#include "streaming/stream_config.h"
+
+#include <gst/gst.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace robot_vision {
+
+/**
+ * RTP/UDP H.264 streamer
+ *
+ * Raw mode: attach as a frame sink. Composited mode: the render thread
+ * asks wantsCompositedFrame() each frame and, when true, starts a
+ * framebuffer readback; it submits each collected readback. Frames reach
+ * the encoder from one thread at a time.
+ */
+class RtpStreamer : public IFrameSink {
+public:
+    /**
+     * @param capture_width, capture_height Stream size when the config leaves it 0
+     */
+    RtpStreamer(const StreamConfig& config, IPlatform& platform,
+                int capture_width, int capture_height);
+    ~RtpStreamer() override;
+
+    // Non-copyable (GStreamer resources)
+    RtpStreamer(const RtpStreamer&) = delete;
+    RtpStreamer& operator=(const RtpStreamer&) = delete;
+
+    /**
+     * Build and start the stream pipeline
+     */
+    bool start();
+
+    /**
+     * Stop the pipeline (idempotent; after the record stage has stopped)
+     */
+    void stop();
+
+    /**
+     * Composited mode: true when the next framebuffer readback is due
+     */
+    bool wantsCompositedFrame();
+
+    /**
+     * Raw mode: queue a frame for encoding; dropped if the encoder is behind
+     *
+     * @return false if the frame was dropped
+     */
+    bool submit(const std::shared_ptr<FrameData>& frame);
+
+    /**
+     * Composited mode: queue a framebuffer readback (flipped and repacked
+     * in the stream pipeline, not by the caller)
+     *
+     * @return false if the image was dropped
+     */
+    bool submit(const std::shared_ptr<FramebufferImage>& image);
+
+    // IFrameSink (record thread): raw mode only
+    void consumeFrame(const std::shared_ptr<FrameData>& frame) override;
+
+    bool isComposited() const { return config_.source == "composited"; }
+    const std::string& getLastError() const { return last_error_; }
+
+private:
+    /**
+     * Stream-rate gate: true (and advance the slot) if a frame is due
+     */
+    bool due(uint64_t now_ns);
+
+    /**
+     * Hand pixels to appsrc without copying; owner is kept alive until
+     * the encoder is done with them
+     */
+    bool push(std::shared_ptr<const void> owner, const uint8_t* pixels, size_t bytes,
+              int width, int height, uint64_t capture_time_ns);
+    void setError(const std::string& error);
+
+    StreamConfig config_;
+    IPlatform& platform_;
+    int width_;
+    int height_;
+
+    GstElement* pipeline_ = nullptr;
+    GstElement* appsrc_ = nullptr;      // Owned by pipeline
+    int caps_width_ = 0;                // Size appsrc caps currently announce
+    int caps_height_ = 0;
+    uint64_t base_ns_ = 0;              // Capture time of the first frame (PTS 0)
+    uint64_t next_frame_ns_ = 0;        // Raw/composited rate limit
+    std::atomic<bool> running_{false};
+
+    Counter& sent_;
+    Counter& dropped_;
+
+    std::string last_error_;
+};
+
+} // namespace robot_vision
@@ -0,0 +1,36 @@
+#pragma once
+
+/**
+ * @file stream_config.h
+ * @brief RTP stream settings
+ */
+
+#include <string>
+
+namespace robot_vision {
+
+/**
+ * Stream configuration
+ */
+struct StreamConfig {
+    bool enabled = false;
+    std::string host = "127.0.0.1";     // Receiver address (unicast or multicast)
+    int port = 5600;                    // Receiver UDP port
+    std::string source = "raw";         // raw | composited (video + OSD)
+    int width = 0;                      // Stream size (0 = capture size)
+    int height = 0;
+    int fps = 15;                       // Stream rate (frames above it are skipped)
+    int bitrate_kbps = 2000;
+    int keyframe_interval = 15;         // Frames per GOP (recovery time after loss)
+    int mtu = 1200;                     // RTP payload size (stay below the path MTU)
+
+    bool isValid() const {
+        return !host.empty() && port > 0 && port <= 65535 &&
+               (source == "raw" || source == "composited") &&
+               width >= 0 && height >= 0 && (width == 0) == (height == 0) &&
+               fps > 0 && fps <= 120 && bitrate_kbps > 0 && keyframe_interval > 0 &&
+               mtu >= 256 && mtu <= 9000;
+    }
+};
+
+} // namespace robot_vision
@@ -0,0 +1,259 @@
+/**
+ * @file mavlink.cpp
+ * @brief MAVLink framing, X.25 checksum and payload decoders
+ */
+
+#include "mavlink.h"
+
+#include <cstring>
+
+namespace robot_vision {
+
+namespace {
+
+constexpr uint8_t STX_V1 = 0xFE;
+constexpr uint8_t STX_V2 = 0xFD;
+constexpr size_t HEADER_V1 = 6;     // STX .. msgid
+constexpr size_t HEADER_V2 = 10;
+constexpr size_t CHECKSUM_BYTES = 2;
+constexpr size_t SIGNATURE_BYTES = 13;
+constexpr uint8_t INCOMPAT_SIGNED = 0x01;
+
+struct MessageInfo {
+    uint32_t msgid;
+    uint8_t crc_extra;
+    uint8_t wire_length;            // MAVLink 1 payload length (v2 extensions ignored)
+};
+
+// Must match common.xml: a wrong CRC_EXTRA rejects every message of that id
+constexpr MessageInfo MESSAGES[] = {
+    {mavlink::MSG_HEARTBEAT, 50, 9},
+    {mavlink::MSG_SYS_STATUS, 124, 31},
+    {mavlink::MSG_ATTITUDE, 39, 28},
+    {mavlink::MSG_GLOBAL_POSITION_INT, 104, 28},
+    {mavlink::MSG_VFR_HUD, 20, 20},
+    {mavlink::MSG_BATTERY_STATUS, 154, 36},
+};
+
+const MessageInfo* findMessage(uint32_t msgid) {
+    for (const auto& info : MESSAGES) {
+        if (info.msgid == msgid) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * CRC-16/MCRF4XX ("X.25" in the MAVLink docs), one byte at a time
+ */
+uint16_t crcAccumulate(uint8_t byte, uint16_t crc) {
+    uint8_t tmp = byte ^ static_cast<uint8_t>(crc & 0xFF);
+    tmp ^= static_cast<uint8_t>(tmp << 4);
+    return static_cast<uint16_t>((crc >> 8) ^ (tmp << 8) ^ (tmp << 3) ^ (tmp >> 4));
+}
+
+/**
+ * Payload with v2 zero-trimming undone (points into the frame when not trimmed)
+ */
+class Payload {
+public:
+    Payload(const MavlinkMessage& msg, size_t wire_length)
+        : data_(msg.payload)
+    {
+        if (msg.length < wire_length) {
+            std::memset(padded_, 0, sizeof(padded_));
+            std::memcpy(padded_, msg.payload, msg.length);
+            data_ = padded_;
+        }
+    }
+
+    template <typename V>
+    V get(size_t offset) const {
+        V value;
+        std::memcpy(&value, data_ + offset, sizeof(V));   // Little-endian host
+        return value;
+    }
+
+private:
+    const uint8_t* data_;
+    uint8_t padded_[64];
+};
+
+} // namespace
+
+// ============================================================================
+// Framing
+// ============================================================================
+
+size_t mavlinkFrameLength(const uint8_t* data, size_t size) {
+    if (size < 2) {
+        return 0;
+    }
+    size_t length;
+    if (data[0] == STX_V1) {
+        length = HEADER_V1 + data[1] + CHECKSUM_BYTES;
+    } else if (data[0] == STX_V2) {
+        if (size < 3) {
+            return 0;
+        }
+        length = HEADER_V2 + data[1] + CHECKSUM_BYTES + ((data[2] & INCOMPAT_SIGNED) ? SIGNATURE_BYTES : 0);
+    } else {
+        return 0;
+    }
+    return length <= size ? length : 0;
+}
+
+MavlinkParseStats parseMavlink(const uint8_t* data, size_t size,
+                               const std::function<void(const MavlinkMessage&)>& on_message) {
+    MavlinkParseStats stats;
+    size_t pos = 0;
+    while (pos < size) {
+        size_t frame_length = mavlinkFrameLength(data + pos, size - pos);
+        if (frame_length == 0) {
+            ++stats.garbage_bytes;
+            ++pos;
+            continue;
+        }
+        const uint8_t* frame = data + pos;
+        const bool v2 = frame[0] == STX_V2;
+
+        MavlinkMessage msg;
+        msg.length = frame[1];
+        if (v2) {
+            msg.seq = frame[4];
+            msg.sysid = frame[5];
+            msg.compid = frame[6];
+            msg.msgid = frame[7] | (frame[8] << 8) | (static_cast<uint32_t>(frame[9]) << 16);
+            msg.payload = frame + HEADER_V2;
+        } else {
+            msg.seq = frame[2];
+            msg.sysid = frame[3];
+            msg.compid = frame[4];
+            msg.msgid = frame[5];
+            msg.payload = frame + HEADER_V1;
+        }
+
+        const MessageInfo* info = findMessage(msg.msgid);
+        if (!info) {
+            ++stats.messages;       // Can't validate it: trust the framing
+            on_message(msg);
+            pos += frame_length;
+            continue;
+        }
+
+        // Checksum: everything after STX through the payload, then CRC_EXTRA
+        const size_t header = v2 ? HEADER_V2 : HEADER_V1;
+        uint16_t crc = 0xFFFF;
+        for (size_t i = 1; i < header + msg.length; ++i) {
+            crc = crcAccumulate(frame[i], crc);
+        }
+        crc = crcAccumulate(info->crc_extra, crc);
+        const uint16_t wire_crc = frame[header + msg.length] | (frame[header + msg.length + 1] << 8);
+        if (crc != wire_crc) {
+            // Probably a false start marker inside another frame: resync one byte on
+            ++stats.crc_errors;
+            ++pos;
+            continue;
+        }
+
+        ++stats.messages;
+        on_message(msg);
+        pos += frame_length;
+    }
+    return stats;
+}
+
+// ============================================================================
+// Decoders (offsets follow MAVLink wire order: fields sorted by size)
+// ============================================================================
+
+bool decodeHeartbeat(const MavlinkMessage& msg, mavlink::Heartbeat& out) {
+    if (msg.msgid != mavlink::MSG_HEARTBEAT) {
+        return false;
+    }
+    Payload p(msg, 9);
+    out.custom_mode = p.get<uint32_t>(0);
+    out.type = p.get<uint8_t>(4);
+    out.autopilot = p.get<uint8_t>(5);
+    out.base_mode = p.get<uint8_t>(6);
+    out.system_status = p.get<uint8_t>(7);
+    return true;
+}
+
+bool decodeSysStatus(const MavlinkMessage& msg, mavlink::SysStatus& out) {
+    if (msg.msgid != mavlink::MSG_SYS_STATUS) {
+        return false;
+    }
+    Payload p(msg, 31);
+    out.load = p.get<uint16_t>(12);
+    out.voltage_battery_mv = p.get<uint16_t>(14);
+    out.current_battery_ca = p.get<int16_t>(16);
+    out.drop_rate_comm = p.get<uint16_t>(18);
+    out.battery_remaining = p.get<int8_t>(30);
+    return true;
+}
+
+bool decodeAttitude(const MavlinkMessage& msg, mavlink::Attitude& out) {
+    if (msg.msgid != mavlink::MSG_ATTITUDE) {
+        return false;
+    }
+    Payload p(msg, 28);
+    out.time_boot_ms = p.get<uint32_t>(0);
+    out.roll = p.get<float>(4);
+    out.pitch = p.get<float>(8);
+    out.yaw = p.get<float>(12);
+    out.rollspeed = p.get<float>(16);
+    out.pitchspeed = p.get<float>(20);
+    out.yawspeed = p.get<float>(24);
+    return true;
+}
+
+bool decodeGlobalPositionInt(const MavlinkMessage& msg, mavlink::GlobalPositionInt& out) {
+    if (msg.msgid != mavlink::MSG_GLOBAL_POSITION_INT) {
+        return false;
+    }
+    Payload p(msg, 28);
+    out.time_boot_ms = p.get<uint32_t>(0);
+    out.lat = p.get<int32_t>(4);
+    out.lon = p.get<int32_t>(8);
+    out.alt_mm = p.get<int32_t>(12);
+    out.relative_alt_mm = p.get<int32_t>(16);
+    out.vx = p.get<int16_t>(20);
+    out.vy = p.get<int16_t>(22);
+    out.vz = p.get<int16_t>(24);
+    out.hdg_cdeg = p.get<uint16_t>(26);
+    return true;
+}
+
+bool decodeVfrHud(const MavlinkMessage& msg, mavlink::VfrHud& out) {
+    if (msg.msgid != mavlink::MSG_VFR_HUD) {
+        return false;
+    }
+    Payload p(msg, 20);
+    out.airspeed = p.get<float>(0);
+    out.groundspeed = p.get<float>(4);
+    out.alt = p.get<float>(8);
+    out.climb = p.get<float>(12);
+    out.heading = p.get<int16_t>(16);
+    out.throttle = p.get<uint16_t>(18);
+    return true;
+}
+
+bool decodeBatteryStatus(const MavlinkMessage& msg, mavlink::BatteryStatus& out) {
+    if (msg.msgid != mavlink::MSG_BATTERY_STATUS) {
+        return false;
+    }
+    Payload p(msg, 36);
+    out.current_consumed_mah = p.get<int32_t>(0);
+    out.temperature_cdeg = p.get<int16_t>(8);
+    for (int i = 0; i < 10; ++i) {
+        out.voltages_mv[i] = p.get<uint16_t>(10 + 2 * i);
+    }
+    out.current_battery_ca = p.get<int16_t>(30);
+    out.id = p.get<uint8_t>(32);
+    out.battery_remaining = p.get<int8_t>(35);
+    return true;
+}
+
+} // namespace robot_vision
@@ -0,0 +1,144 @@
+#pragma once
+
+/**
+ * @file mavlink.h
+ * @brief Minimal zero-copy MAVLink v1/v2 framing and common-message decoders
+ *
+ * Only what the OSD needs, without the generated MAVLink headers:
+ *
+ *   v1: FE len seq sys comp msgid              payload crc16
+ *   v2: FD len incompat compat seq sys comp msgid[3] payload crc16 [signature 13]
+ *
+ * The parser walks a received datagram in place and hands out messages
+ * that point into it; decoders read fields straight from that payload.
+ * MAVLink v2 trims trailing zero bytes from payloads, so a decoder pads
+ * a short payload into a small stack buffer - the only copy made.
+ *
+ * TEACHING: CRC_EXTRA
+ * -------------------
+ * Every message's checksum also covers one extra byte derived from the
+ * message definition (field names and types). A sender and receiver that
+ * disagree on a message's layout therefore see a CRC error instead of
+ * silently decoding garbage - which is why the table below must match the
+ * official message set exactly.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace robot_vision {
+
+// ============================================================================
+// Messages
+// ============================================================================
+
+namespace mavlink {
+
+constexpr uint32_t MSG_HEARTBEAT = 0;
+constexpr uint32_t MSG_SYS_STATUS = 1;
+constexpr uint32_t MSG_ATTITUDE = 30;
+constexpr uint32_t MSG_GLOBAL_POSITION_INT = 33;
+constexpr uint32_t MSG_VFR_HUD = 74;
+constexpr uint32_t MSG_BATTERY_STATUS = 147;
+
+struct Heartbeat {
+    uint32_t custom_mode;           // Autopilot-specific flight mode
+    uint8_t type;                   // MAV_TYPE
+    uint8_t autopilot;
+    uint8_t base_mode;              // Bit 7 = armed
+    uint8_t system_status;
+};
+
+struct SysStatus {
+    uint16_t load;                  // Main loop load, 0.1 %
+    uint16_t voltage_battery_mv;
+    int16_t current_battery_ca;     // 10 mA units, -1 = unknown
+    uint16_t drop_rate_comm;        // 0.01 %
+    int8_t battery_remaining;       // %, -1 = unknown
+};
+
+struct Attitude {
+    uint32_t time_boot_ms;
+    float roll, pitch, yaw;         // rad
+    float rollspeed, pitchspeed, yawspeed;  // rad/s
+};
+
+struct GlobalPositionInt {
+    uint32_t time_boot_ms;
+    int32_t lat, lon;               // degE7
+    int32_t alt_mm;                 // MSL
+    int32_t relative_alt_mm;        // Above home
+    int16_t vx, vy, vz;             // cm/s, NED
+    uint16_t hdg_cdeg;              // UINT16_MAX = unknown
+};
+
+struct VfrHud {
+    float airspeed;                 // m/s
+    float groundspeed;              // m/s
+    float alt;                      // m MSL
+    float climb;                    // m/s
+    int16_t heading;                // deg 0..360
+    uint16_t throttle;              // %
+};
+
+struct BatteryStatus {
+    int32_t current_consumed_mah;   // -1 = unknown
+    int16_t temperature_cdeg;       // INT16_MAX = unknown
+    uint16_t voltages_mv[10];       // Per cell, UINT16_MAX = not present
+    int16_t current_battery_ca;
+    uint8_t id;
+    int8_t battery_remaining;       // %
+};
+
+} // namespace mavlink
+
+// ============================================================================
+// Framing
+// ============================================================================
+
+/**
+ * One framed message, pointing into the buffer it was parsed from
+ */
+struct MavlinkMessage {
+    uint32_t msgid = 0;
+    uint8_t sysid = 0;
+    uint8_t compid = 0;
+    uint8_t seq = 0;
+    uint8_t length = 0;             // Payload bytes on the wire (v2: after zero trimming)
+    const uint8_t* payload = nullptr;
+};
+
+/**
+ * Counters from one parse() call
+ */
+struct MavlinkParseStats {
+    size_t messages = 0;            // Valid frames (known or not)
+    size_t crc_errors = 0;          // Known message ids whose checksum failed
+    size_t garbage_bytes = 0;       // Bytes skipped looking for a start marker
+};
+
+/**
+ * Parse every complete frame in a buffer (a UDP datagram or tlog record)
+ *
+ * Frames of message ids without a CRC_EXTRA entry cannot be checksum
+ * verified; they are still passed on (their sequence numbers count for
+ * link loss) but none of the decoders below accepts them.
+ */
+MavlinkParseStats parseMavlink(const uint8_t* data, size_t size,
+                               const std::function<void(const MavlinkMessage&)>& on_message);
+
+/**
+ * Length of the frame starting at data (0 if data doesn't start one or it is truncated)
+ */
+size_t mavlinkFrameLength(const uint8_t* data, size_t size);
+
+// Decoders: false if msg is a different message
+bool decodeHeartbeat(const MavlinkMessage& msg, mavlink::Heartbeat& out);
+bool decodeSysStatus(const MavlinkMessage& msg, mavlink::SysStatus& out);
+bool decodeAttitude(const MavlinkMessage& msg, mavlink::Attitude& out);
+bool decodeGlobalPositionInt(const MavlinkMessage& msg, mavlink::GlobalPositionInt& out);
+bool decodeVfrHud(const MavlinkMessage& msg, mavlink::VfrHud& out);
+bool decodeBatteryStatus(const MavlinkMessage& msg, mavlink::BatteryStatus& out);
+
+} // namespace robot_vision
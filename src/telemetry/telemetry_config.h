@@ -0,0 +1,26 @@
+#pragma once
+
+/**
+ * @file telemetry_config.h
+ * @brief Telemetry listener settings
+ */
+
+#include <string>
+
+namespace robot_vision {
+
+/**
+ * Telemetry listener configuration
+ */
+struct TelemetryConfig {
+    bool enabled = false;
+    std::string listen = "0.0.0.0:14550";   // [host:]port for incoming MAVLink UDP
+    int sysid = 0;                          // Vehicle to follow (0 = first one heard)
+    int stale_ms = 1500;                    // OSD shows the link as lost after this long
+
+    bool isValid() const {
+        return !listen.empty() && sysid >= 0 && sysid <= 255 && stale_ms >= 100;
+    }
+};
+
+} // namespace robot_vision
@@ -0,0 +1,317 @@
+/**
+ * @file telemetry_receiver.cpp
+ * @brief UDP receive thread, message handling and clock alignment
+ */
+
+#include "telemetry_receiver.h"
+#include "util/logger.h"
+#include "util/thread_policy.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace robot_vision {
+
+namespace {
+
+// Longest the thread sleeps in poll() before re-checking running_
+constexpr int POLL_SLICE_MS = 200;
+
+// Largest MAVLink v2 frame is 280 bytes; routers may batch several per datagram
+constexpr size_t DATAGRAM_BYTES = 2048;
+
+// How far attitudeAt() extrapolates from the last sample
+constexpr double MAX_EXTRAPOLATION_S = 0.1;
+
+// The offset estimate creeps up by 1/N of the gap per sample (drift tracking)
+constexpr int64_t OFFSET_CREEP_DIVISOR = 256;
+
+constexpr uint8_t MAV_MODE_FLAG_SAFETY_ARMED = 0x80;
+
+} // namespace
+
+// ============================================================================
+// Snapshot
+// ============================================================================
+
+void TelemetrySnapshot::attitudeAt(uint64_t time_ns, float& out_roll, float& out_pitch, float& out_yaw) const {
+    double dt = 0.0;
+    if (attitude_ns != 0 && time_ns != 0) {
+        dt = (static_cast<double>(time_ns) - static_cast<double>(attitude_ns)) / 1e9;
+        dt = std::max(-MAX_EXTRAPOLATION_S, std::min(MAX_EXTRAPOLATION_S, dt));
+    }
+    out_roll = roll + roll_rate * static_cast<float>(dt);
+    out_pitch = pitch + pitch_rate * static_cast<float>(dt);
+    out_yaw = yaw + yaw_rate * static_cast<float>(dt);
+}
+
+uint64_t TelemetryReceiver::ClockAligner::toLocal(uint32_t time_boot_ms, uint64_t arrival_ns) {
+    const int64_t boot_ns = static_cast<int64_t>(time_boot_ms) * 1000000;
+    const int64_t sample = static_cast<int64_t>(arrival_ns) - boot_ns;
+
+    // First sample, or the autopilot rebooted (its clock jumped back)
+    if (!valid || time_boot_ms + 1000 < last_boot_ms) {
+        offset_ns = sample;
+        valid = true;
+    } else if (sample < offset_ns) {
+        offset_ns = sample;     // Less transit delay than ever seen: better estimate
+    } else {
+        offset_ns += (sample - offset_ns) / OFFSET_CREEP_DIVISOR;
+    }
+    last_boot_ms = time_boot_ms;
+
+    // Never after the arrival (the sample can't come from the future)
+    int64_t local = boot_ns + offset_ns;
+    return static_cast<uint64_t>(std::min<int64_t>(local, static_cast<int64_t>(arrival_ns)));
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+TelemetryReceiver::TelemetryReceiver(const TelemetryConfig& config)
+    : config_(config)
+    , messages_(MetricsRegistry::global().counter("rv_telemetry_messages_total",
+                                                  "MAVLink frames received (any message id)"))
+    , crc_errors_(MetricsRegistry::global().counter("rv_telemetry_crc_errors_total",
+                                                    "MAVLink frames with a bad checksum"))
+    , lost_(MetricsRegistry::global().counter("rv_telemetry_lost_total",
+                                              "MAVLink frames missing from the followed vehicle's sequence"))
+{
+    std::fill(std::begin(last_seq_), std::end(last_seq_), -1);
+    followed_sysid_ = config_.sysid;
+}
+
+TelemetryReceiver::~TelemetryReceiver() {
+    stop();
+}
+
+bool TelemetryReceiver::start() {
+    if (running_) {
+        return true;
+    }
+    if (!config_.isValid()) {
+        setError("Invalid telemetry configuration");
+        return false;
+    }
+
+    // [host:]port, host defaults to any interface (the autopilot is usually remote)
+    std::string host = "0.0.0.0";
+    std::string port = config_.listen;
+    size_t colon = config_.listen.rfind(':');
+    if (colon != std::string::npos) {
+        if (colon > 0) {
+            host = config_.listen.substr(0, colon);
+        }
+        port = config_.listen.substr(colon + 1);
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    int port_num = std::atoi(port.c_str());
+    if (port_num <= 0 || port_num > 65535 || ::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        setError("Invalid telemetry listen address: " + config_.listen);
+        return false;
+    }
+    addr.sin_port = htons(static_cast<uint16_t>(port_num));
+
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd_ < 0) {
+        setError(std::string("socket() failed: ") + std::strerror(errno));
+        return false;
+    }
+    int yes = 1;
+    ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        setError("Cannot bind " + config_.listen + ": " + std::strerror(errno));
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&TelemetryReceiver::receiveLoop, this);
+    RV_LOG_INFO("telemetry", "Telemetry: MAVLink on udp://{}", config_.listen);
+    return true;
+}
+
+void TelemetryReceiver::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+// ============================================================================
+// Thread
+// ============================================================================
+
+void TelemetryReceiver::receiveLoop() {
+#ifdef PLATFORM_MACOS
+    pthread_setname_np("rv-telemetry");
+#else
+    pthread_setname_np(pthread_self(), "rv-telemetry");
+#endif
+    ScopedThreadRole thread_role("background");
+
+    uint8_t buffer[DATAGRAM_BYTES];
+    while (running_.load(std::memory_order_relaxed)) {
+        pollfd pfd{fd_, POLLIN, 0};
+        if (::poll(&pfd, 1, POLL_SLICE_MS) <= 0) {
+            continue;
+        }
+
+        // Drain everything queued, publish once: readers see whole batches
+        bool changed = false;
+        ssize_t n;
+        while ((n = ::recv(fd_, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+            const uint64_t arrival_ns = metricsNowNs();
+            MavlinkParseStats stats = parseMavlink(buffer, static_cast<size_t>(n),
+                [&](const MavlinkMessage& msg) { handleMessage(msg, arrival_ns); });
+            messages_.inc(stats.messages);
+            crc_errors_.inc(stats.crc_errors);
+            changed |= stats.messages > 0;
+        }
+        if (changed) {
+            latest_.store(state_);
+        }
+    }
+}
+
+void TelemetryReceiver::handleMessage(const MavlinkMessage& msg, uint64_t arrival_ns) {
+    // Follow one vehicle; ignore GCS heartbeats and other aircraft on the same link
+    if (followed_sysid_ == 0) {
+        mavlink::Heartbeat hb;
+        if (!decodeHeartbeat(msg, hb) || hb.type == 6 /* MAV_TYPE_GCS */) {
+            return;
+        }
+        followed_sysid_ = msg.sysid;
+        RV_LOG_INFO("telemetry", "Following vehicle sysid {} (type {}, autopilot {})",
+                    msg.sysid, hb.type, hb.autopilot);
+    }
+    if (msg.sysid != followed_sysid_) {
+        return;
+    }
+
+    // Sequence numbers wrap at 256: a gap of half that or more is a
+    // duplicate, a late packet or a restarted sender, not a loss
+    int& last = last_seq_[msg.compid];
+    const uint8_t gap = static_cast<uint8_t>(msg.seq - last - 1);
+    if (last < 0 || gap < 128) {
+        if (last >= 0) {
+            lost_.inc(gap);
+        }
+        last = msg.seq;
+    }
+
+    state_.sysid = msg.sysid;
+    state_.updated_ns = arrival_ns;
+
+    switch (msg.msgid) {
+        case mavlink::MSG_HEARTBEAT: {
+            mavlink::Heartbeat hb;
+            decodeHeartbeat(msg, hb);
+            state_.heartbeat_ns = arrival_ns;
+            state_.armed = (hb.base_mode & MAV_MODE_FLAG_SAFETY_ARMED) != 0;
+            state_.custom_mode = hb.custom_mode;
+            state_.vehicle_type = hb.type;
+            break;
+        }
+        case mavlink::MSG_ATTITUDE: {
+            mavlink::Attitude att;
+            decodeAttitude(msg, att);
+            state_.attitude_ns = clock_.toLocal(att.time_boot_ms, arrival_ns);
+            state_.roll = att.roll;
+            state_.pitch = att.pitch;
+            state_.yaw = att.yaw;
+            state_.roll_rate = att.rollspeed;
+            state_.pitch_rate = att.pitchspeed;
+            state_.yaw_rate = att.yawspeed;
+            break;
+        }
+        case mavlink::MSG_GLOBAL_POSITION_INT: {
+            mavlink::GlobalPositionInt pos;
+            decodeGlobalPositionInt(msg, pos);
+            state_.position_ns = clock_.toLocal(pos.time_boot_ms, arrival_ns);
+            state_.latitude_deg = pos.lat / 1e7;
+            state_.longitude_deg = pos.lon / 1e7;
+            state_.altitude_msl_m = pos.alt_mm / 1000.0f;
+            state_.altitude_rel_m = pos.relative_alt_mm / 1000.0f;
+            state_.velocity_n = pos.vx / 100.0f;
+            state_.velocity_e = pos.vy / 100.0f;
+            state_.velocity_d = pos.vz / 100.0f;
+            break;
+        }
+        case mavlink::MSG_VFR_HUD: {
+            mavlink::VfrHud hud;
+            decodeVfrHud(msg, hud);
+            state_.hud_ns = arrival_ns;
+            state_.airspeed = hud.airspeed;
+            state_.groundspeed = hud.groundspeed;
+            state_.climb_rate = hud.climb;
+            state_.heading_deg = static_cast<float>(hud.heading);
+            state_.throttle_pct = hud.throttle;
+            break;
+        }
+        case mavlink::MSG_SYS_STATUS: {
+            mavlink::SysStatus sys;
+            decodeSysStatus(msg, sys);
+            state_.battery_ns = arrival_ns;
+            state_.cpu_load_pct = sys.load / 10.0f;
+            if (sys.voltage_battery_mv != std::numeric_limits<uint16_t>::max()) {
+                state_.battery_v = sys.voltage_battery_mv / 1000.0f;
+            }
+            state_.battery_a = sys.current_battery_ca >= 0 ? sys.current_battery_ca / 100.0f : -1.0f;
+            state_.battery_pct = sys.battery_remaining;
+            break;
+        }
+        case mavlink::MSG_BATTERY_STATUS: {
+            mavlink::BatteryStatus bat;
+            decodeBatteryStatus(msg, bat);
+            if (bat.id != 0) {
+                break;      // OSD shows the main pack only
+            }
+            state_.battery_ns = arrival_ns;
+            state_.consumed_mah = bat.current_consumed_mah >= 0 ? static_cast<float>(bat.current_consumed_mah) : -1.0f;
+            int cells = 0;
+            uint16_t min_mv = std::numeric_limits<uint16_t>::max();
+            for (uint16_t mv : bat.voltages_mv) {
+                if (mv != std::numeric_limits<uint16_t>::max() && mv > 0) {
+                    ++cells;
+                    min_mv = std::min(min_mv, mv);
+                }
+            }
+            state_.cell_count = cells;
+            state_.min_cell_v = cells > 0 ? min_mv / 1000.0f : 0.0f;
+            if (bat.battery_remaining >= 0) {
+                state_.battery_pct = bat.battery_remaining;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void TelemetryReceiver::setError(const std::string& error) {
+    last_error_ = error;
+    RV_LOG_ERROR("telemetry", "{}", error);
+}
+
+} // namespace robot_vision
@@ -0,0 +1,174 @@
+#pragma once
+
+/**
+ * @file telemetry_receiver.h
+ * @brief MAVLink UDP listener publishing flight telemetry for the OSD
+ *
+ *   autopilot / GCS router --UDP--> [rv-telemetry] parse --> SeqLock<TelemetrySnapshot>
+ *                                                               |
+ *                                    render loop: read() once per frame (wait-free)
+ *
+ * Test without a vehicle by replaying a recorded telemetry log:
+ *
+ *   ./build/rv_mavreplay flight.tlog --port=14550
+ *
+ * TEACHING: Aligning Two Clocks
+ * -----------------------------
+ * ATTITUDE and GLOBAL_POSITION_INT carry the autopilot's time since boot,
+ * frames carry our steady clock. (arrival - time_boot) is the clock
+ * offset plus a transit delay that is never negative, so the smallest
+ * value seen is the best offset estimate; it is allowed to creep up
+ * slowly to follow drift between the two oscillators. With it, each
+ * sample gets a timestamp on the frame clock, and the OSD can ask for the
+ * attitude at the displayed frame's capture time instead of "whatever
+ * arrived last" - the horizon then stays glued to the video even when
+ * the two paths have different latency.
+ */
+
+#include "metrics/metrics.h"
+#include "telemetry/mavlink.h"
+#include "telemetry/telemetry_config.h"
+#include "util/seqlock.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace robot_vision {
+
+/**
+ * Latest flight state (trivially copyable: lives in a SeqLock)
+ *
+ * All *_ns times are on the steady clock used for frame capture times.
+ * A group is valid once its time is non-zero.
+ */
+struct TelemetrySnapshot {
+    uint64_t updated_ns = 0;        // Last message of any kind
+    uint8_t sysid = 0;
+
+    // HEARTBEAT
+    uint64_t heartbeat_ns = 0;
+    bool armed = false;
+    uint32_t custom_mode = 0;
+    uint8_t vehicle_type = 0;
+
+    // ATTITUDE (radians, rad/s), sample time aligned to the frame clock
+    uint64_t attitude_ns = 0;
+    float roll = 0.0f;
+    float pitch = 0.0f;
+    float yaw = 0.0f;
+    float roll_rate = 0.0f;
+    float pitch_rate = 0.0f;
+    float yaw_rate = 0.0f;
+
+    // GLOBAL_POSITION_INT, sample time aligned to the frame clock
+    uint64_t position_ns = 0;
+    double latitude_deg = 0.0;
+    double longitude_deg = 0.0;
+    float altitude_msl_m = 0.0f;
+    float altitude_rel_m = 0.0f;    // Above home
+    float velocity_n = 0.0f;        // m/s
+    float velocity_e = 0.0f;
+    float velocity_d = 0.0f;
+
+    // VFR_HUD
+    uint64_t hud_ns = 0;
+    float airspeed = 0.0f;          // m/s
+    float groundspeed = 0.0f;       // m/s
+    float climb_rate = 0.0f;        // m/s
+    float heading_deg = 0.0f;       // 0..360
+    int throttle_pct = 0;
+
+    // SYS_STATUS + BATTERY_STATUS
+    uint64_t battery_ns = 0;
+    float battery_v = 0.0f;
+    float battery_a = -1.0f;        // < 0 = unknown
+    int battery_pct = -1;           // < 0 = unknown
+    float consumed_mah = -1.0f;     // < 0 = unknown
+    float min_cell_v = 0.0f;        // 0 = not reported
+    int cell_count = 0;
+    float cpu_load_pct = 0.0f;
+
+    /**
+     * True if a message arrived within max_age_ns of now_ns
+     */
+    bool linkAlive(uint64_t now_ns, uint64_t max_age_ns) const {
+        return updated_ns != 0 && now_ns >= updated_ns && now_ns - updated_ns <= max_age_ns;
+    }
+
+    /**
+     * Attitude at time_ns (e.g. a frame's capture time), extrapolated from
+     * the last sample with its body rates (at most 100 ms either way)
+     */
+    void attitudeAt(uint64_t time_ns, float& out_roll, float& out_pitch, float& out_yaw) const;
+};
+
+/**
+ * MAVLink UDP receiver (owns one thread)
+ */
+class TelemetryReceiver {
+public:
+    explicit TelemetryReceiver(const TelemetryConfig& config);
+    ~TelemetryReceiver();
+
+    // Non-copyable (owns a socket and a thread)
+    TelemetryReceiver(const TelemetryReceiver&) = delete;
+    TelemetryReceiver& operator=(const TelemetryReceiver&) = delete;
+
+    /**
+     * Bind the UDP port and start the receive thread
+     */
+    bool start();
+
+    /**
+     * Stop and join the thread (idempotent)
+     */
+    void stop();
+
+    /**
+     * Copy the latest state (any thread, wait-free)
+     *
+     * @return false if a write overlapped every attempt; out keeps its old value
+     */
+    bool read(TelemetrySnapshot& out) const { return latest_.read(out); }
+
+    const TelemetryConfig& config() const { return config_; }
+    const std::string& getLastError() const { return last_error_; }
+
+private:
+    /**
+     * Vehicle boot clock -> local steady clock (minimum-delay estimate)
+     */
+    struct ClockAligner {
+        int64_t offset_ns = 0;
+        uint32_t last_boot_ms = 0;
+        bool valid = false;
+
+        uint64_t toLocal(uint32_t time_boot_ms, uint64_t arrival_ns);
+    };
+
+    void receiveLoop();
+    void handleMessage(const MavlinkMessage& msg, uint64_t arrival_ns);
+    void setError(const std::string& error);
+
+    TelemetryConfig config_;
+    std::atomic<bool> running_{false};
+    int fd_ = -1;
+    std::thread thread_;
+    std::string last_error_;
+
+    SeqLock<TelemetrySnapshot> latest_;
+
+    // Receive thread only
+    TelemetrySnapshot state_;
+    ClockAligner clock_;
+    int followed_sysid_ = 0;
+    int last_seq_[256];             // Per component id, -1 = none yet
+
+    Counter& messages_;
+    Counter& crc_errors_;
+    Counter& lost_;
+};
+
+} // namespace robot_vision
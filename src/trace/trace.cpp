@@ -0,0 +1,167 @@
+/**
+ * @file trace.cpp
+ * @brief Per-thread span rings and Chrome trace JSON export
+ */
+
+#include "trace.h"
+#include "util/logger.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <utility>
+
+namespace robot_vision {
+
+namespace {
+
+// This thread's ring (registered on first span, owned by the Tracer)
+thread_local void* t_ring = nullptr;
+
+size_t roundUpPow2(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+std::string currentThreadName() {
+    char name[64] = {0};
+    if (pthread_getname_np(pthread_self(), name, sizeof(name)) != 0 || name[0] == '\0') {
+        return "thread";
+    }
+    return name;
+}
+
+} // namespace
+
+// ============================================================================
+// ThreadRing
+// ============================================================================
+
+Tracer::ThreadRing::ThreadRing(size_t capacity, uint64_t tid_, std::string name)
+    : events(capacity)
+    , mask(capacity - 1)
+    , tid(tid_)
+    , thread_name(std::move(name))
+{
+}
+
+// ============================================================================
+// Tracer
+// ============================================================================
+
+Tracer& Tracer::global() {
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::configure(const TraceConfig& config) {
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        ring_events_ = roundUpPow2(config.ring_events);
+        output_path_ = config.output_path;
+    }
+    enabled_.store(config.enabled, std::memory_order_relaxed);
+}
+
+Tracer::ThreadRing* Tracer::threadRing() {
+    if (t_ring) {
+        return static_cast<ThreadRing*>(t_ring);
+    }
+
+    // First span on this thread: register a ring (slow path, once per thread)
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    auto ring = std::make_shared<ThreadRing>(ring_events_, rings_.size() + 1, currentThreadName());
+    rings_.push_back(ring);
+    t_ring = ring.get();
+    return ring.get();
+}
+
+void Tracer::record(const char* name, uint64_t begin_ns, uint64_t end_ns, uint64_t frame_id) {
+    ThreadRing* ring = threadRing();
+
+    // Single producer: plain write to the slot, then publish with release
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    ring->events[head & ring->mask] = TraceEvent{name, begin_ns, end_ns - begin_ns, frame_id};
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+bool Tracer::dump(const std::string& path) {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    const std::string& out_path = path.empty() ? output_path_ : path;
+
+    std::string tmp = out_path + ".tmp";
+    std::ofstream out(tmp, std::ios::trunc);
+    if (!out) {
+        RV_LOG_ERROR("trace", "Cannot write trace {}", tmp);
+        return false;
+    }
+
+    const int pid = static_cast<int>(::getpid());
+    size_t written = 0;
+    bool first = true;
+    auto separator = [&]() -> const char* {
+        const char* sep = first ? "" : ",\n";
+        first = false;
+        return sep;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    std::vector<TraceEvent> copy;
+    for (const auto& ring : rings_) {
+        out << separator() << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid
+            << ",\"tid\":" << ring->tid << ",\"args\":{\"name\":\"" << ring->thread_name << "\"}}";
+
+        /**
+         * TEACHING: Reading a Ring Someone Is Writing
+         * -------------------------------------------
+         * Copy first, then re-read head. Any slot the writer may have
+         * reused while we copied (index older than new_head - capacity,
+         * plus the slot it might be writing right now) is discarded.
+         */
+        const uint64_t capacity = ring->mask + 1;
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t begin = head > capacity ? head - capacity : 0;
+
+        copy.clear();
+        for (uint64_t i = begin; i < head; ++i) {
+            copy.push_back(ring->events[i & ring->mask]);
+        }
+
+        uint64_t new_head = ring->head.load(std::memory_order_acquire);
+        uint64_t valid_from = new_head >= capacity ? new_head - capacity + 1 : 0;
+        size_t skip = valid_from > begin ? static_cast<size_t>(valid_from - begin) : 0;
+
+        for (size_t i = std::min(skip, copy.size()); i < copy.size(); ++i) {
+            const TraceEvent& e = copy[i];
+            out << separator() << "{\"ph\":\"X\",\"name\":\"" << e.name << "\",\"pid\":" << pid
+                << ",\"tid\":" << ring->tid
+                << ",\"ts\":" << e.begin_ns / 1000 << "." << (e.begin_ns % 1000) / 100
+                << ",\"dur\":" << e.duration_ns / 1000 << "." << (e.duration_ns % 1000) / 100;
+            if (e.frame_id != NO_FRAME) {
+                out << ",\"args\":{\"frame\":" << e.frame_id << "}";
+            }
+            out << "}";
+            written++;
+        }
+    }
+
+    out << "\n]}\n";
+    out.close();
+    if (!out || std::rename(tmp.c_str(), out_path.c_str()) != 0) {
+        RV_LOG_ERROR("trace", "Failed writing trace {}", out_path);
+        return false;
+    }
+
+    RV_LOG_INFO("trace", "Trace: {} spans from {} threads written to {}",
+                written, rings_.size(), out_path);
+    return true;
+}
+
+} // namespace robot_vision
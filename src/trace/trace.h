@@ -0,0 +1,178 @@
+#pragma once
+
+/**
+ * @file trace.h
+ * @brief Scoped-span frame timeline, exported as Chrome trace JSON
+ *
+ * Mark a region with TRACE_SCOPE and it appears as a bar on that thread's
+ * track in chrome://tracing or https://ui.perfetto.dev:
+ *
+ *   void TextureRenderer::updateTexture(...) {
+ *       TRACE_SCOPE("updateTexture");
+ *       ...
+ *   }
+ *
+ *   TRACE_SCOPE_FRAME("pullFrame", span);   // named span object
+ *   ...
+ *   span.setFrame(frame->frame_number);     // correlate across threads
+ *
+ * Spans tagged with the same frame id can be followed from capture through
+ * detection to display by clicking "frame" in the span's args.
+ *
+ * TEACHING: Flight Recorder
+ * -------------------------
+ * Each thread writes finished spans into its OWN fixed-size ring buffer:
+ * no lock, no allocation, no sharing of cache lines with other threads.
+ * Old spans are overwritten, so tracing can stay on all the time with
+ * constant memory. When a hitch is seen, dump the ring (SIGUSR1 or the T
+ * key) and the last few seconds of every thread are written to disk.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * Tracing configuration
+ */
+struct TraceConfig {
+    bool enabled = false;                       // Record spans
+    size_t ring_events = 16384;                 // Spans kept per thread (rounded up to power of 2)
+    std::string output_path = "rv_trace.json";  // Chrome trace JSON written on dump
+    bool dump_on_exit = false;                  // Write a trace at shutdown
+
+    bool isValid() const {
+        return ring_events >= 64 && ring_events <= (1u << 22);
+    }
+};
+
+/**
+ * One finished span
+ */
+struct TraceEvent {
+    const char* name;           // String literal (never freed)
+    uint64_t begin_ns;          // Steady clock
+    uint64_t duration_ns;
+    uint64_t frame_id;          // NO_FRAME if not frame-related
+};
+
+/**
+ * Process-wide tracer
+ */
+class Tracer {
+public:
+    static constexpr uint64_t NO_FRAME = UINT64_MAX;
+
+    static Tracer& global();
+
+    /**
+     * Apply configuration (call before stage threads start)
+     */
+    void configure(const TraceConfig& config);
+
+    /**
+     * Check if spans are being recorded (one relaxed load)
+     */
+    bool enabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Record a finished span on the calling thread's ring
+     */
+    void record(const char* name, uint64_t begin_ns, uint64_t end_ns, uint64_t frame_id);
+
+    /**
+     * Write all threads' rings as Chrome trace JSON
+     *
+     * Safe to call while other threads keep tracing; spans overwritten
+     * during the dump are skipped.
+     *
+     * @param path Output file (empty = configured output_path)
+     * @return true if the file was written
+     */
+    bool dump(const std::string& path = "");
+
+    static uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+private:
+    /**
+     * Single-producer ring owned by one thread
+     */
+    struct ThreadRing {
+        ThreadRing(size_t capacity, uint64_t tid, std::string name);
+
+        std::vector<TraceEvent> events;
+        size_t mask;
+        std::atomic<uint64_t> head{0};      // Total spans ever written
+        uint64_t tid;
+        std::string thread_name;
+    };
+
+    Tracer() = default;
+    ThreadRing* threadRing();
+
+    std::atomic<bool> enabled_{false};
+    size_t ring_events_ = 16384;
+    std::string output_path_ = "rv_trace.json";
+
+    std::mutex rings_mutex_;                            // Ring registration and dump
+    std::vector<std::shared_ptr<ThreadRing>> rings_;    // Outlive their threads
+};
+
+/**
+ * RAII span: records [construction, destruction) on the calling thread
+ */
+class ScopedSpan {
+public:
+    explicit ScopedSpan(const char* name, uint64_t frame_id = Tracer::NO_FRAME)
+        : name_(name)
+        , frame_id_(frame_id)
+        , begin_ns_(Tracer::global().enabled() ? Tracer::nowNs() : 0)
+    {
+    }
+
+    ~ScopedSpan() {
+        if (begin_ns_ != 0) {
+            Tracer::global().record(name_, begin_ns_, Tracer::nowNs(), frame_id_);
+        }
+    }
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+    /**
+     * Attach a frame id learned inside the span
+     */
+    void setFrame(uint64_t frame_id) { frame_id_ = frame_id; }
+
+private:
+    const char* name_;
+    uint64_t frame_id_;
+    uint64_t begin_ns_;         // 0 = tracing was off at construction
+};
+
+#define RV_TRACE_CONCAT_(a, b) a##b
+#define RV_TRACE_CONCAT(a, b) RV_TRACE_CONCAT_(a, b)
+
+/**
+ * Trace the enclosing scope
+ */
+#define TRACE_SCOPE(name) \
+    ::robot_vision::ScopedSpan RV_TRACE_CONCAT(rv_trace_span_, __LINE__)(name)
+
+/**
+ * Trace the enclosing scope as a named span object (for setFrame())
+ */
+#define TRACE_SCOPE_FRAME(name, var) ::robot_vision::ScopedSpan var(name)
+
+} // namespace robot_vision
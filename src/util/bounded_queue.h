@@ -0,0 +1,144 @@
+#pragma once
+
+/**
+ * @file bounded_queue.h
+ * @brief Bounded lock-free multi-producer/multi-consumer queue
+ *
+ * TEACHING: Sequence-Numbered Ring Buffer
+ * ---------------------------------------
+ * Every cell carries a sequence number that tells producers and consumers
+ * whose turn it is to touch the cell:
+ * - sequence == pos        -> cell is free, producer at `pos` may write
+ * - sequence == pos + 1    -> cell is full, consumer at `pos` may read
+ *
+ * Producers and consumers claim positions with a compare-and-swap, so no
+ * mutex is ever taken and a stalled thread cannot block the others from
+ * making progress on different cells.
+ *
+ * Because any thread may pop, a producer can implement "drop oldest" by
+ * popping and discarding an element itself - something a single-consumer
+ * ring cannot do safely.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace robot_vision {
+
+template <typename T>
+class BoundedQueue {
+public:
+    /**
+     * Create queue
+     *
+     * @param capacity Maximum number of elements held (>= 1)
+     */
+    explicit BoundedQueue(size_t capacity)
+        : capacity_(capacity > 0 ? capacity : 1)
+    {
+        // Ring size must be a power of two (>= 2) so we can mask instead of mod
+        size_t ring_size = 2;
+        while (ring_size < capacity_) {
+            ring_size <<= 1;
+        }
+        mask_ = ring_size - 1;
+        cells_ = std::make_unique<Cell[]>(ring_size);
+        for (size_t i = 0; i < ring_size; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Non-copyable, non-movable (threads hold references)
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * Try to enqueue an element
+     *
+     * @return false if the queue is full (element is left untouched)
+     */
+    bool tryPush(T&& value) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            // Logical capacity may be smaller than the ring
+            // (signed: a stale `pos` may lag behind the consumers)
+            intptr_t used = static_cast<intptr_t>(pos - dequeue_pos_.load(std::memory_order_acquire));
+            if (used >= static_cast<intptr_t>(capacity_)) {
+                return false;
+            }
+
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.data = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Ring full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Try to dequeue an element
+     *
+     * @return false if the queue is empty
+     */
+    bool tryPop(T& out) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(cell.data);
+                    cell.data = T{};  // Release payload (e.g. shared_ptr) promptly
+                    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Approximate number of queued elements (exact when quiescent)
+     */
+    size_t size() const {
+        size_t head = enqueue_pos_.load(std::memory_order_acquire);
+        size_t tail = dequeue_pos_.load(std::memory_order_acquire);
+        return head >= tail ? head - tail : 0;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T data{};
+    };
+
+    size_t capacity_;
+    size_t mask_ = 0;
+    std::unique_ptr<Cell[]> cells_;
+
+    // Separate cache lines so producers and consumers don't false-share
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<size_t> dequeue_pos_{0};
+};
+
+} // namespace robot_vision
@@ -0,0 +1,52 @@
+#pragma once
+
+/**
+ * @file file_util.h
+ * @brief Small filesystem helpers shared by the writers (snapshots, clips)
+ */
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+namespace robot_vision {
+
+/**
+ * mkdir -p
+ *
+ * @return false if a component could not be created (errno is set)
+ */
+inline bool makeDirectories(const std::string& path) {
+    for (size_t pos = 1; pos <= path.size(); ++pos) {
+        if (pos == path.size() || path[pos] == '/') {
+            std::string part = path.substr(0, pos);
+            if (::mkdir(part.c_str(), 0755) != 0 && errno != EEXIST) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Local wall time for file names: "20240131-142501-123"
+ */
+inline std::string wallTimestamp() {
+    auto now = std::chrono::system_clock::now();
+    std::time_t secs = std::chrono::system_clock::to_time_t(now);
+    int ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        now.time_since_epoch()).count() % 1000);
+    std::tm tm{};
+    localtime_r(&secs, &tm);
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%04d%02d%02d-%02d%02d%02d-%03d",
+                  tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                  tm.tm_hour, tm.tm_min, tm.tm_sec, ms);
+    return buf;
+}
+
+} // namespace robot_vision
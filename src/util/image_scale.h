@@ -0,0 +1,93 @@
+#pragma once
+
+/**
+ * @file image_scale.h
+ * @brief Cheap RGB downscaling for consumers that need fewer pixels
+ */
+
+#include "pixel/pixel_kernels.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * Nearest-neighbour resize of packed RGB (3 bytes per pixel)
+ *
+ * Good enough for detector input, where the model resamples again anyway;
+ * one read and one write per output pixel, no filtering.
+ *
+ * @param dst Resized to dst_width * dst_height * 3
+ */
+inline void scaleNearestRGB(const uint8_t* src, int src_width, int src_height,
+                            std::vector<uint8_t>& dst, int dst_width, int dst_height) {
+    dst.resize(static_cast<size_t>(dst_width) * dst_height * 3);
+
+    // Source byte offset of every output column, computed once per call
+    std::vector<uint32_t> columns(static_cast<size_t>(dst_width));
+    for (int x = 0; x < dst_width; ++x) {
+        columns[x] = static_cast<uint32_t>(
+            static_cast<uint64_t>(x) * src_width / dst_width * 3);
+    }
+
+    const size_t src_stride = static_cast<size_t>(src_width) * 3;
+    uint8_t* out = dst.data();
+    for (int y = 0; y < dst_height; ++y) {
+        const uint8_t* row = src + static_cast<uint64_t>(y) * src_height / dst_height * src_stride;
+        for (int x = 0; x < dst_width; ++x) {
+            std::memcpy(out, row + columns[x], 3);
+            out += 3;
+        }
+    }
+}
+
+/**
+ * Box-filtered luma (BT.601 weights) of packed RGB at a smaller size
+ *
+ * Every source pixel is added to exactly one output pixel, so the frame is
+ * read once, in order; the averaging also suppresses the aliasing a
+ * nearest-neighbour thumbnail would feed into sharpness or motion scores.
+ *
+ * @param dst Resized to dst_width * dst_height (dst_width <= src_width,
+ *            dst_height <= src_height)
+ */
+inline void lumaThumbnail(const uint8_t* src, int src_width, int src_height,
+                          std::vector<uint8_t>& dst, int dst_width, int dst_height) {
+    dst.resize(static_cast<size_t>(dst_width) * dst_height);
+
+    // Output column of every source column, and how many source columns each gets
+    std::vector<uint32_t> column_of(static_cast<size_t>(src_width));
+    std::vector<uint32_t> column_count(static_cast<size_t>(dst_width), 0);
+    for (int x = 0; x < src_width; ++x) {
+        column_of[x] = static_cast<uint32_t>(static_cast<uint64_t>(x) * dst_width / src_width);
+        ++column_count[column_of[x]];
+    }
+
+    const PixelKernels& kernels = pixelKernels();
+    std::vector<uint32_t> sums(static_cast<size_t>(dst_width));
+    std::vector<uint8_t> luma(static_cast<size_t>(src_width));
+    const size_t src_stride = static_cast<size_t>(src_width) * 3;
+    int src_y = 0;
+    for (int y = 0; y < dst_height; ++y) {
+        const int end_y = static_cast<int>(static_cast<uint64_t>(y + 1) * src_height / dst_height);
+        const uint32_t rows = static_cast<uint32_t>(end_y - src_y);
+        std::fill(sums.begin(), sums.end(), 0u);
+        for (; src_y < end_y; ++src_y) {
+            // Conversion vectorized per row; the column binning that follows is a cheap add
+            kernels.rgb_to_luma(src + static_cast<size_t>(src_y) * src_stride, luma.data(),
+                                static_cast<size_t>(src_width));
+            for (int x = 0; x < src_width; ++x) {
+                sums[column_of[x]] += luma[x];
+            }
+        }
+        uint8_t* out = dst.data() + static_cast<size_t>(y) * dst_width;
+        for (int x = 0; x < dst_width; ++x) {
+            out[x] = static_cast<uint8_t>(sums[x] / (column_count[x] * rows));
+        }
+    }
+}
+
+} // namespace robot_vision
@@ -0,0 +1,507 @@
+/**
+ * @file logger.cpp
+ * @brief Per-thread staging rings, writer thread and line formatting
+ */
+
+#include "logger.h"
+#include "thread_policy.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace robot_vision {
+
+namespace {
+
+constexpr uint64_t NS_PER_SECOND = 1000000000ull;
+
+uint64_t wallNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+const char* const LEVEL_NAMES[] = {"trace", "debug", "info", "warn", "error", "off"};
+const char* const LEVEL_TAGS[] = {"TRACE", "DEBUG", "INFO ", "WARN ", "ERROR", "OFF  "};
+
+/**
+ * Single-producer/single-consumer ring of log slots (one per thread)
+ *
+ * The owning thread writes at head_, the writer thread reads at tail_.
+ * Slots are fixed-size, so neither side ever allocates.
+ */
+struct LogRing {
+    explicit LogRing(size_t capacity) : slots(capacity) {}
+
+    std::vector<LogSlot> slots;
+    std::atomic<size_t> head{0};        // Next slot to write (producer)
+    std::atomic<size_t> tail{0};        // Next slot to read (consumer)
+    std::atomic<bool> retired{false};   // Owning thread exited
+    std::atomic<uint64_t> dropped{0};
+    std::string thread_name;
+};
+
+/**
+ * Thread-exit hook: marks the ring retired so the writer can free it
+ */
+struct RingHolder {
+    std::shared_ptr<LogRing> ring;
+    ~RingHolder() {
+        if (ring) {
+            ring->retired.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local RingHolder t_ring;
+
+/**
+ * Decode the arguments of a slot and expand "{}" placeholders
+ *
+ * "{:.1f}" style specs are printf conversions applied to floating-point
+ * arguments; other argument types ignore them.
+ */
+void formatMessage(const LogSlot& slot, std::string& out) {
+    size_t pos = 0;
+    auto nextArg = [&](std::string& dst, const std::string& spec) -> bool {
+        if (pos >= slot.used) {
+            return false;
+        }
+        char tag = slot.payload[pos++];
+        const char* p = slot.payload + pos;
+        char buf[64];
+        switch (tag) {
+            case 'b': dst += (*p ? "true" : "false"); pos += 1; break;
+            case 'c': dst += *p; pos += 1; break;
+            case 'i': { int64_t v; std::memcpy(&v, p, 8); pos += 8;
+                        std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(v)); dst += buf; break; }
+            case 'u': { uint64_t v; std::memcpy(&v, p, 8); pos += 8;
+                        std::snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(v)); dst += buf; break; }
+            case 'd': { double v; std::memcpy(&v, p, 8); pos += 8;
+                        std::string conv = spec.empty() ? "%g" : "%" + spec;
+                        std::snprintf(buf, sizeof(buf), conv.c_str(), v); dst += buf; break; }
+            case 'p': { uintptr_t v; std::memcpy(&v, p, sizeof(v)); pos += sizeof(v);
+                        std::snprintf(buf, sizeof(buf), "0x%llx", static_cast<unsigned long long>(v)); dst += buf; break; }
+            case 's': { uint16_t n; std::memcpy(&n, p, 2); dst.append(p + 2, n); pos += 2 + n; break; }
+            default: pos = slot.used; return false;
+        }
+        return true;
+    };
+
+    std::string spec;
+    for (const char* f = slot.format; *f; ++f) {
+        if (f[0] != '{' || (f[1] != '}' && f[1] != ':')) {
+            out += *f;
+            continue;
+        }
+        const char* close = std::strchr(f, '}');
+        if (!close) {
+            out += f;
+            break;
+        }
+        spec.assign(f[1] == ':' ? f + 2 : close, close);
+        // Only float conversions are passed to snprintf
+        if (!spec.empty() && std::strchr("fFeEgG", spec.back()) == nullptr) {
+            spec.clear();
+        }
+        if (!nextArg(out, spec)) {
+            out.append(f, close + 1);
+        }
+        f = close;
+    }
+}
+
+void appendJsonString(std::string& out, const std::string& s) {
+    out += '"';
+    for (char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+} // namespace
+
+bool parseLogLevel(const std::string& name, LogLevel& level) {
+    for (int i = 0; i <= static_cast<int>(LogLevel::Off); ++i) {
+        if (name == LEVEL_NAMES[i]) {
+            level = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* logLevelName(LogLevel level) {
+    return LEVEL_NAMES[static_cast<int>(level)];
+}
+
+// ============================================================================
+// Implementation State
+// ============================================================================
+
+struct Logger::Impl {
+    struct Line {
+        uint64_t time_ns;
+        uint64_t seq;
+        bool error_stream;
+        std::string text;
+    };
+
+    // Output settings (guarded by config_mutex; the writer copies them per batch)
+    std::mutex config_mutex;
+    std::string format = "text";
+    int file_fd = -1;
+
+    // Read on the hot path
+    std::atomic<int> rate_limit_per_s{20};
+    std::atomic<size_t> ring_slots{512};
+    std::atomic<bool> stopped{false};   // After shutdown(): drain synchronously
+
+    // Rings of every thread that has logged
+    std::mutex rings_mutex;
+    std::vector<std::shared_ptr<LogRing>> rings;
+
+    // Writer thread
+    std::mutex drain_mutex;             // One drain at a time (writer or flush())
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+    bool running = false;
+    std::thread thread;
+    std::atomic<uint64_t> dropped_total{0};
+
+    std::vector<Line> lines;
+    std::string out_buffer;
+
+    void drain();
+    void formatLine(const LogSlot& slot, const std::string& thread_name,
+                    const std::string& format, std::string& out);
+    void writerLoop();
+};
+
+void Logger::Impl::formatLine(const LogSlot& slot, const std::string& thread_name,
+                              const std::string& fmt, std::string& out) {
+    std::string message;
+    formatMessage(slot, message);
+    if (slot.suppressed > 0) {
+        message += " (" + std::to_string(slot.suppressed) + " similar suppressed)";
+    }
+    if (fmt == "plain") {
+        out = message;
+        return;
+    }
+
+    std::time_t secs = static_cast<std::time_t>(slot.time_ns / NS_PER_SECOND);
+    int ms = static_cast<int>((slot.time_ns / 1000000ull) % 1000);
+    std::tm tm{};
+    localtime_r(&secs, &tm);
+    char stamp[48];
+
+    const LogSite& site = *slot.site;
+    if (fmt == "json") {
+        std::snprintf(stamp, sizeof(stamp), "%04d-%02d-%02dT%02d:%02d:%02d.%03d",
+                      tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                      tm.tm_hour, tm.tm_min, tm.tm_sec, ms);
+        const char* file = std::strrchr(site.file, '/');
+        out = "{\"ts\":\"";
+        out += stamp;
+        out += "\",\"level\":\"";
+        out += logLevelName(site.level);
+        out += "\",\"component\":";
+        appendJsonString(out, site.component);
+        out += ",\"thread\":";
+        appendJsonString(out, thread_name);
+        out += ",\"src\":";
+        appendJsonString(out, std::string(file ? file + 1 : site.file) + ":" + std::to_string(site.line));
+        out += ",\"msg\":";
+        appendJsonString(out, message);
+        out += "}";
+    } else {
+        std::snprintf(stamp, sizeof(stamp), "%02d:%02d:%02d.%03d ",
+                      tm.tm_hour, tm.tm_min, tm.tm_sec, ms);
+        out = stamp;
+        out += LEVEL_TAGS[static_cast<int>(site.level)];
+        out += ' ';
+        out += site.component;
+        out += ": ";
+        out += message;
+    }
+}
+
+void Logger::Impl::drain() {
+    std::lock_guard<std::mutex> drain_lock(drain_mutex);
+
+    std::string fmt;
+    int fd;
+    {
+        std::lock_guard<std::mutex> lock(config_mutex);
+        fmt = format;
+        fd = file_fd;
+    }
+
+    std::vector<std::shared_ptr<LogRing>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex);
+        snapshot = rings;
+    }
+
+    lines.clear();
+    uint64_t seq = 0;
+    for (const auto& ring : snapshot) {
+        size_t tail = ring->tail.load(std::memory_order_relaxed);
+        size_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            const LogSlot& slot = ring->slots[tail % ring->slots.size()];
+            Line line{slot.time_ns, seq++, slot.site->level >= LogLevel::Warn, {}};
+            formatLine(slot, ring->thread_name, fmt, line.text);
+            lines.push_back(std::move(line));
+        }
+        ring->tail.store(tail, std::memory_order_release);
+
+        uint64_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            dropped_total.fetch_add(dropped, std::memory_order_relaxed);
+            lines.push_back(Line{wallNowNs(), seq++, true,
+                "log: " + std::to_string(dropped) + " lines dropped (ring full) on " + ring->thread_name});
+        }
+    }
+
+    // Release rings of threads that have exited, once empty
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex);
+        rings.erase(std::remove_if(rings.begin(), rings.end(), [](const std::shared_ptr<LogRing>& r) {
+            return r->retired.load(std::memory_order_acquire) &&
+                   r->tail.load(std::memory_order_relaxed) == r->head.load(std::memory_order_acquire);
+        }), rings.end());
+    }
+
+    if (lines.empty()) {
+        return;
+    }
+
+    // Interleave threads in time order (each ring is already ordered)
+    std::sort(lines.begin(), lines.end(), [](const Line& a, const Line& b) {
+        return a.time_ns != b.time_ns ? a.time_ns < b.time_ns : a.seq < b.seq;
+    });
+
+    // One write() per destination per batch
+    auto writeBatch = [&](int out_fd, bool errors) {
+        out_buffer.clear();
+        for (const auto& line : lines) {
+            if (out_fd == fd || line.error_stream == errors) {
+                out_buffer += line.text;
+                out_buffer += '\n';
+            }
+        }
+        size_t done = 0;
+        while (done < out_buffer.size()) {
+            ssize_t n = ::write(out_fd, out_buffer.data() + done, out_buffer.size() - done);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;  // Nowhere left to report it
+            }
+            done += static_cast<size_t>(n);
+        }
+    };
+    if (fd >= 0) {
+        writeBatch(fd, false);
+    } else {
+        writeBatch(STDOUT_FILENO, false);
+        writeBatch(STDERR_FILENO, true);
+    }
+}
+
+void Logger::Impl::writerLoop() {
+#ifdef PLATFORM_MACOS
+    pthread_setname_np("rv-log");
+#else
+    pthread_setname_np(pthread_self(), "rv-log");
+#endif
+    ScopedThreadRole thread_role("background");
+
+    std::unique_lock<std::mutex> lock(wake_mutex);
+    while (running) {
+        wake_cv.wait_for(lock, std::chrono::milliseconds(50));
+        lock.unlock();
+        drain();
+        lock.lock();
+    }
+}
+
+// ============================================================================
+// Logger
+// ============================================================================
+
+Logger& Logger::global() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : impl_(std::make_unique<Impl>())
+{
+    impl_->running = true;
+    impl_->thread = std::thread(&Impl::writerLoop, impl_.get());
+}
+
+Logger::~Logger() {
+    shutdown();
+    if (impl_->file_fd >= 0) {
+        ::close(impl_->file_fd);
+    }
+}
+
+bool Logger::configure(const LogConfig& config) {
+    LogLevel level;
+    if (!config.isValid() || !parseLogLevel(config.level, level)) {
+        return false;
+    }
+
+    int fd = -1;
+    if (!config.file.empty()) {
+        fd = ::open(config.file.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+    }
+
+    flush();    // Lines staged so far go to the old destination
+    int old_fd;
+    {
+        std::lock_guard<std::mutex> lock(impl_->config_mutex);
+        impl_->format = config.format;
+        old_fd = impl_->file_fd;
+        impl_->file_fd = fd;
+    }
+    if (old_fd >= 0) {
+        std::lock_guard<std::mutex> drain_lock(impl_->drain_mutex);
+        ::close(old_fd);
+    }
+    impl_->rate_limit_per_s.store(config.rate_limit_per_s, std::memory_order_relaxed);
+    impl_->ring_slots.store(config.ring_slots, std::memory_order_relaxed);  // New threads only
+    setLevel(level);
+    return true;
+}
+
+void Logger::flush() {
+    impl_->drain();
+}
+
+void Logger::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(impl_->wake_mutex);
+        if (!impl_->running) {
+            return;
+        }
+        impl_->running = false;
+        impl_->stopped.store(true);
+    }
+    impl_->wake_cv.notify_all();
+    if (impl_->thread.joinable()) {
+        impl_->thread.join();
+    }
+    impl_->drain();
+}
+
+uint64_t Logger::droppedCount() const {
+    return impl_->dropped_total.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Hot Path (calling thread)
+// ============================================================================
+
+LogSlot* Logger::beginRecord(LogSite& site, const char* format) {
+    uint64_t now = wallNowNs();
+
+    /**
+     * TEACHING: Per-Site Rate Limiting
+     * --------------------------------
+     * A message inside a 60 FPS loop (a reconnect warning, a detection
+     * line) can produce thousands of identical lines a minute. Each call
+     * site gets a budget per second; over-budget calls cost two atomic
+     * increments, and the next line that gets through reports how many
+     * were suppressed.
+     */
+    uint32_t suppressed = 0;
+    int limit = impl_->rate_limit_per_s.load(std::memory_order_relaxed);
+    if (limit > 0) {
+        uint64_t window = site.window_ns.load(std::memory_order_relaxed);
+        if (now - window >= NS_PER_SECOND &&
+            site.window_ns.compare_exchange_strong(window, now, std::memory_order_relaxed)) {
+            site.window_count.store(0, std::memory_order_relaxed);
+        }
+        if (site.window_count.fetch_add(1, std::memory_order_relaxed) >= static_cast<uint32_t>(limit)) {
+            site.suppressed.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+    }
+
+    LogRing* ring = t_ring.ring.get();
+    if (!ring) {
+        auto created = std::make_shared<LogRing>(impl_->ring_slots.load(std::memory_order_relaxed));
+        char name[32] = "main";
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        created->thread_name = name;
+        {
+            std::lock_guard<std::mutex> lock(impl_->rings_mutex);
+            impl_->rings.push_back(created);
+        }
+        t_ring.ring = created;
+        ring = created.get();
+    }
+
+    size_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= ring->slots.size()) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;     // Full: drop rather than block the caller
+    }
+
+    LogSlot& slot = ring->slots[head % ring->slots.size()];
+    slot.site = &site;
+    slot.format = format;
+    slot.time_ns = now;
+    slot.suppressed = suppressed;
+    slot.used = 0;
+    return &slot;
+}
+
+void Logger::commitRecord(LogLevel level) {
+    LogRing* ring = t_ring.ring.get();
+    size_t head = ring->head.load(std::memory_order_relaxed) + 1;
+    ring->head.store(head, std::memory_order_release);
+
+    if (impl_->stopped.load(std::memory_order_relaxed)) {
+        impl_->drain();     // Writer gone (shutdown): write synchronously
+    } else if (level >= LogLevel::Warn ||
+               head - ring->tail.load(std::memory_order_relaxed) >= ring->slots.size() / 2) {
+        impl_->wake_cv.notify_one();    // Get problems (and near-full rings) out promptly
+    }
+}
+
+} // namespace robot_vision
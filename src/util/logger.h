@@ -0,0 +1,261 @@
+#pragma once
+
+/**
+ * @file logger.h
+ * @brief Leveled, structured, asynchronous logger
+ *
+ *   RV_LOG_INFO("video", "Frame dimensions: {}x{}", width, height);
+ *   RV_LOG_ERROR("detect", "Connect failed: {}", error);
+ *   RV_LOG_INFO("app", "FPS {:.1f}", fps);      // printf spec for floats
+ *
+ * A log call checks the level (one relaxed atomic load), applies the
+ * call site's rate limit, and copies the format pointer and the raw
+ * arguments into a per-thread ring. That is all the calling thread does:
+ * no formatting, no locks, no I/O. A background thread drains every ring,
+ * formats the lines ("{}" placeholders, text or JSON) and writes each
+ * batch with one write() call.
+ *
+ * TEACHING: Why Printing Hurts a Frame Loop
+ * -----------------------------------------
+ * std::cout to a terminal is synchronous: the calling thread formats the
+ * text, takes the stream lock and blocks in write() until the terminal
+ * (or an SSH session, or a full pipe) accepts it. A burst of detections
+ * printed from the render thread can cost milliseconds - whole frames.
+ * Moving formatting and I/O to one writer thread bounds the cost at the
+ * call site to a few hundred nanoseconds, and a full ring drops messages
+ * (counted) instead of stalling the caller.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace robot_vision {
+
+/**
+ * Log severity, lowest first
+ */
+enum class LogLevel : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Off
+};
+
+bool parseLogLevel(const std::string& name, LogLevel& level);
+const char* logLevelName(LogLevel level);
+
+/**
+ * Logger configuration
+ */
+struct LogConfig {
+    std::string level = "info";     // trace | debug | info | warn | error | off
+    std::string format = "text";    // text | json | plain (message only)
+    std::string file = "";          // "" = stdout (warnings and errors to stderr)
+    int rate_limit_per_s = 20;      // Lines per call site per second (0 = unlimited)
+    size_t ring_slots = 512;        // Per-thread staging ring size
+
+    bool isValid() const {
+        LogLevel l;
+        return parseLogLevel(level, l) &&
+               (format == "text" || format == "json" || format == "plain") &&
+               rate_limit_per_s >= 0 && ring_slots >= 16 && ring_slots <= 65536;
+    }
+};
+
+/**
+ * Static data for one RV_LOG_* statement (rate limit state lives here)
+ */
+struct LogSite {
+    LogLevel level;
+    const char* component;
+    const char* file;
+    int line;
+
+    std::atomic<uint64_t> window_ns{0};     // Start of the current 1 s window
+    std::atomic<uint32_t> window_count{0};  // Lines emitted in the window
+    std::atomic<uint32_t> suppressed{0};    // Lines dropped by the rate limit
+};
+
+// ============================================================================
+// Staging Record
+// ============================================================================
+
+constexpr size_t LOG_SLOT_PAYLOAD = 200;
+
+/**
+ * One staged log call: format pointer plus encoded arguments
+ *
+ * Arguments are stored as a tag byte followed by the value; strings are
+ * copied (truncated to fit), because the caller's buffer will be gone by
+ * the time the writer formats the line.
+ */
+struct LogSlot {
+    const LogSite* site;
+    const char* format;             // Must be a string literal
+    uint64_t time_ns;               // Wall clock (Unix ns)
+    uint32_t suppressed;            // Rate-limited lines since the last one from this site
+    uint16_t used;                  // Payload bytes
+    char payload[LOG_SLOT_PAYLOAD];
+};
+
+/**
+ * Argument encoder (calling thread)
+ */
+class LogArgWriter {
+public:
+    explicit LogArgWriter(LogSlot& slot) : slot_(slot) {}
+
+    void put(bool v) { putTagged('b', static_cast<uint8_t>(v)); }
+    void put(char v) { putTagged('c', v); }
+    void put(double v) { putTagged('d', v); }
+    void put(float v) { putTagged('d', static_cast<double>(v)); }
+    void put(const char* v) { putString(v ? v : "(null)", v ? std::strlen(v) : 6); }
+    void put(const std::string& v) { putString(v.data(), v.size()); }
+    void put(const void* v) { putTagged('p', reinterpret_cast<uintptr_t>(v)); }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+    put(T v) { putTagged('i', static_cast<int64_t>(v)); }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type
+    put(T v) { putTagged('u', static_cast<uint64_t>(v)); }
+
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type
+    put(T v) { putTagged('i', static_cast<int64_t>(v)); }
+
+private:
+    template <typename T>
+    void putTagged(char tag, const T& value) {
+        if (slot_.used + 1 + sizeof(T) > LOG_SLOT_PAYLOAD) {
+            return;     // Out of room: placeholder prints as "{}"
+        }
+        slot_.payload[slot_.used++] = tag;
+        std::memcpy(slot_.payload + slot_.used, &value, sizeof(T));
+        slot_.used += sizeof(T);
+    }
+
+    void putString(const char* s, size_t n) {
+        size_t room = LOG_SLOT_PAYLOAD - slot_.used;
+        if (room < 4) {
+            return;
+        }
+        if (n > room - 3) {
+            n = room - 3;
+        }
+        uint16_t len = static_cast<uint16_t>(n);
+        slot_.payload[slot_.used++] = 's';
+        std::memcpy(slot_.payload + slot_.used, &len, 2);
+        std::memcpy(slot_.payload + slot_.used + 2, s, n);
+        slot_.used += 2 + len;
+    }
+
+    LogSlot& slot_;
+};
+
+// ============================================================================
+// Logger
+// ============================================================================
+
+class Logger {
+public:
+    /**
+     * Process-wide logger (writer thread starts on first use)
+     */
+    static Logger& global();
+
+    ~Logger();
+
+    // Non-copyable (owns the writer thread)
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * Apply level, format, output file and limits (any thread)
+     */
+    bool configure(const LogConfig& config);
+
+    /**
+     * Change only the level (live reload)
+     */
+    static void setLevel(LogLevel level) {
+        min_level_.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+    }
+
+    static bool enabled(LogLevel level) {
+        return static_cast<uint8_t>(level) >= min_level_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Stage one line (call through the RV_LOG_* macros)
+     */
+    template <typename... Args>
+    void log(LogSite& site, const char* format, const Args&... args) {
+        LogSlot* slot = beginRecord(site, format);
+        if (!slot) {
+            return;
+        }
+        LogArgWriter writer(*slot);
+        (void)writer;
+        (writer.put(args), ...);
+        commitRecord(site.level);
+    }
+
+    /**
+     * Write everything staged so far before returning (any thread)
+     */
+    void flush();
+
+    /**
+     * Flush and stop the writer thread; later lines are written synchronously
+     */
+    void shutdown();
+
+    /**
+     * Lines lost because a thread's ring was full
+     */
+    uint64_t droppedCount() const;
+
+private:
+    Logger();
+
+    LogSlot* beginRecord(LogSite& site, const char* format);
+    void commitRecord(LogLevel level);
+
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+
+    inline static std::atomic<uint8_t> min_level_{static_cast<uint8_t>(LogLevel::Info)};
+};
+
+} // namespace robot_vision
+
+// ============================================================================
+// Macros
+// ============================================================================
+
+/**
+ * Log at a level: RV_LOG(LogLevel::Info, "component", "format {}", args...)
+ *
+ * Arguments are not evaluated when the level is disabled.
+ */
+#define RV_LOG(lvl, component, ...)                                                   \
+    do {                                                                              \
+        if (::robot_vision::Logger::enabled(lvl)) {                                   \
+            static ::robot_vision::LogSite rv_log_site_{lvl, component, __FILE__, __LINE__}; \
+            ::robot_vision::Logger::global().log(rv_log_site_, __VA_ARGS__);          \
+        }                                                                             \
+    } while (0)
+
+#define RV_LOG_TRACE(component, ...) RV_LOG(::robot_vision::LogLevel::Trace, component, __VA_ARGS__)
+#define RV_LOG_DEBUG(component, ...) RV_LOG(::robot_vision::LogLevel::Debug, component, __VA_ARGS__)
+#define RV_LOG_INFO(component, ...)  RV_LOG(::robot_vision::LogLevel::Info, component, __VA_ARGS__)
+#define RV_LOG_WARN(component, ...)  RV_LOG(::robot_vision::LogLevel::Warn, component, __VA_ARGS__)
+#define RV_LOG_ERROR(component, ...) RV_LOG(::robot_vision::LogLevel::Error, component, __VA_ARGS__)
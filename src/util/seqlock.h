@@ -0,0 +1,101 @@
+#pragma once
+
+/**
+ * @file seqlock.h
+ * @brief Single-writer latest-value store with wait-free bounded reads
+ *
+ * TEACHING: Sequence Locks
+ * ------------------------
+ * The writer bumps a sequence number to odd, writes the value, and bumps
+ * it to even again. A reader copies the value between two reads of the
+ * sequence; if both reads are equal and even, nobody wrote in between
+ * and the copy is consistent. Readers never write shared memory, so any
+ * number of them cost the writer nothing - unlike a mutex, a slow reader
+ * cannot delay an update, and the writer never waits.
+ *
+ * A plain seqlock reader retries until it wins, which is lock-free but
+ * not wait-free. Here read() gives up after a few attempts and reports
+ * failure, so the caller (the render loop) keeps the previous value for
+ * one frame instead of spinning: its cost is bounded whatever the writer
+ * does.
+ *
+ * The value is stored as relaxed atomic words rather than a plain struct,
+ * so the torn copies a reader discards are not data races either.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace robot_vision {
+
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock values are copied bytewise");
+
+public:
+    SeqLock() {
+        store(T{});
+    }
+
+    // Non-copyable (shared between threads by reference)
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * Publish a new value (one writer thread only)
+     */
+    void store(const T& value) {
+        std::array<uint64_t, WORDS> words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * Copy the latest value (any thread, wait-free)
+     *
+     * @return false if every attempt overlapped a write; out is unchanged
+     */
+    bool read(T& out, int max_attempts = 4) const {
+        std::array<uint64_t, WORDS> words;
+        for (int attempt = 0; attempt < max_attempts; ++attempt) {
+            uint64_t before = seq_.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;   // Write in progress
+            }
+            for (size_t i = 0; i < WORDS; ++i) {
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == before) {
+                std::memcpy(static_cast<void*>(&out), words.data(), sizeof(T));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Number of completed writes (changes whenever the value does)
+     */
+    uint64_t version() const {
+        return seq_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> seq_{0};
+    std::array<std::atomic<uint64_t>, WORDS> words_{};
+};
+
+} // namespace robot_vision
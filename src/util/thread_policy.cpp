@@ -0,0 +1,424 @@
+/**
+ * @file thread_policy.cpp
+ * @brief Thread role registry: affinity, scheduling class, run-queue latency
+ */
+
+#include "thread_policy.h"
+#include "metrics/metrics.h"
+#include "util/logger.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#ifndef PLATFORM_MACOS
+#include <sys/syscall.h>
+#endif
+
+namespace robot_vision {
+
+namespace {
+
+/**
+ * Parse "0,2-3" into a CPU list
+ */
+bool parseCpuList(const std::string& text, std::vector<int>& cpus) {
+    cpus.clear();
+    std::stringstream in(text);
+    std::string part;
+    while (std::getline(in, part, ',')) {
+        size_t dash = part.find('-');
+        try {
+            int first = std::stoi(part.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(part.substr(dash + 1));
+            if (first < 0 || last < first || last >= 1024) {
+                return false;
+            }
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return !cpus.empty();
+}
+
+uint64_t currentTid() {
+#ifdef PLATFORM_MACOS
+    uint64_t tid = 0;
+    pthread_threadid_np(nullptr, &tid);
+    return tid;
+#else
+    return static_cast<uint64_t>(::syscall(SYS_gettid));
+#endif
+}
+
+std::string currentThreadName() {
+    char name[16] = {};
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+    return name[0] ? name : "unnamed";
+}
+
+/**
+ * Total run-queue wait and number of timeslices (false if unavailable)
+ */
+bool readSchedstat(uint64_t tid, uint64_t& wait_ns, uint64_t& slices) {
+#ifdef PLATFORM_MACOS
+    (void)tid;
+    (void)wait_ns;
+    (void)slices;
+    return false;
+#else
+    std::ifstream in("/proc/self/task/" + std::to_string(tid) + "/schedstat");
+    uint64_t run_ns = 0;
+    return static_cast<bool>(in >> run_ns >> wait_ns >> slices);
+#endif
+}
+
+} // namespace
+
+// ============================================================================
+// ThreadPolicy
+// ============================================================================
+
+std::string ThreadPolicy::describe() const {
+    if (isDefault()) {
+        return "inherit";
+    }
+    std::string out;
+    if (!cpus.empty()) {
+        out += "cpus=";
+        for (size_t i = 0; i < cpus.size(); ++i) {
+            out += (i ? "," : "") + std::to_string(cpus[i]);
+        }
+    }
+    if (!sched.empty()) {
+        out += (out.empty() ? "" : " ") + sched;
+        if (sched != "other") {
+            out += "/" + std::to_string(priority);
+        }
+    }
+    if (nice != 0) {
+        out += (out.empty() ? "" : " ") + std::string("nice=") + std::to_string(nice);
+    }
+    return out;
+}
+
+bool parseThreadPolicy(const std::string& text, ThreadPolicy& policy, std::string& error) {
+    policy = ThreadPolicy{};
+    std::stringstream in(text);
+    std::string token;
+    while (in >> token) {
+        size_t eq = token.find('=');
+        if (eq == std::string::npos) {
+            error = "expected key=value, got '" + token + "'";
+            return false;
+        }
+        std::string key = token.substr(0, eq);
+        std::string value = token.substr(eq + 1);
+        try {
+            if (key == "cpus") {
+                if (!parseCpuList(value, policy.cpus)) {
+                    error = "bad CPU list '" + value + "' (e.g. 0,2-3)";
+                    return false;
+                }
+            } else if (key == "sched") {
+                if (value != "other" && value != "fifo" && value != "rr") {
+                    error = "sched must be other, fifo or rr";
+                    return false;
+                }
+                policy.sched = value;
+            } else if (key == "priority") {
+                policy.priority = std::stoi(value);
+            } else if (key == "nice") {
+                policy.nice = std::stoi(value);
+            } else {
+                error = "unknown key '" + key + "' (cpus, sched, priority, nice)";
+                return false;
+            }
+        } catch (const std::exception&) {
+            error = "bad number in '" + token + "'";
+            return false;
+        }
+    }
+
+    bool realtime = policy.sched == "fifo" || policy.sched == "rr";
+    if (realtime && (policy.priority < 1 || policy.priority > 99)) {
+        error = "fifo/rr priority must be 1..99";
+        return false;
+    }
+    if (!realtime && policy.priority != 0) {
+        error = "priority needs sched=fifo or sched=rr (use nice for sched=other)";
+        return false;
+    }
+    if (policy.nice < -20 || policy.nice > 19) {
+        error = "nice must be -20..19";
+        return false;
+    }
+    if (realtime && policy.nice != 0) {
+        error = "nice has no effect with sched=fifo/rr";
+        return false;
+    }
+    return true;
+}
+
+const std::string* ThreadPolicyConfig::find(const std::string& role) const {
+    if (role == "render") return &render;
+    if (role == "capture") return &capture;
+    if (role == "detect") return &detect;
+    if (role == "record") return &record;
+    if (role == "gst") return &gst;
+    if (role == "background") return &background;
+    return nullptr;
+}
+
+// ============================================================================
+// ThreadRegistry
+// ============================================================================
+
+struct ThreadRegistry::Impl {
+    struct Entry {
+        int id;
+        uint64_t tid;
+        pthread_t handle;
+        std::string name;
+        std::string role;
+        uint64_t base_wait_ns = 0;      // At registration
+        uint64_t base_slices = 0;
+        uint64_t last_wait_ns = 0;      // At the previous export
+        uint64_t last_slices = 0;
+        Gauge* latency = nullptr;
+    };
+
+    std::mutex mutex;
+    ThreadPolicyConfig config;
+    std::vector<Entry> entries;
+    int next_id = 1;
+    bool collecting = false;
+
+    ThreadPolicy policyFor(const std::string& role) const {
+        ThreadPolicy policy;
+        std::string error;
+        const std::string* text = config.find(role);
+        if (text) {
+            parseThreadPolicy(*text, policy, error);   // Validated with the config
+        }
+        return policy;
+    }
+
+    /**
+     * Apply a policy to a thread (any thread on Linux)
+     *
+     * @return Problems, one per failed setting (empty = all applied)
+     */
+    static std::vector<std::string> apply(const Entry& entry, const ThreadPolicy& policy);
+
+    void collect();
+};
+
+std::vector<std::string> ThreadRegistry::Impl::apply(const Entry& entry, const ThreadPolicy& policy) {
+    std::vector<std::string> problems;
+
+    if (!policy.cpus.empty()) {
+#ifdef PLATFORM_MACOS
+        problems.push_back("CPU affinity is not supported on macOS");
+#else
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : policy.cpus) {
+            CPU_SET(cpu, &set);
+        }
+        if (sched_setaffinity(static_cast<pid_t>(entry.tid), sizeof(set), &set) != 0) {
+            problems.push_back(std::string("affinity: ") + std::strerror(errno));
+        }
+#endif
+    }
+
+    if (!policy.sched.empty()) {
+        int kind = policy.sched == "fifo" ? SCHED_FIFO : policy.sched == "rr" ? SCHED_RR : SCHED_OTHER;
+        sched_param param{};
+        param.sched_priority = policy.priority;
+        int rc = pthread_setschedparam(entry.handle, kind, &param);
+        if (rc != 0) {
+            problems.push_back(std::string("sched ") + policy.sched + ": " + std::strerror(rc) +
+                               (rc == EPERM ? " (needs CAP_SYS_NICE or an rtprio limit)" : ""));
+        }
+    }
+
+    if (policy.nice != 0) {
+#ifdef PLATFORM_MACOS
+        problems.push_back("per-thread nice is not supported on macOS");
+#else
+        // Linux: nice is per thread (PRIO_PROCESS with a TID)
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(entry.tid), policy.nice) != 0) {
+            problems.push_back(std::string("nice: ") + std::strerror(errno));
+        }
+#endif
+    }
+    return problems;
+}
+
+void ThreadRegistry::Impl::collect() {
+    // Threads with the same name and role share a series: pool the deltas
+    std::map<Gauge*, std::pair<uint64_t, uint64_t>> totals;     // wait ns, slices
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : entries) {
+        uint64_t wait_ns = 0;
+        uint64_t slices = 0;
+        if (!readSchedstat(entry.tid, wait_ns, slices)) {
+            continue;
+        }
+        auto& total = totals[entry.latency];
+        if (slices > entry.last_slices) {
+            total.first += wait_ns - entry.last_wait_ns;
+            total.second += slices - entry.last_slices;
+        }
+        entry.last_wait_ns = wait_ns;
+        entry.last_slices = slices;
+    }
+    for (const auto& kv : totals) {
+        if (kv.second.second > 0) {
+            kv.first->set(static_cast<double>(kv.second.first) /
+                          static_cast<double>(kv.second.second) / 1e9);
+        }
+    }
+}
+
+ThreadRegistry& ThreadRegistry::global() {
+    // Never destroyed: threads joined during static destruction (the
+    // logger's writer) still leave() on their way out
+    static ThreadRegistry* registry = new ThreadRegistry();
+    return *registry;
+}
+
+ThreadRegistry::ThreadRegistry()
+    : impl_(std::make_unique<Impl>())
+{
+}
+
+ThreadRegistry::~ThreadRegistry() = default;
+
+void ThreadRegistry::configure(const ThreadPolicyConfig& config) {
+    std::vector<std::pair<std::string, std::vector<std::string>>> failures;
+    bool start_collecting = false;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->config = config;
+        for (const auto& entry : impl_->entries) {
+            auto problems = Impl::apply(entry, impl_->policyFor(entry.role));
+            if (!problems.empty()) {
+                failures.emplace_back(entry.name, std::move(problems));
+            }
+        }
+        start_collecting = !impl_->collecting;
+        impl_->collecting = true;
+    }
+
+    for (const auto& failure : failures) {
+        for (const auto& problem : failure.second) {
+            RV_LOG_WARN("threads", "{}: {}", failure.first, problem);
+        }
+    }
+    if (start_collecting) {
+        Impl* impl = impl_.get();
+        MetricsRegistry::global().addCollector([impl]() { impl->collect(); });
+    }
+}
+
+int ThreadRegistry::enter(const std::string& role) {
+    Impl::Entry entry;
+    entry.tid = currentTid();
+    entry.handle = pthread_self();
+    entry.name = currentThreadName();
+    entry.role = role;
+    readSchedstat(entry.tid, entry.base_wait_ns, entry.base_slices);
+    entry.last_wait_ns = entry.base_wait_ns;
+    entry.last_slices = entry.base_slices;
+    // No tid label: series outlive their threads, and restarted pools and
+    // GStreamer tasks come back under the same name
+    entry.latency = &MetricsRegistry::global().gauge(
+        "rv_thread_sched_latency_seconds",
+        "Mean run-queue wait per timeslice since the last export",
+        "thread=\"" + entry.name + "\",role=\"" + role + "\"");
+
+    std::vector<std::string> problems;
+    ThreadPolicy policy;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        entry.id = impl_->next_id++;
+        policy = impl_->policyFor(role);
+        problems = Impl::apply(entry, policy);
+        impl_->entries.push_back(entry);
+    }
+
+    for (const auto& problem : problems) {
+        RV_LOG_WARN("threads", "{}: {}", entry.name, problem);
+    }
+    if (!policy.isDefault() && problems.empty()) {
+        RV_LOG_DEBUG("threads", "{} ({}): {}", entry.name, role, policy.describe());
+    }
+    return entry.id;
+}
+
+void ThreadRegistry::leave(int id) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto& entries = impl_->entries;
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (it->id == id) {
+            Gauge* latency = it->latency;
+            entries.erase(it);
+            // Nobody left in the series: show idle rather than the last reading
+            if (std::none_of(entries.begin(), entries.end(),
+                             [latency](const Impl::Entry& e) { return e.latency == latency; })) {
+                latency->set(0.0);
+            }
+            return;
+        }
+    }
+}
+
+void ThreadRegistry::logSummary() {
+    struct Line {
+        std::string name;
+        std::string role;
+        std::string policy;
+        double latency_ms;
+        uint64_t slices;
+    };
+    std::vector<Line> lines;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        for (const auto& entry : impl_->entries) {
+            uint64_t wait_ns = 0;
+            uint64_t slices = 0;
+            if (!readSchedstat(entry.tid, wait_ns, slices) || slices <= entry.base_slices) {
+                continue;
+            }
+            slices -= entry.base_slices;
+            lines.push_back(Line{entry.name, entry.role, impl_->policyFor(entry.role).describe(),
+                                 static_cast<double>(wait_ns - entry.base_wait_ns) /
+                                     static_cast<double>(slices) / 1e6,
+                                 slices});
+        }
+    }
+    if (lines.empty()) {
+        return;
+    }
+    RV_LOG_INFO("threads", "Scheduling latency (mean run-queue wait per timeslice):");
+    for (const auto& line : lines) {
+        RV_LOG_INFO("threads", "  {} [{}, {}]: {:.3f} ms over {} slices", line.name, line.role,
+                    line.policy, line.latency_ms, line.slices);
+    }
+}
+
+} // namespace robot_vision
@@ -0,0 +1,151 @@
+#pragma once
+
+/**
+ * @file thread_policy.h
+ * @brief CPU affinity, scheduling class and nice level per thread role
+ *
+ * Every thread the app creates tags itself with a role when it starts:
+ *
+ *   void StagedPipeline::captureLoop() {
+ *       setThreadName("rv-capture");
+ *       ScopedThreadRole role("capture");
+ *       ...
+ *   }
+ *
+ * and gets the policy configured for that role, e.g.
+ *
+ *   --threads.capture="cpus=2 sched=fifo priority=40"
+ *   --threads.background="cpus=0 nice=10"
+ *
+ * GStreamer's streaming threads are tagged "gst" from the pipeline's
+ * stream-status bus messages. Roles with no policy inherit the process
+ * defaults, so an empty [threads] section changes nothing.
+ *
+ * TEACHING: Run-Queue Delay
+ * -------------------------
+ * The kernel keeps, per thread, the total time it was runnable but waiting
+ * for a CPU (/proc/self/task/TID/schedstat, second field) and how many
+ * times it got one. Their ratio is the thread's average scheduling latency
+ * - exactly what pinning and SCHED_FIFO are supposed to shrink. It is
+ * exported per thread name and role as rv_thread_sched_latency_seconds, so a
+ * policy change can be judged by numbers, not by feel.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * Policy for one thread role
+ */
+struct ThreadPolicy {
+    std::vector<int> cpus;              // Allowed CPUs (empty = inherit)
+    std::string sched = "";             // "" (inherit) | other | fifo | rr
+    int priority = 0;                   // fifo/rr: 1..99
+    int nice = 0;                       // other: -20..19 (0 = leave alone)
+
+    bool isDefault() const { return cpus.empty() && sched.empty() && nice == 0; }
+    std::string describe() const;
+};
+
+/**
+ * Parse "cpus=0,2-3 sched=fifo priority=40 nice=-5" (all keys optional)
+ *
+ * @return false (and error) on an unknown key or an out-of-range value
+ */
+bool parseThreadPolicy(const std::string& text, ThreadPolicy& policy, std::string& error);
+
+/**
+ * Thread policy configuration: one policy string per role
+ */
+struct ThreadPolicyConfig {
+    std::string render = "";            // Main thread (render or headless loop)
+    std::string capture = "";           // rv-capture
+    std::string detect = "";            // rv-det-submit, rv-det-ingest
+    std::string record = "";            // rv-record
+    std::string gst = "";               // GStreamer streaming threads
+    std::string background = "";        // Logger, writers, metrics, governor
+
+    /**
+     * Policy string for a role name (nullptr if the role is unknown)
+     */
+    const std::string* find(const std::string& role) const;
+
+    bool isValid() const {
+        ThreadPolicy policy;
+        std::string error;
+        for (const auto* text : {&render, &capture, &detect, &record, &gst, &background}) {
+            if (!parseThreadPolicy(*text, policy, error)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * Process-wide table of tagged threads
+ *
+ * Thread-safe. Threads tagged before configure() (e.g. the logger) get
+ * their policy when configure() runs.
+ */
+class ThreadRegistry {
+public:
+    static ThreadRegistry& global();
+
+    ThreadRegistry();
+    ~ThreadRegistry();
+
+    // Non-copyable (process-wide)
+    ThreadRegistry(const ThreadRegistry&) = delete;
+    ThreadRegistry& operator=(const ThreadRegistry&) = delete;
+
+    /**
+     * Set the per-role policies and apply them to every registered thread
+     *
+     * Also starts exporting per-thread scheduling latency.
+     */
+    void configure(const ThreadPolicyConfig& config);
+
+    /**
+     * Tag the calling thread with a role and apply its policy
+     *
+     * @return Registration id for leave()
+     */
+    int enter(const std::string& role);
+
+    /**
+     * Forget a thread (call on the thread's way out)
+     */
+    void leave(int id);
+
+    /**
+     * Log each registered thread's policy and scheduling latency so far
+     */
+    void logSummary();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * Tags the current thread for its lifetime
+ */
+class ScopedThreadRole {
+public:
+    explicit ScopedThreadRole(const std::string& role)
+        : id_(ThreadRegistry::global().enter(role)) {}
+    ~ScopedThreadRole() { ThreadRegistry::global().leave(id_); }
+
+    ScopedThreadRole(const ScopedThreadRole&) = delete;
+    ScopedThreadRole& operator=(const ScopedThreadRole&) = delete;
+
+private:
+    int id_;
+};
+
+} // namespace robot_vision
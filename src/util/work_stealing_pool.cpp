@@ -0,0 +1,133 @@
+/**
+ * @file work_stealing_pool.cpp
+ * @brief Worker loop, stealing and sleep/wake
+ */
+
+#include "work_stealing_pool.h"
+#include "util/thread_policy.h"
+
+#include <pthread.h>
+
+#include <algorithm>
+
+namespace robot_vision {
+
+namespace {
+
+// Per-worker queue capacity; tasks beyond it run on the submitting thread
+constexpr size_t QUEUE_CAPACITY = 256;
+
+// Which pool and worker the current thread is (submit() pushes locally)
+thread_local const WorkStealingPool* tls_pool = nullptr;
+thread_local size_t tls_worker = 0;
+
+void setThreadName(const std::string& name) {
+#ifdef PLATFORM_MACOS
+    pthread_setname_np(name.c_str());
+#else
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#endif
+}
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(int threads, std::string name, std::string role)
+    : name_(std::move(name))
+    , role_(std::move(role))
+{
+    for (int i = 0; i < std::max(1, threads); ++i) {
+        workers_.push_back(std::make_unique<Worker>(QUEUE_CAPACITY));
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    stop();
+}
+
+void WorkStealingPool::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        workers_[i]->thread = std::thread(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+void WorkStealingPool::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    sleep_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    Task discarded;
+    for (auto& worker : workers_) {
+        while (worker->tasks.tryPop(discarded)) {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    const size_t count = workers_.size();
+    const size_t first = tls_pool == this ? tls_worker
+                                          : next_queue_.fetch_add(1, std::memory_order_relaxed) % count;
+    bool queued = false;
+    for (size_t n = 0; n < count && !queued; ++n) {
+        queued = workers_[(first + n) % count]->tasks.tryPush(std::move(task));
+    }
+    if (!queued) {
+        task();     // Every queue full: run it here rather than drop it
+        return;
+    }
+
+    // Count before the wake-up so a worker checking queued_ under the lock can't miss it
+    queued_.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    sleep_cv_.notify_one();
+}
+
+bool WorkStealingPool::findTask(size_t index, Task& task) {
+    if (workers_[index]->tasks.tryPop(task)) {
+        return true;
+    }
+    for (size_t n = 1; n < workers_.size(); ++n) {
+        if (workers_[(index + n) % workers_.size()]->tasks.tryPop(task)) {
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(size_t index) {
+    setThreadName(name_ + "-" + std::to_string(index));
+    ScopedThreadRole thread_role(role_);
+    tls_pool = this;
+    tls_worker = index;
+
+    Task task;
+    while (running_.load(std::memory_order_relaxed)) {
+        if (findTask(index, task)) {
+            queued_.fetch_sub(1, std::memory_order_acq_rel);
+            task();
+            task = nullptr;     // Release captures before sleeping
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.wait(lock, [this] {
+            return queued_.load(std::memory_order_acquire) > 0 || !running_.load(std::memory_order_relaxed);
+        });
+    }
+    tls_pool = nullptr;
+}
+
+} // namespace robot_vision
@@ -0,0 +1,102 @@
+#pragma once
+
+/**
+ * @file work_stealing_pool.h
+ * @brief Fixed thread pool where idle workers take queued tasks from busy ones
+ *
+ *   WorkStealingPool pool(3, "rv-proc", "background");
+ *   pool.start();
+ *   pool.submit([] { ... });        // From any thread, including a task
+ *   pool.stop();
+ *
+ * TEACHING: Work Stealing
+ * -----------------------
+ * With one shared queue, every worker contends on the same head and tail
+ * for every task. Here each worker has its own queue: a task submitted
+ * from a worker goes to that worker's queue (its inputs are likely still
+ * in that core's cache), and a worker with nothing of its own takes work
+ * from a neighbour's queue instead of sleeping. Work spreads out only
+ * when there is idle capacity to absorb it.
+ *
+ * The per-worker queues are the lock-free BoundedQueue, so both the owner
+ * and thieves pop without a mutex. Sleeping uses one condition variable,
+ * touched only when a worker actually runs out of work.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/bounded_queue.h"
+
+namespace robot_vision {
+
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @param threads Worker count (>= 1)
+     * @param name Thread name prefix ("rv-proc" -> rv-proc-0, rv-proc-1, ...)
+     * @param role Thread policy role the workers tag themselves with
+     */
+    WorkStealingPool(int threads, std::string name, std::string role);
+    ~WorkStealingPool();
+
+    // Non-copyable (owns threads)
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void start();
+
+    /**
+     * Join the workers (idempotent); tasks still queued are discarded
+     */
+    void stop();
+
+    /**
+     * Queue a task (never blocks)
+     *
+     * From a worker of this pool the task goes to that worker's own
+     * queue; from any other thread, queues are filled round-robin. If
+     * every queue is full the task runs on the calling thread.
+     */
+    void submit(Task task);
+
+    int size() const { return static_cast<int>(workers_.size()); }
+
+    /**
+     * Tasks a worker took from another worker's queue
+     */
+    uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct Worker {
+        explicit Worker(size_t capacity) : tasks(capacity) {}
+
+        BoundedQueue<Task> tasks;
+        std::thread thread;
+    };
+
+    void workerLoop(size_t index);
+    bool findTask(size_t index, Task& task);
+
+    std::string name_;
+    std::string role_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> next_queue_{0};
+    std::atomic<int64_t> queued_{0};        // Tasks in all queues (sleep/wake decision)
+    std::atomic<uint64_t> steals_{0};
+
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+};
+
+} // namespace robot_vision
@@ -0,0 +1,462 @@
+/**
+ * @file camera_prober.cpp
+ * @brief GstDeviceMonitor probing and the mode cost model
+ */
+
+#include "camera_prober.h"
+#include "util/logger.h"
+
+#include <gst/gst.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace robot_vision {
+
+namespace {
+
+/**
+ * What it takes to turn one pixel of a native format into packed RGB
+ */
+struct FormatInfo {
+    const char* name;
+    double bytes_per_pixel;     // On the bus (MJPEG: a typical compressed size)
+    double convert_cost;        // videoconvert work per pixel, YUV -> RGB = 1
+    const char* conversion;     // For the log
+};
+
+constexpr FormatInfo FORMATS[] = {
+    {"RGB", 3.0, 0.0, "native RGB, no conversion"},
+    {"BGR", 3.0, 0.25, "channel swizzle to RGB"},
+    {"RGBx", 4.0, 0.25, "channel swizzle to RGB"},
+    {"BGRx", 4.0, 0.25, "channel swizzle to RGB"},
+    {"xRGB", 4.0, 0.25, "channel swizzle to RGB"},
+    {"xBGR", 4.0, 0.25, "channel swizzle to RGB"},
+    {"RGBA", 4.0, 0.25, "channel swizzle to RGB"},
+    {"BGRA", 4.0, 0.25, "channel swizzle to RGB"},
+    {"ARGB", 4.0, 0.25, "channel swizzle to RGB"},
+    {"ABGR", 4.0, 0.25, "channel swizzle to RGB"},
+    {"YUY2", 2.0, 1.0, "YUV 4:2:2 to RGB"},
+    {"UYVY", 2.0, 1.0, "YUV 4:2:2 to RGB"},
+    {"YVYU", 2.0, 1.0, "YUV 4:2:2 to RGB"},
+    {"NV12", 1.5, 1.0, "YUV 4:2:0 to RGB"},
+    {"NV21", 1.5, 1.0, "YUV 4:2:0 to RGB"},
+    {"I420", 1.5, 1.0, "YUV 4:2:0 to RGB"},
+    {"YV12", 1.5, 1.0, "YUV 4:2:0 to RGB"},
+    {"GRAY8", 1.0, 0.5, "greyscale to RGB (no colour)"},
+    {"MJPG", 0.3, 1.0, "JPEG decode, then YUV to RGB"},
+};
+
+/**
+ * TEACHING: A Cost Model in Pixel-Equivalents
+ * -------------------------------------------
+ * The weights are rough ratios of single-core throughput, not timings:
+ * libjpeg-turbo decodes a few hundred Mpx/s where videoconvert does
+ * YUYV -> RGB at about four times that, and a bilinear videoscale pass
+ * costs most of a conversion. They only have to order the modes a camera
+ * offers, and for that the ratios are what matter.
+ */
+constexpr double JPEG_DECODE_COST = 4.0;        // CPU (jpegdec) per source pixel
+constexpr double JPEG_DECODE_COST_HW = 0.3;     // Hardware decoder: the copy out
+constexpr double SCALE_COST = 0.75;             // videoscale per pixel (larger side)
+constexpr double ASPECT_COST = 0.5;             // Letterboxing into another aspect ratio
+constexpr double BUS_COST_PER_BYTE = 0.05;      // DMA and cache traffic, frames dropped or not
+constexpr double RATE_TOLERANCE = 0.98;         // 30000/1001 delivers "30 fps"
+
+// Candidate sizes and rates inside a continuous (stepwise) range
+constexpr std::pair<int, int> COMMON_SIZES[] = {
+    {320, 240}, {640, 360}, {640, 480}, {800, 600}, {960, 540}, {1024, 768},
+    {1280, 720}, {1280, 960}, {1600, 1200}, {1920, 1080}, {2560, 1440}, {3840, 2160},
+};
+constexpr int COMMON_RATES[] = {5, 10, 15, 20, 24, 25, 30, 50, 60, 90, 120};
+
+const FormatInfo* findFormat(const std::string& format) {
+    for (const auto& info : FORMATS) {
+        if (format == info.name) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * An int caps field: a value, a list or a range
+ */
+struct IntField {
+    std::vector<int> values;
+    int min = 0;
+    int max = 0;
+    bool range = false;
+};
+
+bool readInts(const GValue* value, IntField& out) {
+    if (!value) {
+        return false;
+    }
+    if (G_VALUE_HOLDS_INT(value)) {
+        out.values.push_back(g_value_get_int(value));
+    } else if (GST_VALUE_HOLDS_INT_RANGE(value)) {
+        out.range = true;
+        out.min = gst_value_get_int_range_min(value);
+        out.max = gst_value_get_int_range_max(value);
+        return out.max > 0;
+    } else if (GST_VALUE_HOLDS_LIST(value)) {
+        for (guint i = 0; i < gst_value_list_get_size(value); ++i) {
+            const GValue* item = gst_value_list_get_value(value, i);
+            if (G_VALUE_HOLDS_INT(item)) {
+                out.values.push_back(g_value_get_int(item));
+            }
+        }
+    }
+    if (!out.values.empty()) {
+        out.min = *std::min_element(out.values.begin(), out.values.end());
+        out.max = *std::max_element(out.values.begin(), out.values.end());
+    }
+    return !out.values.empty();
+}
+
+void readRates(const GValue* value, std::vector<std::pair<int, int>>& out) {
+    if (!value) {
+        return;
+    }
+    if (GST_VALUE_HOLDS_FRACTION(value)) {
+        out.emplace_back(gst_value_get_fraction_numerator(value), gst_value_get_fraction_denominator(value));
+    } else if (GST_VALUE_HOLDS_FRACTION_RANGE(value)) {
+        const GValue* lo = gst_value_get_fraction_range_min(value);
+        const GValue* hi = gst_value_get_fraction_range_max(value);
+        const double min = static_cast<double>(gst_value_get_fraction_numerator(lo)) /
+                           std::max(1, gst_value_get_fraction_denominator(lo));
+        const int max_num = gst_value_get_fraction_numerator(hi);
+        const int max_den = std::max(1, gst_value_get_fraction_denominator(hi));
+        for (int rate : COMMON_RATES) {
+            if (rate >= min && rate * max_den < max_num) {
+                out.emplace_back(rate, 1);
+            }
+        }
+        out.emplace_back(max_num, max_den);
+    } else if (GST_VALUE_HOLDS_LIST(value)) {
+        for (guint i = 0; i < gst_value_list_get_size(value); ++i) {
+            readRates(gst_value_list_get_value(value, i), out);
+        }
+    }
+}
+
+void readFormats(const GstStructure* s, std::vector<std::string>& out) {
+    const char* media = gst_structure_get_name(s);
+    if (std::strcmp(media, "image/jpeg") == 0) {
+        out.push_back("MJPG");
+        return;
+    }
+    if (std::strcmp(media, "video/x-raw") != 0) {
+        return;     // Bayer, H.264, ...: not something videoconvert takes
+    }
+    const GValue* value = gst_structure_get_value(s, "format");
+    if (value && G_VALUE_HOLDS_STRING(value)) {
+        out.push_back(g_value_get_string(value));
+    } else if (value && GST_VALUE_HOLDS_LIST(value)) {
+        for (guint i = 0; i < gst_value_list_get_size(value); ++i) {
+            const GValue* item = gst_value_list_get_value(value, i);
+            if (G_VALUE_HOLDS_STRING(item)) {
+                out.push_back(g_value_get_string(item));
+            }
+        }
+    }
+}
+
+/**
+ * Expand one caps structure into concrete modes (ranges into common sizes
+ * and rates, plus their maximum)
+ */
+void appendModes(const GstStructure* s, std::vector<CameraMode>& out) {
+    std::vector<std::string> formats;
+    readFormats(s, formats);
+    IntField widths;
+    IntField heights;
+    std::vector<std::pair<int, int>> rates;
+    if (formats.empty() || !readInts(gst_structure_get_value(s, "width"), widths) ||
+        !readInts(gst_structure_get_value(s, "height"), heights)) {
+        return;
+    }
+    readRates(gst_structure_get_value(s, "framerate"), rates);
+    if (rates.empty()) {
+        return;
+    }
+
+    std::vector<std::pair<int, int>> sizes;
+    if (widths.range || heights.range) {
+        for (const auto& size : COMMON_SIZES) {
+            if (size.first >= widths.min && size.first <= widths.max &&
+                size.second >= heights.min && size.second <= heights.max) {
+                sizes.push_back(size);
+            }
+        }
+        sizes.emplace_back(widths.max, heights.max);
+    } else {
+        for (int w : widths.values) {
+            for (int h : heights.values) {
+                sizes.emplace_back(w, h);
+            }
+        }
+    }
+
+    for (const auto& format : formats) {
+        if (!findFormat(format)) {
+            continue;
+        }
+        for (const auto& size : sizes) {
+            for (const auto& rate : rates) {
+                if (rate.first <= 0 || rate.second <= 0) {
+                    continue;   // 0/1 = variable rate: nothing to plan with
+                }
+                CameraMode mode;
+                mode.format = format;
+                mode.width = size.first;
+                mode.height = size.second;
+                mode.fps_num = rate.first;
+                mode.fps_den = rate.second;
+                out.push_back(mode);
+            }
+        }
+    }
+}
+
+std::string deviceString(GstDevice* device, const char* key) {
+    std::string result;
+    if (GstStructure* props = gst_device_get_properties(device)) {
+        if (const char* value = gst_structure_get_string(props, key)) {
+            result = value;
+        }
+        gst_structure_free(props);
+    }
+    return result;
+}
+
+/**
+ * Everything the log and the comparison need about one mode
+ */
+struct Evaluation {
+    bool meets = false;
+    double shortfall = 0.0;     // How far below the request (0 when met)
+    double cost = 0.0;          // Mpx-equivalents per second
+    double bus_mb_s = 0.0;
+};
+
+Evaluation evaluate(const CameraMode& mode, int width, int height, int fps, bool hw_jpeg) {
+    const FormatInfo& info = *findFormat(mode.format);
+    const bool colour = mode.format != "GRAY8";
+    const bool rate_ok = mode.fps() >= fps * RATE_TOLERANCE;
+    const bool size_ok = mode.width >= width && mode.height >= height;
+
+    Evaluation e;
+    e.meets = rate_ok && size_ok && colour;
+    e.shortfall = std::max(0.0, 1.0 - mode.fps() / (fps * RATE_TOLERANCE)) +
+                  (1.0 - std::min(1.0, static_cast<double>(mode.width) / width) *
+                         std::min(1.0, static_cast<double>(mode.height) / height)) +
+                  (colour ? 0.0 : 1.0);
+
+    const double delivered = std::min(mode.fps(), static_cast<double>(fps));
+    const double src_px = static_cast<double>(mode.width) * mode.height;
+    const double out_px = static_cast<double>(width) * height;
+    const bool scaled = mode.width != width || mode.height != height;
+    const bool downscale = src_px >= out_px;
+
+    double work = 0.0;
+    if (mode.isJpeg()) {
+        work += delivered * src_px * (hw_jpeg ? JPEG_DECODE_COST_HW : JPEG_DECODE_COST);
+    }
+    // Downscaling runs before the conversion (fewer pixels to convert)
+    work += delivered * (scaled && downscale ? out_px : src_px) * info.convert_cost;
+    if (scaled) {
+        work += delivered * std::max(src_px, out_px) * SCALE_COST;
+        const double aspect = (static_cast<double>(mode.width) / mode.height) / (static_cast<double>(width) / height);
+        if (std::fabs(aspect - 1.0) > 0.01) {
+            work += delivered * out_px * ASPECT_COST;
+        }
+    }
+    const double bus_bytes = mode.fps() * src_px * info.bytes_per_pixel;
+    work += bus_bytes * BUS_COST_PER_BYTE;
+
+    e.cost = work / 1e6;
+    e.bus_mb_s = bus_bytes / 1e6;
+    return e;
+}
+
+bool better(const Evaluation& a, const Evaluation& b) {
+    if (a.meets != b.meets) {
+        return a.meets;
+    }
+    if (std::fabs(a.shortfall - b.shortfall) > 1e-9) {
+        return a.shortfall < b.shortfall;
+    }
+    return a.cost < b.cost;
+}
+
+std::string explain(const CameraMode& mode, const Evaluation& e, int width, int height, int fps, bool hw_jpeg) {
+    std::string reason = findFormat(mode.format)->conversion;
+    if (mode.isJpeg()) {
+        reason += hw_jpeg ? " (hardware decoder)" : " (CPU decoder)";
+    }
+    if (mode.width == width && mode.height == height) {
+        reason += "; native size";
+    } else {
+        reason += (mode.width >= width && mode.height >= height ? "; downscale " : "; UPSCALE ") +
+                  std::to_string(mode.width) + "x" + std::to_string(mode.height) + " -> " +
+                  std::to_string(width) + "x" + std::to_string(height);
+    }
+    char rate[96];
+    if (mode.fps() > fps / RATE_TOLERANCE) {
+        std::snprintf(rate, sizeof(rate), "; drop %.4g -> %d fps", mode.fps(), fps);
+    } else if (mode.fps() < fps * RATE_TOLERANCE) {
+        std::snprintf(rate, sizeof(rate), "; ONLY %.4g of %d fps", mode.fps(), fps);
+    } else {
+        std::snprintf(rate, sizeof(rate), "; native rate");
+    }
+    reason += rate;
+    char totals[96];
+    std::snprintf(totals, sizeof(totals), "; %.0f MB/s from the camera, ~%.0f Mpx/s of CPU work",
+                  e.bus_mb_s, e.cost);
+    return reason + totals;
+}
+
+} // namespace
+
+// ============================================================================
+// Camera Mode
+// ============================================================================
+
+std::string CameraMode::caps() const {
+    const std::string size_rate =
+        ",width=" + std::to_string(width) + ",height=" + std::to_string(height) +
+        ",framerate=" + std::to_string(fps_num) + "/" + std::to_string(fps_den);
+    return isJpeg() ? "image/jpeg" + size_rate : "video/x-raw,format=" + format + size_rate;
+}
+
+std::string CameraMode::toString() const {
+    return format + " " + std::to_string(width) + "x" + std::to_string(height) + " @ " +
+           std::to_string(fps_num) + "/" + std::to_string(fps_den);
+}
+
+// ============================================================================
+// Probing
+// ============================================================================
+
+std::vector<CameraDevice> probeCameras() {
+    std::vector<CameraDevice> cameras;
+    if (!gst_is_initialized()) {
+        return cameras;
+    }
+
+    GstDeviceMonitor* monitor = gst_device_monitor_new();
+    gst_device_monitor_add_filter(monitor, "Video/Source", nullptr);
+    // Not started: get_devices() probes the providers once and returns
+    GList* devices = gst_device_monitor_get_devices(monitor);
+
+    for (GList* item = devices; item; item = item->next) {
+        GstDevice* device = static_cast<GstDevice*>(item->data);
+        CameraDevice camera;
+        gchar* name = gst_device_get_display_name(device);
+        camera.name = name ? name : "camera";
+        g_free(name);
+
+        // Newer v4l2 providers use api.v4l2.path; PipeWire lists the same nodes
+        camera.path = deviceString(device, "api.v4l2.path");
+        if (camera.path.empty()) {
+            camera.path = deviceString(device, "device.path");
+        }
+        if (camera.path.empty() ||
+            std::any_of(cameras.begin(), cameras.end(),
+                        [&](const CameraDevice& seen) { return seen.path == camera.path; })) {
+            continue;
+        }
+
+        if (GstCaps* caps = gst_device_get_caps(device)) {
+            for (guint i = 0; i < gst_caps_get_size(caps); ++i) {
+                appendModes(gst_caps_get_structure(caps, i), camera.modes);
+            }
+            gst_caps_unref(caps);
+        }
+        RV_LOG_DEBUG("video", "Found '{}' at {}: {} usable modes", camera.name, camera.path, camera.modes.size());
+        if (!camera.modes.empty()) {
+            cameras.push_back(std::move(camera));
+        }
+    }
+
+    g_list_free_full(devices, gst_object_unref);
+    gst_object_unref(monitor);
+    return cameras;
+}
+
+// ============================================================================
+// Selection
+// ============================================================================
+
+bool chooseCameraMode(const std::vector<CameraDevice>& cameras, int width, int height, int fps,
+                      const std::string& device, bool hw_jpeg, CameraChoice& out) {
+    const CameraDevice* best_camera = nullptr;
+    const CameraMode* best_mode = nullptr;
+    Evaluation best{};
+
+    for (const auto& camera : cameras) {
+        if (!device.empty() && camera.path != device && camera.name.find(device) == std::string::npos) {
+            continue;
+        }
+        for (const auto& mode : camera.modes) {
+            const Evaluation e = evaluate(mode, width, height, fps, hw_jpeg);
+            if (!best_mode || better(e, best)) {
+                best_camera = &camera;
+                best_mode = &mode;
+                best = e;
+            }
+        }
+    }
+    if (!best_mode) {
+        return false;
+    }
+
+    out.device_name = best_camera->name;
+    out.device_path = best_camera->path;
+    out.mode = *best_mode;
+    out.meets_request = best.meets;
+    out.cost = best.cost;
+    out.reason = explain(*best_mode, best, width, height, fps, hw_jpeg);
+    return true;
+}
+
+std::string cameraPipeline(const CameraChoice& choice, int width, int height, int fps,
+                           const std::string& jpeg_decoder) {
+    const CameraMode& mode = choice.mode;
+    std::string pipeline = "v4l2src device=" + choice.device_path + " ! " + mode.caps() + " ! ";
+
+    // Drop surplus frames before anything decodes or converts them
+    std::string rate = std::to_string(mode.fps_num) + "/" + std::to_string(mode.fps_den);
+    if (mode.fps() > fps / RATE_TOLERANCE) {
+        rate = std::to_string(fps) + "/1";
+        pipeline += "videorate drop-only=true ! " +
+                    std::string(mode.isJpeg() ? "image/jpeg" : "video/x-raw") + ",framerate=" + rate + " ! ";
+    }
+    const bool scaled = mode.width != width || mode.height != height;
+    if (mode.isJpeg() && jpeg_decoder.empty() && !scaled) {
+        // Decoded by the application's worker pool (MjpegDecoder)
+        return pipeline + "appsink name=sink caps=image/jpeg emit-signals=true max-buffers=1 drop=true";
+    }
+    if (mode.isJpeg()) {
+        pipeline += (jpeg_decoder.empty() ? "jpegdec" : jpeg_decoder) + " ! ";
+    }
+
+    const bool downscale = static_cast<long>(mode.width) * mode.height >= static_cast<long>(width) * height;
+    if (scaled && downscale) {
+        pipeline += "videoscale ! ";
+    }
+    pipeline += "videoconvert ! ";      // Passthrough (no copy) when the camera gives RGB
+    if (scaled && !downscale) {
+        pipeline += "videoscale ! ";
+    }
+    return pipeline +
+           "video/x-raw,format=RGB,width=" + std::to_string(width) + ",height=" + std::to_string(height) +
+           ",framerate=" + rate + " ! "
+           "appsink name=sink emit-signals=true max-buffers=1 drop=true";
+}
+
+} // namespace robot_vision
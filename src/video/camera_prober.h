@@ -0,0 +1,118 @@
+#pragma once
+
+/**
+ * @file camera_prober.h
+ * @brief Camera capability probing and capture mode selection
+ *
+ *   GstDeviceMonitor ("Video/Source")
+ *        |  every camera's caps: format x size x frame rate
+ *        v
+ *   chooseCameraMode(request)  --  cheapest mode that delivers the request
+ *        |
+ *        v
+ *   v4l2src device=/dev/videoN ! <native caps> [! videorate] [! jpegdec]
+ *        [! videoscale] ! videoconvert ! video/x-raw,format=RGB,... ! appsink
+ *
+ *   (MJPEG at the requested size: ... ! appsink caps=image/jpeg, decoded
+ *    by MjpegDecoder on several cores)
+ *
+ * TEACHING: Let the Camera Do the Work
+ * ------------------------------------
+ * A UVC camera offers a fixed list of modes - typically uncompressed YUYV
+ * at small sizes and MJPEG for anything big (USB 2.0 cannot carry 1080p30
+ * YUYV). Asking for a size, format or rate the camera does not have still
+ * "works": v4l2src negotiates some native mode and videoconvert,
+ * videoscale or a JPEG decoder quietly make up the difference on the CPU,
+ * every frame. Picking the mode explicitly from the probed caps turns that
+ * hidden cost into a logged decision:
+ *
+ *   1. Deliver the request: a mode with at least the requested rate and
+ *      size beats any that would need upsampling or drop below the rate.
+ *   2. Then the least CPU per second: JPEG decode > YUV to RGB >
+ *      channel swizzle > none; scaling costs extra; frames captured only
+ *      to be dropped cost bus bandwidth.
+ *
+ * Scoring is a pure function of the probed modes, so the choice can be
+ * reasoned about (and logged) without touching the camera.
+ */
+
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * One native capture mode
+ */
+struct CameraMode {
+    std::string format;         // GStreamer raw format ("YUY2", "NV12", "RGB", ...) or "MJPG"
+    int width = 0;
+    int height = 0;
+    int fps_num = 0;            // Frame rate as a fraction (e.g. 30000/1001)
+    int fps_den = 1;
+
+    double fps() const { return fps_den > 0 ? static_cast<double>(fps_num) / fps_den : 0.0; }
+    bool isJpeg() const { return format == "MJPG"; }
+
+    /**
+     * GStreamer caps for exactly this mode
+     */
+    std::string caps() const;
+
+    /**
+     * "YUY2 1280x720 @ 30/1"
+     */
+    std::string toString() const;
+};
+
+/**
+ * One camera and every mode it advertises (usable formats only)
+ */
+struct CameraDevice {
+    std::string name;           // Display name ("HD USB Camera")
+    std::string path;           // V4L2 node ("/dev/video2")
+    std::vector<CameraMode> modes;
+};
+
+/**
+ * The selected camera mode and why
+ */
+struct CameraChoice {
+    std::string device_name;
+    std::string device_path;
+    CameraMode mode;
+    bool meets_request = false; // Native rate and size at least the request
+    double cost = 0.0;          // Estimated CPU work, million pixel-equivalents/s
+    std::string reason;         // Human-readable summary for the log
+};
+
+/**
+ * Enumerate cameras with a GstDeviceMonitor
+ *
+ * Requires gst_init(); returns no devices before it. Formats the pipeline
+ * cannot turn into RGB (Bayer, H.264, 10-bit, ...) are left out.
+ */
+std::vector<CameraDevice> probeCameras();
+
+/**
+ * Pick the cheapest mode that delivers width x height at fps
+ *
+ * @param cameras From probeCameras()
+ * @param device "" for any camera, else a V4L2 path or part of a camera name
+ * @param hw_jpeg A hardware JPEG decoder is available (MJPEG costs little)
+ * @return false if no camera (matching device) has a usable mode
+ */
+bool chooseCameraMode(const std::vector<CameraDevice>& cameras, int width, int height, int fps,
+                      const std::string& device, bool hw_jpeg, CameraChoice& out);
+
+/**
+ * Capture pipeline for a choice, ending in RGB width x height and appsink
+ *
+ * @param jpeg_decoder Decoder element for MJPEG modes ("jpegdec", "nvjpegdec"),
+ *                     or "" to deliver the JPEG frames to the appsink for
+ *                     MjpegDecoder (jpegdec when the mode needs scaling)
+ */
+std::string cameraPipeline(const CameraChoice& choice, int width, int height, int fps,
+                           const std::string& jpeg_decoder);
+
+} // namespace robot_vision
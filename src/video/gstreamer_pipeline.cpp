@@ -4,11 +4,110 @@
  */
 
 #include "gstreamer_pipeline.h"
-#include <iostream>
+#include "util/logger.h"
+#include "trace/trace.h"
+#include "util/thread_policy.h"
+#include <pthread.h>
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 
 namespace robot_vision {
 
+namespace {
+
+bool isFileSource(const PipelineConfig& config) {
+    return !config.source.empty() && config.source != "test";
+}
+
+/**
+ * Pipeline for a non-camera source, scaled and converted to the configured
+ * size, format and rate so downstream stages see exactly what a camera gives
+ */
+std::string sourcePipeline(const PipelineConfig& config) {
+    std::string caps =
+        "video/x-raw,format=RGB,width=" + std::to_string(config.width) +
+        ",height=" + std::to_string(config.height) +
+        ",framerate=" + std::to_string(config.fps) + "/1";
+
+    if (config.source == "test") {
+        return "videotestsrc is-live=true pattern=ball ! " + caps + " ! "
+               "appsink name=sink emit-signals=true max-buffers=1 drop=true";
+    }
+
+    return "filesrc location=\"" + config.source + "\" ! decodebin ! "
+           "videoconvert ! videoscale ! videorate ! " + caps + " ! "
+           "appsink name=sink emit-signals=true max-buffers=1 drop=true";
+}
+
+/**
+ * The camera's JPEG frames go to the appsink undecoded (see cameraPipeline())
+ */
+bool deliversJpeg(const std::string& pipeline_str) {
+    return pipeline_str.find("appsink name=sink caps=image/jpeg") != std::string::npos;
+}
+
+/**
+ * Put a videoscale + capsfilter in front of the appsink
+ *
+ * With no caps set the pair negotiates passthrough (no copy, no scaling);
+ * setOutputResolution() sets caps on the capsfilter to resize live. A JPEG
+ * appsink gets none: the decoder scales instead.
+ */
+std::string withOutputScaler(const std::string& pipeline_str) {
+    if (deliversJpeg(pipeline_str)) {
+        return pipeline_str;
+    }
+    const std::string sink = "appsink name=sink";
+    size_t pos = pipeline_str.rfind(sink);
+    if (pos == std::string::npos) {
+        return pipeline_str;
+    }
+    return pipeline_str.substr(0, pos) + "videoscale ! capsfilter name=rv_scale ! " +
+           pipeline_str.substr(pos);
+}
+
+/**
+ * Tag GStreamer's streaming threads with the "gst" thread role
+ *
+ * Sync handlers run on the thread that posted the message, and a task
+ * posts STREAM_STATUS ENTER/LEAVE from its own streaming thread - so this
+ * is the one place to name and configure threads GStreamer creates.
+ */
+GstBusSyncReply tagStreamingThread(GstBus*, GstMessage* message, gpointer) {
+    if (GST_MESSAGE_TYPE(message) != GST_MESSAGE_STREAM_STATUS) {
+        return GST_BUS_PASS;
+    }
+
+    // Pool threads are reused by later tasks: one registration at a time
+    static thread_local int role_id = 0;
+
+    GstStreamStatusType type;
+    GstElement* owner = nullptr;
+    gst_message_parse_stream_status(message, &type, &owner);
+    if (type == GST_STREAM_STATUS_TYPE_ENTER) {
+        if (role_id != 0) {
+            ThreadRegistry::global().leave(role_id);
+        }
+        gchar* element = owner ? gst_element_get_name(owner) : nullptr;
+        std::string name = std::string("rv-gst-") + (element ? element : "task");
+        g_free(element);
+        name.resize(std::min<size_t>(name.size(), 15));    // Kernel limit
+#ifdef PLATFORM_MACOS
+        pthread_setname_np(name.c_str());
+#else
+        pthread_setname_np(pthread_self(), name.c_str());
+#endif
+        role_id = ThreadRegistry::global().enter("gst");
+    } else if (type == GST_STREAM_STATUS_TYPE_LEAVE && role_id != 0) {
+        ThreadRegistry::global().leave(role_id);
+        role_id = 0;
+    }
+    return GST_BUS_PASS;
+}
+
+} // namespace
+
 // ============================================================================
 // Constructor / Destructor
 // ============================================================================
@@ -26,6 +125,7 @@ GStreamerPipeline::~GStreamerPipeline() {
         pipeline_ = nullptr;
     }
     appsink_ = nullptr;  // Owned by pipeline, no unref needed
+    scale_caps_ = nullptr;
 }
 
 // ============================================================================
@@ -45,11 +145,13 @@ bool GStreamerPipeline::initialize(const PipelineConfig& config) {
 
     config_ = config;
 
-    // Get pipeline string from platform
-    std::string pipeline_str = platform_.getCameraPipeline(
-        config.width, config.height, config.fps);
+    // Camera pipeline comes from the platform; test and file sources are the same everywhere
+    std::string pipeline_str = config.source.empty()
+        ? platform_.getCameraPipeline(config.width, config.height, config.fps, config.device)
+        : sourcePipeline(config);
+    pipeline_str = withOutputScaler(pipeline_str);
 
-    std::cout << "  Creating pipeline: " << pipeline_str << "\n";
+    RV_LOG_INFO("video", "Creating pipeline: {}", pipeline_str);
 
     // Create the pipeline
     if (!createPipeline(pipeline_str)) {
@@ -61,11 +163,20 @@ bool GStreamerPipeline::initialize(const PipelineConfig& config) {
         return false;
     }
 
+    // Camera MJPEG decoded on a worker pool (see mjpeg_decoder.h)
+    if (deliversJpeg(pipeline_str)) {
+        if (!MjpegDecoder::isAvailable()) {
+            setError("Pipeline delivers JPEG but libjpeg is not built in");
+            return false;
+        }
+        decoder_ = std::make_unique<MjpegDecoder>(MjpegDecoder::resolveThreads(config.decode_threads));
+    }
+
     state_ = PipelineState::Ready;
     actual_width_ = config.width;
     actual_height_ = config.height;
 
-    std::cout << "  Pipeline initialized successfully\n";
+    RV_LOG_INFO("video", "Pipeline initialized successfully");
     return true;
 }
 
@@ -75,6 +186,10 @@ bool GStreamerPipeline::start() {
         return false;
     }
 
+    if (decoder_) {
+        decoder_->start();
+    }
+
     // Set pipeline to PLAYING state
     GstStateChangeReturn ret = gst_element_set_state(pipeline_, GST_STATE_PLAYING);
 
@@ -95,15 +210,18 @@ bool GStreamerPipeline::start() {
     }
 
     state_ = PipelineState::Running;
-    std::cout << "  Pipeline started, capturing frames...\n";
+    RV_LOG_INFO("video", "Pipeline started, capturing frames...");
     return true;
 }
 
 void GStreamerPipeline::stop() {
     if (pipeline_ && (state_ == PipelineState::Running || state_ == PipelineState::Paused)) {
         gst_element_set_state(pipeline_, GST_STATE_NULL);
+        if (decoder_) {
+            decoder_->stop();
+        }
         state_ = PipelineState::Ready;
-        std::cout << "  Pipeline stopped\n";
+        RV_LOG_INFO("video", "Pipeline stopped");
     }
 }
 
@@ -137,6 +255,10 @@ std::shared_ptr<FrameData> GStreamerPipeline::pullFrame() {
     if (!appsink_) {
         return nullptr;
     }
+    if (decoder_) {
+        return pullJpegFrame();
+    }
+    TRACE_SCOPE_FRAME("pullFrame", span);
 
     /**
      * TEACHING: GStreamer AppSink
@@ -153,6 +275,12 @@ std::shared_ptr<FrameData> GStreamerPipeline::pullFrame() {
         GST_APP_SINK(appsink_), 10 * GST_MSECOND);
 
     if (!sample) {
+        // End of a recorded clip: rewind and keep going if asked to
+        if (config_.loop && isFileSource(config_) &&
+            gst_app_sink_is_eos(GST_APP_SINK(appsink_))) {
+            gst_element_seek_simple(pipeline_, GST_FORMAT_TIME,
+                static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT), 0);
+        }
         return nullptr;  // No frame available
     }
 
@@ -183,7 +311,11 @@ std::shared_ptr<FrameData> GStreamerPipeline::pullFrame() {
     frame->width = width;
     frame->height = height;
     frame->timestamp_ns = GST_BUFFER_PTS(buffer);
+    frame->capture_time_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
     frame->frame_number = frame_counter_.fetch_add(1);
+    span.setFrame(frame->frame_number);
 
     // Copy pixel data
     frame->pixels.resize(map.size);
@@ -193,7 +325,7 @@ std::shared_ptr<FrameData> GStreamerPipeline::pullFrame() {
     if (width != actual_width_ || height != actual_height_) {
         actual_width_ = width;
         actual_height_ = height;
-        std::cout << "  Frame dimensions: " << width << "x" << height << "\n";
+        RV_LOG_INFO("video", "Frame dimensions: {}x{}", width, height);
     }
 
     // Cleanup
@@ -204,6 +336,45 @@ std::shared_ptr<FrameData> GStreamerPipeline::pullFrame() {
     return frame;
 }
 
+std::shared_ptr<FrameData> GStreamerPipeline::pullJpegFrame() {
+    TRACE_SCOPE_FRAME("pullJpegFrame", span);
+
+    // While frames are decoding the appsink is only polled, so a decoded
+    // frame is handed on when it is ready rather than when the next JPEG arrives
+    const bool decoding = decoder_->inFlight() > 0;
+    GstSample* sample = gst_app_sink_try_pull_sample(
+        GST_APP_SINK(appsink_), decoding ? 0 : 10 * GST_MSECOND);
+
+    if (sample) {
+        GstBuffer* buffer = gst_sample_get_buffer(sample);
+        GstMapInfo map;
+        if (buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+            decoder_->submit(map.data, map.size, GST_BUFFER_PTS(buffer), metricsNowNs());
+            gst_buffer_unmap(buffer, &map);
+        }
+        gst_sample_unref(sample);
+    }
+
+    // Oldest frame first; returns at once when nothing is decoding
+    auto frame = decoder_->takeNext(std::chrono::milliseconds(1));
+    if (!frame) {
+        return nullptr;
+    }
+
+    // Numbered in delivery order, so frames dropped before decoding leave no gaps
+    frame->frame_number = frame_counter_.fetch_add(1);
+    span.setFrame(frame->frame_number);
+
+    if (frame->width != actual_width_ || frame->height != actual_height_) {
+        actual_width_ = frame->width;
+        actual_height_ = frame->height;
+        RV_LOG_INFO("video", "Frame dimensions: {}x{}", frame->width, frame->height);
+    }
+
+    new_frame_available_.store(true);
+    return frame;
+}
+
 // ============================================================================
 // State and Diagnostics
 // ============================================================================
@@ -236,6 +407,52 @@ void GStreamerPipeline::getFrameDimensions(int& width, int& height) const {
     height = actual_height_;
 }
 
+bool GStreamerPipeline::setOutputResolution(int width, int height) {
+    if (decoder_ && (width == 0) == (height == 0) && width >= 0 && height >= 0) {
+        // JPEG decoded in the app: libjpeg's DCT scaling, in eighths of the
+        // camera size (rounded up so the result is at least the request)
+        int eighths = 8;
+        if (width > 0 && height > 0) {
+            const int ex = (width * 8 + config_.width - 1) / config_.width;
+            const int ey = (height * 8 + config_.height - 1) / config_.height;
+            eighths = std::clamp(std::max(ex, ey), 1, 8);
+        }
+        decoder_->setScale(eighths);
+        RV_LOG_INFO("video", "Output resolution: {}/8 of {}x{} (JPEG decode scaling)",
+                    eighths, config_.width, config_.height);
+        return true;
+    }
+    if (!scale_caps_) {
+        setError("Pipeline has no output scaler");
+        return false;
+    }
+    if ((width == 0) != (height == 0) || width < 0 || height < 0) {
+        setError("Invalid output resolution");
+        return false;
+    }
+
+    // 0x0: format only, so videoscale falls back to passthrough at the source size
+    std::string caps_str = "video/x-raw,format=RGB";
+    if (width > 0) {
+        caps_str += ",width=" + std::to_string(width) + ",height=" + std::to_string(height);
+    }
+    GstCaps* caps = gst_caps_from_string(caps_str.c_str());
+    if (!caps) {
+        setError("Bad caps: " + caps_str);
+        return false;
+    }
+
+    // capsfilter takes its own reference and asks upstream to renegotiate
+    g_object_set(scale_caps_, "caps", caps, nullptr);
+    gst_caps_unref(caps);
+    if (width > 0) {
+        RV_LOG_INFO("video", "Output resolution: {}x{}", width, height);
+    } else {
+        RV_LOG_INFO("video", "Output resolution: as captured");
+    }
+    return true;
+}
+
 // ============================================================================
 // Private Helpers
 // ============================================================================
@@ -263,6 +480,11 @@ bool GStreamerPipeline::createPipeline(const std::string& pipeline_str) {
         return false;
     }
 
+    // Streaming threads get the "gst" thread policy as they start
+    GstBus* bus = gst_element_get_bus(pipeline_);
+    gst_bus_set_sync_handler(bus, tagStreamingThread, nullptr, nullptr);
+    gst_object_unref(bus);
+
     return true;
 }
 
@@ -287,25 +509,34 @@ bool GStreamerPipeline::setupAppSink() {
      * - emit-signals: We don't use signals (pull model instead)
      * - drop: Drop old buffers if we're too slow (prevents lag)
      * - max-buffers: Only keep 1 buffer (we want latest frame)
-     * - sync: False for lowest latency (don't sync to clock)
+     * - sync: False for lowest latency (don't sync to clock). Live
+     *   sources are paced by the device; a file source would otherwise
+     *   play as fast as it decodes, so it syncs when realtime is set.
      */
+    bool sync = isFileSource(config_) && config_.realtime;
     g_object_set(appsink_,
         "emit-signals", FALSE,
         "drop", TRUE,
         "max-buffers", 1,
-        "sync", FALSE,
+        "sync", sync ? TRUE : FALSE,
         nullptr);
 
     // Unref the extra reference from gst_bin_get_by_name
     gst_object_unref(appsink_);
 
+    // Live resize point (see withOutputScaler); optional
+    scale_caps_ = gst_bin_get_by_name(GST_BIN(pipeline_), "rv_scale");
+    if (scale_caps_) {
+        gst_object_unref(scale_caps_);
+    }
+
     return true;
 }
 
 void GStreamerPipeline::setError(const std::string& error) {
     last_error_ = error;
     state_ = PipelineState::Error;
-    std::cerr << "  ERROR: " << error << "\n";
+    RV_LOG_ERROR("video", "{}", error);
 }
 
 PipelineState GStreamerPipeline::gstStateToState(GstState gst_state) {
@@ -7,6 +7,7 @@
 
 #include "core/video_pipeline.h"
 #include "core/platform.h"
+#include "mjpeg_decoder.h"
 #include <gst/gst.h>
 #include <gst/app/gstappsink.h>
 #include <mutex>
@@ -59,6 +60,7 @@ public:
     std::string getStateString() const override;
     std::string getLastError() const override;
     void getFrameDimensions(int& width, int& height) const override;
+    bool setOutputResolution(int width, int height) override;
 
 private:
     /**
@@ -76,6 +78,12 @@ private:
      */
     std::shared_ptr<FrameData> pullFrame();
 
+    /**
+     * pullFrame() for a JPEG appsink: submit what arrived, return the next
+     * decoded frame in order
+     */
+    std::shared_ptr<FrameData> pullJpegFrame();
+
     /**
      * Set error message
      */
@@ -91,6 +99,8 @@ private:
 
     GstElement* pipeline_ = nullptr;        // GStreamer pipeline
     GstElement* appsink_ = nullptr;         // AppSink element for frame access
+    GstElement* scale_caps_ = nullptr;      // capsfilter after videoscale (live resize)
+    std::unique_ptr<MjpegDecoder> decoder_; // Camera JPEG decoded here, not in the pipeline
 
     PipelineConfig config_;                 // Current configuration
     PipelineState state_ = PipelineState::Uninitialized;
@@ -0,0 +1,189 @@
+/**
+ * @file h264_encoder.cpp
+ * @brief appsrc -> encoder -> appsink H.264 pipeline
+ */
+
+#include "h264_encoder.h"
+#include "util/logger.h"
+#include "trace/trace.h"
+
+
+namespace robot_vision {
+
+namespace {
+
+// Frames allowed to wait inside appsrc before new ones are dropped
+constexpr size_t MAX_QUEUED_FRAMES = 2;
+
+/**
+ * appsrc buffer destroy notify: releases the frame the buffer wrapped
+ */
+void releaseFrame(gpointer data) {
+    delete static_cast<std::shared_ptr<FrameData>*>(data);
+}
+
+} // namespace
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+H264Encoder::H264Encoder(IPlatform& platform)
+    : platform_(platform)
+{
+}
+
+H264Encoder::~H264Encoder() {
+    stop();
+}
+
+bool H264Encoder::initialize(const H264EncoderConfig& config) {
+    if (pipeline_) {
+        setError("Encoder already initialized");
+        return false;
+    }
+    if (!config.isValid()) {
+        setError("Invalid encoder configuration");
+        return false;
+    }
+    config_ = config;
+    frame_bytes_ = static_cast<size_t>(config.width) * config.height * 3;
+
+    std::string pipeline_str =
+        "appsrc name=src ! " +
+        platform_.getH264EncoderPipeline(config.bitrate_kbps, config.keyframe_interval) + " ! "
+        "h264parse config-interval=-1 ! "
+        "video/x-h264,stream-format=byte-stream,alignment=au ! "
+        "appsink name=sink";
+    RV_LOG_INFO("video", "Creating encoder: {}", pipeline_str);
+
+    GError* error = nullptr;
+    pipeline_ = gst_parse_launch(pipeline_str.c_str(), &error);
+    if (error) {
+        setError(std::string("Encoder parse error: ") + error->message);
+        g_error_free(error);
+        stop();
+        return false;
+    }
+    if (!pipeline_) {
+        setError("Failed to create encoder pipeline");
+        return false;
+    }
+
+    appsrc_ = gst_bin_get_by_name(GST_BIN(pipeline_), "src");
+    appsink_ = gst_bin_get_by_name(GST_BIN(pipeline_), "sink");
+    if (!appsrc_ || !appsink_) {
+        setError("Encoder pipeline is missing appsrc/appsink");
+        stop();
+        return false;
+    }
+    // Unref the extra references from gst_bin_get_by_name (pipeline owns them)
+    gst_object_unref(appsrc_);
+    gst_object_unref(appsink_);
+
+    /**
+     * TEACHING: Feeding appsrc
+     * ------------------------
+     * - format=time + our own PTS: timestamps are capture times, not
+     *   arrival times at the encoder, so A/V tools see the real cadence
+     * - block=false: push never waits; we watch the queued byte level and
+     *   drop instead (the record thread must not stall on the encoder)
+     * - appsink sync=false: hand AUs over as soon as they exist
+     */
+    GstCaps* caps = gst_caps_from_string(
+        ("video/x-raw,format=RGB,width=" + std::to_string(config.width) +
+         ",height=" + std::to_string(config.height) +
+         ",framerate=" + std::to_string(config.fps) + "/1").c_str());
+    g_object_set(appsrc_,
+        "caps", caps,
+        "format", GST_FORMAT_TIME,
+        "is-live", TRUE,
+        "do-timestamp", FALSE,
+        "block", FALSE,
+        nullptr);
+    gst_caps_unref(caps);
+    g_object_set(appsink_,
+        "emit-signals", FALSE,
+        "sync", FALSE,
+        nullptr);
+
+    if (gst_element_set_state(pipeline_, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        setError("Failed to start encoder pipeline");
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void H264Encoder::stop() {
+    if (pipeline_) {
+        gst_element_set_state(pipeline_, GST_STATE_NULL);
+        gst_object_unref(pipeline_);
+        pipeline_ = nullptr;
+    }
+    appsrc_ = nullptr;
+    appsink_ = nullptr;
+    base_ns_ = 0;
+}
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+bool H264Encoder::encode(const std::shared_ptr<FrameData>& frame,
+                         std::vector<std::shared_ptr<const EncodedFrame>>& out) {
+    TRACE_SCOPE_FRAME("h264Encode", span);
+    if (!pipeline_ || !frame) {
+        return false;
+    }
+    span.setFrame(frame->frame_number);
+
+    bool queued = false;
+    if (frame->width == config_.width && frame->height == config_.height &&
+        frame->pixels.size() >= frame_bytes_ &&
+        gst_app_src_get_current_level_bytes(GST_APP_SRC(appsrc_)) < MAX_QUEUED_FRAMES * frame_bytes_) {
+
+        if (base_ns_ == 0) {
+            base_ns_ = frame->capture_time_ns;
+        }
+
+        // Zero-copy: the buffer keeps the frame alive until the encoder is done with it
+        auto* holder = new std::shared_ptr<FrameData>(frame);
+        GstBuffer* buffer = gst_buffer_new_wrapped_full(
+            GST_MEMORY_FLAG_READONLY, frame->pixels.data(), frame->pixels.size(),
+            0, frame_bytes_, holder, releaseFrame);
+        GST_BUFFER_PTS(buffer) = frame->capture_time_ns - base_ns_;
+        GST_BUFFER_DURATION(buffer) = GST_SECOND / static_cast<GstClockTime>(config_.fps);
+
+        // push_buffer takes ownership of the buffer whatever it returns
+        queued = gst_app_src_push_buffer(GST_APP_SRC(appsrc_), buffer) == GST_FLOW_OK;
+    }
+
+    collect(out);
+    return queued;
+}
+
+void H264Encoder::collect(std::vector<std::shared_ptr<const EncodedFrame>>& out) {
+    // Non-blocking: take what the encoder has finished, leave the rest for next time
+    while (GstSample* sample = gst_app_sink_try_pull_sample(GST_APP_SINK(appsink_), 0)) {
+        GstBuffer* buffer = gst_sample_get_buffer(sample);
+        GstMapInfo map;
+        if (buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+            auto encoded = std::make_shared<EncodedFrame>();
+            encoded->data.assign(map.data, map.data + map.size);
+            encoded->pts_ns = base_ns_ + (GST_CLOCK_TIME_IS_VALID(GST_BUFFER_PTS(buffer))
+                                          ? GST_BUFFER_PTS(buffer) : 0);
+            encoded->keyframe = !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+            gst_buffer_unmap(buffer, &map);
+            out.push_back(std::move(encoded));
+        }
+        gst_sample_unref(sample);
+    }
+}
+
+void H264Encoder::setError(const std::string& error) {
+    last_error_ = error;
+    RV_LOG_ERROR("video", "Encoder: {}", error);
+}
+
+} // namespace robot_vision
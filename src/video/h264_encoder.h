@@ -0,0 +1,118 @@
+#pragma once
+
+/**
+ * @file h264_encoder.h
+ * @brief GStreamer H.264 encoder fed from captured frames
+ *
+ *   appsrc (RGB) ! <platform encoder> ! h264parse ! appsink (Annex-B AUs)
+ *
+ * The encoder element comes from IPlatform::getH264EncoderPipeline(), so
+ * Jetson uses NVENC, macOS VideoToolbox and other Linux boxes x264.
+ *
+ * TEACHING: Access Units and GOPs
+ * -------------------------------
+ * An access unit (AU) is everything needed to decode one frame. A GOP
+ * (group of pictures) starts with a keyframe (IDR) that decodes on its
+ * own; every following frame until the next keyframe depends on it. So
+ * any recording must start on a keyframe, and a buffer of recent video
+ * is naturally a list of whole GOPs. h264parse is set to repeat SPS/PPS
+ * before every keyframe, which makes each GOP self-contained.
+ */
+
+#include "core/platform.h"
+#include "core/video_pipeline.h"
+
+#include <gst/gst.h>
+#include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * One encoded frame (access unit, Annex-B byte stream)
+ */
+struct EncodedFrame {
+    std::vector<uint8_t> data;
+    uint64_t pts_ns = 0;            // Steady-clock capture time of the source frame
+    bool keyframe = false;          // IDR: a decoder can start here
+};
+
+/**
+ * Encoder configuration
+ */
+struct H264EncoderConfig {
+    int width = 1280;
+    int height = 720;
+    int fps = 30;
+    int bitrate_kbps = 4000;
+    int keyframe_interval = 30;     // Frames per GOP
+
+    bool isValid() const {
+        return width > 0 && height > 0 && fps > 0 &&
+               bitrate_kbps > 0 && keyframe_interval > 0;
+    }
+};
+
+/**
+ * H.264 encoder
+ *
+ * encode() is called from one thread only (the record stage). It never
+ * waits for the encoder: frames are queued into appsrc (zero-copy, the
+ * buffer holds a reference to the FrameData) and whatever AUs are ready
+ * are collected. If the encoder falls more than a couple of frames behind,
+ * new frames are dropped instead of queueing without bound.
+ */
+class H264Encoder {
+public:
+    explicit H264Encoder(IPlatform& platform);
+    ~H264Encoder();
+
+    // Non-copyable (GStreamer resources)
+    H264Encoder(const H264Encoder&) = delete;
+    H264Encoder& operator=(const H264Encoder&) = delete;
+
+    /**
+     * Build and start the encoder pipeline
+     */
+    bool initialize(const H264EncoderConfig& config);
+
+    /**
+     * Queue a frame and collect any finished access units
+     *
+     * @param frame Frame matching the configured size (RGB)
+     * @param out   Finished AUs are appended here, in decode order
+     * @return false if the frame was dropped (encoder behind or error)
+     */
+    bool encode(const std::shared_ptr<FrameData>& frame,
+                std::vector<std::shared_ptr<const EncodedFrame>>& out);
+
+    /**
+     * Stop the pipeline (idempotent); AUs still inside the encoder are lost
+     */
+    void stop();
+
+    bool isRunning() const { return pipeline_ != nullptr; }
+    std::string getLastError() const { return last_error_; }
+
+private:
+    void collect(std::vector<std::shared_ptr<const EncodedFrame>>& out);
+    void setError(const std::string& error);
+
+    IPlatform& platform_;
+    H264EncoderConfig config_;
+
+    GstElement* pipeline_ = nullptr;
+    GstElement* appsrc_ = nullptr;      // Owned by pipeline
+    GstElement* appsink_ = nullptr;     // Owned by pipeline
+
+    uint64_t base_ns_ = 0;              // Capture time of the first frame (PTS 0)
+    size_t frame_bytes_ = 0;
+    std::string last_error_;
+};
+
+} // namespace robot_vision
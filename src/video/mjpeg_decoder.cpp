@@ -0,0 +1,282 @@
+/**
+ * @file mjpeg_decoder.cpp
+ * @brief libjpeg-turbo worker pool and the reorder buffer
+ */
+
+#include "mjpeg_decoder.h"
+#include "util/logger.h"
+
+#include <algorithm>
+#include <string>
+#include <thread>
+
+#ifdef HAS_JPEG
+#include <csetjmp>
+#include <cstdio>
+#include <jpeglib.h>
+#endif
+
+namespace robot_vision {
+
+namespace {
+
+// Output frames kept for reuse: one per frame in flight plus what the
+// stage queues and sinks hold, so steady state allocates nothing
+constexpr size_t MAX_POOLED_FRAMES = 16;
+
+#ifdef HAS_JPEG
+
+struct JpegErrorManager {
+    jpeg_error_mgr base;
+    std::jmp_buf jump;
+    char message[JMSG_LENGTH_MAX];
+};
+
+void jpegErrorExit(j_common_ptr cinfo) {
+    auto* err = reinterpret_cast<JpegErrorManager*>(cinfo->err);
+    (*cinfo->err->format_message)(cinfo, err->message);
+    std::longjmp(err->jump, 1);
+}
+
+// Cheap UVC cameras routinely send frames with a few bytes missing; libjpeg
+// pads them with grey and warns on stderr every time. Count, don't print.
+void jpegSilentMessage(j_common_ptr) {}
+
+/**
+ * Decode one JPEG into packed RGB at scale/8 of its size
+ */
+bool decodeJpeg(const uint8_t* data, size_t size, int scale, FrameData& out, std::string& error) {
+    jpeg_decompress_struct cinfo;
+    JpegErrorManager jerr;
+
+    cinfo.err = jpeg_std_error(&jerr.base);
+    jerr.base.error_exit = jpegErrorExit;
+    jerr.base.output_message = jpegSilentMessage;
+    if (setjmp(jerr.jump)) {
+        error = jerr.message;
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, const_cast<unsigned char*>(data), static_cast<unsigned long>(size));
+    jpeg_read_header(&cinfo, TRUE);
+
+    cinfo.out_color_space = JCS_RGB;
+    cinfo.dct_method = JDCT_IFAST;      // libjpeg-turbo's SIMD path; quality loss is negligible
+    cinfo.scale_num = static_cast<unsigned int>(scale);
+    cinfo.scale_denom = 8;
+    jpeg_start_decompress(&cinfo);
+
+    out.width = static_cast<int>(cinfo.output_width);
+    out.height = static_cast<int>(cinfo.output_height);
+    out.pixels.resize(out.getPixelBufferSize());
+
+    const size_t stride = static_cast<size_t>(out.width) * 3;
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = out.pixels.data() + cinfo.output_scanline * stride;
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return true;
+}
+
+#else
+
+bool decodeJpeg(const uint8_t*, size_t, int, FrameData&, std::string& error) {
+    error = "built without libjpeg";
+    return false;
+}
+
+#endif
+
+} // namespace
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+bool MjpegDecoder::isAvailable() {
+#ifdef HAS_JPEG
+    return true;
+#else
+    return false;
+#endif
+}
+
+int MjpegDecoder::resolveThreads(int configured) {
+    if (configured > 0) {
+        return configured;
+    }
+    const int cores = static_cast<int>(std::thread::hardware_concurrency());
+    return std::clamp(cores / 2, 1, 4);
+}
+
+MjpegDecoder::MjpegDecoder(int threads)
+    : threads_(std::max(threads, 1))
+    , pool_(threads_, "rv-mjpeg", "capture")
+    , decode_hist_(MetricsRegistry::global().histogram("rv_jpeg_decode_seconds",
+                                                       "Time to decode one camera JPEG frame (one thread)"))
+    , latency_hist_(MetricsRegistry::global().histogram("rv_jpeg_decode_latency_seconds",
+                                                        "Camera JPEG pulled to decoded frame delivered in order"))
+    , decoded_(MetricsRegistry::global().counter("rv_jpeg_frames_decoded_total",
+                                                 "Camera JPEG frames decoded"))
+    , dropped_busy_(MetricsRegistry::global().counter("rv_jpeg_frames_dropped_total",
+                                                      "Camera JPEG frames not decoded",
+                                                      "reason=\"busy\""))
+    , dropped_corrupt_(MetricsRegistry::global().counter("rv_jpeg_frames_dropped_total",
+                                                         "Camera JPEG frames not decoded",
+                                                         "reason=\"corrupt\""))
+{
+}
+
+MjpegDecoder::~MjpegDecoder() {
+    stop();
+}
+
+void MjpegDecoder::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    pool_.start();
+    running_ = true;
+    RV_LOG_INFO("video", "MJPEG decode on {} threads", threads_);
+}
+
+void MjpegDecoder::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+
+    // Outside the lock: running decodes finish (and take it), queued ones are discarded
+    pool_.stop();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_.clear();
+    next_delivery_ = next_sequence_;
+    in_flight_ = 0;
+    if (frames_ > 0) {
+        RV_LOG_INFO("video", "Decoded {} JPEG frames, mean {:.2f} ms per frame per thread", frames_,
+                    static_cast<double>(decode_ns_) / static_cast<double>(frames_) / 1e6);
+    }
+}
+
+// ============================================================================
+// Decode
+// ============================================================================
+
+bool MjpegDecoder::submit(const uint8_t* data, size_t size, uint64_t timestamp_ns,
+                          uint64_t capture_time_ns) {
+    auto job = std::make_shared<Job>();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return false;
+        }
+        if (in_flight_ > threads_) {
+            dropped_busy_.inc();
+            return false;
+        }
+        job->sequence = next_sequence_++;
+        job->scale = scale_;
+        ++in_flight_;
+    }
+    job->jpeg.assign(data, data + size);
+    job->timestamp_ns = timestamp_ns;
+    job->capture_time_ns = capture_time_ns;
+
+    // Never blocks; with every worker queue full it decodes right here
+    pool_.submit([this, job] { decode(*job); });
+    return true;
+}
+
+void MjpegDecoder::decode(const Job& job) {
+    std::shared_ptr<FrameData> frame;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        frame = takeOutputFrame();
+    }
+
+    std::string error;
+    const uint64_t t0 = metricsNowNs();
+    const bool ok = decodeJpeg(job.jpeg.data(), job.jpeg.size(), job.scale, *frame, error);
+    const uint64_t elapsed = metricsNowNs() - t0;
+
+    if (ok) {
+        frame->timestamp_ns = job.timestamp_ns;
+        frame->capture_time_ns = job.capture_time_ns;
+        decode_hist_.record(elapsed);
+        decoded_.inc();
+    } else {
+        dropped_corrupt_.inc();
+        RV_LOG_DEBUG("video", "JPEG frame {} not decoded: {}", job.sequence, error);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (job.sequence < next_delivery_) {
+        return;                         // Submitted before a stop(); nobody is waiting for it
+    }
+    if (ok) {
+        ++frames_;
+        decode_ns_ += elapsed;
+    }
+    done_[job.sequence] = ok ? std::move(frame) : nullptr;
+    done_cv_.notify_all();
+}
+
+std::shared_ptr<FrameData> MjpegDecoder::takeNext(std::chrono::microseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        auto it = done_.find(next_delivery_);
+        if (it != done_.end()) {
+            std::shared_ptr<FrameData> frame = std::move(it->second);
+            done_.erase(it);
+            ++next_delivery_;
+            --in_flight_;
+            if (!frame) {
+                continue;               // Failed to decode: the next one is due instead
+            }
+            latency_hist_.record(metricsNowNs() - frame->capture_time_ns);
+            return frame;
+        }
+        if (in_flight_ == 0 ||
+            done_cv_.wait_until(lock, deadline) == std::cv_status::timeout) {
+            return nullptr;
+        }
+    }
+}
+
+int MjpegDecoder::inFlight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_flight_;
+}
+
+void MjpegDecoder::setScale(int eighths) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    scale_ = std::clamp(eighths, 1, 8);
+}
+
+std::shared_ptr<FrameData> MjpegDecoder::takeOutputFrame() {
+    for (const auto& frame : frame_pool_) {
+        if (frame.use_count() == 1) {
+            // The last consumer's release happens-before our writes
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return frame;
+        }
+    }
+    if (frame_pool_.size() < MAX_POOLED_FRAMES) {
+        frame_pool_.push_back(std::make_shared<FrameData>());
+        return frame_pool_.back();
+    }
+    return std::make_shared<FrameData>();  // Consumers are holding on to every pooled frame
+}
+
+} // namespace robot_vision
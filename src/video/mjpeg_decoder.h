@@ -0,0 +1,150 @@
+#pragma once
+
+/**
+ * @file mjpeg_decoder.h
+ * @brief Parallel MJPEG decoding with in-order delivery
+ *
+ *   v4l2src ! image/jpeg ! appsink          (GStreamer streaming thread)
+ *        |  pullFrame(): copy the JPEG, submit
+ *        v
+ *   WorkStealingPool "rv-mjpeg"   frame 7 | frame 8 | frame 9   (N decodes at once)
+ *        |  done out of order: 8, 7, 9
+ *        v
+ *   reorder by sequence number --> takeNext(): 7, 8, 9
+ *
+ * TEACHING: Throughput vs Latency in a Decoder
+ * --------------------------------------------
+ * Many USB cameras deliver 1080p30 only as MJPEG, and one jpegdec decodes
+ * on one core: ~25-35 ms per 1080p frame on a small ARM board, so the
+ * stream runs below the camera's rate whatever else the CPU has spare.
+ * JPEG frames are independent, so N workers each decoding a whole frame
+ * raise throughput almost N times. Latency is not improved - each frame
+ * still takes one core's decode time - and frames finish out of order,
+ * so they are put back in capture order before anyone sees them.
+ *
+ * At most threads + 1 frames are in flight; a frame arriving beyond that
+ * is dropped before any work is spent on it (the camera outruns the
+ * decoders), rather than queueing up latency.
+ *
+ * Decoding is libjpeg-turbo (HAS_JPEG): SIMD IDCT and colour conversion
+ * straight to RGB, optionally DCT-scaled by n/8 - a smaller output for
+ * less work, which is how setScale() gives the load governor an output
+ * resolution without a scaler in the pipeline.
+ */
+
+#include "core/video_pipeline.h"
+#include "metrics/metrics.h"
+#include "util/work_stealing_pool.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace robot_vision {
+
+/**
+ * Multi-threaded JPEG -> RGB frame decoder
+ */
+class MjpegDecoder {
+public:
+    /**
+     * libjpeg is compiled in (HAS_JPEG); without it nothing decodes
+     */
+    static bool isAvailable();
+
+    /**
+     * Decoder threads for a configured count (0 = auto: half the cores, 1 to 4)
+     */
+    static int resolveThreads(int configured);
+
+    /**
+     * @param threads Decoder threads (>= 1)
+     */
+    explicit MjpegDecoder(int threads);
+    ~MjpegDecoder();
+
+    // Non-copyable (owns threads)
+    MjpegDecoder(const MjpegDecoder&) = delete;
+    MjpegDecoder& operator=(const MjpegDecoder&) = delete;
+
+    void start();
+
+    /**
+     * Join the workers (idempotent); frames not yet delivered are dropped
+     */
+    void stop();
+
+    /**
+     * Queue one JPEG frame for decoding (the bytes are copied)
+     *
+     * @param timestamp_ns Presentation timestamp for the decoded frame
+     * @param capture_time_ns When the frame was pulled (steady clock)
+     * @return false if dropped (not running, or every decoder busy)
+     */
+    bool submit(const uint8_t* data, size_t size, uint64_t timestamp_ns, uint64_t capture_time_ns);
+
+    /**
+     * Next decoded frame in submission order, waiting up to timeout for it
+     *
+     * Frames that failed to decode are skipped. frame_number is left for
+     * the caller to assign in delivery order.
+     *
+     * @return nullptr if the next frame is not ready in time (or none is in flight)
+     */
+    std::shared_ptr<FrameData> takeNext(std::chrono::microseconds timeout);
+
+    /**
+     * Frames submitted and not yet taken
+     */
+    int inFlight() const;
+
+    /**
+     * Output size as a fraction of the JPEG size, in eighths (1-8, 8 = full)
+     *
+     * Applies to frames submitted from now on.
+     */
+    void setScale(int eighths);
+
+    int threads() const { return threads_; }
+
+private:
+    struct Job {
+        uint64_t sequence = 0;
+        std::vector<uint8_t> jpeg;
+        uint64_t timestamp_ns = 0;
+        uint64_t capture_time_ns = 0;
+        int scale = 8;
+    };
+
+    void decode(const Job& job);
+    std::shared_ptr<FrameData> takeOutputFrame();
+
+    const int threads_;
+    WorkStealingPool pool_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable done_cv_;
+    bool running_ = false;
+    int scale_ = 8;
+    uint64_t next_sequence_ = 0;        // Given to the next submitted frame
+    uint64_t next_delivery_ = 0;        // Sequence takeNext() returns next
+    int in_flight_ = 0;
+    std::map<uint64_t, std::shared_ptr<FrameData>> done_;  // Decoded (nullptr: failed), by sequence
+
+    // Output frames recycled once every consumer has released them
+    std::vector<std::shared_ptr<FrameData>> frame_pool_;
+
+    Histogram& decode_hist_;
+    Histogram& latency_hist_;
+    Counter& decoded_;
+    Counter& dropped_busy_;
+    Counter& dropped_corrupt_;
+    uint64_t frames_ = 0;               // Guarded by mutex_
+    uint64_t decode_ns_ = 0;
+};
+
+} // namespace robot_vision
@@ -0,0 +1,199 @@
+/**
+ * @file rv_detlog.cpp
+ * @brief Query binary detection logs by time range and label
+ *
+ *   ./build/rv_detlog detections/                       # everything
+ *   ./build/rv_detlog --label=person --min-conf=0.6 detections/
+ *   ./build/rv_detlog --from="2024-05-02 14:00" --to="2024-05-02 14:30" detections/
+ *   ./build/rv_detlog --from=1714650000 --count det_20240502-140012-345.rvdl
+ *
+ * Times are Unix seconds or local "YYYY-MM-DD HH:MM[:SS]".
+ */
+
+#include "detection/detection_log.h"
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace robot_vision;
+
+namespace {
+
+struct Options {
+    DetectionLogQuery query;
+    size_t limit = 0;               // 0 = unlimited
+    bool count_only = false;
+    std::vector<std::string> paths;
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options] FILE.rvdl|DIR...\n"
+              << "  --from=TIME          Start (Unix seconds or \"YYYY-MM-DD HH:MM[:SS]\")\n"
+              << "  --to=TIME            End, inclusive\n"
+              << "  --label=NAME         Only records containing this label\n"
+              << "  --min-conf=C         Only boxes with confidence >= C\n"
+              << "  --limit=N            Stop after N records\n"
+              << "  --count              Print only the number of matching records\n";
+}
+
+/**
+ * Parse Unix seconds or a local "YYYY-MM-DD HH:MM[:SS]" time
+ */
+bool parseTime(const std::string& text, uint64_t& ns) {
+    std::tm tm{};
+    int sec = 0;
+    if (std::sscanf(text.c_str(), "%d-%d-%d%*[ T]%d:%d:%d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                    &tm.tm_hour, &tm.tm_min, &sec) >= 5) {
+        tm.tm_year -= 1900;
+        tm.tm_mon -= 1;
+        tm.tm_sec = sec;
+        tm.tm_isdst = -1;
+        std::time_t t = std::mktime(&tm);
+        if (t == static_cast<std::time_t>(-1)) {
+            return false;
+        }
+        ns = static_cast<uint64_t>(t) * 1000000000ull;
+        return true;
+    }
+
+    char* end = nullptr;
+    double seconds = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || *end != '\0' || seconds < 0) {
+        return false;
+    }
+    ns = static_cast<uint64_t>(seconds * 1e9);
+    return true;
+}
+
+std::string formatTime(uint64_t ns) {
+    std::time_t secs = static_cast<std::time_t>(ns / 1000000000ull);
+    std::tm tm{};
+    localtime_r(&secs, &tm);
+    char buf[40];
+    std::snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d.%03d",
+                  tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                  tm.tm_hour, tm.tm_min, tm.tm_sec,
+                  static_cast<int>((ns / 1000000ull) % 1000));
+    return buf;
+}
+
+bool parseArgs(int argc, char* argv[], Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* prefix) -> const char* {
+            size_t n = std::char_traits<char>::length(prefix);
+            return arg.compare(0, n, prefix) == 0 ? argv[i] + n : nullptr;
+        };
+
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (const char* v = value("--from=")) {
+            if (!parseTime(v, opts.query.start_ns)) {
+                std::cerr << "Bad time: " << v << "\n";
+                return false;
+            }
+        } else if (const char* v = value("--to=")) {
+            if (!parseTime(v, opts.query.end_ns)) {
+                std::cerr << "Bad time: " << v << "\n";
+                return false;
+            }
+        } else if (const char* v = value("--label=")) {
+            opts.query.label = v;
+        } else if (const char* v = value("--min-conf=")) {
+            opts.query.min_confidence = std::strtof(v, nullptr);
+        } else if (const char* v = value("--limit=")) {
+            opts.limit = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--count") {
+            opts.count_only = true;
+        } else if (arg.compare(0, 2, "--") == 0) {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        } else {
+            opts.paths.push_back(arg);
+        }
+    }
+    return !opts.paths.empty();
+}
+
+/**
+ * Expand directories to their .rvdl files (session names sort by time)
+ */
+std::vector<std::string> expandPaths(const std::vector<std::string>& paths) {
+    std::vector<std::string> files;
+    for (const auto& path : paths) {
+        DIR* dir = ::opendir(path.c_str());
+        if (!dir) {
+            files.push_back(path);
+            continue;
+        }
+        std::vector<std::string> found;
+        while (dirent* entry = ::readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() > 5 && name.compare(name.size() - 5, 5, ".rvdl") == 0) {
+                found.push_back(path + "/" + name);
+            }
+        }
+        ::closedir(dir);
+        std::sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    }
+    return files;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+    if (!parseArgs(argc, argv, opts)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    size_t total = 0;
+    size_t bytes = 0;
+    bool limited = false;
+
+    for (const auto& file : expandPaths(opts.paths)) {
+        DetectionLogReader reader;
+        if (!reader.open(file)) {
+            std::cerr << "  WARNING: " << reader.getLastError() << "\n";
+            continue;
+        }
+        bytes += reader.dataBytes();
+
+        reader.query(opts.query, [&](const DetectionLogRecord& record) {
+            ++total;
+            if (!opts.count_only) {
+                std::cout << formatTime(record.timestamp_ns) << "  frame " << record.frame_id;
+                for (const auto& box : record.boxes) {
+                    char buf[96];
+                    std::snprintf(buf, sizeof(buf), "  %s %.2f [%.3f %.3f %.3f %.3f]",
+                                  box.label, box.confidence, box.x, box.y, box.width, box.height);
+                    std::cout << buf;
+                }
+                std::cout << "\n";
+            }
+            limited = opts.limit > 0 && total >= opts.limit;
+            return !limited;
+        });
+        if (limited) {
+            break;
+        }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    if (opts.count_only) {
+        std::cout << total << "\n";
+    }
+    std::cerr << total << " records (" << bytes / 1024 << " KiB of logs) in " << ms << " ms\n";
+    return 0;
+}
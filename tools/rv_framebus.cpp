@@ -0,0 +1,160 @@
+/**
+ * @file rv_framebus.cpp
+ * @brief Subscribe to the shared-memory frame bus and report what arrives
+ *
+ *   ./build/rv_framebus                                  # newest frames, stats every second
+ *   ./build/rv_framebus --all --hold-ms=50 --name=slowpoke
+ *   ./build/rv_framebus --frames=1 --save=frame.ppm
+ *
+ * Doubles as a reference consumer: connect, next(), use the pixels in
+ * place, release().
+ */
+
+#include "framebus/frame_bus.h"
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace robot_vision;
+
+namespace {
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void handleSignal(int) {
+    g_stop = 1;
+}
+
+struct Options {
+    std::string socket_path = FrameBusConfig().socket_path;
+    std::string name = "rv_framebus";
+    bool all = false;                   // Every frame still in the ring, not just the newest
+    int hold_ms = 0;                    // Pretend to process each frame this long
+    uint64_t frames = 0;                // 0 = until Ctrl+C
+    std::string save;                   // Write the first frame as PPM
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --socket=PATH        Control socket (default " << Options().socket_path << ")\n"
+              << "  --name=NAME          Reader name in the publisher's metrics\n"
+              << "  --all                Take every frame still in the ring instead of the newest\n"
+              << "  --hold-ms=N          Hold each frame N ms (simulate a slow consumer)\n"
+              << "  --frames=N           Exit after N frames\n"
+              << "  --save=FILE.ppm      Save the first frame received\n";
+}
+
+bool parseArgs(int argc, char* argv[], Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* prefix) -> const char* {
+            size_t n = std::char_traits<char>::length(prefix);
+            return arg.compare(0, n, prefix) == 0 ? argv[i] + n : nullptr;
+        };
+
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (const char* v = value("--socket=")) {
+            opts.socket_path = v;
+        } else if (const char* v = value("--name=")) {
+            opts.name = v;
+        } else if (arg == "--all") {
+            opts.all = true;
+        } else if (const char* v = value("--hold-ms=")) {
+            opts.hold_ms = std::atoi(v);
+        } else if (const char* v = value("--frames=")) {
+            opts.frames = std::strtoull(v, nullptr, 10);
+        } else if (const char* v = value("--save=")) {
+            opts.save = v;
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool savePpm(const std::string& path, const FrameBusView& frame) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << "P6\n" << frame.width << " " << frame.height << "\n255\n";
+    for (uint32_t y = 0; y < frame.height; ++y) {
+        file.write(reinterpret_cast<const char*>(frame.pixels + static_cast<size_t>(y) * frame.stride),
+                   static_cast<std::streamsize>(frame.width) * 3);
+    }
+    return static_cast<bool>(file);
+}
+
+uint64_t steadyNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+    if (!parseArgs(argc, argv, opts)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    FrameBusReader bus;
+    if (!bus.connect(opts.socket_path, opts.name)) {
+        std::cerr << "ERROR: " << bus.getLastError() << "\n";
+        return 1;
+    }
+    const FrameBusHeader* header = bus.header();
+    std::cerr << "Connected as reader " << bus.readerIndex() << ": " << header->slot_count
+              << " slots, publisher pid " << header->publisher_pid << "\n";
+
+    uint64_t total = 0;
+    uint64_t window_frames = 0;
+    double window_latency_ms = 0.0;
+    auto window_start = std::chrono::steady_clock::now();
+
+    FrameBusView frame;
+    while (!g_stop && (opts.frames == 0 || total < opts.frames)) {
+        if (!bus.next(frame, 1000, !opts.all)) {
+            if (!bus.getLastError().empty()) {
+                std::cerr << "ERROR: " << bus.getLastError() << "\n";
+                return 1;
+            }
+            continue;   // Nothing published this second
+        }
+        ++total;
+        ++window_frames;
+        uint64_t now = steadyNowNs();
+        window_latency_ms += now > frame.capture_time_ns ? (now - frame.capture_time_ns) / 1e6 : 0.0;
+
+        if (opts.hold_ms > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(opts.hold_ms));
+        }
+        if (!opts.save.empty() && total == 1 && !savePpm(opts.save, frame)) {
+            std::cerr << "ERROR: cannot write " << opts.save << "\n";
+        }
+        bus.release(frame);
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - window_start).count();
+        if (elapsed >= 1.0) {
+            std::printf("frame %llu  %ux%u  %.1f fps  latency %.2f ms  skipped %llu\n",
+                        static_cast<unsigned long long>(frame.frame_id), frame.width, frame.height,
+                        window_frames / elapsed, window_latency_ms / window_frames,
+                        static_cast<unsigned long long>(bus.skipped()));
+            std::fflush(stdout);
+            window_frames = 0;
+            window_latency_ms = 0.0;
+            window_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    std::cerr << total << " frames, " << bus.skipped() << " skipped\n";
+    return 0;
+}
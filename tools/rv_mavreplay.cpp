@@ -0,0 +1,175 @@
+/**
+ * @file rv_mavreplay.cpp
+ * @brief Replay a MAVLink telemetry log (.tlog) over UDP in real time
+ *
+ *   ./build/rv_mavreplay flight.tlog                     # to 127.0.0.1:14550
+ *   ./build/rv_mavreplay --speed=4 --loop flight.tlog
+ *   ./build/rv_mavreplay --host=192.168.1.20 --port=14551 flight.tlog
+ *
+ * A .tlog (Mission Planner / MAVProxy / QGroundControl) is a sequence of
+ * [u64 big-endian Unix microseconds][one MAVLink frame]. Each frame is
+ * sent as its own datagram at its recorded time, so the receiver sees
+ * the original message rates and jitter.
+ */
+
+#include "telemetry/mavlink.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace robot_vision;
+
+namespace {
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void handleSignal(int) {
+    g_stop = 1;
+}
+
+struct Options {
+    std::string host = "127.0.0.1";
+    int port = 14550;
+    double speed = 1.0;
+    bool loop = false;
+    std::string path;
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options] FILE.tlog\n"
+              << "  --host=ADDR          Destination address (default 127.0.0.1)\n"
+              << "  --port=N             Destination UDP port (default 14550)\n"
+              << "  --speed=X            Playback speed factor (default 1)\n"
+              << "  --loop               Start over at the end\n";
+}
+
+bool parseArgs(int argc, char* argv[], Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* prefix) -> const char* {
+            size_t n = std::char_traits<char>::length(prefix);
+            return arg.compare(0, n, prefix) == 0 ? argv[i] + n : nullptr;
+        };
+
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (const char* v = value("--host=")) {
+            opts.host = v;
+        } else if (const char* v = value("--port=")) {
+            opts.port = std::atoi(v);
+        } else if (const char* v = value("--speed=")) {
+            opts.speed = std::strtod(v, nullptr);
+        } else if (arg == "--loop") {
+            opts.loop = true;
+        } else if (arg.compare(0, 2, "--") == 0) {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        } else {
+            opts.path = arg;
+        }
+    }
+    return !opts.path.empty() && opts.port > 0 && opts.port <= 65535 && opts.speed > 0.0;
+}
+
+struct Record {
+    uint64_t time_us;
+    size_t offset;                  // Frame start in the file buffer
+    size_t length;
+};
+
+/**
+ * Split a tlog into timestamped frames (resyncing past damaged records)
+ */
+std::vector<Record> indexTlog(const std::vector<uint8_t>& data) {
+    std::vector<Record> records;
+    size_t pos = 0;
+    while (pos + 8 < data.size()) {
+        size_t length = mavlinkFrameLength(data.data() + pos + 8, data.size() - pos - 8);
+        if (length == 0) {
+            ++pos;
+            continue;
+        }
+        uint64_t time_us = 0;
+        for (int i = 0; i < 8; ++i) {
+            time_us = (time_us << 8) | data[pos + i];
+        }
+        records.push_back(Record{time_us, pos + 8, length});
+        pos += 8 + length;
+    }
+    return records;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+    if (!parseArgs(argc, argv, opts)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    std::ifstream file(opts.path, std::ios::binary);
+    if (!file) {
+        std::cerr << "ERROR: cannot open " << opts.path << "\n";
+        return 1;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::vector<Record> records = indexTlog(data);
+    if (records.empty()) {
+        std::cerr << "ERROR: no MAVLink frames in " << opts.path << "\n";
+        return 1;
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(opts.port));
+    if (::inet_pton(AF_INET, opts.host.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "ERROR: bad address " << opts.host << "\n";
+        return 1;
+    }
+    int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        std::cerr << "ERROR: socket() failed\n";
+        return 1;
+    }
+
+    double duration_s = (records.back().time_us - records.front().time_us) / 1e6;
+    std::cerr << records.size() << " frames, " << duration_s << " s -> udp://" << opts.host << ":"
+              << opts.port << " at " << opts.speed << "x\n";
+
+    size_t sent = 0;
+    do {
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t first_us = records.front().time_us;
+        for (const auto& record : records) {
+            if (g_stop) {
+                break;
+            }
+            // Recorded offset scaled by the speed; timestamps going backwards send at once
+            uint64_t offset_us = record.time_us > first_us ? record.time_us - first_us : 0;
+            std::this_thread::sleep_until(start + std::chrono::microseconds(
+                static_cast<int64_t>(offset_us / opts.speed)));
+            ::sendto(fd, data.data() + record.offset, record.length, 0,
+                     reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+            ++sent;
+        }
+    } while (opts.loop && !g_stop);
+
+    ::close(fd);
+    std::cerr << sent << " frames sent\n";
+    return 0;
+}